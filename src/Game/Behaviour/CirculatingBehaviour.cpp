@@ -35,6 +35,11 @@ void CirculatingBehaviour::Initialize(uint32_t position_entity_id, float radius,
 }
 
 void CirculatingBehaviour::Run(const mono::UpdateContext& update_context)
+{
+    m_body->SetVelocity(NextVelocity(update_context));
+}
+
+math::Vector CirculatingBehaviour::NextVelocity(const mono::UpdateContext& update_context)
 {
     const math::Vector unit_rotation = math::VectorFromAngle(m_current_angle_rad);
     const math::Vector radius_position = unit_rotation * m_radius;
@@ -44,5 +49,5 @@ void CirculatingBehaviour::Run(const mono::UpdateContext& update_context)
 
     const math::Vector center_position = m_transform_system->GetWorldPosition(m_position_entity_id);
     const math::Vector delta_to_position = (center_position + radius_position) - m_body->GetPosition();
-    m_body->SetVelocity(math::Normalized(delta_to_position) * m_forward_velocity);
+    return math::Normalized(delta_to_position) * m_forward_velocity;
 }
@@ -3,6 +3,7 @@
 
 #include "MonoFwd.h"
 #include "Physics/PhysicsFwd.h"
+#include "Math/Vector.h"
 #include <cstdint>
 
 namespace game
@@ -15,6 +16,9 @@ namespace game
         void Initialize(uint32_t position_entity_id, float radius, float heading, mono::IBody* body);
         void Run(const mono::UpdateContext& update_context);
 
+        // Advances like Run and returns the velocity for the body instead of setting it.
+        math::Vector NextVelocity(const mono::UpdateContext& update_context);
+
     private:
 
         mono::TransformSystem* m_transform_system;
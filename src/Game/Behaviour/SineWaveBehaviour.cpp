@@ -29,6 +29,12 @@ void SineWaveBehaviour::Initialize(mono::IBody* body, const math::Vector& positi
 }
 
 void SineWaveBehaviour::Run(const mono::UpdateContext& update_context)
+{
+    m_body->SetPosition(NextPosition(update_context));
+    m_body->SetVelocity(math::ZeroVec);
+}
+
+math::Vector SineWaveBehaviour::NextPosition(const mono::UpdateContext& update_context)
 {
     m_radians += (update_context.delta_s * math::ToRadians(m_sine_speed_deg_s));
     const float sine_value = std::sin(m_radians);
@@ -38,7 +44,5 @@ void SineWaveBehaviour::Run(const mono::UpdateContext& update_context)
     const math::Vector velocity_normalized = math::Normalized(m_velocity);
     const math::Vector perpendicular_to_vel = math::Perpendicular(velocity_normalized);
 
-    const math::Vector m_sine_position = m_position + (perpendicular_to_vel * sine_value * m_magnitude);
-    m_body->SetPosition(m_sine_position);
-    m_body->SetVelocity(math::ZeroVec);
+    return m_position + (perpendicular_to_vel * sine_value * m_magnitude);
 }
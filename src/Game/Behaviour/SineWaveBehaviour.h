@@ -15,6 +15,9 @@ namespace game
         void Initialize(mono::IBody* body, const math::Vector& position);
         void Run(const mono::UpdateContext& update_context);
 
+        // Advances like Run and returns the position for the body instead of setting it, the velocity is zero.
+        math::Vector NextPosition(const mono::UpdateContext& update_context);
+
     private:
 
         mono::IBody* m_body;
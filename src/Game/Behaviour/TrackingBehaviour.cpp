@@ -10,21 +10,33 @@
 #include "Physics/PhysicsSystem.h"
 #include "System/Debug.h"
 
+#include <algorithm>
+
 using namespace game;
 
 TrackingBehaviour::TrackingBehaviour()
-    : m_tracking_position(math::INF, math::INF)
+    : m_entity_id(0)
+    , m_entity_body(nullptr)
+    , m_navigation_system(nullptr)
+    , m_path_ticket(InvalidPathTicket)
+    , m_path_failed(false)
+    , m_tracking_position(math::INF, math::INF)
     , m_current_position(0.0f)
     , m_meter_per_second(1.0f)
     , m_timestamp_last_updated(0.0f)
 { }
 
-TrackingBehaviour::~TrackingBehaviour() = default;
+TrackingBehaviour::~TrackingBehaviour()
+{
+    if(m_navigation_system)
+        m_navigation_system->CancelPaths(m_entity_id);
+}
 
-void TrackingBehaviour::Init(mono::IBody* body, NavigationSystem* navigation_system)
+void TrackingBehaviour::Init(uint32_t entity_id, mono::IBody* body, NavigationSystem* navigation_system)
 {
     MONO_ASSERT(body->GetType() == mono::BodyType::DYNAMIC);
 
+    m_entity_id = entity_id;
     m_entity_body = body;
     m_navigation_system = navigation_system;
     m_tracking_position = body->GetPosition();
@@ -37,37 +49,49 @@ void TrackingBehaviour::SetTrackingSpeed(float meter_per_second)
 
 TrackingResult TrackingBehaviour::Run(const mono::UpdateContext& update_context)
 {
+    TakePendingPath();
+
     if(!m_path)
     {
         TrackingResult result;
-        result.state = TrackingState::NO_PATH;
+        result.state = (m_path_ticket != InvalidPathTicket) ? TrackingState::PATH_PENDING : TrackingState::NO_PATH;
         result.distance_to_target = math::INF;
         return result;
     }
 
-    return Run(update_context, m_path->GetEndPoint());
+    return Run(update_context, m_tracking_position);
 }
 
 TrackingResult TrackingBehaviour::Run(const mono::UpdateContext& update_context, const math::Vector& tracking_position)
 {
+    TakePendingPath();
+
     TrackingResult result;
     result.state = TrackingState::NO_PATH;
     result.distance_to_target = math::INF;
 
+    // A failed search is reported once, the next run will try again.
+    const bool path_failed = m_path_failed;
+    m_path_failed = false;
+
+    const bool path_pending = (m_path_ticket != InvalidPathTicket);
     const float delta_time = update_context.timestamp - m_timestamp_last_updated;
 
     const float distance_to_last = math::DistanceBetween(m_tracking_position, tracking_position);
     const bool time_to_update_path = distance_to_last > 0.5f && delta_time > 2.0f;
 
-    if(!m_path || time_to_update_path)
+    // Keep following the current path while waiting for a new one.
+    if(!path_pending && ((!m_path && !path_failed) || time_to_update_path))
     {
         m_timestamp_last_updated = update_context.timestamp;
+        UpdatePath(tracking_position);
+    }
 
-        const bool path_updated = UpdatePath(tracking_position);
-        if(!path_updated)
-            return result;
-
-        m_tracking_position = tracking_position;
+    if(!m_path)
+    {
+        if(m_path_ticket != InvalidPathTicket)
+            result.state = TrackingState::PATH_PENDING;
+        return result;
     }
 
     result.distance_to_target = m_path->Length() - m_current_position;
@@ -104,20 +128,92 @@ TrackingResult TrackingBehaviour::Run(const mono::UpdateContext& update_context,
     return result;
 }
 
-bool TrackingBehaviour::UpdatePath(const math::Vector& tracking_position)
+TrackingResult TrackingBehaviour::RunTowardsTarget(
+    const mono::UpdateContext& update_context, uint32_t target_id, const math::Vector& target_position)
 {
+    math::Vector flow_direction;
+    float distance_to_target;
+
+    const math::Vector current_position = m_entity_body->GetPosition();
+    const bool has_flow_field =
+        m_navigation_system->SampleFlowField(target_id, current_position, flow_direction, distance_to_target);
+    if(!has_flow_field)
+        return Run(update_context, target_position);
+
+    // Drop any path, it will be outdated if the flow field goes away.
+    if(m_path_ticket != InvalidPathTicket)
+    {
+        m_navigation_system->CancelPath(m_path_ticket);
+        m_path_ticket = InvalidPathTicket;
+    }
+    m_path = nullptr;
+    m_path_failed = false;
+
+    TrackingResult result;
+    result.distance_to_target = distance_to_target;
+
+    constexpr float at_target_distance = 0.2f;
+    if(distance_to_target <= at_target_distance)
+    {
+        result.state = TrackingState::AT_TARGET;
+        return result;
+    }
+
+    // Ease towards the flow direction, slowing down close to the target.
+    const float speed = std::min(m_meter_per_second, distance_to_target / update_context.delta_s);
+    const math::Vector target_velocity = flow_direction * speed;
+
+    constexpr float move_halflife = 0.3f;
+    const float blend = std::min(update_context.delta_s / move_halflife, 1.0f);
+    m_move_velocity = m_move_velocity + (target_velocity - m_move_velocity) * blend;
+
+    m_entity_body->SetVelocity(m_move_velocity);
+    m_tracking_position = target_position;
+
+    result.state = TrackingState::TRACKING;
+    return result;
+}
+
+void TrackingBehaviour::UpdatePath(const math::Vector& tracking_position)
+{
+    if(m_path_ticket != InvalidPathTicket)
+        m_navigation_system->CancelPath(m_path_ticket);
+
     const math::Vector position = m_entity_body->GetPosition();
-    const FindPathResult& find_path_result = m_navigation_system->FindPath(position, tracking_position);
-    
+    m_path_ticket = m_navigation_system->RequestPath(m_entity_id, position, tracking_position);
+    m_tracking_position = tracking_position;
+    m_path_failed = false;
+}
+
+void TrackingBehaviour::TakePendingPath()
+{
+    if(m_path_ticket == InvalidPathTicket)
+        return;
+
+    FindPathResult find_path_result;
+    const bool path_finished = m_navigation_system->TakePathResult(m_path_ticket, find_path_result);
+    if(!path_finished)
+    {
+        // Cancelled from the outside, for example when the navigation system is reset.
+        if(!m_navigation_system->IsPathPending(m_path_ticket))
+            m_path_ticket = InvalidPathTicket;
+        return;
+    }
+
+    m_path_ticket = InvalidPathTicket;
+
     if(find_path_result.result == AStarResult::SUCCESS)
     {
+        // The entity has moved while the path was computed, continue from the current position.
         m_path = mono::CreatePath(find_path_result.nav_points);
-        const mono::LengthResult result = m_path->GetLengthFromPosition(position);
+        const mono::LengthResult result = m_path->GetLengthFromPosition(m_entity_body->GetPosition());
         m_current_position = result.valid_length;
-        return true;
     }
-
-    return false;
+    else
+    {
+        m_path = nullptr;
+        m_path_failed = true;
+    }
 }
 
 const math::Vector& TrackingBehaviour::GetTrackingPosition() const
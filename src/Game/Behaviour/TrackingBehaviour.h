@@ -12,6 +12,7 @@ namespace game
     {
         AT_TARGET,
         TRACKING,
+        PATH_PENDING,
         NO_PATH
     };
 
@@ -23,6 +24,8 @@ namespace game
             return "At Target";
         case TrackingState::TRACKING:
             return "Tracking";
+        case TrackingState::PATH_PENDING:
+            return "Path Pending";
         case TrackingState::NO_PATH:
             return "No Path";
         };
@@ -47,20 +50,31 @@ namespace game
 
         TrackingBehaviour();
         ~TrackingBehaviour();
-        void Init(mono::IBody* body, class NavigationSystem* navigation_system);
+        void Init(uint32_t entity_id, mono::IBody* body, class NavigationSystem* navigation_system);
 
         void SetTrackingSpeed(float meter_per_second);
-        bool UpdatePath(const math::Vector& tracking_position);
+
+        // Requests a new path to the tracking position, the current path (if any) is followed until the new one is ready.
+        void UpdatePath(const math::Vector& tracking_position);
         const math::Vector& GetTrackingPosition() const;
         TrackingDebugData GetDebugData() const;
 
         TrackingResult Run(const mono::UpdateContext& update_context);
         TrackingResult Run(const mono::UpdateContext& update_context, const math::Vector& tracking_position);
 
+        // Steers using the flow field of the target when there is one, otherwise the same as Run with a position.
+        TrackingResult RunTowardsTarget(
+            const mono::UpdateContext& update_context, uint32_t target_id, const math::Vector& target_position);
+
     private:
 
+        void TakePendingPath();
+
+        uint32_t m_entity_id;
         mono::IBody* m_entity_body;
         game::NavigationSystem* m_navigation_system;
+        uint32_t m_path_ticket;
+        bool m_path_failed;
 
         math::Vector m_tracking_position;
         float m_current_position;
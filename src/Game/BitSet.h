@@ -0,0 +1,73 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace game
+{
+    inline uint32_t CountTrailingZeros(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return index;
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    // Fixed size set of bits that iterates the set bits a word at a time.
+    class BitSet
+    {
+    public:
+
+        BitSet(uint32_t n_bits)
+            : m_words((n_bits + 63) / 64, 0)
+            , m_size(n_bits)
+        { }
+
+        uint32_t Size() const
+        {
+            return m_size;
+        }
+
+        bool Test(uint32_t index) const
+        {
+            return (m_words[index / 64] >> (index % 64)) & 1;
+        }
+
+        void Set(uint32_t index, bool value)
+        {
+            const uint64_t mask = uint64_t(1) << (index % 64);
+            if(value)
+                m_words[index / 64] |= mask;
+            else
+                m_words[index / 64] &= ~mask;
+        }
+
+        template <typename T>
+        void ForEachSet(T&& callback) const
+        {
+            for(uint32_t word_index = 0; word_index < m_words.size(); ++word_index)
+            {
+                uint64_t word = m_words[word_index];
+                while(word != 0)
+                {
+                    const uint32_t bit = CountTrailingZeros(word);
+                    word &= word - 1;
+                    callback(word_index * 64 + bit);
+                }
+            }
+        }
+
+    private:
+
+        std::vector<uint64_t> m_words;
+        uint32_t m_size;
+    };
+}
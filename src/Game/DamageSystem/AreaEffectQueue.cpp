@@ -0,0 +1,194 @@
+
+#include "AreaEffectQueue.h"
+
+#include "DamageSystem/DamageSystem.h"
+#include "Weapons/WeaponTypes.h"
+
+#include "Math/MathFunctions.h"
+#include "Physics/IBody.h"
+#include "Physics/IShape.h"
+#include "Physics/PhysicsSystem.h"
+#include "Physics/PhysicsSpace.h"
+
+#include <algorithm>
+
+using namespace game;
+
+namespace
+{
+    // Larger clusters would query a lot of bodies that none of the effects reach.
+    constexpr float MaxClusterRadius = 15.0f;
+
+    // Smallest circle that contains both circles.
+    void MergeCircle(math::Vector& center, float& radius, const math::Vector& other_center, float other_radius)
+    {
+        const math::Vector delta = other_center - center;
+        const float distance = math::Length(delta);
+
+        if(distance + other_radius <= radius)
+            return;
+
+        if(distance + radius <= other_radius)
+        {
+            center = other_center;
+            radius = other_radius;
+            return;
+        }
+
+        const float new_radius = (radius + distance + other_radius) * 0.5f;
+        center = center + delta * ((new_radius - radius) / distance);
+        radius = new_radius;
+    }
+
+    float DistanceToQuad(const math::Vector& point, const math::Quad& quad)
+    {
+        const math::Vector closest_point(
+            std::clamp(point.x, quad.bottom_left.x, quad.top_right.x),
+            std::clamp(point.y, quad.bottom_left.y, quad.top_right.y));
+        return math::Length(point - closest_point);
+    }
+}
+
+void AreaEffectQueue::Push(const AreaEffect& effect)
+{
+    m_effects.push_back(effect);
+}
+
+bool AreaEffectQueue::Empty() const
+{
+    return m_effects.empty();
+}
+
+const std::vector<AreaEffectCluster>& AreaEffectQueue::BuildClusters(float max_cluster_radius)
+{
+    m_clusters.clear();
+    m_effect_clusters.clear();
+
+    for(const AreaEffect& effect : m_effects)
+    {
+        uint32_t cluster_index = 0;
+        for(; cluster_index < m_clusters.size(); ++cluster_index)
+        {
+            AreaEffectCluster& cluster = m_clusters[cluster_index];
+
+            math::Vector merged_center = cluster.center;
+            float merged_radius = cluster.radius;
+            MergeCircle(merged_center, merged_radius, effect.position, effect.radius);
+
+            if(merged_radius <= max_cluster_radius)
+            {
+                cluster.center = merged_center;
+                cluster.radius = merged_radius;
+                cluster.object_types |= effect.object_types;
+                cluster.n_effects++;
+                break;
+            }
+        }
+
+        if(cluster_index == m_clusters.size())
+            m_clusters.push_back({ effect.position, effect.radius, effect.object_types, 0, 1 });
+
+        m_effect_clusters.push_back(cluster_index);
+    }
+
+    // Effects in cluster order, stable so the queue order is kept within the clusters.
+    uint32_t first_effect = 0;
+    for(AreaEffectCluster& cluster : m_clusters)
+    {
+        cluster.first_effect = first_effect;
+        first_effect += cluster.n_effects;
+        cluster.n_effects = 0;
+    }
+
+    m_clustered_effects.resize(m_effects.size());
+    m_clustered_queue_indices.resize(m_effects.size());
+
+    for(uint32_t index = 0; index < m_effects.size(); ++index)
+    {
+        AreaEffectCluster& cluster = m_clusters[m_effect_clusters[index]];
+        const uint32_t clustered_index = cluster.first_effect + cluster.n_effects;
+        m_clustered_effects[clustered_index] = m_effects[index];
+        m_clustered_queue_indices[clustered_index] = index;
+        cluster.n_effects++;
+    }
+
+    return m_clusters;
+}
+
+const std::vector<AreaEffect>& AreaEffectQueue::ClusteredEffects() const
+{
+    return m_clustered_effects;
+}
+
+void AreaEffectQueue::Resolve(mono::PhysicsSystem* physics_system, game::DamageSystem* damage_system)
+{
+    if(m_effects.empty())
+        return;
+
+    BuildClusters(MaxClusterRadius);
+    m_hits.clear();
+
+    mono::PhysicsSpace* space = physics_system->GetSpace();
+
+    for(const AreaEffectCluster& cluster : m_clusters)
+    {
+        const std::vector<mono::QueryResult> found_bodies = space->QueryRadius(cluster.center, cluster.radius, cluster.object_types);
+        if(found_bodies.empty())
+            continue;
+
+        // The one broadphase query for the cluster gives the candidates, a body is found once per shape.
+        m_candidates.clear();
+        for(const mono::QueryResult& query_result : found_bodies)
+        {
+            const auto same_body = [&query_result](const AreaEffectCandidate& candidate) {
+                return candidate.body == query_result.body;
+            };
+            if(std::any_of(m_candidates.begin(), m_candidates.end(), same_body))
+                continue;
+
+            const uint32_t entity_id = mono::PhysicsSystem::GetIdFromBody(query_result.body);
+            for(mono::IShape* shape : physics_system->GetShapesAttachedToBody(entity_id))
+                m_candidates.push_back({ entity_id, query_result.body, query_result.collision_category, shape->GetBoundingBox() });
+        }
+
+        // Then each effect hits the candidates with a shape that overlaps it, once per body.
+        for(uint32_t effect_index = cluster.first_effect; effect_index < cluster.first_effect + cluster.n_effects; ++effect_index)
+        {
+            const AreaEffect& effect = m_clustered_effects[effect_index];
+            const mono::IBody* last_hit_body = nullptr;
+
+            for(const AreaEffectCandidate& candidate : m_candidates)
+            {
+                if(candidate.body == last_hit_body || !(candidate.collision_category & effect.object_types))
+                    continue;
+
+                if(DistanceToQuad(effect.position, candidate.shape_bounds) > effect.radius)
+                    continue;
+
+                m_hits.push_back({ m_clustered_queue_indices[effect_index], candidate.entity_id, candidate.body });
+                last_hit_body = candidate.body;
+            }
+        }
+    }
+
+    // The broadphase order depends on the physics space, apply in queue and entity order.
+    const auto sort_by_queue_and_entity = [](const AreaEffectHit& left, const AreaEffectHit& right) {
+        if(left.queue_index != right.queue_index)
+            return left.queue_index < right.queue_index;
+        return left.entity_id < right.entity_id;
+    };
+    std::sort(m_hits.begin(), m_hits.end(), sort_by_queue_and_entity);
+
+    for(const AreaEffectHit& hit : m_hits)
+    {
+        const AreaEffect& effect = m_effects[hit.queue_index];
+
+        const math::Vector delta = hit.body->GetPosition() - effect.position;
+        hit.body->ApplyImpulse(math::Normalized(delta) * effect.magnitude, effect.position);
+
+        if(damage_system)
+            damage_system->ApplyDamage(hit.entity_id, effect.who_did_damage, NO_WEAPON_IDENTIFIER, DamageDetails(effect.damage, false, false, false));
+    }
+
+    m_effects.clear();
+}
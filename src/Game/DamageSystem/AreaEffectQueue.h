@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "Math/Vector.h"
+#include "Math/Quad.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    class DamageSystem;
+
+    struct AreaEffect
+    {
+        math::Vector position;
+        float radius;
+        float magnitude;
+        int damage;
+        uint32_t who_did_damage;
+        uint32_t object_types;
+    };
+
+    // Effects close enough to each other to share one broadphase query, a range in the clustered effects.
+    struct AreaEffectCluster
+    {
+        math::Vector center;
+        float radius;
+        uint32_t object_types;
+        uint32_t first_effect;
+        uint32_t n_effects;
+    };
+
+    // Area effects (shockwaves with damage) for a frame, resolved together so that overlapping effects share
+    // one broadphase query and only test the shapes it found, and impulses and damage are applied in the order
+    // the effects were queued.
+    class AreaEffectQueue
+    {
+    public:
+
+        void Push(const AreaEffect& effect);
+        bool Empty() const;
+
+        // Groups the queued effects, the clustered effects keep their queue order within each cluster.
+        const std::vector<AreaEffectCluster>& BuildClusters(float max_cluster_radius);
+        const std::vector<AreaEffect>& ClusteredEffects() const;
+
+        // Applies impulses and damage for everything queued, and clears the queue.
+        void Resolve(mono::PhysicsSystem* physics_system, game::DamageSystem* damage_system);
+
+    private:
+
+        struct AreaEffectCandidate
+        {
+            uint32_t entity_id;
+            mono::IBody* body;
+            uint32_t collision_category;
+            math::Quad shape_bounds;
+        };
+
+        struct AreaEffectHit
+        {
+            uint32_t queue_index;
+            uint32_t entity_id;
+            mono::IBody* body;
+        };
+
+        // Scratch buffers, cleared every frame but keeping their memory.
+        std::vector<AreaEffect> m_effects;
+        std::vector<uint32_t> m_effect_clusters;
+        std::vector<AreaEffectCluster> m_clusters;
+        std::vector<AreaEffect> m_clustered_effects;
+        std::vector<uint32_t> m_clustered_queue_indices;
+        std::vector<AreaEffectCandidate> m_candidates;
+        std::vector<AreaEffectHit> m_hits;
+    };
+}
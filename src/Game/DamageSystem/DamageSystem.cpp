@@ -72,7 +72,9 @@ DamageSystem::DamageSystem(
     , m_damage_records(num_records)
     , m_damage_callbacks(num_records)
     , m_damage_filters(num_records)
-    , m_active(num_records, false)
+    , m_active(num_records)
+    , m_callback_types(num_records, 0)
+    , m_global_callback_types(0)
 {
     file::FilePtr config_file = file::OpenAsciiFile("res/configs/damage_config.json");
     if(config_file)
@@ -86,8 +88,8 @@ DamageSystem::DamageSystem(
 
 DamageRecord* DamageSystem::CreateRecord(uint32_t id)
 {
-    MONO_ASSERT(!m_active[id]);
-    m_active[id] = true;
+    MONO_ASSERT(!m_active.Test(id));
+    m_active.Set(id, true);
 
     DamageRecord& new_record = m_damage_records[id];
     new_record.health = 100;
@@ -104,23 +106,24 @@ void DamageSystem::ReleaseRecord(uint32_t id)
 {
     for(auto& callback : m_damage_callbacks[id])
         callback.callback = nullptr;
+    m_callback_types[id] = 0;
 
     ClearDamageFilter(id);
     m_damage_modifiers.erase(id);
-    m_active[id] = false;
+    m_active.Set(id, false);
 }
 
 bool DamageSystem::IsAllocated(uint32_t id) const
 {
-    if(id >= m_active.size())
+    if(id >= m_active.Size())
         return false;
 
-    return m_active[id];
+    return m_active.Test(id);
 }
 
 void DamageSystem::ReactivateDamageRecord(uint32_t id)
 {
-    m_active[id] = true;
+    m_active.Set(id, true);
 
     DamageRecord* record = GetDamageRecord(id);
     record->health = record->full_health;
@@ -129,7 +132,7 @@ void DamageSystem::ReactivateDamageRecord(uint32_t id)
 
 DamageRecord* DamageSystem::GetDamageRecord(uint32_t id)
 {
-    MONO_ASSERT(m_active[id]);
+    MONO_ASSERT(m_active.Test(id));
     return &m_damage_records[id];
 }
 
@@ -149,12 +152,14 @@ uint32_t DamageSystem::SetDamageCallback(uint32_t id, uint32_t callback_types, D
     const uint32_t free_index = FindFreeCallbackIndex(damage_callbacks);
     MONO_ASSERT(free_index != std::numeric_limits<uint32_t>::max());
     damage_callbacks[free_index] = { callback_types, damage_callback };
+    m_callback_types[id] = CollectCallbackTypes(damage_callbacks);
     return free_index;
 }
 
 void DamageSystem::RemoveDamageCallback(uint32_t id, uint32_t callback_id)
 {
     m_damage_callbacks[id][callback_id].callback = nullptr;
+    m_callback_types[id] = CollectCallbackTypes(m_damage_callbacks[id]);
 }
 
 uint32_t DamageSystem::SetGlobalDamageCallback(uint32_t callback_types, DamageCallback damage_callback)
@@ -162,12 +167,14 @@ uint32_t DamageSystem::SetGlobalDamageCallback(uint32_t callback_types, DamageCa
     const uint32_t free_index = FindFreeCallbackIndex(m_global_damage_callbacks);
     MONO_ASSERT(free_index != std::numeric_limits<uint32_t>::max());
     m_global_damage_callbacks[free_index] = { callback_types, damage_callback };
+    m_global_callback_types = CollectCallbackTypes(m_global_damage_callbacks);
     return free_index;
 }
 
 void DamageSystem::RemoveGlobalDamageCallback(uint32_t callback_id)
 {
     m_global_damage_callbacks[callback_id].callback = nullptr;
+    m_global_callback_types = CollectCallbackTypes(m_global_damage_callbacks);
 }
 
 ShockwaveComponent* DamageSystem::CreateShockwaveComponent(uint32_t entity_id)
@@ -257,6 +264,9 @@ DamageResult DamageSystem::ApplyDamage(uint32_t id_damaged_entity, uint32_t id_w
 
     m_damage_events.push_back(damage_event);
 
+    if(damage_record.health <= 0)
+        m_dead_entities.push_back(id_damaged_entity);
+
     return result;
 }
 
@@ -295,6 +305,18 @@ void DamageSystem::GainHealth(uint32_t id, int health_gain)
     DamageRecord* record = GetDamageRecord(id);
     record->health = std::clamp(record->health + health_gain, 0, record->full_health);
     record->last_damaged_timestamp = m_timestamp;
+
+    if(record->health <= 0)
+        m_dead_entities.push_back(id);
+}
+
+void DamageSystem::SetHealth(uint32_t id, int health)
+{
+    DamageRecord* record = GetDamageRecord(id);
+    record->health = health;
+
+    if(record->health <= 0)
+        m_dead_entities.push_back(id);
 }
 
 const std::vector<DamageRecord>& DamageSystem::GetDamageRecords() const
@@ -327,6 +349,11 @@ void DamageSystem::ApplyShockwave(uint32_t entity_id)
     }
 }
 
+void DamageSystem::QueueAreaEffect(const AreaEffect& area_effect)
+{
+    m_area_effects.Push(area_effect);
+}
+
 bool DamageSystem::IsInvincible(uint32_t id) const
 {
     const bool has_damage_record = IsAllocated(id);
@@ -393,34 +420,65 @@ void DamageSystem::Update(const mono::UpdateContext& update_context)
         }
     };
 
-    for(const DamageEvent& damage_event : m_damage_events)
+    // Callbacks can apply more damage, so no iterators here.
+    for(size_t index = 0; index < m_damage_events.size(); ++index)
     {
-        call_callbacks(damage_event, m_damage_callbacks[damage_event.id_damaged_entity]);
-        call_callbacks(damage_event, m_global_damage_callbacks);
+        const DamageEvent damage_event = m_damage_events[index];
+        if(m_callback_types[damage_event.id_damaged_entity] & damage_event.damage_result)
+            call_callbacks(damage_event, m_damage_callbacks[damage_event.id_damaged_entity]);
+
+        if(m_global_callback_types & damage_event.damage_result)
+            call_callbacks(damage_event, m_global_damage_callbacks);
     }
 
-    for(uint32_t entity_id = 0; entity_id < m_damage_records.size(); ++entity_id)
+    for(size_t index = 0; index < m_dead_entities.size(); ++index)
     {
-        if(!m_active[entity_id])
+        const uint32_t entity_id = m_dead_entities[index];
+
+        // Might be listed more than once, or healed and reactivated since.
+        if(!m_active.Test(entity_id))
             continue;
 
         const DamageRecord& damage_record = m_damage_records[entity_id];
-        if(damage_record.health <= 0)
-        {
-            if(damage_record.release_entity_on_death)
-                m_entity_manager->ReleaseEntity(entity_id);
+        if(damage_record.health > 0)
+            continue;
+
+        if(damage_record.release_entity_on_death)
+            m_entity_manager->ReleaseEntity(entity_id);
 
+        // No death entities without the damage config.
+        if(!m_death_entities.empty())
+        {
             const std::string& explosion_entity = m_death_entities.front();
             game::SpawnEntityWithAnimation(
                 explosion_entity.c_str(), 0, entity_id, m_entity_manager, m_transform_system, m_sprite_system);
-            m_active[entity_id] = false;
         }
+
+        m_active.Set(entity_id, false);
     }
+
+    m_dead_entities.clear();
 }
 
 void DamageSystem::PostUpdate()
 {
     m_damage_events.clear();
+
+    // The logics and weapons queuing area effects update after this system, resolving here applies the
+    // damage in the same frame as before the queue. The events are handled in the next update.
+    m_area_effects.Resolve(m_physics_system, this);
+}
+
+uint32_t DamageSystem::CollectCallbackTypes(const DamageCallbacks& callbacks)
+{
+    uint32_t callback_types = 0;
+    for(const DamageCallbackData& callback_data : callbacks)
+    {
+        if(callback_data.callback)
+            callback_types |= callback_data.callback_types;
+    }
+
+    return callback_types;
 }
 
 uint32_t DamageSystem::FindFreeCallbackIndex(const DamageCallbacks& callbacks) const
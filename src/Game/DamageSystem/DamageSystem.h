@@ -4,6 +4,8 @@
 #include "IGameSystem.h"
 #include "DamageSystemTypes.h"
 #include "IDamageModifier.h"
+#include "AreaEffectQueue.h"
+#include "BitSet.h"
 
 #include "MonoFwd.h"
 
@@ -87,11 +89,18 @@ namespace game
 
         DamageResult ApplyDamage(uint32_t id_damaged_entity, uint32_t id_who_did_damage, uint32_t weapon_identifier, const DamageDetails& damage_details);
         void GainHealth(uint32_t id, int health_gain);
+
+        // Use this instead of writing the record health directly, the death check only looks at
+        // entities that had their health changed.
+        void SetHealth(uint32_t id, int health);
         const std::vector<DamageRecord>& GetDamageRecords() const;
         const std::vector<DamageEvent>& GetDamageEventsThisFrame() const;
 
         void ApplyShockwave(uint32_t entity_id);
 
+        // Impulse and damage in an area, resolved together with the other area effects of the frame in PostUpdate.
+        void QueueAreaEffect(const AreaEffect& area_effect);
+
         int AddDamageModifierForId(uint32_t id, IDamageModifier* modifier);
         void RemoveDamageModifierForId(uint32_t id, int slot_id);
 
@@ -106,11 +115,9 @@ namespace game
         template <typename T>
         inline void ForEeach(T&& func)
         {
-            for(uint32_t entity_id = 0; entity_id < m_damage_records.size(); ++entity_id)
-            {
-                if(m_active[entity_id])
-                    func(entity_id, m_damage_records[entity_id]);
-            }
+            m_active.ForEachSet([this, &func](uint32_t entity_id) {
+                func(entity_id, m_damage_records[entity_id]);
+            });
         }
 
         const char* Name() const override;
@@ -127,6 +134,7 @@ namespace game
         using DamageCallbacks = std::array<DamageCallbackData, 8>;
 
         uint32_t FindFreeCallbackIndex(const DamageCallbacks& callbacks) const;
+        static uint32_t CollectCallbackTypes(const DamageCallbacks& callbacks);
 
         mono::TransformSystem* m_transform_system;
         mono::SpriteSystem* m_sprite_system;
@@ -138,7 +146,14 @@ namespace game
         std::vector<DamageRecord> m_damage_records;
         std::vector<DamageCallbacks> m_damage_callbacks;
         std::vector<DamageFilter> m_damage_filters;
-        std::vector<bool> m_active;
+        BitSet m_active;
+
+        // Entities that reached zero health since the last update.
+        std::vector<uint32_t> m_dead_entities;
+
+        // DamageType mask of the callbacks set per entity, and for the global callbacks.
+        std::vector<uint32_t> m_callback_types;
+        uint32_t m_global_callback_types;
 
         std::vector<std::string> m_death_entities;
         DamageCallbacks m_global_damage_callbacks;
@@ -146,6 +161,7 @@ namespace game
         std::vector<DamageEvent> m_damage_events;
 
         std::unordered_map<uint32_t, ShockwaveComponent> m_shockwave_components;
+        AreaEffectQueue m_area_effects;
 
         struct DamageModifierContext
         {
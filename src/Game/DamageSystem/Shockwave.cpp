@@ -3,7 +3,6 @@
 
 #include "CollisionConfiguration.h"
 #include "DamageSystem/DamageSystem.h"
-#include "Weapons/WeaponTypes.h"
 
 #include "Physics/PhysicsSystem.h"
 #include "Physics/PhysicsSpace.h"
@@ -37,12 +36,17 @@ void game::ShockwaveAndDamageAt(
     uint32_t who_did_damage,
     uint32_t object_types)
 {
+    if(damage_system)
+    {
+        damage_system->QueueAreaEffect({ world_position, shockwave_radius, magnitude, damage, who_did_damage, object_types });
+        return;
+    }
+
     const std::vector<mono::QueryResult> found_bodies =
         physics_system->GetSpace()->QueryRadius(world_position, shockwave_radius, object_types);
 
     for(const mono::QueryResult& query_result : found_bodies)
     {
-        const uint32_t other_entity_id = physics_system->GetIdFromBody(query_result.body);
         const math::Vector body_position = query_result.body->GetPosition();
 
         const math::Vector delta = body_position - world_position;
@@ -51,8 +55,5 @@ void game::ShockwaveAndDamageAt(
         //const float length = math::Length(delta); // Maybe scale the damage and impulse with the length
 
         query_result.body->ApplyImpulse(normalized_delta * magnitude, world_position);
-
-        if(damage_system)
-            damage_system->ApplyDamage(other_entity_id, who_did_damage, NO_WEAPON_IDENTIFIER, DamageDetails(damage, false, false, false));
     }
 }
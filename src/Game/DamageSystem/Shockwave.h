@@ -23,6 +23,7 @@ namespace game
         float magnitude,
         uint32_t object_types);
 
+    // With a damage system the shockwave is queued and resolved in the next damage system update.
     void ShockwaveAndDamageAt(
         mono::PhysicsSystem* physics_system,
         game::DamageSystem* damage_system,
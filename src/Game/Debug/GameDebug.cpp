@@ -46,6 +46,7 @@ bool game::g_draw_targets = false;
 uint32_t game::g_draw_physics_subcomponents = mono::PhysicsDebugComponents::DRAW_SHAPES;
 bool game::g_draw_physics_stats = false;
 bool game::g_draw_particle_stats = false;
+bool game::g_draw_target_stats = false;
 bool game::g_draw_network_stats = false;
 bool game::g_draw_position_prediction = false;
 bool game::g_draw_debug_players = false;
@@ -94,6 +95,7 @@ void DrawDebugMenu(game::EntityLogicSystem* logic_system, mono::EventHandler* ev
         ImGui::PopID();
         ImGui::Checkbox("Physics Stats",        &game::g_draw_physics_stats);
         ImGui::Checkbox("Particle Stats",       &game::g_draw_particle_stats);
+        ImGui::Checkbox("Target Stats",         &game::g_draw_target_stats);
         ImGui::Checkbox("Network Stats",        &game::g_draw_network_stats);
         ImGui::Checkbox("Client Viewport",      &game::g_draw_client_viewport);
         ImGui::Checkbox("Prediction System",    &game::g_draw_position_prediction);
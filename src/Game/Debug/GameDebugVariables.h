@@ -18,6 +18,7 @@ namespace game
     extern uint32_t g_draw_physics_subcomponents;
     extern bool g_draw_physics_stats;
     extern bool g_draw_particle_stats;
+    extern bool g_draw_target_stats;
     extern bool g_draw_network_stats;
     extern bool g_draw_position_prediction;
     extern bool g_draw_debug_players;
@@ -45,7 +45,8 @@ namespace
 BulletTrailEffect::BulletTrailEffect(
     mono::TransformSystem* transform_system,
     mono::ParticleSystem* particle_system,
-    mono::IEntityManager* entity_system)
+    mono::IEntityManager* entity_system,
+    uint32_t pool_size)
     : m_transform_system(transform_system)
     , m_particle_system(particle_system)
     , m_entity_system(entity_system)
@@ -53,7 +54,7 @@ BulletTrailEffect::BulletTrailEffect(
     mono::Entity particle_entity = m_entity_system->CreateEntity("BulletTrailEffect", { TRANSFORM_COMPONENT, PARTICLE_SYSTEM_COMPONENT });
     m_particle_system->SetPoolData(
         particle_entity.id,
-        500,
+        pool_size,
         "res/textures/particles/white_square.png",
         mono::BlendMode::ONE,
         mono::ParticleDrawLayer::POST_GAMEOBJECTS,
@@ -15,7 +15,8 @@ namespace game
         BulletTrailEffect(
             mono::TransformSystem* transform_system,
             mono::ParticleSystem* particle_system,
-            mono::IEntityManager* entity_system);
+            mono::IEntityManager* entity_system,
+            uint32_t pool_size = 500);
         ~BulletTrailEffect();
 
         void AttachEmitterToBullet(uint32_t entity_id);
@@ -43,14 +43,14 @@ namespace
     }
 }
 
-MuzzleFlash::MuzzleFlash(mono::ParticleSystem* particle_system, mono::IEntityManager* entity_system)
+MuzzleFlash::MuzzleFlash(mono::ParticleSystem* particle_system, mono::IEntityManager* entity_system, uint32_t pool_size)
     : m_particle_system(particle_system)
     , m_entity_system(entity_system)
 {
     mono::Entity particle_entity = m_entity_system->CreateEntity("MuzzleFlash", { TRANSFORM_COMPONENT, PARTICLE_SYSTEM_COMPONENT });
     particle_system->SetPoolData(
         particle_entity.id,
-        500,
+        pool_size,
         "res/textures/particles/flare.png",
         mono::BlendMode::ONE,
         mono::ParticleDrawLayer::POST_GAMEOBJECTS,
@@ -11,7 +11,7 @@ namespace game
     {
     public:
 
-        MuzzleFlash(mono::ParticleSystem* particle_system, mono::IEntityManager* entity_system);
+        MuzzleFlash(mono::ParticleSystem* particle_system, mono::IEntityManager* entity_system, uint32_t pool_size = 500);
         ~MuzzleFlash();
         void EmittAt(const math::Vector& position, float direction);
 
@@ -7,7 +7,6 @@
 #include "Rendering/Sprite/Sprite.h"
 #include "Rendering/Sprite/SpriteProperties.h"
 #include "SystemContext.h"
-#include "Util/Random.h"
 
 using namespace game;
 
@@ -21,17 +20,24 @@ namespace tweak_values
 }
 
 BatController::BatController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler)
+    : BatController(entity_id, system_context, event_handler, MakeRandomSeed())
+{ }
+
+BatController::BatController(
+    uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler, uint32_t random_seed)
+    : m_random(random_seed, entity_id)
 {
     m_entity_id = entity_id;
     m_transform_system = system_context->GetSystem<mono::TransformSystem>();
     m_sprite_system = system_context->GetSystem<mono::SpriteSystem>();
 
-    const BatStateMachine::StateTable state_table = {
-        BatStateMachine::MakeState(States::IDLE, &BatController::ToIdle, &BatController::Idle, this),
-        BatStateMachine::MakeState(States::MOVING, &BatController::ToMoving, &BatController::Moving, this),
+    static constexpr BatStateMachine::State state_table[] = {
+        BatStateMachine::MakeState(States::IDLE, &BatController::ToIdle, &BatController::Idle),
+        BatStateMachine::MakeState(States::MOVING, &BatController::ToMoving, &BatController::Moving),
     };
 
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(BatStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 
     const math::Matrix& world_transform = m_transform_system->GetWorld(entity_id);
     const math::Vector& world_position = math::GetPosition(world_transform);
@@ -47,7 +53,7 @@ void BatController::Update(const mono::UpdateContext& update_context)
 
 void BatController::ToIdle()
 {
-    m_chill_time = mono::Random(tweak_values::chill_time_min, tweak_values::chill_time_max);
+    m_chill_time = m_random.Random(tweak_values::chill_time_min, tweak_values::chill_time_max);
 }
 
 void BatController::Idle(const mono::UpdateContext& update_context)
@@ -63,8 +69,8 @@ void BatController::ToMoving()
     m_current_position = math::GetPosition(world_transform);
 
     constexpr float move_radius = tweak_values::move_radius;
-    const float x = mono::Random(-move_radius, move_radius);
-    const float y = mono::Random(-move_radius, move_radius);
+    const float x = m_random.Random(-move_radius, move_radius);
+    const float y = m_random.Random(-move_radius, move_radius);
 
     m_move_delta = (m_start_position + math::Vector(x, y)) - m_current_position;
     m_move_counter = 0.0f;
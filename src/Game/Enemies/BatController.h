@@ -4,6 +4,7 @@
 #include "MonoFwd.h"
 #include "Entity/IEntityLogic.h"
 #include "Math/Vector.h"
+#include "RandomStream.h"
 #include "StateMachine.h"
 
 namespace game
@@ -13,6 +14,7 @@ namespace game
     public:
 
         BatController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler);
+        BatController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler, uint32_t random_seed);
         void Update(const mono::UpdateContext& update_context) override;
 
     private:
@@ -31,6 +33,7 @@ namespace game
         math::Vector m_move_delta;
         float m_move_counter;
         float m_chill_time;
+        RandomStream m_random;
 
         enum class States
         {
@@ -38,7 +41,7 @@ namespace game
             MOVING
         };
 
-        using BatStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using BatStateMachine = StaticStateMachine<BatController, States, const mono::UpdateContext&>;
         BatStateMachine m_states;
     };
 }
@@ -0,0 +1,120 @@
+
+#include "BatLogicPool.h"
+
+#include "Math/EasingFunctions.h"
+#include "Math/Matrix.h"
+#include "TransformSystem/TransformSystem.h"
+#include "Rendering/Sprite/SpriteSystem.h"
+#include "Rendering/Sprite/Sprite.h"
+#include "Rendering/Sprite/SpriteProperties.h"
+#include "IUpdatable.h"
+
+using namespace game;
+
+namespace tweak_values
+{
+    constexpr float chill_time_min = 0.0f;
+    constexpr float chill_time_max = 0.0f;
+    constexpr float move_radius = 0.25f;
+    constexpr float move_speed = 0.4f;
+    constexpr math::EaseFunction ease_function = math::EaseBackOut;
+}
+
+BatLogicPool::BatLogicPool(
+    uint32_t n_entities, mono::TransformSystem* transform_system, mono::SpriteSystem* sprite_system, uint32_t random_seed)
+    : m_transform_system(transform_system)
+    , m_sprite_system(sprite_system)
+    , m_random_seed(random_seed)
+    , m_bats(n_entities)
+{ }
+
+void BatLogicPool::Add(uint32_t entity_id)
+{
+    const math::Vector& world_position = m_transform_system->GetWorldPosition(entity_id);
+
+    Bat& bat = m_bats.Add(entity_id);
+    bat.random = RandomStream(m_random_seed, entity_id);
+    bat.state = States::IDLE;
+    bat.chill_time = bat.random.Random(tweak_values::chill_time_min, tweak_values::chill_time_max);
+    bat.move_counter = 0.0f;
+    bat.move_duration = 0.0f;
+    bat.start_position = world_position;
+    bat.current_position = world_position;
+    bat.move_delta = math::ZeroVec;
+}
+
+void BatLogicPool::Remove(uint32_t entity_id)
+{
+    m_bats.Remove(entity_id);
+}
+
+uint32_t BatLogicPool::Size() const
+{
+    return m_bats.Size();
+}
+
+void BatLogicPool::Update(const mono::UpdateContext& update_context)
+{
+    Bat* bats = m_bats.Data();
+    const uint32_t* entity_ids = m_bats.EntityIds();
+    const uint32_t n_bats = m_bats.Size();
+
+    m_start_moving.clear();
+    m_moved.clear();
+
+    for(uint32_t index = 0; index < n_bats; ++index)
+    {
+        Bat& bat = bats[index];
+
+        if(bat.state == States::IDLE)
+        {
+            bat.chill_time -= update_context.delta_s;
+            if(bat.chill_time <= 0.0f)
+                m_start_moving.push_back(index);
+        }
+        else
+        {
+            math::Vector new_position;
+            new_position.x = tweak_values::ease_function(bat.move_counter, bat.move_duration, bat.current_position.x, bat.move_delta.x);
+            new_position.y = tweak_values::ease_function(bat.move_counter, bat.move_duration, bat.current_position.y, bat.move_delta.y);
+            m_moved.push_back({ entity_ids[index], new_position });
+
+            bat.move_counter += update_context.delta_s;
+            if(bat.move_counter >= bat.move_duration)
+            {
+                bat.state = States::IDLE;
+                bat.chill_time = bat.random.Random(tweak_values::chill_time_min, tweak_values::chill_time_max);
+            }
+        }
+    }
+
+    for(uint32_t index : m_start_moving)
+    {
+        const uint32_t entity_id = entity_ids[index];
+
+        Bat& bat = bats[index];
+        bat.current_position = m_transform_system->GetWorldPosition(entity_id);
+
+        constexpr float move_radius = tweak_values::move_radius;
+        const float x = bat.random.Random(-move_radius, move_radius);
+        const float y = bat.random.Random(-move_radius, move_radius);
+
+        bat.state = States::MOVING;
+        bat.move_delta = (bat.start_position + math::Vector(x, y)) - bat.current_position;
+        bat.move_counter = 0.0f;
+        bat.move_duration = math::Length(bat.move_delta) / tweak_values::move_speed;
+
+        mono::ISprite* sprite = m_sprite_system->GetSprite(entity_id);
+        if(bat.move_delta.x < 0.0f)
+            sprite->SetProperty(mono::SpriteProperty::FLIP_HORIZONTAL);
+        else
+            sprite->ClearProperty(mono::SpriteProperty::FLIP_HORIZONTAL);
+    }
+
+    for(const MovedBat& moved_bat : m_moved)
+    {
+        math::Matrix& transform = m_transform_system->GetTransform(moved_bat.entity_id);
+        math::Position(transform, moved_bat.position);
+        m_transform_system->SetTransformState(moved_bat.entity_id, mono::TransformState::CLIENT);
+    }
+}
@@ -0,0 +1,63 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "Entity/ILogicPool.h"
+#include "Math/Vector.h"
+#include "RandomStream.h"
+
+#include <vector>
+
+namespace game
+{
+    // Same behaviour as BatController, but all bats are updated together. The timers run in one loop over the
+    // bat data, the bats that start moving read their positions in one pass and the new positions are written in
+    // another, so the transform and sprite systems are not touched from inside the per bat loop. Each bat has a
+    // random stream from random_seed and its entity id, a BatController with the same seed moves the same way.
+    class BatLogicPool : public ILogicPool
+    {
+    public:
+
+        BatLogicPool(
+            uint32_t n_entities, mono::TransformSystem* transform_system, mono::SpriteSystem* sprite_system, uint32_t random_seed);
+
+        void Add(uint32_t entity_id) override;
+        void Remove(uint32_t entity_id) override;
+        uint32_t Size() const override;
+        void Update(const mono::UpdateContext& update_context) override;
+
+    private:
+
+        enum class States : uint32_t
+        {
+            IDLE,
+            MOVING
+        };
+
+        struct Bat
+        {
+            States state;
+            float chill_time;
+            float move_counter;
+            float move_duration;
+            math::Vector start_position;
+            math::Vector current_position;
+            math::Vector move_delta;
+            RandomStream random;
+        };
+
+        struct MovedBat
+        {
+            uint32_t entity_id;
+            math::Vector position;
+        };
+
+        mono::TransformSystem* m_transform_system;
+        mono::SpriteSystem* m_sprite_system;
+        const uint32_t m_random_seed;
+        LogicPoolStorage<Bat> m_bats;
+
+        std::vector<uint32_t> m_start_moving;
+        std::vector<MovedBat> m_moved;
+    };
+}
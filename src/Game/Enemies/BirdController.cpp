@@ -47,14 +47,15 @@ BirdController::BirdController(uint32_t entity_id, mono::SystemContext* system_c
     m_walk_anim_id = m_sprite->GetAnimationIdFromName("walk");
     m_flying_anim_id = m_sprite->GetAnimationIdFromName("flying");
 
-    const BirdStateMachine::StateTable state_table = {
-        BirdStateMachine::MakeState(States::IDLE, &BirdController::ToIdle, &BirdController::Idle, this),
-        BirdStateMachine::MakeState(States::PECK, &BirdController::ToPeck, &BirdController::Peck, this),
-        BirdStateMachine::MakeState(States::MOVING, &BirdController::ToMoving, &BirdController::Moving, this),
-        BirdStateMachine::MakeState(States::FLYING, &BirdController::ToFlying, &BirdController::Flying, &BirdController::ExitFlying, this),
+    static constexpr BirdStateMachine::State state_table[] = {
+        BirdStateMachine::MakeState(States::IDLE, &BirdController::ToIdle, &BirdController::Idle),
+        BirdStateMachine::MakeState(States::PECK, &BirdController::ToPeck, &BirdController::Peck),
+        BirdStateMachine::MakeState(States::MOVING, &BirdController::ToMoving, &BirdController::Moving),
+        BirdStateMachine::MakeState(States::FLYING, &BirdController::ToFlying, &BirdController::Flying, &BirdController::ExitFlying),
     };
 
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(BirdStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 void BirdController::Update(const mono::UpdateContext& update_context)
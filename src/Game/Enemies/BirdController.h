@@ -71,7 +71,7 @@ namespace game
             FLYING
         };
 
-        using BirdStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using BirdStateMachine = StaticStateMachine<BirdController, States, const mono::UpdateContext&>;
         BirdStateMachine m_states;
     };
 }
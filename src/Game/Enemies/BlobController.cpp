@@ -7,7 +7,6 @@
 #include "Rendering/Sprite/SpriteSystem.h"
 #include "Rendering/Sprite/SpriteProperties.h"
 #include "TransformSystem/TransformSystem.h"
-#include "Util/Random.h"
 #include "Math/EasingFunctions.h"
 
 
@@ -17,31 +16,46 @@ namespace tweak_values
     constexpr int percentage_to_move = 50;
     constexpr float move_radius = 0.25f;
     constexpr math::EaseFunction ease_function = math::EaseInOutCubic;
+    constexpr uint32_t jump_length_without_sprite_s = 1;
 }
 
 using namespace game;
 
 BlobController::BlobController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler)
+    : BlobController(entity_id, system_context, event_handler, MakeRandomSeed())
+{ }
+
+BlobController::BlobController(
+    uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler, uint32_t random_seed)
     : m_entity_id(entity_id)
+    , m_sprite(nullptr)
+    , m_idle_anim_id(-1)
+    , m_jump_anim_id(-1)
+    , m_jump_anim_length(tweak_values::jump_length_without_sprite_s)
+    , m_random(random_seed, entity_id)
 {
     m_transform_system = system_context->GetSystem<mono::TransformSystem>();
 
     mono::SpriteSystem* sprite_system = system_context->GetSystem<mono::SpriteSystem>();
-    m_sprite = sprite_system->GetSprite(entity_id);
+    if(sprite_system->IsAllocated(entity_id))
+    {
+        m_sprite = sprite_system->GetSprite(entity_id);
 
-    m_idle_anim_id = m_sprite->GetAnimationIdFromName("idle");
-    m_jump_anim_id = m_sprite->GetAnimationIdFromName("jump");
-    if(m_jump_anim_id == -1)
-        m_jump_anim_id = m_sprite->GetAnimationIdFromName("run");
+        m_idle_anim_id = m_sprite->GetAnimationIdFromName("idle");
+        m_jump_anim_id = m_sprite->GetAnimationIdFromName("jump");
+        if(m_jump_anim_id == -1)
+            m_jump_anim_id = m_sprite->GetAnimationIdFromName("run");
 
-    m_jump_anim_length = m_sprite->GetAnimationLengthSeconds(m_jump_anim_id);
+        m_jump_anim_length = m_sprite->GetAnimationLengthSeconds(m_jump_anim_id);
+    }
 
-    const BlobStateMachine::StateTable state_table = {
-        BlobStateMachine::MakeState(States::IDLE, &BlobController::ToIdle, &BlobController::Idle, this),
-        BlobStateMachine::MakeState(States::MOVING, &BlobController::ToMoving, &BlobController::Moving, this),
+    static constexpr BlobStateMachine::State state_table[] = {
+        BlobStateMachine::MakeState(States::IDLE, &BlobController::ToIdle, &BlobController::Idle),
+        BlobStateMachine::MakeState(States::MOVING, &BlobController::ToMoving, &BlobController::Moving),
     };
 
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(BlobStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 void BlobController::Update(const mono::UpdateContext& update_context)
@@ -52,7 +66,9 @@ void BlobController::Update(const mono::UpdateContext& update_context)
 void BlobController::ToIdle()
 {
     m_idle_timer_s = 0.0f;
-    m_sprite->SetAnimation(m_idle_anim_id);
+
+    if(m_sprite)
+        m_sprite->SetAnimation(m_idle_anim_id);
 }
 
 void BlobController::Idle(const mono::UpdateContext& update_context)
@@ -61,7 +77,7 @@ void BlobController::Idle(const mono::UpdateContext& update_context)
 
     if(m_idle_timer_s > tweak_values::idle_threshold_s)
     {
-        const bool move = mono::Chance(tweak_values::percentage_to_move);
+        const bool move = m_random.Chance(tweak_values::percentage_to_move);
         if(move)
             m_states.TransitionTo(States::MOVING);
 
@@ -75,12 +91,15 @@ void BlobController::ToMoving()
     m_current_position = math::GetPosition(world_transform);
 
     constexpr float move_radius = tweak_values::move_radius;
-    const float x = mono::Random(-move_radius, move_radius);
-    const float y = mono::Random(-move_radius, move_radius);
+    const float x = m_random.Random(-move_radius, move_radius);
+    const float y = m_random.Random(-move_radius, move_radius);
 
     m_move_delta = math::Vector(x, y);
     m_move_counter_s = 0.0f;
 
+    if(!m_sprite)
+        return;
+
     if(m_move_delta.x < 0.0f)
         m_sprite->SetProperty(mono::SpriteProperty::FLIP_HORIZONTAL);
     else
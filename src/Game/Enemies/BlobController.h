@@ -6,6 +6,7 @@
 #include "Entity/IEntityLogic.h"
 #include "StateMachine.h"
 #include "Math/Vector.h"
+#include "RandomStream.h"
 
 namespace game
 {
@@ -14,6 +15,7 @@ namespace game
     public:
 
         BlobController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler);
+        BlobController(uint32_t entity_id, mono::SystemContext* system_context, mono::EventHandler* event_handler, uint32_t random_seed);
         void Update(const mono::UpdateContext& update_context) override;
 
     private:
@@ -26,7 +28,7 @@ namespace game
 
         uint32_t m_entity_id;
         mono::TransformSystem* m_transform_system;
-        mono::ISprite* m_sprite;
+        mono::ISprite* m_sprite; // Null when the entity has no sprite
 
         int m_idle_anim_id;
         int m_jump_anim_id;
@@ -37,6 +39,7 @@ namespace game
         math::Vector m_current_position;
         math::Vector m_move_delta;
         float m_move_counter_s;
+        RandomStream m_random;
 
         enum class States
         {
@@ -44,7 +47,7 @@ namespace game
             MOVING
         };
 
-        using BlobStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using BlobStateMachine = StaticStateMachine<BlobController, States, const mono::UpdateContext&>;
         BlobStateMachine m_states;
     };
 }
@@ -0,0 +1,149 @@
+
+#include "BlobLogicPool.h"
+
+#include "Math/EasingFunctions.h"
+#include "Math/Matrix.h"
+#include "TransformSystem/TransformSystem.h"
+#include "Rendering/Sprite/ISprite.h"
+#include "Rendering/Sprite/SpriteSystem.h"
+#include "Rendering/Sprite/SpriteProperties.h"
+#include "IUpdatable.h"
+
+using namespace game;
+
+namespace tweak_values
+{
+    constexpr float idle_threshold_s = 0.5f;
+    constexpr int percentage_to_move = 50;
+    constexpr float move_radius = 0.25f;
+    constexpr math::EaseFunction ease_function = math::EaseInOutCubic;
+    constexpr uint32_t jump_length_without_sprite_s = 1;
+}
+
+BlobLogicPool::BlobLogicPool(
+    uint32_t n_entities, mono::TransformSystem* transform_system, mono::SpriteSystem* sprite_system, uint32_t random_seed)
+    : m_transform_system(transform_system)
+    , m_sprite_system(sprite_system)
+    , m_random_seed(random_seed)
+    , m_blobs(n_entities)
+{ }
+
+void BlobLogicPool::Add(uint32_t entity_id)
+{
+    Blob& blob = m_blobs.Add(entity_id);
+    blob.state = States::IDLE;
+    blob.idle_timer_s = 0.0f;
+    blob.move_counter_s = 0.0f;
+    blob.current_position = math::ZeroVec;
+    blob.move_delta = math::ZeroVec;
+    blob.random = RandomStream(m_random_seed, entity_id);
+
+    blob.sprite = nullptr;
+    blob.idle_anim_id = -1;
+    blob.jump_anim_id = -1;
+    blob.jump_anim_length = tweak_values::jump_length_without_sprite_s;
+
+    if(m_sprite_system->IsAllocated(entity_id))
+    {
+        blob.sprite = m_sprite_system->GetSprite(entity_id);
+        blob.idle_anim_id = blob.sprite->GetAnimationIdFromName("idle");
+        blob.jump_anim_id = blob.sprite->GetAnimationIdFromName("jump");
+        if(blob.jump_anim_id == -1)
+            blob.jump_anim_id = blob.sprite->GetAnimationIdFromName("run");
+
+        blob.jump_anim_length = blob.sprite->GetAnimationLengthSeconds(blob.jump_anim_id);
+        blob.sprite->SetAnimation(blob.idle_anim_id);
+    }
+}
+
+void BlobLogicPool::Remove(uint32_t entity_id)
+{
+    m_blobs.Remove(entity_id);
+}
+
+uint32_t BlobLogicPool::Size() const
+{
+    return m_blobs.Size();
+}
+
+void BlobLogicPool::Update(const mono::UpdateContext& update_context)
+{
+    Blob* blobs = m_blobs.Data();
+    const uint32_t* entity_ids = m_blobs.EntityIds();
+    const uint32_t n_blobs = m_blobs.Size();
+
+    m_start_moving.clear();
+    m_stop_moving.clear();
+    m_moved.clear();
+
+    for(uint32_t index = 0; index < n_blobs; ++index)
+    {
+        Blob& blob = blobs[index];
+
+        if(blob.state == States::IDLE)
+        {
+            blob.idle_timer_s += update_context.delta_s;
+            if(blob.idle_timer_s > tweak_values::idle_threshold_s)
+            {
+                if(blob.random.Chance(tweak_values::percentage_to_move))
+                    m_start_moving.push_back(index);
+
+                blob.idle_timer_s = 0.0f;
+            }
+        }
+        else
+        {
+            const float duration = blob.jump_anim_length;
+
+            math::Vector new_position;
+            new_position.x = tweak_values::ease_function(blob.move_counter_s, duration, blob.current_position.x, blob.move_delta.x);
+            new_position.y = tweak_values::ease_function(blob.move_counter_s, duration, blob.current_position.y, blob.move_delta.y);
+            m_moved.push_back({ entity_ids[index], new_position });
+
+            blob.move_counter_s += update_context.delta_s;
+            if(blob.move_counter_s > duration)
+                m_stop_moving.push_back(index);
+        }
+    }
+
+    for(uint32_t index : m_start_moving)
+    {
+        Blob& blob = blobs[index];
+        blob.current_position = m_transform_system->GetWorldPosition(entity_ids[index]);
+
+        constexpr float move_radius = tweak_values::move_radius;
+        const float x = blob.random.Random(-move_radius, move_radius);
+        const float y = blob.random.Random(-move_radius, move_radius);
+
+        blob.state = States::MOVING;
+        blob.move_delta = math::Vector(x, y);
+        blob.move_counter_s = 0.0f;
+
+        if(!blob.sprite)
+            continue;
+
+        if(blob.move_delta.x < 0.0f)
+            blob.sprite->SetProperty(mono::SpriteProperty::FLIP_HORIZONTAL);
+        else
+            blob.sprite->ClearProperty(mono::SpriteProperty::FLIP_HORIZONTAL);
+
+        blob.sprite->SetAnimation(blob.jump_anim_id);
+    }
+
+    for(uint32_t index : m_stop_moving)
+    {
+        Blob& blob = blobs[index];
+        blob.state = States::IDLE;
+        blob.idle_timer_s = 0.0f;
+
+        if(blob.sprite)
+            blob.sprite->SetAnimation(blob.idle_anim_id);
+    }
+
+    for(const MovedBlob& moved_blob : m_moved)
+    {
+        math::Matrix& transform = m_transform_system->GetTransform(moved_blob.entity_id);
+        math::Position(transform, moved_blob.position);
+        m_transform_system->SetTransformState(moved_blob.entity_id, mono::TransformState::CLIENT);
+    }
+}
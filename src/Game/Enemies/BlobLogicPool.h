@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "Rendering/RenderFwd.h"
+#include "Entity/ILogicPool.h"
+#include "Math/Vector.h"
+#include "RandomStream.h"
+
+#include <vector>
+
+namespace game
+{
+    // Same behaviour as BlobController, updated in passes over all blobs like the BatLogicPool. The sprite
+    // animations only change on a state change, so the sprite calls are done in the passes for those. The
+    // random streams are seeded like in the BatLogicPool.
+    class BlobLogicPool : public ILogicPool
+    {
+    public:
+
+        BlobLogicPool(
+            uint32_t n_entities, mono::TransformSystem* transform_system, mono::SpriteSystem* sprite_system, uint32_t random_seed);
+
+        void Add(uint32_t entity_id) override;
+        void Remove(uint32_t entity_id) override;
+        uint32_t Size() const override;
+        void Update(const mono::UpdateContext& update_context) override;
+
+    private:
+
+        enum class States : uint32_t
+        {
+            IDLE,
+            MOVING
+        };
+
+        struct Blob
+        {
+            States state;
+            float idle_timer_s;
+            float move_counter_s;
+            uint32_t jump_anim_length;
+            math::Vector current_position;
+            math::Vector move_delta;
+            RandomStream random;
+
+            mono::ISprite* sprite; // Null when the entity has no sprite
+            int idle_anim_id;
+            int jump_anim_id;
+        };
+
+        struct MovedBlob
+        {
+            uint32_t entity_id;
+            math::Vector position;
+        };
+
+        mono::TransformSystem* m_transform_system;
+        mono::SpriteSystem* m_sprite_system;
+        const uint32_t m_random_seed;
+        LogicPoolStorage<Blob> m_blobs;
+
+        std::vector<uint32_t> m_start_moving;
+        std::vector<uint32_t> m_stop_moving;
+        std::vector<MovedBlob> m_moved;
+    };
+}
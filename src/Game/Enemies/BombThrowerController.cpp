@@ -39,12 +39,13 @@ BombThrowerController::BombThrowerController(uint32_t entity_id, mono::SystemCon
     game::WeaponSystem* weapon_system = system_context->GetSystem<game::WeaponSystem>();
     m_weapon = weapon_system->CreatePrimaryWeapon(entity_id, game::WeaponFaction::ENEMY);
 
-    const TStateMachine::StateTable state_table = {
-        TStateMachine::MakeState(States::IDLE, &BombThrowerController::EnterIdle, &BombThrowerController::Idle, this),
-        TStateMachine::MakeState(States::PREPARE_ATTACK, &BombThrowerController::EnterPrepareAttack, &BombThrowerController::PrepareAttack, this),
-        TStateMachine::MakeState(States::ATTACK, &BombThrowerController::EnterAttack, &BombThrowerController::Attack, this),
+    static constexpr TStateMachine::State state_table[] = {
+        TStateMachine::MakeState(States::IDLE, &BombThrowerController::EnterIdle, &BombThrowerController::Idle),
+        TStateMachine::MakeState(States::PREPARE_ATTACK, &BombThrowerController::EnterPrepareAttack, &BombThrowerController::PrepareAttack),
+        TStateMachine::MakeState(States::ATTACK, &BombThrowerController::EnterAttack, &BombThrowerController::Attack),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(TStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 BombThrowerController::~BombThrowerController() = default;
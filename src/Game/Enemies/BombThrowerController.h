@@ -51,7 +51,7 @@ namespace game
             PREPARE_ATTACK,
             ATTACK
         };
-        using TStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using TStateMachine = StaticStateMachine<BombThrowerController, States, const mono::UpdateContext&>;
         TStateMachine m_states;
     };
 }
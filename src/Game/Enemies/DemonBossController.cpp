@@ -81,23 +81,24 @@ DemonBossController::DemonBossController(uint32_t entity_id, mono::SystemContext
 
     m_target_system = system_context->GetSystem<TargetSystem>();
 
-    const CacoStateMachine::StateTable state_table = {
+    static constexpr CacoStateMachine::State state_table[] = {
         CacoStateMachine::MakeState(
-            States::IDLE, &DemonBossController::OnIdle, &DemonBossController::Idle, this),
+            States::IDLE, &DemonBossController::OnIdle, &DemonBossController::Idle),
         CacoStateMachine::MakeState(
-            States::ACTIVE, &DemonBossController::OnActive, &DemonBossController::Active, this),
+            States::ACTIVE, &DemonBossController::OnActive, &DemonBossController::Active),
         CacoStateMachine::MakeState(
-            States::TURN_TO_PLAYER, &DemonBossController::OnTurn, &DemonBossController::TurnToPlayer, this),
+            States::TURN_TO_PLAYER, &DemonBossController::OnTurn, &DemonBossController::TurnToPlayer),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_CIRCLE, &DemonBossController::OnCircleAttack, &DemonBossController::CircleAttack, this),
+            States::ACTION_FIRE_CIRCLE, &DemonBossController::OnCircleAttack, &DemonBossController::CircleAttack),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_HOMING, &DemonBossController::OnFireHoming, &DemonBossController::ActionFireHoming, this),
+            States::ACTION_FIRE_HOMING, &DemonBossController::OnFireHoming, &DemonBossController::ActionFireHoming),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_LONG, &DemonBossController::OnLongAttack, &DemonBossController::ActionLongAttack, this),
+            States::ACTION_FIRE_LONG, &DemonBossController::OnLongAttack, &DemonBossController::ActionLongAttack),
         CacoStateMachine::MakeState(
-            States::DEAD, &DemonBossController::OnDead, &DemonBossController::Dead, this),
+            States::DEAD, &DemonBossController::OnDead, &DemonBossController::Dead),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(CacoStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 DemonBossController::~DemonBossController()
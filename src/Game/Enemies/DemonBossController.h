@@ -93,7 +93,7 @@ namespace game
         const char* StateToString(States state) const;
         void TurnAndTransitionTo(States state_after_turn);
 
-        using CacoStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using CacoStateMachine = StaticStateMachine<DemonBossController, States, const mono::UpdateContext&>;
         CacoStateMachine m_states;
 
         States m_state_after_turn;
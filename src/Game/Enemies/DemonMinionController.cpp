@@ -81,23 +81,24 @@ DemonMinionController::DemonMinionController(uint32_t entity_id, mono::SystemCon
 
     m_target_system = system_context->GetSystem<TargetSystem>();
 
-    const CacoStateMachine::StateTable state_table = {
+    static constexpr CacoStateMachine::State state_table[] = {
         CacoStateMachine::MakeState(
-            States::IDLE, &DemonMinionController::OnIdle, &DemonMinionController::Idle, this),
+            States::IDLE, &DemonMinionController::OnIdle, &DemonMinionController::Idle),
         CacoStateMachine::MakeState(
-            States::ACTIVE, &DemonMinionController::OnActive, &DemonMinionController::Active, this),
+            States::ACTIVE, &DemonMinionController::OnActive, &DemonMinionController::Active),
         CacoStateMachine::MakeState(
-            States::TURN_TO_PLAYER, &DemonMinionController::OnTurn, &DemonMinionController::TurnToPlayer, this),
+            States::TURN_TO_PLAYER, &DemonMinionController::OnTurn, &DemonMinionController::TurnToPlayer),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_CIRCLE, &DemonMinionController::OnCircleAttack, &DemonMinionController::CircleAttack, this),
+            States::ACTION_FIRE_CIRCLE, &DemonMinionController::OnCircleAttack, &DemonMinionController::CircleAttack),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_HOMING, &DemonMinionController::OnFireHoming, &DemonMinionController::ActionFireHoming, this),
+            States::ACTION_FIRE_HOMING, &DemonMinionController::OnFireHoming, &DemonMinionController::ActionFireHoming),
         CacoStateMachine::MakeState(
-            States::ACTION_FIRE_LONG, &DemonMinionController::OnLongAttack, &DemonMinionController::ActionLongAttack, this),
+            States::ACTION_FIRE_LONG, &DemonMinionController::OnLongAttack, &DemonMinionController::ActionLongAttack),
         CacoStateMachine::MakeState(
-            States::DEAD, &DemonMinionController::OnDead, &DemonMinionController::Dead, this),
+            States::DEAD, &DemonMinionController::OnDead, &DemonMinionController::Dead),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(CacoStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 DemonMinionController::~DemonMinionController()
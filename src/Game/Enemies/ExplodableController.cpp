@@ -52,12 +52,13 @@ ExplodableController::ExplodableController(uint32_t entity_id, mono::SystemConte
     mono::ParticleSystem* particle_system = system_context->GetSystem<mono::ParticleSystem>();
     m_explosion_effect = std::make_unique<ExplosionEffect>(particle_system, m_entity_system);
 
-    const ExplodableStateMachine::StateTable state_table = {
-        ExplodableStateMachine::MakeState(States::IDLE, &ExplodableController::OnIdle, &ExplodableController::Idle, this),
-        ExplodableStateMachine::MakeState(States::DEAD, &ExplodableController::OnDead, &ExplodableController::Dead, this),
+    static constexpr ExplodableStateMachine::State state_table[] = {
+        ExplodableStateMachine::MakeState(States::IDLE, &ExplodableController::OnIdle, &ExplodableController::Idle),
+        ExplodableStateMachine::MakeState(States::DEAD, &ExplodableController::OnDead, &ExplodableController::Dead),
     };
 
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(ExplodableStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 void ExplodableController::DrawDebugInfo(IDebugDrawer* debug_drawer) const
@@ -44,11 +44,10 @@ namespace game
         enum class States
         {
             IDLE,
-            ATTACK,
             DEAD,
         };
 
-        using ExplodableStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using ExplodableStateMachine = StaticStateMachine<ExplodableController, States, const mono::UpdateContext&>;
         ExplodableStateMachine m_states;
 
         float m_wait_timer_s;
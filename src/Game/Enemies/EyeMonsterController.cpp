@@ -61,7 +61,7 @@ EyeMonsterController::EyeMonsterController(uint32_t entity_id, mono::SystemConte
     m_homing_movement.SetForwardVelocity(tweak_values::velocity_m_per_s);
     m_homing_movement.SetAngularVelocity(tweak_values::degrees_per_second);
 
-    m_tracking_movement.Init(body, m_navigation_system);
+    m_tracking_movement.Init(entity_id, body, m_navigation_system);
     m_tracking_movement.SetTrackingSpeed(tweak_values::velocity_m_per_s);
 
     m_entity_manager = system_context->GetSystem<mono::IEntityManager>();
@@ -70,14 +70,15 @@ EyeMonsterController::EyeMonsterController(uint32_t entity_id, mono::SystemConte
 
     using namespace std::placeholders;
 
-    const MyStateMachine::StateTable& state_table = {
-        MyStateMachine::MakeState(States::SLEEPING, &EyeMonsterController::ToSleep,     &EyeMonsterController::SleepState, this),
-        MyStateMachine::MakeState(States::AWAKE,    &EyeMonsterController::ToAwake,     &EyeMonsterController::AwakeState, this),
-        MyStateMachine::MakeState(States::RETARGET, &EyeMonsterController::ToRetarget,  &EyeMonsterController::RetargetState, this),
-        MyStateMachine::MakeState(States::TRACKING, &EyeMonsterController::ToTracking,  &EyeMonsterController::TrackingState, this),
-        MyStateMachine::MakeState(States::HUNT,     &EyeMonsterController::ToHunt,      &EyeMonsterController::HuntState, &EyeMonsterController::ExitHunt, this),
+    static constexpr MyStateMachine::State state_table[] = {
+        MyStateMachine::MakeState(States::SLEEPING, &EyeMonsterController::ToSleep,     &EyeMonsterController::SleepState),
+        MyStateMachine::MakeState(States::AWAKE,    &EyeMonsterController::ToAwake,     &EyeMonsterController::AwakeState),
+        MyStateMachine::MakeState(States::RETARGET, &EyeMonsterController::ToRetarget,  &EyeMonsterController::RetargetState),
+        MyStateMachine::MakeState(States::TRACKING, &EyeMonsterController::ToTracking,  &EyeMonsterController::TrackingState),
+        MyStateMachine::MakeState(States::HUNT,     &EyeMonsterController::ToHunt,      &EyeMonsterController::HuntState, &EyeMonsterController::ExitHunt),
     };
-    m_states.SetStateTableAndState(state_table, States::SLEEPING);
+    static_assert(MyStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::SLEEPING);
 }
 
 EyeMonsterController::~EyeMonsterController()
@@ -245,13 +246,14 @@ void EyeMonsterController::TrackingState(const mono::UpdateContext& update_conte
         m_force_update_path = false;
     }
 
-    const TrackingResult result = m_tracking_movement.Run(update_context, target_position);
+    const TrackingResult result = m_tracking_movement.RunTowardsTarget(update_context, m_aquired_target->TargetId(), target_position);
     switch(result.state)
     {
     case TrackingState::NO_PATH:
         m_states.TransitionTo(States::SLEEPING);
         break;
  
+    case TrackingState::PATH_PENDING:
     case TrackingState::TRACKING:
         if(result.distance_to_target < (tweak_values::engage_distance - 1.0f))
             m_states.TransitionTo(States::HUNT);
@@ -70,7 +70,7 @@ namespace game
         float m_retarget_timer_s;
         bool m_force_update_path;
 
-        using MyStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using MyStateMachine = StaticStateMachine<EyeMonsterController, States, const mono::UpdateContext&>;
         MyStateMachine m_states;
         HomingBehaviour m_homing_movement;
         TrackingBehaviour m_tracking_movement;
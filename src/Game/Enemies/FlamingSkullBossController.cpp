@@ -58,20 +58,21 @@ FlamingSkullBossController::FlamingSkullBossController(uint32_t entity_id, mono:
     m_homing_movement.SetForwardVelocity(tweak_values::velocity);
     m_homing_movement.SetAngularVelocity(tweak_values::degrees_per_second);
 
-    m_tracking_movement.Init(body, m_navigation_system);
+    m_tracking_movement.Init(entity_id, body, m_navigation_system);
     m_tracking_movement.SetTrackingSpeed(tweak_values::velocity);
 
     m_stagger_behaviour.SetChanceAndDuration(0.1f, 1.0f);
 
     using namespace std::placeholders;
 
-    const MyStateMachine::StateTable& state_table = {
-        MyStateMachine::MakeState(States::SLEEPING, &FlamingSkullBossController::ToSleep, &FlamingSkullBossController::SleepState, this),
-        MyStateMachine::MakeState(States::AWAKE,    &FlamingSkullBossController::ToAwake, &FlamingSkullBossController::AwakeState, this),
-        MyStateMachine::MakeState(States::TRACKING, &FlamingSkullBossController::ToTracking, &FlamingSkullBossController::TrackingState, this),
-        MyStateMachine::MakeState(States::HUNT,     &FlamingSkullBossController::ToHunt,  &FlamingSkullBossController::HuntState, this),
+    static constexpr MyStateMachine::State state_table[] = {
+        MyStateMachine::MakeState(States::SLEEPING, &FlamingSkullBossController::ToSleep, &FlamingSkullBossController::SleepState),
+        MyStateMachine::MakeState(States::AWAKE,    &FlamingSkullBossController::ToAwake, &FlamingSkullBossController::AwakeState),
+        MyStateMachine::MakeState(States::TRACKING, &FlamingSkullBossController::ToTracking, &FlamingSkullBossController::TrackingState),
+        MyStateMachine::MakeState(States::HUNT,     &FlamingSkullBossController::ToHunt,  &FlamingSkullBossController::HuntState),
     };
-    m_states.SetStateTableAndState(state_table, States::SLEEPING);
+    static_assert(MyStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::SLEEPING);
 }
 
 FlamingSkullBossController::~FlamingSkullBossController()
@@ -188,13 +189,14 @@ void FlamingSkullBossController::TrackingState(const mono::UpdateContext& update
         return;
     }
 
-    const TrackingResult result = m_tracking_movement.Run(update_context, m_aquired_target->Position());
+    const TrackingResult result = m_tracking_movement.RunTowardsTarget(update_context, m_aquired_target->TargetId(), m_aquired_target->Position());
     switch(result.state)
     {
     case TrackingState::NO_PATH:
         m_states.TransitionTo(States::SLEEPING);
         break;
  
+    case TrackingState::PATH_PENDING:
     case TrackingState::TRACKING:
         if(result.distance_to_target < (tweak_values::trigger_distance - 1.0f))
             m_states.TransitionTo(States::HUNT);
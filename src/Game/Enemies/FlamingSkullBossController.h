@@ -58,7 +58,7 @@ namespace game
         float m_awake_state_timer_s;
         float m_visibility_check_timer_s;
 
-        using MyStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using MyStateMachine = StaticStateMachine<FlamingSkullBossController, States, const mono::UpdateContext&>;
         MyStateMachine m_states;
         HomingBehaviour m_homing_movement;
         TrackingBehaviour m_tracking_movement;
@@ -52,7 +52,7 @@ FlyingMonsterController::FlyingMonsterController(uint32_t entity_id, mono::Syste
 
     mono::PhysicsSystem* physics_system = system_context->GetSystem<mono::PhysicsSystem>();
     mono::IBody* entity_body = physics_system->GetBody(entity_id);
-    m_tracking_movement.Init(entity_body, navigation_system);
+    m_tracking_movement.Init(entity_id, entity_body, navigation_system);
 
     m_homing_movement.SetBody(entity_body);
     m_homing_movement.SetForwardVelocity(tweak_values::move_speed);
@@ -60,14 +60,15 @@ FlyingMonsterController::FlyingMonsterController(uint32_t entity_id, mono::Syste
 
     m_target_system = system_context->GetSystem<TargetSystem>();
 
-    const FlyingMonsterStateMachine::StateTable& state_table = {
-        FlyingMonsterStateMachine::MakeState(States::IDLE, &FlyingMonsterController::ToIdle, &FlyingMonsterController::Idle, this),
-        FlyingMonsterStateMachine::MakeState(States::TRACKING, &FlyingMonsterController::ToTracking, &FlyingMonsterController::Tracking, this),
-        FlyingMonsterStateMachine::MakeState(States::REPOSITION, &FlyingMonsterController::ToReposition, &FlyingMonsterController::Reposition, this),
-        FlyingMonsterStateMachine::MakeState(States::ATTACK_ANTICIPATION, &FlyingMonsterController::ToAttackAnticipation, &FlyingMonsterController::AttackAnticipation, this),
-        FlyingMonsterStateMachine::MakeState(States::ATTACKING, &FlyingMonsterController::ToAttacking, &FlyingMonsterController::Attacking, this),
+    static constexpr FlyingMonsterStateMachine::State state_table[] = {
+        FlyingMonsterStateMachine::MakeState(States::IDLE, &FlyingMonsterController::ToIdle, &FlyingMonsterController::Idle),
+        FlyingMonsterStateMachine::MakeState(States::TRACKING, &FlyingMonsterController::ToTracking, &FlyingMonsterController::Tracking),
+        FlyingMonsterStateMachine::MakeState(States::REPOSITION, &FlyingMonsterController::ToReposition, &FlyingMonsterController::Reposition),
+        FlyingMonsterStateMachine::MakeState(States::ATTACK_ANTICIPATION, &FlyingMonsterController::ToAttackAnticipation, &FlyingMonsterController::AttackAnticipation),
+        FlyingMonsterStateMachine::MakeState(States::ATTACKING, &FlyingMonsterController::ToAttacking, &FlyingMonsterController::Attacking),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(FlyingMonsterStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 FlyingMonsterController::~FlyingMonsterController()
@@ -216,7 +217,7 @@ void FlyingMonsterController::Tracking(const mono::UpdateContext& update_context
         }
     }
 
-    const TrackingResult result = m_tracking_movement.Run(update_context, target_world_position);
+    const TrackingResult result = m_tracking_movement.RunTowardsTarget(update_context, m_aquired_target->TargetId(), target_world_position);
     if(result.state == TrackingState::NO_PATH || result.state == TrackingState::AT_TARGET)
         m_states.TransitionTo(States::IDLE);
 }
@@ -65,7 +65,7 @@ namespace game
         float m_idle_timer_s;
         float m_attack_anticipation_timer_s;
         
-        using FlyingMonsterStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using FlyingMonsterStateMachine = StaticStateMachine<FlyingMonsterController, States, const mono::UpdateContext&>;
         FlyingMonsterStateMachine m_states;
 
         int m_bullets_fired;
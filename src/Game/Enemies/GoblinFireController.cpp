@@ -49,7 +49,7 @@ GoblinFireController::GoblinFireController(uint32_t entity_id, mono::SystemConte
     m_homing_movement.SetForwardVelocity(tweak_values::move_speed);
     m_homing_movement.SetAngularVelocity(tweak_values::degrees_per_second);
 
-    m_tracking_movement.Init(body, m_navigation_system);
+    m_tracking_movement.Init(entity_id, body, m_navigation_system);
     m_tracking_movement.SetTrackingSpeed(tweak_values::move_speed);
 
     mono::SpriteSystem* sprite_system = system_context->GetSystem<mono::SpriteSystem>();
@@ -61,15 +61,16 @@ GoblinFireController::GoblinFireController(uint32_t entity_id, mono::SystemConte
     game::WeaponSystem* weapon_system = system_context->GetSystem<game::WeaponSystem>();
     m_weapon = weapon_system->CreatePrimaryWeapon(entity_id, WeaponFaction::ENEMY);
 
-    const GoblinStateMachine::StateTable state_table = {
-        GoblinStateMachine::MakeState(States::IDLE, &GoblinFireController::ToIdle, &GoblinFireController::Idle, this),
-        GoblinStateMachine::MakeState(States::TRACKING, &GoblinFireController::ToTracking, &GoblinFireController::Tracking, this),
-        GoblinStateMachine::MakeState(States::REPOSITION, &GoblinFireController::ToReposition, &GoblinFireController::Reposition, this),
-        GoblinStateMachine::MakeState(States::PREPARE_ATTACK, &GoblinFireController::ToPrepareAttack, &GoblinFireController::PrepareAttack, this),
-        GoblinStateMachine::MakeState(States::ATTACKING, &GoblinFireController::ToAttacking, &GoblinFireController::Attacking, this),
+    static constexpr GoblinStateMachine::State state_table[] = {
+        GoblinStateMachine::MakeState(States::IDLE, &GoblinFireController::ToIdle, &GoblinFireController::Idle),
+        GoblinStateMachine::MakeState(States::REPOSITION, &GoblinFireController::ToReposition, &GoblinFireController::Reposition),
+        GoblinStateMachine::MakeState(States::TRACKING, &GoblinFireController::ToTracking, &GoblinFireController::Tracking),
+        GoblinStateMachine::MakeState(States::PREPARE_ATTACK, &GoblinFireController::ToPrepareAttack, &GoblinFireController::PrepareAttack),
+        GoblinStateMachine::MakeState(States::ATTACKING, &GoblinFireController::ToAttacking, &GoblinFireController::Attacking),
     };
 
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(GoblinStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 void GoblinFireController::Update(const mono::UpdateContext& update_context)
@@ -176,13 +177,14 @@ void GoblinFireController::Tracking(const mono::UpdateContext& update_context)
         return;
     }
 
-    const TrackingResult result = m_tracking_movement.Run(update_context, m_aquired_target->Position());
+    const TrackingResult result = m_tracking_movement.RunTowardsTarget(update_context, m_aquired_target->TargetId(), m_aquired_target->Position());
     switch(result.state)
     {
     case TrackingState::NO_PATH:
         m_states.TransitionTo(States::IDLE);
         break;
  
+    case TrackingState::PATH_PENDING:
     case TrackingState::TRACKING:
         if(result.distance_to_target < (tweak_values::activate_distance_to_player_threshold - 1.0f))
             m_states.TransitionTo(States::REPOSITION);
@@ -59,7 +59,7 @@ namespace game
         int m_idle_anim_id;
         int m_run_anim_id;
 
-        using GoblinStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using GoblinStateMachine = StaticStateMachine<GoblinFireController, States, const mono::UpdateContext&>;
         GoblinStateMachine m_states;
 
         float m_idle_timer_s;
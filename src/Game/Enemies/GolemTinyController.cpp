@@ -66,7 +66,7 @@ GolemTinyController::GolemTinyController(uint32_t entity_id, mono::SystemContext
     mono::IBody* body = m_physics_system->GetBody(entity_id);
     body->AddCollisionHandler(this);
     
-    m_tracking_movement.Init(body, m_navigation_system);
+    m_tracking_movement.Init(entity_id, body, m_navigation_system);
     m_tracking_movement.SetTrackingSpeed(tweak_values::velocity_m_per_s);
 
     m_path_behaviour.Init(body);
@@ -74,14 +74,15 @@ GolemTinyController::GolemTinyController(uint32_t entity_id, mono::SystemContext
 
     using namespace std::placeholders;
 
-    const MyStateMachine::StateTable& state_table = {
-        MyStateMachine::MakeState(States::IDLE,         &GolemTinyController::ToIdle,       &GolemTinyController::IdleState, this),
-        MyStateMachine::MakeState(States::WANDER,       &GolemTinyController::ToWander,     &GolemTinyController::TrackingState, this),
-        MyStateMachine::MakeState(States::TRACKING,     &GolemTinyController::ToTracking,   &GolemTinyController::TrackingState, &GolemTinyController::ExitTracking, this),
-        MyStateMachine::MakeState(States::STOMP_ATTACK, &GolemTinyController::ToStompAttack,&GolemTinyController::StompAttackState, &GolemTinyController::ExitAttack, this),
-        MyStateMachine::MakeState(States::ROLL_ATTACK,  &GolemTinyController::ToRollAttack, &GolemTinyController::RollAttackState, &GolemTinyController::ExitAttack, this),
+    static constexpr MyStateMachine::State state_table[] = {
+        MyStateMachine::MakeState(States::IDLE,         &GolemTinyController::ToIdle,       &GolemTinyController::IdleState),
+        MyStateMachine::MakeState(States::WANDER,       &GolemTinyController::ToWander,     &GolemTinyController::TrackingState),
+        MyStateMachine::MakeState(States::TRACKING,     &GolemTinyController::ToTracking,   &GolemTinyController::TrackingState, &GolemTinyController::ExitTracking),
+        MyStateMachine::MakeState(States::STOMP_ATTACK, &GolemTinyController::ToStompAttack,&GolemTinyController::StompAttackState, &GolemTinyController::ExitAttack),
+        MyStateMachine::MakeState(States::ROLL_ATTACK,  &GolemTinyController::ToRollAttack, &GolemTinyController::RollAttackState, &GolemTinyController::ExitAttack),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(MyStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 GolemTinyController::~GolemTinyController()
@@ -246,6 +247,7 @@ void GolemTinyController::TrackingState(const mono::UpdateContext& update_contex
         m_states.TransitionTo(States::IDLE);
         break;
  
+    case TrackingState::PATH_PENDING:
     case TrackingState::TRACKING:
         break;
 
@@ -76,7 +76,7 @@ namespace game
 
         bool m_perform_roll_attack = false;
 
-        using MyStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using MyStateMachine = StaticStateMachine<GolemTinyController, States, const mono::UpdateContext&>;
         MyStateMachine m_states;
 
         TrackingBehaviour m_tracking_movement;
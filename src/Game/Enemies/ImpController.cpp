@@ -50,7 +50,7 @@ ImpController::ImpController(uint32_t entity_id, mono::SystemContext* system_con
     m_homing_movement.SetForwardVelocity(tweak_values::move_speed);
     m_homing_movement.SetAngularVelocity(tweak_values::degrees_per_second);
 
-    m_tracking_movement.Init(body, m_navigation_system);
+    m_tracking_movement.Init(entity_id, body, m_navigation_system);
     m_tracking_movement.SetTrackingSpeed(tweak_values::move_speed);
 
     m_sprite = m_sprite_system->GetSprite(entity_id);
@@ -60,14 +60,15 @@ ImpController::ImpController(uint32_t entity_id, mono::SystemContext* system_con
     m_attack_anim_id = m_sprite->GetAnimationIdFromName("attack");
 
 
-    const GoblinStateMachine::StateTable state_table = {
-        GoblinStateMachine::MakeState(States::IDLE, &ImpController::ToIdle, &ImpController::Idle, this),
-        GoblinStateMachine::MakeState(States::TRACKING, &ImpController::ToTracking, &ImpController::Tracking, this),
-        GoblinStateMachine::MakeState(States::REPOSITION, &ImpController::ToReposition, &ImpController::Reposition, this),
-        GoblinStateMachine::MakeState(States::PREPARE_ATTACK, &ImpController::ToPrepareAttack, &ImpController::PrepareAttack, this),
-        GoblinStateMachine::MakeState(States::ATTACKING, &ImpController::ToAttacking, &ImpController::Attacking, this),
+    static constexpr GoblinStateMachine::State state_table[] = {
+        GoblinStateMachine::MakeState(States::IDLE, &ImpController::ToIdle, &ImpController::Idle),
+        GoblinStateMachine::MakeState(States::TRACKING, &ImpController::ToTracking, &ImpController::Tracking),
+        GoblinStateMachine::MakeState(States::REPOSITION, &ImpController::ToReposition, &ImpController::Reposition),
+        GoblinStateMachine::MakeState(States::PREPARE_ATTACK, &ImpController::ToPrepareAttack, &ImpController::PrepareAttack),
+        GoblinStateMachine::MakeState(States::ATTACKING, &ImpController::ToAttacking, &ImpController::Attacking),
     };
-    m_states.SetStateTableAndState(state_table, States::IDLE);
+    static_assert(GoblinStateMachine::IsStateTableOrdered(state_table));
+    m_states.SetStateTableAndState(this, state_table, States::IDLE);
 }
 
 ImpController::~ImpController()
@@ -169,13 +170,14 @@ void ImpController::Tracking(const mono::UpdateContext& update_context)
         return;
     }
 
-    const TrackingResult result = m_tracking_movement.Run(update_context, m_aquired_target->Position());
+    const TrackingResult result = m_tracking_movement.RunTowardsTarget(update_context, m_aquired_target->TargetId(), m_aquired_target->Position());
     switch(result.state)
     {
     case TrackingState::NO_PATH:
         m_states.TransitionTo(States::IDLE);
         break;
  
+    case TrackingState::PATH_PENDING:
     case TrackingState::TRACKING:
         if(result.distance_to_target < (tweak_values::activate_distance_to_player_threshold - 1.0f))
             m_states.TransitionTo(States::REPOSITION);
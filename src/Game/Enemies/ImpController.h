@@ -65,7 +65,7 @@ namespace game
         int m_run_anim_id;
         int m_attack_anim_id;
 
-        using GoblinStateMachine = StateMachine<States, const mono::UpdateContext&>;
+        using GoblinStateMachine = StaticStateMachine<ImpController, States, const mono::UpdateContext&>;
         GoblinStateMachine m_states;
 
         float m_idle_timer_s;
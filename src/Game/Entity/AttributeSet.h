@@ -0,0 +1,119 @@
+
+#pragma once
+
+#include "Component.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Index of a vector<Attribute> sorted on id, built once for code that looks up many attributes in the same
+// vector. The ids are searched in a small inline array instead of stepping over the variants, the attributes
+// themselves stay in the vector so the entity manager and the json serialization are unchanged.
+class AttributeSet
+{
+public:
+
+    explicit AttributeSet(const std::vector<Attribute>& attributes)
+        : m_attributes(attributes)
+        , m_n_entries(0)
+    {
+        for(uint32_t index = 0; index < attributes.size(); ++index)
+            Add(attributes[index].id, index);
+    }
+
+    int IndexOf(uint32_t id) const
+    {
+        const Entry* begin = Entries();
+        const Entry* end = begin + m_n_entries;
+        const Entry* it = std::lower_bound(begin, end, id, [](const Entry& entry, uint32_t id) {
+            return entry.id < id;
+        });
+
+        return (it != end && it->id == id) ? int(it->index) : -1;
+    }
+
+    const Attribute* Find(uint32_t id) const
+    {
+        const int index = IndexOf(id);
+        return (index != -1) ? &m_attributes[index] : nullptr;
+    }
+
+    // For attributes pushed to the vector after the set was made. Like a linear search the first
+    // attribute with an id wins, so duplicates are ignored.
+    void Add(uint32_t id, uint32_t index)
+    {
+        if(m_n_entries == max_inline_entries && m_overflow.empty())
+            m_overflow.assign(m_inline, m_inline + m_n_entries);
+
+        Entry* begin = Entries();
+        Entry* end = begin + m_n_entries;
+        Entry* it = std::lower_bound(begin, end, id, [](const Entry& entry, uint32_t id) {
+            return entry.id < id;
+        });
+
+        if(it != end && it->id == id)
+            return;
+
+        if(m_overflow.empty())
+        {
+            std::move_backward(it, end, end + 1);
+            *it = { id, index };
+        }
+        else
+        {
+            m_overflow.insert(m_overflow.begin() + (it - begin), { id, index });
+        }
+
+        m_n_entries++;
+    }
+
+private:
+
+    struct Entry
+    {
+        uint32_t id;
+        uint32_t index;
+    };
+
+    static constexpr uint32_t max_inline_entries = 16;
+
+    const Entry* Entries() const
+    {
+        return m_overflow.empty() ? m_inline : m_overflow.data();
+    }
+
+    Entry* Entries()
+    {
+        return m_overflow.empty() ? m_inline : m_overflow.data();
+    }
+
+    const std::vector<Attribute>& m_attributes;
+    uint32_t m_n_entries;
+    Entry m_inline[max_inline_entries];
+    std::vector<Entry> m_overflow;
+};
+
+inline bool FindAttribute(uint32_t id, const AttributeSet& attributes, const Attribute*& output)
+{
+    output = attributes.Find(id);
+    return (output != nullptr);
+}
+
+template <typename T>
+inline bool FindAttribute(uint32_t id, const AttributeSet& attributes, T& value, FallbackMode fallback_mode)
+{
+    const Attribute* attribute = attributes.Find(id);
+    const bool found_attribute = (attribute != nullptr);
+    if(found_attribute && std::holds_alternative<T>(attribute->value))
+    {
+        value = std::get<T>(attribute->value);
+    }
+    else if(fallback_mode == FallbackMode::SET_DEFAULT)
+    {
+        value = std::get<T>(DefaultAttributeFromHash(id));
+        return true;
+    }
+
+    return found_attribute;
+}
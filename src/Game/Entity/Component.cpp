@@ -1,5 +1,6 @@
 
 #include "Component.h"
+#include "AttributeSet.h"
 #include "System/Hash.h"
 #include "System/System.h"
 #include "System/Debug.h"
@@ -562,6 +563,32 @@ const Component default_components[] = {
     MakeComponent(BEHAVIOUR_COMPONENT,          NULL_COMPONENT,             false,  "logic",        { ENTITY_BEHAVIOUR_ATTRIBUTE }),
 };
 
+namespace
+{
+    struct DefaultAttributeIndex
+    {
+        uint32_t hash;
+        uint32_t index;
+    };
+
+    // Default values are looked up for every attribute missing in a component, keep the hashes sorted.
+    const std::vector<DefaultAttributeIndex>& SortedDefaultAttributes()
+    {
+        static const std::vector<DefaultAttributeIndex> sorted_attributes = [] {
+            std::vector<DefaultAttributeIndex> attributes;
+            for(uint32_t index = 0; index < std::size(default_attributes); ++index)
+                attributes.push_back({ default_attributes[index].hash, index });
+
+            std::stable_sort(attributes.begin(), attributes.end(), [](const DefaultAttributeIndex& first, const DefaultAttributeIndex& second) {
+                return first.hash < second.hash;
+            });
+            return attributes;
+        }();
+
+        return sorted_attributes;
+    }
+}
+
 const char* AttributeNameFromHash(uint32_t hash)
 {
     for(const DefaultAttribute& hash_string : default_attributes)
@@ -587,11 +614,14 @@ const char* AttributeTooltipFromHash(uint32_t hash)
 
 const Variant& DefaultAttributeFromHash(uint32_t hash)
 {
-    for(const DefaultAttribute& hash_string : default_attributes)
-    {
-        if(hash_string.hash == hash)
-            return hash_string.default_value;
-    }
+    const std::vector<DefaultAttributeIndex>& sorted_attributes = SortedDefaultAttributes();
+    const auto it = std::lower_bound(
+        sorted_attributes.begin(), sorted_attributes.end(), hash, [](const DefaultAttributeIndex& entry, uint32_t hash) {
+            return entry.hash < hash;
+        });
+
+    if(it != sorted_attributes.end() && it->hash == hash)
+        return default_attributes[it->index].default_value;
 
     const char* attribute_name = AttributeNameFromHash(hash);
     System::Log("Component|Unable to find default attribute for hash: %u (%s)", hash, attribute_name);
@@ -620,24 +650,35 @@ bool FindAttribute(uint32_t id, const std::vector<Attribute>& attributes, const
 
 void MergeAttributes(std::vector<Attribute>& result_attributes, const std::vector<Attribute>& other_attributes)
 {
+    AttributeSet result_set(result_attributes);
+
     for(const Attribute& input : other_attributes)
     {
-        Attribute* attribute = nullptr;
-        if(FindAttribute(input.id, result_attributes, attribute))
-            attribute->value = input.value;
+        const int index = result_set.IndexOf(input.id);
+        if(index != -1)
+        {
+            result_attributes[index].value = input.value;
+        }
         else
+        {
+            result_set.Add(input.id, result_attributes.size());
             result_attributes.push_back(input);
+        }
     }
 }
 
 void UnionAttributes(std::vector<Attribute>& result_attributes, const std::vector<Attribute>& other_attributes)
 {
+    AttributeSet result_set(result_attributes);
+
     for(const Attribute& input : other_attributes)
     {
-        Attribute* attribute = nullptr;
-        const bool found = FindAttribute(input.id, result_attributes, attribute);
-        if(!found)
+        const int index = result_set.IndexOf(input.id);
+        if(index == -1)
+        {
+            result_set.Add(input.id, result_attributes.size());
             result_attributes.push_back(input);
+        }
     }
 }
 
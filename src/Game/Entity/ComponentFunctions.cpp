@@ -21,6 +21,7 @@
 #include "EntitySystem/IEntityManager.h"
 
 #include "Component.h"
+#include "AttributeSet.h"
 
 namespace
 {
@@ -39,15 +40,17 @@ namespace
 
     bool UpdateTransform(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         math::Vector position;
         float rotation = 0.0f;
         float scale = 1.0f;
-        FindAttribute(POSITION_ATTRIBUTE, properties, position, FallbackMode::SET_DEFAULT);
-        FindAttribute(ROTATION_ATTRIBUTE, properties, rotation, FallbackMode::SET_DEFAULT);
-        FindAttribute(SCALE_ATTRIBUTE, properties, scale, FallbackMode::SET_DEFAULT);
+        FindAttribute(POSITION_ATTRIBUTE, attribute_set, position, FallbackMode::SET_DEFAULT);
+        FindAttribute(ROTATION_ATTRIBUTE, attribute_set, rotation, FallbackMode::SET_DEFAULT);
+        FindAttribute(SCALE_ATTRIBUTE, attribute_set, scale, FallbackMode::SET_DEFAULT);
 
         uint32_t entity_ref = 0;
-        FindAttribute(ENTITY_REFERENCE_ATTRIBUTE, properties, entity_ref, FallbackMode::SET_DEFAULT);
+        FindAttribute(ENTITY_REFERENCE_ATTRIBUTE, attribute_set, entity_ref, FallbackMode::SET_DEFAULT);
 
         mono::TransformSystem* transform_system = context->GetSystem<mono::TransformSystem>();
         math::Matrix& transform = transform_system->GetTransform(entity->id);
@@ -140,24 +143,26 @@ namespace
 
     bool UpdateSprite(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string sprite_file;
         mono::SpriteComponents sprite_args;
 
-        const bool success = FindAttribute(SPRITE_ATTRIBUTE, properties, sprite_file, FallbackMode::REQUIRE_ATTRIBUTE);
+        const bool success = FindAttribute(SPRITE_ATTRIBUTE, attribute_set, sprite_file, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!success)
         {
             System::Log("ComponentFunctions|Missing sprite parameters, unable to update component");
             return false;
         }
         
-        FindAttribute(COLOR_ATTRIBUTE, properties, sprite_args.shade, FallbackMode::SET_DEFAULT);
-        FindAttribute(ANIMATION_ATTRIBUTE, properties, sprite_args.animation_id, FallbackMode::SET_DEFAULT);
-        FindAttribute(SPRITE_PROPERTIES_ATTRIBUTE, properties, sprite_args.properties, FallbackMode::SET_DEFAULT);
-        FindAttribute(SHADOW_OFFSET_ATTRIBUTE, properties, sprite_args.shadow_offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(SHADOW_SIZE_ATTRIBUTE, properties, sprite_args.shadow_size, FallbackMode::SET_DEFAULT);
-        FindAttribute(LAYER_ATTRIBUTE, properties, sprite_args.layer, FallbackMode::SET_DEFAULT);
-        FindAttribute(SORT_OFFSET_ATTRIBUTE, properties, sprite_args.sort_offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(RANDOM_START_FRAME_ATTRIBUTE, properties, sprite_args.random_start_frame, FallbackMode::SET_DEFAULT);
+        FindAttribute(COLOR_ATTRIBUTE, attribute_set, sprite_args.shade, FallbackMode::SET_DEFAULT);
+        FindAttribute(ANIMATION_ATTRIBUTE, attribute_set, sprite_args.animation_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(SPRITE_PROPERTIES_ATTRIBUTE, attribute_set, sprite_args.properties, FallbackMode::SET_DEFAULT);
+        FindAttribute(SHADOW_OFFSET_ATTRIBUTE, attribute_set, sprite_args.shadow_offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(SHADOW_SIZE_ATTRIBUTE, attribute_set, sprite_args.shadow_size, FallbackMode::SET_DEFAULT);
+        FindAttribute(LAYER_ATTRIBUTE, attribute_set, sprite_args.layer, FallbackMode::SET_DEFAULT);
+        FindAttribute(SORT_OFFSET_ATTRIBUTE, attribute_set, sprite_args.sort_offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(RANDOM_START_FRAME_ATTRIBUTE, attribute_set, sprite_args.random_start_frame, FallbackMode::SET_DEFAULT);
 
         char sprite_path[1024] = { 0 };
         std::snprintf(sprite_path, std::size(sprite_path), "res/sprites/%s", sprite_file.c_str());
@@ -191,16 +196,18 @@ namespace
 
     bool UpdateText(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::TextComponent text_component;
 
-        FindAttribute(TEXT_ATTRIBUTE, properties, text_component.text, FallbackMode::SET_DEFAULT);
-        FindAttribute(FONT_ID_ATTRIBUTE, properties, text_component.font_id, FallbackMode::SET_DEFAULT);
-        FindAttribute(COLOR_ATTRIBUTE, properties, text_component.tint, FallbackMode::SET_DEFAULT);
-        FindAttribute(CENTER_FLAGS_ATTRIBUTE, properties, (uint32_t&)text_component.center_flags, FallbackMode::SET_DEFAULT);
+        FindAttribute(TEXT_ATTRIBUTE, attribute_set, text_component.text, FallbackMode::SET_DEFAULT);
+        FindAttribute(FONT_ID_ATTRIBUTE, attribute_set, text_component.font_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(COLOR_ATTRIBUTE, attribute_set, text_component.tint, FallbackMode::SET_DEFAULT);
+        FindAttribute(CENTER_FLAGS_ATTRIBUTE, attribute_set, (uint32_t&)text_component.center_flags, FallbackMode::SET_DEFAULT);
 
-        FindAttribute(TEXT_SHADOW_ATTRIBUTE, properties, text_component.draw_shadow, FallbackMode::SET_DEFAULT);
-        FindAttribute(OFFSET_ATTRIBUTE, properties, text_component.shadow_offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(SHADOW_COLOR_ATTRIBUTE, properties, text_component.shadow_color, FallbackMode::SET_DEFAULT);
+        FindAttribute(TEXT_SHADOW_ATTRIBUTE, attribute_set, text_component.draw_shadow, FallbackMode::SET_DEFAULT);
+        FindAttribute(OFFSET_ATTRIBUTE, attribute_set, text_component.shadow_offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(SHADOW_COLOR_ATTRIBUTE, attribute_set, text_component.shadow_color, FallbackMode::SET_DEFAULT);
 
         mono::TextSystem* text_system = context->GetSystem<mono::TextSystem>();
         text_system->SetTextData(entity->id, text_component);
@@ -224,14 +231,16 @@ namespace
 
     bool UpdatePath(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int path_type;
-        FindAttribute(PATH_TYPE_ATTRIBUTE, properties, path_type, FallbackMode::SET_DEFAULT);
+        FindAttribute(PATH_TYPE_ATTRIBUTE, attribute_set, path_type, FallbackMode::SET_DEFAULT);
 
         mono::PathComponent component;
         component.type = mono::PathType(path_type);
 
-        FindAttribute(PATH_POINTS_ATTRIBUTE, properties, component.points, FallbackMode::REQUIRE_ATTRIBUTE);
-        FindAttribute(PATH_CLOSED_ATTRIBUTE, properties, component.closed, FallbackMode::SET_DEFAULT);
+        FindAttribute(PATH_POINTS_ATTRIBUTE, attribute_set, component.points, FallbackMode::REQUIRE_ATTRIBUTE);
+        FindAttribute(PATH_CLOSED_ATTRIBUTE, attribute_set, component.closed, FallbackMode::SET_DEFAULT);
 
         mono::PathSystem* path_system = context->GetSystem<mono::PathSystem>();
         path_system->SetPathData(entity->id, component);
@@ -255,10 +264,12 @@ namespace
 
     bool UpdateRoad(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::RoadComponent component;
-        FindAttribute(WIDTH_ATTRIBUTE, properties, component.width, FallbackMode::SET_DEFAULT);
-        FindAttribute(COLOR_ATTRIBUTE, properties, component.color, FallbackMode::SET_DEFAULT);
-        FindAttribute(TEXTURE_ATTRIBUTE, properties, component.texture_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(WIDTH_ATTRIBUTE, attribute_set, component.width, FallbackMode::SET_DEFAULT);
+        FindAttribute(COLOR_ATTRIBUTE, attribute_set, component.color, FallbackMode::SET_DEFAULT);
+        FindAttribute(TEXTURE_ATTRIBUTE, attribute_set, component.texture_name, FallbackMode::SET_DEFAULT);
 
         mono::RoadSystem* road_system = context->GetSystem<mono::RoadSystem>();
         road_system->SetData(entity->id, component);
@@ -282,13 +293,15 @@ namespace
 
     bool UpdateLight(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::LightComponent component;
-        FindAttribute(RADIUS_ATTRIBUTE, properties, component.radius, FallbackMode::SET_DEFAULT);
-        FindAttribute(OFFSET_ATTRIBUTE, properties, component.offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(COLOR_ATTRIBUTE, properties, component.shade, FallbackMode::SET_DEFAULT);
-        FindAttribute(FLICKER_ATTRIBUTE, properties, component.flicker, FallbackMode::SET_DEFAULT);
-        FindAttribute(FREQUENCY_ATTRIBUTE, properties, component.flicker_frequencey, FallbackMode::SET_DEFAULT);
-        FindAttribute(PERCENTAGE_ATTRIBUTE, properties, component.flicker_percentage, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, component.radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(OFFSET_ATTRIBUTE, attribute_set, component.offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(COLOR_ATTRIBUTE, attribute_set, component.shade, FallbackMode::SET_DEFAULT);
+        FindAttribute(FLICKER_ATTRIBUTE, attribute_set, component.flicker, FallbackMode::SET_DEFAULT);
+        FindAttribute(FREQUENCY_ATTRIBUTE, attribute_set, component.flicker_frequencey, FallbackMode::SET_DEFAULT);
+        FindAttribute(PERCENTAGE_ATTRIBUTE, attribute_set, component.flicker_percentage, FallbackMode::SET_DEFAULT);
 
         mono::LightSystem* light_system = context->GetSystem<mono::LightSystem>();
         light_system->SetData(entity->id, component);
@@ -319,18 +332,20 @@ namespace
 
     bool UpdateParticleSystem(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int pool_size;
         std::string texture_file;
         int blend_mode;
         int draw_layer;
         int transform_space;
         float damping;
-        FindAttribute(POOL_SIZE_ATTRIBUTE, properties, pool_size, FallbackMode::SET_DEFAULT);
-        FindAttribute(TEXTURE_ATTRIBUTE, properties, texture_file, FallbackMode::SET_DEFAULT);
-        FindAttribute(BLEND_MODE_ATTRIBUTE, properties, blend_mode, FallbackMode::SET_DEFAULT);
-        FindAttribute(PARTICLE_DRAW_LAYER, properties, draw_layer, FallbackMode::SET_DEFAULT);
-        FindAttribute(TRANSFORM_SPACE_ATTRIBUTE, properties, transform_space, FallbackMode::SET_DEFAULT);
-        FindAttribute(DAMPING_ATTRIBUTE, properties, damping, FallbackMode::SET_DEFAULT);
+        FindAttribute(POOL_SIZE_ATTRIBUTE, attribute_set, pool_size, FallbackMode::SET_DEFAULT);
+        FindAttribute(TEXTURE_ATTRIBUTE, attribute_set, texture_file, FallbackMode::SET_DEFAULT);
+        FindAttribute(BLEND_MODE_ATTRIBUTE, attribute_set, blend_mode, FallbackMode::SET_DEFAULT);
+        FindAttribute(PARTICLE_DRAW_LAYER, attribute_set, draw_layer, FallbackMode::SET_DEFAULT);
+        FindAttribute(TRANSFORM_SPACE_ATTRIBUTE, attribute_set, transform_space, FallbackMode::SET_DEFAULT);
+        FindAttribute(DAMPING_ATTRIBUTE, attribute_set, damping, FallbackMode::SET_DEFAULT);
 
         mono::ParticleSystem* particle_system = context->GetSystem<mono::ParticleSystem>();
         particle_system->SetPoolData(
@@ -358,25 +373,27 @@ namespace
 
     bool UpdateBoxEmitter(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         float duration;
         float emit_rate;
         int emitter_type;
         mono::ParticleGeneratorProperties generator_properties;
 
-        FindAttribute(DURATION_ATTRIBUTE, properties, duration, FallbackMode::SET_DEFAULT);
-        FindAttribute(EMIT_RATE_ATTRIBUTE, properties, emit_rate, FallbackMode::SET_DEFAULT);
-        FindAttribute(EMITTER_TYPE_ATTRIBUTE, properties, emitter_type, FallbackMode::SET_DEFAULT);
-
-        FindAttribute(OFFSET_ATTRIBUTE, properties, generator_properties.offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(SIZE_ATTRIBUTE, properties, generator_properties.emit_area, FallbackMode::SET_DEFAULT);
-        FindAttribute(GRADIENT4_ATTRIBUTE, properties, generator_properties.color_gradient, FallbackMode::SET_DEFAULT);
-        FindAttribute(DIRECTION_INTERVAL_ATTRIBUTE, properties, generator_properties.direction_degrees_interval, FallbackMode::SET_DEFAULT);
-        FindAttribute(UNIFORM_DIRECTION_ATTRIBUTE, properties, generator_properties.uniform_direction, FallbackMode::SET_DEFAULT);
-        FindAttribute(MAGNITUDE_INTERVAL_ATTRIBUTE, properties, generator_properties.magnitude_interval, FallbackMode::SET_DEFAULT);
-        FindAttribute(ANGLAR_VELOCITY_INTERVAL_ATTRIBUTE, properties, generator_properties.angular_velocity_interval, FallbackMode::SET_DEFAULT);
-        FindAttribute(LIFE_INTERVAL_ATTRIBUTE, properties, generator_properties.life_interval, FallbackMode::SET_DEFAULT);
-        FindAttribute(START_SIZE_SPREAD_ATTRIBUTE, properties, generator_properties.start_size_spread, FallbackMode::SET_DEFAULT);
-        FindAttribute(END_SIZE_SPREAD_ATTRIBUTE, properties, generator_properties.end_size_spread, FallbackMode::SET_DEFAULT);
+        FindAttribute(DURATION_ATTRIBUTE, attribute_set, duration, FallbackMode::SET_DEFAULT);
+        FindAttribute(EMIT_RATE_ATTRIBUTE, attribute_set, emit_rate, FallbackMode::SET_DEFAULT);
+        FindAttribute(EMITTER_TYPE_ATTRIBUTE, attribute_set, emitter_type, FallbackMode::SET_DEFAULT);
+
+        FindAttribute(OFFSET_ATTRIBUTE, attribute_set, generator_properties.offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(SIZE_ATTRIBUTE, attribute_set, generator_properties.emit_area, FallbackMode::SET_DEFAULT);
+        FindAttribute(GRADIENT4_ATTRIBUTE, attribute_set, generator_properties.color_gradient, FallbackMode::SET_DEFAULT);
+        FindAttribute(DIRECTION_INTERVAL_ATTRIBUTE, attribute_set, generator_properties.direction_degrees_interval, FallbackMode::SET_DEFAULT);
+        FindAttribute(UNIFORM_DIRECTION_ATTRIBUTE, attribute_set, generator_properties.uniform_direction, FallbackMode::SET_DEFAULT);
+        FindAttribute(MAGNITUDE_INTERVAL_ATTRIBUTE, attribute_set, generator_properties.magnitude_interval, FallbackMode::SET_DEFAULT);
+        FindAttribute(ANGLAR_VELOCITY_INTERVAL_ATTRIBUTE, attribute_set, generator_properties.angular_velocity_interval, FallbackMode::SET_DEFAULT);
+        FindAttribute(LIFE_INTERVAL_ATTRIBUTE, attribute_set, generator_properties.life_interval, FallbackMode::SET_DEFAULT);
+        FindAttribute(START_SIZE_SPREAD_ATTRIBUTE, attribute_set, generator_properties.start_size_spread, FallbackMode::SET_DEFAULT);
+        FindAttribute(END_SIZE_SPREAD_ATTRIBUTE, attribute_set, generator_properties.end_size_spread, FallbackMode::SET_DEFAULT);
 
         mono::ParticleSystem* particle_system = context->GetSystem<mono::ParticleSystem>();
         const std::vector<mono::ParticleEmitterComponent*>& attached_emitters = particle_system->GetAttachedEmitters(entity->id);
@@ -420,15 +437,17 @@ namespace
     
     bool UpdateTexturedPolygon(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string texture_file;
         mono::Color::RGBA color;
         int draw_layer;
         std::vector<math::Vector> vertices;
 
-        FindAttribute(TEXTURE_ATTRIBUTE, properties, texture_file, FallbackMode::SET_DEFAULT);
-        FindAttribute(COLOR_ATTRIBUTE, properties, color, FallbackMode::SET_DEFAULT);
-        FindAttribute(POLYGON_DRAW_LAYER_ATTRIBUTE, properties, draw_layer, FallbackMode::SET_DEFAULT);
-        FindAttribute(POLYGON_ATTRIBUTE, properties, vertices, FallbackMode::SET_DEFAULT);
+        FindAttribute(TEXTURE_ATTRIBUTE, attribute_set, texture_file, FallbackMode::SET_DEFAULT);
+        FindAttribute(COLOR_ATTRIBUTE, attribute_set, color, FallbackMode::SET_DEFAULT);
+        FindAttribute(POLYGON_DRAW_LAYER_ATTRIBUTE, attribute_set, draw_layer, FallbackMode::SET_DEFAULT);
+        FindAttribute(POLYGON_ATTRIBUTE, attribute_set, vertices, FallbackMode::SET_DEFAULT);
 
         game::WorldBoundsSystem* world_system = context->GetSystem<game::WorldBoundsSystem>();
         world_system->AddPolygon(entity->id, vertices, texture_file, color, game::PolygonDrawLayer(draw_layer));
@@ -452,22 +471,24 @@ namespace
     
     bool UpdateUIItem(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int ui_group;
         int ui_item_state;
         mono::Event on_click_trigger_name;
 
-        FindAttribute(UI_GROUP_ATTRIBUTE, properties, ui_group, FallbackMode::SET_DEFAULT);
-        FindAttribute(UI_ITEM_STATE_ATTRIBUTE, properties, ui_item_state, FallbackMode::SET_DEFAULT);
-        FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, on_click_trigger_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_GROUP_ATTRIBUTE, attribute_set, ui_group, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_ITEM_STATE_ATTRIBUTE, attribute_set, ui_item_state, FallbackMode::SET_DEFAULT);
+        FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, on_click_trigger_name, FallbackMode::SET_DEFAULT);
 
         game::UINavigationSetup navigation_setup = {
             mono::INVALID_ID, mono::INVALID_ID, mono::INVALID_ID, mono::INVALID_ID
         };
 
-        FindAttribute(UI_LEFT_ITEM_ID_ATTRIBUTE, properties, navigation_setup.left_entity_id, FallbackMode::SET_DEFAULT);
-        FindAttribute(UI_RIGHT_ITEM_ID_ATTRIBUTE, properties, navigation_setup.right_entity_id, FallbackMode::SET_DEFAULT);
-        FindAttribute(UI_ABOVE_ITEM_ID_ATTRIBUTE, properties, navigation_setup.above_entity_id, FallbackMode::SET_DEFAULT);
-        FindAttribute(UI_BELOW_ITEM_ID_ATTRIBUTE, properties, navigation_setup.below_entity_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_LEFT_ITEM_ID_ATTRIBUTE, attribute_set, navigation_setup.left_entity_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_RIGHT_ITEM_ID_ATTRIBUTE, attribute_set, navigation_setup.right_entity_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_ABOVE_ITEM_ID_ATTRIBUTE, attribute_set, navigation_setup.above_entity_id, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_BELOW_ITEM_ID_ATTRIBUTE, attribute_set, navigation_setup.below_entity_id, FallbackMode::SET_DEFAULT);
 
         const mono::IEntityManager* entity_manager = context->GetSystem<mono::IEntityManager>();
         navigation_setup.left_entity_id = entity_manager->GetEntityIdFromUuid(navigation_setup.left_entity_id);
@@ -504,13 +525,15 @@ namespace
     
     bool UpdateUISetGroupState(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int ui_group;
         int ui_item_state;
         mono::Event trigger_name;
 
-        FindAttribute(UI_GROUP_ATTRIBUTE, properties, ui_group, FallbackMode::SET_DEFAULT);
-        FindAttribute(UI_ITEM_STATE_ATTRIBUTE, properties, ui_item_state, FallbackMode::SET_DEFAULT);
-        FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_GROUP_ATTRIBUTE, attribute_set, ui_group, FallbackMode::SET_DEFAULT);
+        FindAttribute(UI_ITEM_STATE_ATTRIBUTE, attribute_set, ui_item_state, FallbackMode::SET_DEFAULT);
+        FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::SET_DEFAULT);
 
         game::UISystem* ui_system = context->GetSystem<game::UISystem>();
         ui_system->UpdateUISetGroupState(entity->id, ui_group, game::UIItemState(ui_item_state), hash::Hash(trigger_name.text.c_str()));
@@ -1,11 +1,15 @@
 
 #include "EntityLogicSystem.h"
 #include "IEntityLogic.h"
+#include "ILogicPool.h"
 #include "System/Hash.h"
 #include "Debug/IDebugDrawer.h"
+#include "RandomStream.h"
 
 #include "EntitySystem/ObjectAttribute.h"
 #include "SystemContext.h"
+#include "TransformSystem/TransformSystem.h"
+#include "Rendering/Sprite/SpriteSystem.h"
 
 #include "Perks/PerkSystem.h"
 #include "Weapons/WeaponSystem.h"
@@ -27,12 +31,22 @@
 #include "Enemies/DemonMinionController.h"
 #include "Enemies/GolemTinyController.h"
 
+#include "Enemies/BatLogicPool.h"
+#include "Enemies/BlobLogicPool.h"
+
 #include "World/ReactivePropLogic.h"
 
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+
 
+namespace tweak_values
+{
+    constexpr uint32_t logics_per_slab_page = 64;
+    constexpr uint32_t min_logics_per_thread = 128;
+}
 
 namespace
 {
@@ -82,13 +96,40 @@ EntityLogicSystem::EntityLogicSystem(
     : m_system_context(system_context)
     , m_event_handler(event_handler)
     , m_logics(n_entities)
-{ }
+    , m_allocation_stats({ })
+    , m_logic_pools(std::size(g_entity_logic_strings))
+    , m_entity_to_pool(n_entities, nullptr)
+    , m_command_buffers(1)
+    , m_command_targets(MakeLogicCommandTargets(system_context))
+    , m_worker_update_context(nullptr)
+    , m_worker_ranges(1)
+    , m_work_frame(0)
+    , m_workers_busy(0)
+    , m_stop_workers(false)
+{
+    if(m_system_context)
+    {
+        mono::TransformSystem* transform_system = m_system_context->GetSystem<mono::TransformSystem>();
+        mono::SpriteSystem* sprite_system = m_system_context->GetSystem<mono::SpriteSystem>();
+
+        const uint32_t random_seed = MakeRandomSeed();
+        SetLogicPool(EntityLogicType::BAT, std::make_unique<BatLogicPool>(n_entities, transform_system, sprite_system, random_seed));
+        SetLogicPool(EntityLogicType::BLOB, std::make_unique<BlobLogicPool>(n_entities, transform_system, sprite_system, random_seed));
+    }
+}
 
 EntityLogicSystem::~EntityLogicSystem()
 {
+    StopWorkers();
 }
 
 void EntityLogicSystem::AddLogic(uint32_t entity_id, IEntityLogic* entity_logic)
+{
+    m_allocation_stats.heap_logics++;
+    AddLogicComponent(entity_id, entity_logic, nullptr, nullptr);
+}
+
+void EntityLogicSystem::AddLogicComponent(uint32_t entity_id, IEntityLogic* entity_logic, SlabAllocator* slab, void* slab_memory)
 {
     const char* debug_category_string = entity_logic->GetDebugCategory();
     const uint32_t debug_category_hash = hash::Hash(debug_category_string);
@@ -96,6 +137,9 @@ void EntityLogicSystem::AddLogic(uint32_t entity_id, IEntityLogic* entity_logic)
     EntityLogicComponent logic_component;
     logic_component.logic = entity_logic;
     logic_component.debug_category = debug_category_hash;
+    logic_component.thread_safe = entity_logic->IsThreadSafe();
+    logic_component.slab = slab;
+    logic_component.slab_memory = slab_memory;
 
     {
         // Debug stuff
@@ -109,6 +153,14 @@ void EntityLogicSystem::AddLogic(uint32_t entity_id, IEntityLogic* entity_logic)
 
 void EntityLogicSystem::ReleaseLogic(uint32_t entity_id)
 {
+    ILogicPool* logic_pool = m_entity_to_pool[entity_id];
+    if(logic_pool)
+    {
+        logic_pool->Remove(entity_id);
+        m_entity_to_pool[entity_id] = nullptr;
+        return;
+    }
+
     EntityLogicComponent* logic_component = m_logics.Get(entity_id);
 
     {
@@ -120,12 +172,198 @@ void EntityLogicSystem::ReleaseLogic(uint32_t entity_id)
             m_hash_to_category.erase(category_hash);
     }
 
-    delete logic_component->logic;
+    if(logic_component->slab)
+    {
+        logic_component->logic->~IEntityLogic();
+        logic_component->slab->Free(logic_component->slab_memory);
+        logic_component->slab = nullptr;
+        logic_component->slab_memory = nullptr;
+    }
+    else
+    {
+        delete logic_component->logic;
+    }
+
     logic_component->logic = nullptr;
 
     m_logics.Release(entity_id);
 }
 
+const LogicAllocationStats& EntityLogicSystem::GetAllocationStats() const
+{
+    return m_allocation_stats;
+}
+
+void EntityLogicSystem::SetUpdateThreads(uint32_t n_threads)
+{
+    StopWorkers();
+
+    n_threads = std::max(n_threads, 1u);
+    m_command_buffers.resize(n_threads);
+
+    for(uint32_t range_index = 1; range_index < n_threads; ++range_index)
+        m_workers.emplace_back(&EntityLogicSystem::WorkerFunc, this, range_index, m_work_frame);
+}
+
+uint32_t EntityLogicSystem::GetUpdateThreads() const
+{
+    return m_workers.size() + 1;
+}
+
+void EntityLogicSystem::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_worker_mutex);
+        m_stop_workers = true;
+    }
+    m_work_signal.notify_all();
+
+    for(std::thread& worker : m_workers)
+        worker.join();
+
+    m_workers.clear();
+    m_stop_workers = false;
+}
+
+void EntityLogicSystem::WorkerFunc(uint32_t range_index, uint32_t work_frame)
+{
+    uint32_t last_work_frame = work_frame;
+
+    while(true)
+    {
+        uint32_t n_ranges = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(m_worker_mutex);
+            m_work_signal.wait(lock, [this, last_work_frame] { return m_stop_workers || m_work_frame != last_work_frame; });
+            if(m_stop_workers)
+                return;
+
+            last_work_frame = m_work_frame;
+            n_ranges = m_worker_ranges;
+        }
+
+        UpdateLogicRange(range_index, n_ranges);
+
+        {
+            std::lock_guard<std::mutex> lock(m_worker_mutex);
+            m_workers_busy--;
+        }
+        m_done_signal.notify_one();
+    }
+}
+
+void EntityLogicSystem::UpdateParallel(const mono::UpdateContext& update_context)
+{
+    constexpr uint32_t main_thread_logic = uint32_t(-1);
+
+    m_update_order.clear();
+    m_thread_safe_logics.clear();
+
+    const auto collect_logic = [this](uint32_t index, EntityLogicComponent& logic_component) {
+        if(logic_component.thread_safe)
+        {
+            m_update_order.push_back({ logic_component.logic, uint32_t(m_thread_safe_logics.size()) });
+            m_thread_safe_logics.push_back(logic_component.logic);
+        }
+        else
+        {
+            m_update_order.push_back({ logic_component.logic, main_thread_logic });
+        }
+    };
+    m_logics.ForEach(collect_logic);
+
+    m_command_ends.resize(m_thread_safe_logics.size());
+    UpdateThreadSafeLogics(update_context);
+
+    // The main thread logics and the commands of the thread safe logics in entity order, like the serial update.
+    for(const OrderedLogic& ordered_logic : m_update_order)
+    {
+        if(ordered_logic.thread_safe_index == main_thread_logic)
+        {
+            ordered_logic.logic->Update(update_context);
+        }
+        else
+        {
+            const CommandEnd& command_end = m_command_ends[ordered_logic.thread_safe_index];
+            m_command_buffers[command_end.buffer_index].ApplyUntil(m_command_targets, command_end.end_index);
+        }
+    }
+
+    for(LogicCommandBuffer& commands : m_command_buffers)
+        commands.Clear();
+}
+
+void EntityLogicSystem::UpdateThreadSafeLogics(const mono::UpdateContext& update_context)
+{
+    // Only split the logics up when there is enough work for each thread.
+    const uint32_t n_logics = m_thread_safe_logics.size();
+    const uint32_t max_ranges = std::max(n_logics / tweak_values::min_logics_per_thread, 1u);
+    const uint32_t n_ranges = std::min(GetUpdateThreads(), max_ranges);
+
+    m_worker_update_context = &update_context;
+
+    if(n_ranges == 1)
+    {
+        UpdateLogicRange(0, 1);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_worker_mutex);
+        m_worker_ranges = n_ranges;
+        m_workers_busy = m_workers.size();
+        m_work_frame++;
+    }
+    m_work_signal.notify_all();
+
+    UpdateLogicRange(0, n_ranges);
+
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_done_signal.wait(lock, [this] { return m_workers_busy == 0; });
+}
+
+void EntityLogicSystem::UpdateLogicRange(uint32_t range_index, uint32_t n_ranges)
+{
+    if(range_index >= n_ranges)
+        return;
+
+    // Contiguous ranges, each buffer holds the commands of its range in logic order.
+    const uint32_t n_logics = m_thread_safe_logics.size();
+    const uint32_t begin = uint64_t(n_logics) * range_index / n_ranges;
+    const uint32_t end = uint64_t(n_logics) * (range_index + 1) / n_ranges;
+
+    LogicCommandBuffer& commands = m_command_buffers[range_index];
+    for(uint32_t index = begin; index < end; ++index)
+    {
+        m_thread_safe_logics[index]->UpdateWithCommands(*m_worker_update_context, commands);
+        m_command_ends[index] = { range_index, commands.Size() };
+    }
+}
+
+void* EntityLogicSystem::AllocateLogicMemory(size_t logic_size, SlabAllocator*& out_slab)
+{
+    // Logics of about the same size share a slab.
+    const size_t block_size = SlabAllocator::BlockSizeFor(logic_size);
+    const auto find_by_block_size = [block_size](const std::unique_ptr<SlabAllocator>& slab) {
+        return slab->BlockSize() == block_size;
+    };
+
+    auto it = std::find_if(m_slabs.begin(), m_slabs.end(), find_by_block_size);
+    if(it == m_slabs.end())
+        it = m_slabs.insert(m_slabs.end(), std::make_unique<SlabAllocator>(block_size, tweak_values::logics_per_slab_page));
+
+    out_slab = it->get();
+    void* memory = out_slab->Allocate();
+
+    m_allocation_stats.pooled_logics++;
+    m_allocation_stats.slab_pages = 0;
+    for(const std::unique_ptr<SlabAllocator>& slab : m_slabs)
+        m_allocation_stats.slab_pages += slab->Pages();
+
+    return memory;
+}
+
 void EntityLogicSystem::SetDebugCategory(const char* debug_category, bool activate)
 {
     const uint32_t hashed_debug_category = hash::Hash(debug_category);
@@ -154,7 +392,35 @@ std::vector<EntityDebugCategory> EntityLogicSystem::GetDebugCategories() const
 IEntityLogic* EntityLogicSystem::CreateLogic(EntityLogicType type, const std::vector<Attribute>& properties, uint32_t entity_id)
 {
     IEntityLogic* logic = create_functions[static_cast<uint32_t>(type)](entity_id, m_system_context, m_event_handler);
+    ApplyEnemyModifiers(entity_id);
+    return logic;
+}
+
+bool EntityLogicSystem::AddBatchedLogic(EntityLogicType type, uint32_t entity_id)
+{
+    // Updating the behaviour of an entity replaces the logic it had, pooled or not.
+    if(m_entity_to_pool[entity_id] || m_logics.IsActive(entity_id))
+        ReleaseLogic(entity_id);
+
+    ILogicPool* logic_pool = m_logic_pools[static_cast<uint32_t>(type)].get();
+    if(!logic_pool)
+        return false;
+
+    logic_pool->Add(entity_id);
+    m_entity_to_pool[entity_id] = logic_pool;
+    m_allocation_stats.batched_logics++;
+
+    ApplyEnemyModifiers(entity_id);
+    return true;
+}
+
+void EntityLogicSystem::SetLogicPool(EntityLogicType type, std::unique_ptr<ILogicPool> logic_pool)
+{
+    m_logic_pools[static_cast<uint32_t>(type)] = std::move(logic_pool);
+}
 
+void EntityLogicSystem::ApplyEnemyModifiers(uint32_t entity_id)
+{
     PerkSystem* perk_system = m_system_context->GetSystem<PerkSystem>();
     if(perk_system)
     {
@@ -174,8 +440,6 @@ IEntityLogic* EntityLogicSystem::CreateLogic(EntityLogicType type, const std::ve
                 damage_system->AddDamageModifierForId(entity_id, enemy_damage_modifier);
         }
     }
-
-    return logic;
 }
 
 const char* EntityLogicSystem::Name() const
@@ -185,10 +449,34 @@ const char* EntityLogicSystem::Name() const
 
 void EntityLogicSystem::Update(const mono::UpdateContext& update_context)
 {
-    const auto update_logic = [&update_context](uint32_t index, EntityLogicComponent& logic_component) {
-        logic_component.logic->Update(update_context);
-    };
-    m_logics.ForEach(update_logic);
+    if(GetUpdateThreads() == 1)
+    {
+        // Every logic in entity order, as before the worker threads. The commands of a thread safe logic are
+        // applied right after it, where it would have made the change itself.
+        LogicCommandBuffer& commands = m_command_buffers.front();
+        const auto update_logic = [this, &update_context, &commands](uint32_t index, EntityLogicComponent& logic_component) {
+            if(logic_component.thread_safe)
+            {
+                logic_component.logic->UpdateWithCommands(update_context, commands);
+                commands.Apply(m_command_targets);
+            }
+            else
+            {
+                logic_component.logic->Update(update_context);
+            }
+        };
+        m_logics.ForEach(update_logic);
+    }
+    else
+    {
+        UpdateParallel(update_context);
+    }
+
+    for(const std::unique_ptr<ILogicPool>& logic_pool : m_logic_pools)
+    {
+        if(logic_pool)
+            logic_pool->Update(update_context);
+    }
 
     if(!m_active_categories.empty())
     {
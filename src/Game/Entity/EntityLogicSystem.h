@@ -5,8 +5,16 @@
 #include "IGameSystem.h"
 #include "Util/ActiveVector.h"
 #include "EntityLogicTypes.h"
+#include "LogicCommandBuffer.h"
+#include "SlabAllocator.h"
 
+#include <condition_variable>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -16,11 +24,25 @@ struct Attribute;
 namespace game
 {
     class IEntityLogic;
+    class ILogicPool;
 
     struct EntityLogicComponent
     {
         IEntityLogic* logic;
         uint32_t debug_category;
+        bool thread_safe;
+
+        // Set when the logic lives in one of the slabs instead of on the heap.
+        SlabAllocator* slab;
+        void* slab_memory;
+    };
+
+    struct LogicAllocationStats
+    {
+        uint32_t heap_logics;
+        uint32_t pooled_logics;
+        uint32_t slab_pages;
+        uint32_t batched_logics;
     };
 
     struct EntityDebugCategory
@@ -40,11 +62,37 @@ namespace game
         void AddLogic(uint32_t entity_id, IEntityLogic* entity_logic);
         void ReleaseLogic(uint32_t entity_id);
 
+        // For short lived logics like bullets, constructs the logic in a slab block and adds it.
+        template <typename T, typename... Args>
+        T* AddPooledLogic(uint32_t entity_id, Args&&... args)
+        {
+            SlabAllocator* slab = nullptr;
+            void* memory = AllocateLogicMemory(sizeof(T), slab);
+            T* logic = new (memory) T(std::forward<Args>(args)...);
+            AddLogicComponent(entity_id, logic, slab, memory);
+            return logic;
+        }
+
+        const LogicAllocationStats& GetAllocationStats() const;
+
+        // Thread safe logics are spread over this many threads, the calling thread included. With more than one
+        // they are updated before the other logics, then the other logics are updated and the world changes the
+        // thread safe logics recorded are applied in entity order. The world changes in the same order as with 1
+        // thread, where every logic is updated in entity order and its commands are applied right after it.
+        void SetUpdateThreads(uint32_t n_threads);
+        uint32_t GetUpdateThreads() const;
+
         void SetDebugCategory(const char* debug_category, bool activate);
         std::vector<EntityDebugCategory> GetDebugCategories() const;
 
         IEntityLogic* CreateLogic(EntityLogicType type, const std::vector<Attribute>& properties, uint32_t entity_id);
 
+        // Types with a logic pool are updated per type instead of per entity. Returns false if the type
+        // has no pool, then the logic has to be made with CreateLogic. Released with ReleaseLogic as usual.
+        // Any logic the entity already had is released first.
+        bool AddBatchedLogic(EntityLogicType type, uint32_t entity_id);
+        void SetLogicPool(EntityLogicType type, std::unique_ptr<ILogicPool> logic_pool);
+
         template <typename T>
         void ForEach(T&& callback)
         {
@@ -56,11 +104,57 @@ namespace game
         const char* Name() const override;
         void Update(const mono::UpdateContext& update_context) override;
 
+        void AddLogicComponent(uint32_t entity_id, IEntityLogic* entity_logic, SlabAllocator* slab, void* slab_memory);
+        void* AllocateLogicMemory(size_t logic_size, SlabAllocator*& out_slab);
+        void ApplyEnemyModifiers(uint32_t entity_id);
+
+        void UpdateParallel(const mono::UpdateContext& update_context);
+        void UpdateThreadSafeLogics(const mono::UpdateContext& update_context);
+        void UpdateLogicRange(uint32_t range_index, uint32_t n_ranges);
+        void WorkerFunc(uint32_t range_index, uint32_t work_frame);
+        void StopWorkers();
+
         mono::SystemContext* m_system_context;
         mono::EventHandler* m_event_handler;
 
         mono::ActiveVector<EntityLogicComponent> m_logics;
         std::unordered_map<uint32_t, EntityDebugCategory> m_hash_to_category;
         std::unordered_set<uint32_t> m_active_categories;
+
+        std::vector<std::unique_ptr<SlabAllocator>> m_slabs;
+        LogicAllocationStats m_allocation_stats;
+
+        std::vector<std::unique_ptr<ILogicPool>> m_logic_pools;
+        std::vector<ILogicPool*> m_entity_to_pool;
+
+        // The logics in entity order for the parallel update, thread_safe_index is into m_thread_safe_logics
+        // and m_command_ends. The workers write where the commands of each thread safe logic end.
+        struct OrderedLogic
+        {
+            IEntityLogic* logic;
+            uint32_t thread_safe_index;
+        };
+
+        struct CommandEnd
+        {
+            uint32_t buffer_index;
+            uint32_t end_index;
+        };
+
+        std::vector<OrderedLogic> m_update_order;
+        std::vector<IEntityLogic*> m_thread_safe_logics;
+        std::vector<CommandEnd> m_command_ends;
+        std::vector<LogicCommandBuffer> m_command_buffers;
+        LogicCommandTargets m_command_targets;
+
+        const mono::UpdateContext* m_worker_update_context;
+        uint32_t m_worker_ranges;
+        uint32_t m_work_frame;
+        uint32_t m_workers_busy;
+        bool m_stop_workers;
+        std::mutex m_worker_mutex;
+        std::condition_variable m_work_signal;
+        std::condition_variable m_done_signal;
+        std::vector<std::thread> m_workers;
     };
 }
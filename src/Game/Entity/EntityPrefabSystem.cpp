@@ -0,0 +1,136 @@
+
+#include "EntityPrefabSystem.h"
+
+#include "EntitySystem/IEntityManager.h"
+#include "EntitySystem/Serialize.h"
+#include "Math/Serialize.h"
+#include "Rendering/Serialize.h"
+
+#include "System/Hash.h"
+#include "System/System.h"
+
+#include "nlohmann/json.hpp"
+
+using namespace game;
+
+bool game::ParseEntityPrefab(const std::vector<byte>& file_data, EntityPrefab& out_prefab)
+{
+    std::vector<mono::EntityData> loaded_entity_data;
+
+    // A broken file fails the load, the spawn falls back to the entity manager.
+    try
+    {
+        const nlohmann::json& json = nlohmann::json::parse(file_data);
+        if(!json.contains("entities"))
+            return false;
+
+        loaded_entity_data = json["entities"].get<std::vector<mono::EntityData>>();
+    }
+    catch(const nlohmann::json::exception& error)
+    {
+        System::Log("EntityPrefabSystem|%s", error.what());
+        return false;
+    }
+
+    if(loaded_entity_data.empty())
+        return false;
+
+    out_prefab.is_collection = (loaded_entity_data.size() > 1);
+    out_prefab.components.clear();
+
+    const mono::EntityData& entity_data = loaded_entity_data.front();
+    out_prefab.name = entity_data.entity_name;
+    out_prefab.properties = entity_data.entity_properties;
+
+    out_prefab.components.reserve(entity_data.entity_components.size());
+    for(const mono::ComponentData& component_data : entity_data.entity_components)
+    {
+        Component component = component::DefaultComponentFromHash(component_data.hash);
+        MergeAttributes(component.properties, component_data.properties);
+        out_prefab.components.push_back(std::move(component));
+    }
+
+    return true;
+}
+
+EntityPrefabSystem::EntityPrefabSystem(mono::IEntityManager* entity_manager)
+    : m_entity_manager(entity_manager)
+    , m_stats({ })
+{ }
+
+void EntityPrefabSystem::Preload(const char* entity_file)
+{
+    FindOrLoadPrefab(entity_file);
+}
+
+void EntityPrefabSystem::Preload(const std::vector<std::string>& entity_files)
+{
+    for(const std::string& entity_file : entity_files)
+        FindOrLoadPrefab(entity_file.c_str());
+}
+
+mono::Entity EntityPrefabSystem::SpawnEntity(const char* entity_file)
+{
+    const EntityPrefab* prefab = FindOrLoadPrefab(entity_file);
+    if(!prefab || prefab->is_collection)
+        return m_entity_manager->SpawnEntity(entity_file);
+
+    m_stats.spawns++;
+
+    mono::Entity entity = m_entity_manager->CreateEntity(prefab->name.c_str(), { });
+    m_entity_manager->SetEntityProperties(entity.id, prefab->properties);
+
+    for(const Component& component : prefab->components)
+    {
+        const bool add_component_result = m_entity_manager->AddComponent(entity.id, component.hash);
+        const bool set_component_result = m_entity_manager->SetComponentData(entity.id, component.hash, component.properties);
+        if(!add_component_result || !set_component_result)
+        {
+            System::Log(
+                "EntityPrefabSystem|Failed to setup component '%s' for '%s'.",
+                component::ComponentNameFromHash(component.hash),
+                entity_file);
+        }
+    }
+
+    return entity;
+}
+
+const PrefabStats& EntityPrefabSystem::GetStats() const
+{
+    return m_stats;
+}
+
+const char* EntityPrefabSystem::Name() const
+{
+    return "entityprefabsystem";
+}
+
+void EntityPrefabSystem::Update(const mono::UpdateContext& update_context)
+{ }
+
+const EntityPrefab* EntityPrefabSystem::FindOrLoadPrefab(const char* entity_file)
+{
+    const uint32_t file_hash = hash::Hash(entity_file);
+    const auto it = m_prefabs.find(file_hash);
+    if(it != m_prefabs.end())
+        return &it->second;
+
+    m_stats.cache_misses++;
+
+    if(!file::Exists(entity_file))
+    {
+        System::Log("EntityPrefabSystem|Unable to find entity file '%s'.", entity_file);
+        return nullptr;
+    }
+
+    EntityPrefab prefab;
+    if(!ParseEntityPrefab(file::FileReadAll(entity_file), prefab))
+    {
+        System::Log("EntityPrefabSystem|Unable to parse entity file '%s'.", entity_file);
+        return nullptr;
+    }
+
+    m_stats.prefabs++;
+    return &m_prefabs.emplace(file_hash, std::move(prefab)).first->second;
+}
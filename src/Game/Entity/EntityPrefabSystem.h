@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "IGameSystem.h"
+#include "EntitySystem/Entity.h"
+#include "Entity/Component.h"
+#include "System/File.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace game
+{
+    // An entity file parsed once, with the component defaults already merged in.
+    struct EntityPrefab
+    {
+        std::string name;
+        uint32_t properties;
+        std::vector<Component> components;
+
+        // Files with more than one entity are left to the entity manager.
+        bool is_collection;
+    };
+
+    bool ParseEntityPrefab(const std::vector<byte>& file_data, EntityPrefab& out_prefab);
+
+    struct PrefabStats
+    {
+        uint32_t prefabs;
+        uint32_t spawns;
+        uint32_t cache_misses;
+    };
+
+    // Caches the parsed prefabs, the entities themselves still come from the entity manager. There are no
+    // pre-warmed entities per prefab, a released entity goes back to the entity manager like any other.
+    // Pooling them needs the entity manager to hand a released entity back instead of tearing down its
+    // components, that is left as a follow-up to the cache.
+    class EntityPrefabSystem : public mono::IGameSystem
+    {
+    public:
+
+        EntityPrefabSystem(mono::IEntityManager* entity_manager);
+
+        // Parse the files up front, so the first spawn in game does not hit the disk.
+        void Preload(const char* entity_file);
+        void Preload(const std::vector<std::string>& entity_files);
+
+        // Same as IEntityManager::SpawnEntity, but from the cached prefab.
+        mono::Entity SpawnEntity(const char* entity_file);
+
+        const PrefabStats& GetStats() const;
+
+        const char* Name() const override;
+        void Update(const mono::UpdateContext& update_context) override;
+
+    private:
+
+        const EntityPrefab* FindOrLoadPrefab(const char* entity_file);
+
+        mono::IEntityManager* m_entity_manager;
+        std::unordered_map<uint32_t, EntityPrefab> m_prefabs;
+        PrefabStats m_stats;
+    };
+}
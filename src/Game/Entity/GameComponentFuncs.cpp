@@ -27,6 +27,7 @@
 #include "Pickups/PickupSystem.h"
 
 #include "Component.h"
+#include "AttributeSet.h"
 #include "CollisionConfiguration.h"
 
 #include "System/Hash.h"
@@ -57,22 +58,24 @@ namespace
 
     bool UpdatePhysics(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::BodyComponent body_args;
 
-        FindAttribute(BODY_TYPE_ATTRIBUTE, properties, (int&)body_args.type, FallbackMode::SET_DEFAULT);
-        FindAttribute(MASS_ATTRIBUTE, properties, body_args.mass, FallbackMode::SET_DEFAULT);
-        FindAttribute(INERTIA_ATTRIBUTE, properties, body_args.inertia, FallbackMode::SET_DEFAULT);
+        FindAttribute(BODY_TYPE_ATTRIBUTE, attribute_set, (int&)body_args.type, FallbackMode::SET_DEFAULT);
+        FindAttribute(MASS_ATTRIBUTE, attribute_set, body_args.mass, FallbackMode::SET_DEFAULT);
+        FindAttribute(INERTIA_ATTRIBUTE, attribute_set, body_args.inertia, FallbackMode::SET_DEFAULT);
 
         bool prevent_rotation = false;
-        FindAttribute(PREVENT_ROTATION_ATTRIBUTE, properties, prevent_rotation, FallbackMode::SET_DEFAULT);
+        FindAttribute(PREVENT_ROTATION_ATTRIBUTE, attribute_set, prevent_rotation, FallbackMode::SET_DEFAULT);
         
         bool use_custom_damping = false;
         float custom_damping = 0.0f;
-        FindAttribute(USE_CUSTOM_DAMPING, properties, use_custom_damping, FallbackMode::SET_DEFAULT);
-        FindAttribute(DAMPING_ATTRIBUTE, properties, custom_damping, FallbackMode::SET_DEFAULT);
+        FindAttribute(USE_CUSTOM_DAMPING, attribute_set, use_custom_damping, FallbackMode::SET_DEFAULT);
+        FindAttribute(DAMPING_ATTRIBUTE, attribute_set, custom_damping, FallbackMode::SET_DEFAULT);
 
         uint32_t material;
-        FindAttribute(PHYSICS_MATERIAL_ATTRIBUTE, properties, material, FallbackMode::SET_DEFAULT);
+        FindAttribute(PHYSICS_MATERIAL_ATTRIBUTE, attribute_set, material, FallbackMode::SET_DEFAULT);
 
         mono::PhysicsSystem* physics_system = context->GetSystem<mono::PhysicsSystem>();
         mono::IBody* body = physics_system->GetBody(entity->id);
@@ -102,13 +105,15 @@ namespace
 
     bool UpdateCircleShape(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int faction = 0;
         mono::CircleComponent shape_params;
 
-        FindAttribute(FACTION_ATTRIBUTE, properties, faction, FallbackMode::SET_DEFAULT);
-        FindAttribute(RADIUS_ATTRIBUTE, properties, shape_params.radius, FallbackMode::SET_DEFAULT);
-        FindAttribute(POSITION_ATTRIBUTE, properties, shape_params.offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(SENSOR_ATTRIBUTE, properties, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
+        FindAttribute(FACTION_ATTRIBUTE, attribute_set, faction, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, shape_params.radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(POSITION_ATTRIBUTE, attribute_set, shape_params.offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(SENSOR_ATTRIBUTE, attribute_set, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
 
         const game::FactionPair& faction_pair = game::g_faction_lookup_table[faction];
         shape_params.category = faction_pair.category;
@@ -121,13 +126,15 @@ namespace
 
     bool UpdateBoxShape(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int faction;
         mono::BoxComponent shape_params;
 
-        FindAttribute(FACTION_ATTRIBUTE, properties, faction, FallbackMode::SET_DEFAULT);
-        FindAttribute(SIZE_ATTRIBUTE, properties, shape_params.size, FallbackMode::SET_DEFAULT);
-        FindAttribute(POSITION_ATTRIBUTE, properties, shape_params.offset, FallbackMode::SET_DEFAULT);
-        FindAttribute(SENSOR_ATTRIBUTE, properties, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
+        FindAttribute(FACTION_ATTRIBUTE, attribute_set, faction, FallbackMode::SET_DEFAULT);
+        FindAttribute(SIZE_ATTRIBUTE, attribute_set, shape_params.size, FallbackMode::SET_DEFAULT);
+        FindAttribute(POSITION_ATTRIBUTE, attribute_set, shape_params.offset, FallbackMode::SET_DEFAULT);
+        FindAttribute(SENSOR_ATTRIBUTE, attribute_set, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
 
         const game::FactionPair& faction_pair = game::g_faction_lookup_table[faction];
         shape_params.category = faction_pair.category;
@@ -140,14 +147,16 @@ namespace
 
     bool UpdateSegmentShape(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int faction;
         mono::SegmentComponent shape_params;
 
-        FindAttribute(FACTION_ATTRIBUTE, properties, faction, FallbackMode::SET_DEFAULT);
-        FindAttribute(RADIUS_ATTRIBUTE, properties, shape_params.radius, FallbackMode::SET_DEFAULT);
-        FindAttribute(START_ATTRIBUTE, properties, shape_params.start, FallbackMode::SET_DEFAULT);
-        FindAttribute(END_ATTRIBUTE, properties, shape_params.end, FallbackMode::SET_DEFAULT);
-        FindAttribute(SENSOR_ATTRIBUTE, properties, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
+        FindAttribute(FACTION_ATTRIBUTE, attribute_set, faction, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, shape_params.radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(START_ATTRIBUTE, attribute_set, shape_params.start, FallbackMode::SET_DEFAULT);
+        FindAttribute(END_ATTRIBUTE, attribute_set, shape_params.end, FallbackMode::SET_DEFAULT);
+        FindAttribute(SENSOR_ATTRIBUTE, attribute_set, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
 
         const game::FactionPair& faction_pair = game::g_faction_lookup_table[faction];
         shape_params.category = faction_pair.category;
@@ -160,12 +169,14 @@ namespace
 
     bool UpdatePolygonShape(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int faction;
         mono::PolyComponent shape_params;
 
-        FindAttribute(FACTION_ATTRIBUTE, properties, faction, FallbackMode::SET_DEFAULT);
-        FindAttribute(POLYGON_ATTRIBUTE, properties, shape_params.vertices, FallbackMode::SET_DEFAULT);
-        FindAttribute(SENSOR_ATTRIBUTE, properties, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
+        FindAttribute(FACTION_ATTRIBUTE, attribute_set, faction, FallbackMode::SET_DEFAULT);
+        FindAttribute(POLYGON_ATTRIBUTE, attribute_set, shape_params.vertices, FallbackMode::SET_DEFAULT);
+        FindAttribute(SENSOR_ATTRIBUTE, attribute_set, shape_params.is_sensor, FallbackMode::SET_DEFAULT);
 
         const game::FactionPair& faction_pair = game::g_faction_lookup_table[faction];
         shape_params.category = faction_pair.category;
@@ -192,17 +203,20 @@ namespace
 
     bool UpdateHealth(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         int health;
         bool release_on_death;
         bool is_boss_health;
 
-        FindAttribute(HEALTH_ATTRIBUTE, properties, health, FallbackMode::SET_DEFAULT);
-        FindAttribute(RELEASE_ON_DEATH_ATTRIBUTE, properties, release_on_death, FallbackMode::SET_DEFAULT);
-        FindAttribute(BOSS_HEALTH_ATTRIBUTE, properties, is_boss_health, FallbackMode::SET_DEFAULT);
+        FindAttribute(HEALTH_ATTRIBUTE, attribute_set, health, FallbackMode::SET_DEFAULT);
+        FindAttribute(RELEASE_ON_DEATH_ATTRIBUTE, attribute_set, release_on_death, FallbackMode::SET_DEFAULT);
+        FindAttribute(BOSS_HEALTH_ATTRIBUTE, attribute_set, is_boss_health, FallbackMode::SET_DEFAULT);
 
         game::DamageSystem* damage_system = context->GetSystem<game::DamageSystem>();
+        damage_system->SetHealth(entity->id, health);
+
         game::DamageRecord* damage_record = damage_system->GetDamageRecord(entity->id);
-        damage_record->health = health;
         damage_record->full_health = health;
         damage_record->release_entity_on_death = release_on_death;
         damage_record->is_boss = is_boss_health;
@@ -226,19 +240,21 @@ namespace
 
     bool UpdateShockwave(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         uint32_t trigger = 0;
         float radius;
         math::Interval magnitude;
         int damage;
 
         mono::Event trigger_name;
-        const bool found_enable = FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::SET_DEFAULT);
+        const bool found_enable = FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::SET_DEFAULT);
         if(found_enable)
             trigger = hash::Hash(trigger_name.text.c_str());
 
-        FindAttribute(RADIUS_ATTRIBUTE, properties, radius, FallbackMode::SET_DEFAULT);
-        FindAttribute(MAGNITUDE_INTERVAL_ATTRIBUTE, properties, magnitude, FallbackMode::SET_DEFAULT);
-        FindAttribute(HEALTH_ATTRIBUTE, properties, damage, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(MAGNITUDE_INTERVAL_ATTRIBUTE, attribute_set, magnitude, FallbackMode::SET_DEFAULT);
+        FindAttribute(HEALTH_ATTRIBUTE, attribute_set, damage, FallbackMode::SET_DEFAULT);
 
         game::DamageSystem* damage_system = context->GetSystem<game::DamageSystem>();
         damage_system->UpdateShockwaveComponent(entity->id, trigger, radius, mono::Random(magnitude.min, magnitude.max), damage);
@@ -267,9 +283,15 @@ namespace
         if(!found_property)
             return false;
 
+        const game::EntityLogicType logic_type = game::EntityLogicType(logic_type_value);
         game::EntityLogicSystem* logic_system = context->GetSystem<game::EntityLogicSystem>();
-        game::IEntityLogic* entity_logic = logic_system->CreateLogic(game::EntityLogicType(logic_type_value), properties, entity->id);
-        logic_system->AddLogic(entity->id, entity_logic);
+
+        const bool added_batched = logic_system->AddBatchedLogic(logic_type, entity->id);
+        if(!added_batched)
+        {
+            game::IEntityLogic* entity_logic = logic_system->CreateLogic(logic_type, properties, entity->id);
+            logic_system->AddLogic(entity->id, entity_logic);
+        }
 
         return true;
     }
@@ -290,27 +312,29 @@ namespace
 
     bool UpdateSpawnPoint(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         game::SpawnSystem::SpawnPointComponent spawn_point;
         spawn_point.enable_trigger = 0;
         spawn_point.disable_trigger = 0;
 
-        FindAttribute(SPAWN_SCORE_ATTRIBUTE, properties, spawn_point.spawn_score, FallbackMode::SET_DEFAULT);
-        FindAttribute(SPAWN_LIMIT_ATTRIBUTE, properties, spawn_point.spawn_limit_total, FallbackMode::SET_DEFAULT);
-        FindAttribute(SPAWN_LIMIT_CONCURRENT_ATTRIBUTE, properties, spawn_point.spawn_limit_concurrent, FallbackMode::SET_DEFAULT);
-        FindAttribute(RADIUS_ATTRIBUTE, properties, spawn_point.radius, FallbackMode::SET_DEFAULT);
-        FindAttribute(TIME_STAMP_ATTRIBUTE, properties, spawn_point.interval_ms, FallbackMode::SET_DEFAULT);
+        FindAttribute(SPAWN_SCORE_ATTRIBUTE, attribute_set, spawn_point.spawn_score, FallbackMode::SET_DEFAULT);
+        FindAttribute(SPAWN_LIMIT_ATTRIBUTE, attribute_set, spawn_point.spawn_limit_total, FallbackMode::SET_DEFAULT);
+        FindAttribute(SPAWN_LIMIT_CONCURRENT_ATTRIBUTE, attribute_set, spawn_point.spawn_limit_concurrent, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, spawn_point.radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(TIME_STAMP_ATTRIBUTE, attribute_set, spawn_point.interval_ms, FallbackMode::SET_DEFAULT);
 
         mono::Event enable_trigger;
-        const bool found_enable = FindAttribute(ENABLE_TRIGGER_ATTRIBUTE, properties, enable_trigger, FallbackMode::SET_DEFAULT);
+        const bool found_enable = FindAttribute(ENABLE_TRIGGER_ATTRIBUTE, attribute_set, enable_trigger, FallbackMode::SET_DEFAULT);
         if(found_enable && !enable_trigger.text.empty())
             spawn_point.enable_trigger = hash::Hash(enable_trigger.text.c_str());
 
         mono::Event disable_trigger;
-        const bool found_disable = FindAttribute(DISABLE_TRIGGER_ATTRIBUTE, properties, disable_trigger, FallbackMode::SET_DEFAULT);
+        const bool found_disable = FindAttribute(DISABLE_TRIGGER_ATTRIBUTE, attribute_set, disable_trigger, FallbackMode::SET_DEFAULT);
         if(found_disable && !disable_trigger.text.empty())
             spawn_point.disable_trigger = hash::Hash(disable_trigger.text.c_str());
 
-        FindAttribute(SPAWN_POINTS_ATTRIBUTE, properties, spawn_point.points, FallbackMode::SET_DEFAULT);
+        FindAttribute(SPAWN_POINTS_ATTRIBUTE, attribute_set, spawn_point.points, FallbackMode::SET_DEFAULT);
 
         game::SpawnSystem* spawn_system = context->GetSystem<game::SpawnSystem>();
         spawn_system->SetSpawnPointData(entity->id, spawn_point);
@@ -333,21 +357,23 @@ namespace
 
     bool UpdateEntitySpawnPoint(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string entity_file;
         float spawn_radius = 0.0f;
         uint32_t spawn_trigger = 0;
 
-        const bool success = FindAttribute(ENTITY_FILE_ATTRIBUTE, properties, entity_file, FallbackMode::REQUIRE_ATTRIBUTE);
+        const bool success = FindAttribute(ENTITY_FILE_ATTRIBUTE, attribute_set, entity_file, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!success)
         {
             System::Log("UpdateEntitySpawnPoint|Missing entity file parameters, unable to update component");
             return false;
         }
 
-        FindAttribute(RADIUS_ATTRIBUTE, properties, spawn_radius, FallbackMode::SET_DEFAULT);
+        FindAttribute(RADIUS_ATTRIBUTE, attribute_set, spawn_radius, FallbackMode::SET_DEFAULT);
 
         mono::Event spawn_trigger_name;
-        const bool found_enable = FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, spawn_trigger_name, FallbackMode::SET_DEFAULT);
+        const bool found_enable = FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, spawn_trigger_name, FallbackMode::SET_DEFAULT);
         if(found_enable)
             spawn_trigger = hash::Hash(spawn_trigger_name.text.c_str());
 
@@ -399,13 +425,15 @@ namespace
     
     bool UpdateShapeTrigger(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event enter_trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, enter_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, enter_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
 
         mono::Event exit_trigger_name;
         const bool found_exit_trigger_name =
-            FindAttribute(TRIGGER_NAME_EXIT_ATTRIBUTE, properties, exit_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_EXIT_ATTRIBUTE, attribute_set, exit_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
 
         if(!found_trigger_name && !found_exit_trigger_name)
         {
@@ -414,7 +442,7 @@ namespace
         }
 
         bool emit_once;
-        FindAttribute(EMIT_ONCE_ATTRIBUTE, properties, emit_once, FallbackMode::SET_DEFAULT);
+        FindAttribute(EMIT_ONCE_ATTRIBUTE, attribute_set, emit_once, FallbackMode::SET_DEFAULT);
 
         const uint32_t enter_trigger_hash = hash::Hash(enter_trigger_name.text.c_str());
         const uint32_t exit_trigger_hash = hash::Hash(exit_trigger_name.text.c_str());
@@ -481,9 +509,11 @@ namespace
 
     bool UpdateAreaTrigger(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name)
             return false;
 
@@ -492,10 +522,10 @@ namespace
         int operation;
         int n_entities;
 
-        FindAttribute(SIZE_ATTRIBUTE, properties, size, FallbackMode::SET_DEFAULT);
-        FindAttribute(FACTION_PICKER_ATTRIBUTE, properties, faction, FallbackMode::SET_DEFAULT);
-        FindAttribute(LOGIC_OP_ATTRIBUTE, properties, operation, FallbackMode::SET_DEFAULT);
-        FindAttribute(N_ENTITIES_ATTRIBUTE, properties, n_entities, FallbackMode::SET_DEFAULT);
+        FindAttribute(SIZE_ATTRIBUTE, attribute_set, size, FallbackMode::SET_DEFAULT);
+        FindAttribute(FACTION_PICKER_ATTRIBUTE, attribute_set, faction, FallbackMode::SET_DEFAULT);
+        FindAttribute(LOGIC_OP_ATTRIBUTE, attribute_set, operation, FallbackMode::SET_DEFAULT);
+        FindAttribute(N_ENTITIES_ATTRIBUTE, attribute_set, n_entities, FallbackMode::SET_DEFAULT);
 
         const math::Vector half_width_height = size / 2.0f;
 
@@ -529,16 +559,18 @@ namespace
 
     bool UpdateTimeTrigger(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name)
             return false;
 
         int timeout_ms;
         bool repeating;
-        FindAttribute(TIME_STAMP_ATTRIBUTE, properties, timeout_ms, FallbackMode::SET_DEFAULT);
-        FindAttribute(REPEATING_ATTRIBUTE, properties, repeating, FallbackMode::SET_DEFAULT);
+        FindAttribute(TIME_STAMP_ATTRIBUTE, attribute_set, timeout_ms, FallbackMode::SET_DEFAULT);
+        FindAttribute(REPEATING_ATTRIBUTE, attribute_set, repeating, FallbackMode::SET_DEFAULT);
 
         const uint32_t trigger_hash = hash::Hash(trigger_name.text.c_str());
         mono::TriggerSystem* trigger_system = context->GetSystem<mono::TriggerSystem>();
@@ -564,19 +596,21 @@ namespace
 
     bool UpdateCounterTrigger(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         mono::Event trigger_name_completed;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         const bool found_trigger_name_completed =
-            FindAttribute(TRIGGER_NAME_COMPLETED_ATTRIBUTE, properties, trigger_name_completed, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_COMPLETED_ATTRIBUTE, attribute_set, trigger_name_completed, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name || !found_trigger_name_completed)
             return false;
 
         int count;
         bool reset_on_completed;
-        FindAttribute(COUNT_ATTRIBUTE, properties, count, FallbackMode::SET_DEFAULT);
-        FindAttribute(RESET_ON_COMPLETED_ATTRIBUTE, properties, reset_on_completed, FallbackMode::SET_DEFAULT);
+        FindAttribute(COUNT_ATTRIBUTE, attribute_set, count, FallbackMode::SET_DEFAULT);
+        FindAttribute(RESET_ON_COMPLETED_ATTRIBUTE, attribute_set, reset_on_completed, FallbackMode::SET_DEFAULT);
 
         const uint32_t trigger_hash = hash::Hash(trigger_name.text.c_str());
         const uint32_t completed_trigger_hash = hash::Hash(trigger_name_completed.text.c_str());
@@ -606,17 +640,19 @@ namespace
 
     bool UpdateRelayTrigger(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         mono::Event trigger_name_completed;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         const bool found_trigger_name_completed =
-            FindAttribute(TRIGGER_NAME_COMPLETED_ATTRIBUTE, properties, trigger_name_completed, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_COMPLETED_ATTRIBUTE, attribute_set, trigger_name_completed, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name || !found_trigger_name_completed)
             return false;
 
         int delay_ms;
-        FindAttribute(TIME_STAMP_ATTRIBUTE, properties, delay_ms, FallbackMode::SET_DEFAULT);
+        FindAttribute(TIME_STAMP_ATTRIBUTE, attribute_set, delay_ms, FallbackMode::SET_DEFAULT);
 
         const uint32_t trigger_hash = hash::Hash(trigger_name.text.c_str());
         const uint32_t completed_trigger_hash = hash::Hash(trigger_name_completed.text.c_str());
@@ -759,9 +795,11 @@ namespace
 
     bool UpdateTranslationAnimation(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
 
         if(!found_trigger_name)
         {
@@ -773,10 +811,10 @@ namespace
         float duration;
         int ease_func_index;
         int animation_mode;
-        FindAttribute(POSITION_ATTRIBUTE, properties, translation, FallbackMode::SET_DEFAULT);
-        FindAttribute(DURATION_ATTRIBUTE, properties, duration, FallbackMode::SET_DEFAULT);
-        FindAttribute(EASING_FUNC_ATTRIBUTE, properties, ease_func_index, FallbackMode::SET_DEFAULT);
-        FindAttribute(ANIMATION_MODE_ATTRIBUTE, properties, animation_mode, FallbackMode::SET_DEFAULT);
+        FindAttribute(POSITION_ATTRIBUTE, attribute_set, translation, FallbackMode::SET_DEFAULT);
+        FindAttribute(DURATION_ATTRIBUTE, attribute_set, duration, FallbackMode::SET_DEFAULT);
+        FindAttribute(EASING_FUNC_ATTRIBUTE, attribute_set, ease_func_index, FallbackMode::SET_DEFAULT);
+        FindAttribute(ANIMATION_MODE_ATTRIBUTE, attribute_set, animation_mode, FallbackMode::SET_DEFAULT);
 
         game::AnimationSystem* animation_system = context->GetSystem<game::AnimationSystem>();
         animation_system->AddTranslationComponent(
@@ -787,9 +825,11 @@ namespace
 
     bool UpdateRotationAnimation(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
 
         if(!found_trigger_name)
         {
@@ -801,10 +841,10 @@ namespace
         float duration;
         int ease_func_index;
         int animation_mode;
-        FindAttribute(ROTATION_ATTRIBUTE, properties, rotation, FallbackMode::SET_DEFAULT);
-        FindAttribute(DURATION_ATTRIBUTE, properties, duration, FallbackMode::SET_DEFAULT);
-        FindAttribute(EASING_FUNC_ATTRIBUTE, properties, ease_func_index, FallbackMode::SET_DEFAULT);
-        FindAttribute(ANIMATION_MODE_ATTRIBUTE, properties, animation_mode, FallbackMode::SET_DEFAULT);
+        FindAttribute(ROTATION_ATTRIBUTE, attribute_set, rotation, FallbackMode::SET_DEFAULT);
+        FindAttribute(DURATION_ATTRIBUTE, attribute_set, duration, FallbackMode::SET_DEFAULT);
+        FindAttribute(EASING_FUNC_ATTRIBUTE, attribute_set, ease_func_index, FallbackMode::SET_DEFAULT);
+        FindAttribute(ANIMATION_MODE_ATTRIBUTE, attribute_set, animation_mode, FallbackMode::SET_DEFAULT);
 
         game::AnimationSystem* animation_system = context->GetSystem<game::AnimationSystem>();
         animation_system->AddRotationComponent(
@@ -815,9 +855,11 @@ namespace
 
     bool UpdateScaleAnimation(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
 
         if(!found_trigger_name)
         {
@@ -829,10 +871,10 @@ namespace
         float duration;
         int ease_func_index;
         int animation_mode;
-        FindAttribute(SCALE_ATTRIBUTE, properties, scale, FallbackMode::SET_DEFAULT);
-        FindAttribute(DURATION_ATTRIBUTE, properties, duration, FallbackMode::SET_DEFAULT);
-        FindAttribute(EASING_FUNC_ATTRIBUTE, properties, ease_func_index, FallbackMode::SET_DEFAULT);
-        FindAttribute(ANIMATION_MODE_ATTRIBUTE, properties, animation_mode, FallbackMode::SET_DEFAULT);
+        FindAttribute(SCALE_ATTRIBUTE, attribute_set, scale, FallbackMode::SET_DEFAULT);
+        FindAttribute(DURATION_ATTRIBUTE, attribute_set, duration, FallbackMode::SET_DEFAULT);
+        FindAttribute(EASING_FUNC_ATTRIBUTE, attribute_set, ease_func_index, FallbackMode::SET_DEFAULT);
+        FindAttribute(ANIMATION_MODE_ATTRIBUTE, attribute_set, animation_mode, FallbackMode::SET_DEFAULT);
 
         game::AnimationSystem* animation_system = context->GetSystem<game::AnimationSystem>();
         animation_system->AddScaleComponent(
@@ -960,9 +1002,11 @@ namespace
     
     bool UpdateInteraction(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name)
         {
             System::Log("GameComponentFunctions|Missing trigger name parameter, unable to update component");
@@ -973,9 +1017,9 @@ namespace
         bool draw_name = false;
         std::string interaction_sound;
 
-        FindAttribute(INTERACTION_TYPE_ATTRIBUTE, properties, (int&)interaction_type, FallbackMode::SET_DEFAULT);
-        FindAttribute(DRAW_NAME_ATTRIBUTE, properties, draw_name, FallbackMode::SET_DEFAULT);
-        FindAttribute(SOUND_ATTRIBUTE, properties, interaction_sound, FallbackMode::SET_DEFAULT);
+        FindAttribute(INTERACTION_TYPE_ATTRIBUTE, attribute_set, (int&)interaction_type, FallbackMode::SET_DEFAULT);
+        FindAttribute(DRAW_NAME_ATTRIBUTE, attribute_set, draw_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(SOUND_ATTRIBUTE, attribute_set, interaction_sound, FallbackMode::SET_DEFAULT);
 
         game::InteractionSystem* interaction_system = context->GetSystem<game::InteractionSystem>();
         interaction_system->AddComponent(
@@ -991,11 +1035,13 @@ namespace
 
     bool UpdateInteractionSwitch(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         mono::Event on_trigger_name;
         mono::Event off_trigger_name;
         const bool found_trigger_name =
-            FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, on_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE) &&
-            FindAttribute(TRIGGER_NAME_EXIT_ATTRIBUTE, properties, off_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
+            FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, on_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE) &&
+            FindAttribute(TRIGGER_NAME_EXIT_ATTRIBUTE, attribute_set, off_trigger_name, FallbackMode::REQUIRE_ATTRIBUTE);
         if(!found_trigger_name)
         {
             System::Log("GameComponentFunctions|Missing trigger name parameter, unable to update component");
@@ -1006,9 +1052,9 @@ namespace
         bool draw_name = false;
         std::string interaction_sound;
 
-        FindAttribute(INTERACTION_TYPE_ATTRIBUTE, properties, (int&)interaction_type, FallbackMode::SET_DEFAULT);
-        FindAttribute(DRAW_NAME_ATTRIBUTE, properties, draw_name, FallbackMode::SET_DEFAULT);
-        FindAttribute(SOUND_ATTRIBUTE, properties, interaction_sound, FallbackMode::SET_DEFAULT);
+        FindAttribute(INTERACTION_TYPE_ATTRIBUTE, attribute_set, (int&)interaction_type, FallbackMode::SET_DEFAULT);
+        FindAttribute(DRAW_NAME_ATTRIBUTE, attribute_set, draw_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(SOUND_ATTRIBUTE, attribute_set, interaction_sound, FallbackMode::SET_DEFAULT);
 
         game::InteractionSystem* interaction_system = context->GetSystem<game::InteractionSystem>();
         interaction_system->AddComponent(
@@ -1066,12 +1112,14 @@ namespace
 
     bool UpdateWeaponLoadout(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string primary;
         std::string secondary;
         std::string tertiary;
-        FindAttribute(WEAPON_PRIMARY_ATTRIBUTE, properties, primary, FallbackMode::SET_DEFAULT);
-        FindAttribute(WEAPON_SECONDARY_ATTRIBUTE, properties, secondary, FallbackMode::SET_DEFAULT);
-        FindAttribute(WEAPON_TERTIARY_ATTRIBUTE, properties, tertiary, FallbackMode::SET_DEFAULT);
+        FindAttribute(WEAPON_PRIMARY_ATTRIBUTE, attribute_set, primary, FallbackMode::SET_DEFAULT);
+        FindAttribute(WEAPON_SECONDARY_ATTRIBUTE, attribute_set, secondary, FallbackMode::SET_DEFAULT);
+        FindAttribute(WEAPON_TERTIARY_ATTRIBUTE, attribute_set, tertiary, FallbackMode::SET_DEFAULT);
 
         game::WeaponSystem* weapon_system = context->GetSystem<game::WeaponSystem>();
         weapon_system->SetWeaponLoadout(entity->id, primary, secondary, tertiary);
@@ -1095,15 +1143,17 @@ namespace
 
     bool UpdateSound(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string sound_file;
         mono::Event play_trigger;
         mono::Event stop_trigger;
         uint32_t parameters = 0;
 
-        FindAttribute(SOUND_ATTRIBUTE, properties, sound_file, FallbackMode::SET_DEFAULT);
-        FindAttribute(SOUND_PLAY_PARAMETERS, properties, parameters, FallbackMode::SET_DEFAULT);
-        FindAttribute(ENABLE_TRIGGER_ATTRIBUTE, properties, play_trigger, FallbackMode::SET_DEFAULT);
-        FindAttribute(DISABLE_TRIGGER_ATTRIBUTE, properties, stop_trigger, FallbackMode::SET_DEFAULT);
+        FindAttribute(SOUND_ATTRIBUTE, attribute_set, sound_file, FallbackMode::SET_DEFAULT);
+        FindAttribute(SOUND_PLAY_PARAMETERS, attribute_set, parameters, FallbackMode::SET_DEFAULT);
+        FindAttribute(ENABLE_TRIGGER_ATTRIBUTE, attribute_set, play_trigger, FallbackMode::SET_DEFAULT);
+        FindAttribute(DISABLE_TRIGGER_ATTRIBUTE, attribute_set, stop_trigger, FallbackMode::SET_DEFAULT);
 
         game::SoundSystem* sound_system = context->GetSystem<game::SoundSystem>();
         sound_system->SetSoundComponentData(
@@ -1206,23 +1256,25 @@ namespace
     }
     bool UpdateMissionTracker(mono::Entity* entity, const std::vector<Attribute>& properties, mono::SystemContext* context)
     {
+        const AttributeSet attribute_set(properties);
+
         std::string mission_name;
         std::string mission_description;
         bool time_based;
         float time_s;
         bool fail_on_timeout;
-        FindAttribute(NAME_ATTRIBUTE, properties, mission_name, FallbackMode::SET_DEFAULT);
-        FindAttribute(SUB_TEXT_ATTRIBUTE, properties, mission_description, FallbackMode::SET_DEFAULT);
-        FindAttribute(TIME_BASED_ATTRIBUTE, properties, time_based, FallbackMode::SET_DEFAULT);
-        FindAttribute(TIME_ATTRIBUTE, properties, time_s, FallbackMode::SET_DEFAULT);
-        FindAttribute(FAIL_ON_TIMEOUT_ATTRIBUTE, properties, fail_on_timeout, FallbackMode::SET_DEFAULT);
+        FindAttribute(NAME_ATTRIBUTE, attribute_set, mission_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(SUB_TEXT_ATTRIBUTE, attribute_set, mission_description, FallbackMode::SET_DEFAULT);
+        FindAttribute(TIME_BASED_ATTRIBUTE, attribute_set, time_based, FallbackMode::SET_DEFAULT);
+        FindAttribute(TIME_ATTRIBUTE, attribute_set, time_s, FallbackMode::SET_DEFAULT);
+        FindAttribute(FAIL_ON_TIMEOUT_ATTRIBUTE, attribute_set, fail_on_timeout, FallbackMode::SET_DEFAULT);
 
         mono::Event trigger_name;
         mono::Event completed_trigger_name;
         mono::Event failed_trigger_name;
-        FindAttribute(TRIGGER_NAME_ATTRIBUTE, properties, trigger_name, FallbackMode::SET_DEFAULT);
-        FindAttribute(COMPLETED_TRIGGER_ATTRIBUTE, properties, completed_trigger_name, FallbackMode::SET_DEFAULT);
-        FindAttribute(FAILED_TRIGGER_ATTRIBUTE, properties, failed_trigger_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(TRIGGER_NAME_ATTRIBUTE, attribute_set, trigger_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(COMPLETED_TRIGGER_ATTRIBUTE, attribute_set, completed_trigger_name, FallbackMode::SET_DEFAULT);
+        FindAttribute(FAILED_TRIGGER_ATTRIBUTE, attribute_set, failed_trigger_name, FallbackMode::SET_DEFAULT);
 
         game::MissionSystem* mission_system = context->GetSystem<game::MissionSystem>();
         mission_system->SetMissionData(
@@ -29,5 +29,17 @@ namespace game
         {
             return "Unknown";
         }
+
+        // Logics that only change their own entity can opt in to run on the worker threads. They are then updated
+        // with UpdateWithCommands instead of Update, and record any other change to the world in the command buffer.
+        virtual bool IsThreadSafe() const
+        {
+            return false;
+        }
+
+        virtual void UpdateWithCommands(const mono::UpdateContext& update_context, class LogicCommandBuffer& commands)
+        {
+            Update(update_context);
+        }
     };
 }
@@ -0,0 +1,96 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "System/Debug.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // All logics of one EntityLogicType, stored together and updated in one go by the EntityLogicSystem instead
+    // of through one IEntityLogic per entity. Only for types that have been ported, see EntityLogicSystem::AddBatchedLogic.
+    class ILogicPool
+    {
+    public:
+
+        virtual ~ILogicPool() = default;
+        virtual void Add(uint32_t entity_id) = 0;
+        virtual void Remove(uint32_t entity_id) = 0;
+        virtual uint32_t Size() const = 0;
+        virtual void Update(const mono::UpdateContext& update_context) = 0;
+    };
+
+    // Densely packed logic data for a pool, removing swaps in the last one so updates never skip over holes.
+    template <typename T>
+    class LogicPoolStorage
+    {
+    public:
+
+        LogicPoolStorage(uint32_t n_entities)
+            : m_entity_to_index(n_entities, invalid_index)
+        { }
+
+        // An entity is in the storage at most once, adding it again returns the data it already has.
+        T& Add(uint32_t entity_id)
+        {
+            const uint32_t existing_index = m_entity_to_index[entity_id];
+            MONO_ASSERT(existing_index == invalid_index);
+            if(existing_index != invalid_index)
+                return m_data[existing_index];
+
+            m_entity_to_index[entity_id] = m_data.size();
+            m_entity_ids.push_back(entity_id);
+            return m_data.emplace_back();
+        }
+
+        void Remove(uint32_t entity_id)
+        {
+            const uint32_t index = m_entity_to_index[entity_id];
+            MONO_ASSERT(index != invalid_index);
+            if(index == invalid_index)
+                return;
+
+            const uint32_t last_index = m_data.size() - 1;
+            if(index != last_index)
+            {
+                m_data[index] = m_data[last_index];
+                m_entity_ids[index] = m_entity_ids[last_index];
+                m_entity_to_index[m_entity_ids[index]] = index;
+            }
+
+            m_data.pop_back();
+            m_entity_ids.pop_back();
+            m_entity_to_index[entity_id] = invalid_index;
+        }
+
+        uint32_t Size() const
+        {
+            return m_data.size();
+        }
+
+        bool Contains(uint32_t entity_id) const
+        {
+            return m_entity_to_index[entity_id] != invalid_index;
+        }
+
+        T* Data()
+        {
+            return m_data.data();
+        }
+
+        const uint32_t* EntityIds() const
+        {
+            return m_entity_ids.data();
+        }
+
+    private:
+
+        static constexpr uint32_t invalid_index = uint32_t(-1);
+
+        std::vector<T> m_data;
+        std::vector<uint32_t> m_entity_ids;
+        std::vector<uint32_t> m_entity_to_index;
+    };
+}
@@ -0,0 +1,165 @@
+
+#include "LogicCommandBuffer.h"
+
+#include "DamageSystem/DamageSystem.h"
+#include "EntitySystem/IEntityManager.h"
+#include "Physics/IBody.h"
+#include "Physics/PhysicsSystem.h"
+#include "SystemContext.h"
+#include "System/System.h"
+#include "TransformSystem/TransformSystem.h"
+#include "TriggerSystem/TriggerSystem.h"
+#include "Math/Matrix.h"
+
+#include <algorithm>
+
+using namespace game;
+
+LogicCommandTargets game::MakeLogicCommandTargets(mono::SystemContext* system_context)
+{
+    LogicCommandTargets targets = { nullptr, nullptr, nullptr, nullptr, nullptr };
+    if(system_context)
+    {
+        targets.entity_manager = system_context->GetSystem<mono::IEntityManager>();
+        targets.transform_system = system_context->GetSystem<mono::TransformSystem>();
+        targets.physics_system = system_context->GetSystem<mono::PhysicsSystem>();
+        targets.trigger_system = system_context->GetSystem<mono::TriggerSystem>();
+        targets.damage_system = system_context->GetSystem<DamageSystem>();
+    }
+
+    return targets;
+}
+
+void LogicCommandBuffer::ReleaseEntity(uint32_t entity_id)
+{
+    PushCommand(CommandType::RELEASE_ENTITY, entity_id);
+}
+
+void LogicCommandBuffer::SpawnEntity(const char* entity_file, const math::Vector& position)
+{
+    Command& command = PushCommand(CommandType::SPAWN_ENTITY, 0);
+    command.entity_file = entity_file;
+    command.vector = position;
+}
+
+void LogicCommandBuffer::ApplyDamage(
+    uint32_t damaged_entity_id, uint32_t who_did_damage, uint32_t weapon_identifier, const DamageDetails& damage_details)
+{
+    Command& command = PushCommand(CommandType::APPLY_DAMAGE, damaged_entity_id);
+    command.other_id = who_did_damage;
+    command.hash = weapon_identifier;
+    command.damage_details = damage_details;
+}
+
+void LogicCommandBuffer::EmitTrigger(uint32_t trigger_hash)
+{
+    Command& command = PushCommand(CommandType::EMIT_TRIGGER, 0);
+    command.hash = trigger_hash;
+}
+
+void LogicCommandBuffer::SetBodyVelocity(uint32_t entity_id, const math::Vector& velocity)
+{
+    Command& command = PushCommand(CommandType::SET_BODY_VELOCITY, entity_id);
+    command.vector = velocity;
+}
+
+void LogicCommandBuffer::SetBodyPosition(uint32_t entity_id, const math::Vector& position)
+{
+    Command& command = PushCommand(CommandType::SET_BODY_POSITION, entity_id);
+    command.vector = position;
+}
+
+void LogicCommandBuffer::Call(DeferredFunc function, void* context, uint32_t entity_id)
+{
+    Command& command = PushCommand(CommandType::CALL, entity_id);
+    command.function = function;
+    command.context = context;
+}
+
+void LogicCommandBuffer::ApplyUntil(const LogicCommandTargets& targets, uint32_t end_index)
+{
+    end_index = std::min(end_index, uint32_t(m_commands.size()));
+    for(; m_applied < end_index; ++m_applied)
+        ApplyCommand(m_commands[m_applied], targets);
+}
+
+void LogicCommandBuffer::Apply(const LogicCommandTargets& targets)
+{
+    ApplyUntil(targets, m_commands.size());
+    Clear();
+}
+
+void LogicCommandBuffer::Clear()
+{
+    m_commands.clear();
+    m_applied = 0;
+}
+
+uint32_t LogicCommandBuffer::Size() const
+{
+    return m_commands.size();
+}
+
+LogicCommandBuffer::Command& LogicCommandBuffer::PushCommand(CommandType type, uint32_t entity_id)
+{
+    Command& command = m_commands.emplace_back();
+    command.type = type;
+    command.entity_id = entity_id;
+    return command;
+}
+
+void LogicCommandBuffer::ApplyCommand(const Command& command, const LogicCommandTargets& targets)
+{
+    bool has_target = true;
+
+    switch(command.type)
+    {
+    case CommandType::RELEASE_ENTITY:
+        has_target = (targets.entity_manager != nullptr);
+        if(has_target)
+            targets.entity_manager->ReleaseEntity(command.entity_id);
+        break;
+    case CommandType::SPAWN_ENTITY:
+    {
+        has_target = (targets.entity_manager != nullptr && targets.transform_system != nullptr);
+        if(has_target)
+        {
+            const mono::Entity spawned_entity = targets.entity_manager->SpawnEntity(command.entity_file);
+            math::Matrix& transform = targets.transform_system->GetTransform(spawned_entity.id);
+            math::Position(transform, command.vector);
+            targets.transform_system->SetTransformState(spawned_entity.id, mono::TransformState::CLIENT);
+        }
+        break;
+    }
+    case CommandType::APPLY_DAMAGE:
+        has_target = (targets.damage_system != nullptr);
+        if(has_target)
+            targets.damage_system->ApplyDamage(command.entity_id, command.other_id, command.hash, command.damage_details);
+        break;
+    case CommandType::EMIT_TRIGGER:
+        has_target = (targets.trigger_system != nullptr);
+        if(has_target)
+            targets.trigger_system->EmitTrigger(command.hash);
+        break;
+    case CommandType::SET_BODY_VELOCITY:
+    case CommandType::SET_BODY_POSITION:
+    {
+        mono::IBody* body = targets.physics_system ? targets.physics_system->GetBody(command.entity_id) : nullptr;
+        has_target = (body != nullptr);
+        if(!has_target)
+            break;
+
+        if(command.type == CommandType::SET_BODY_VELOCITY)
+            body->SetVelocity(command.vector);
+        else
+            body->SetPosition(command.vector);
+        break;
+    }
+    case CommandType::CALL:
+        command.function(command.context, command.entity_id);
+        break;
+    }
+
+    if(!has_target)
+        System::Log("LogicCommandBuffer|No target for command %u on entity %u, dropped.", uint32_t(command.type), command.entity_id);
+}
@@ -0,0 +1,87 @@
+
+#pragma once
+
+#include "MonoFwd.h"
+#include "Math/Vector.h"
+#include "DamageSystem/DamageSystemTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    class DamageSystem;
+
+    // Where the commands are applied, from the system context. A command with a missing target is dropped.
+    struct LogicCommandTargets
+    {
+        mono::IEntityManager* entity_manager;
+        mono::TransformSystem* transform_system;
+        mono::PhysicsSystem* physics_system;
+        mono::TriggerSystem* trigger_system;
+        DamageSystem* damage_system;
+    };
+
+    LogicCommandTargets MakeLogicCommandTargets(mono::SystemContext* system_context);
+
+    // Changes to the world recorded by logics running on the worker threads, applied on the main thread. The
+    // EntityLogicSystem applies the commands of each logic where the logic is in the entity order, so the world
+    // changes in the same order no matter how many threads did the update.
+    class LogicCommandBuffer
+    {
+    public:
+
+        using DeferredFunc = void (*)(void* context, uint32_t entity_id);
+
+        void ReleaseEntity(uint32_t entity_id);
+
+        // The entity file is not copied, it has to outlive the frame.
+        void SpawnEntity(const char* entity_file, const math::Vector& position);
+        void ApplyDamage(uint32_t damaged_entity_id, uint32_t who_did_damage, uint32_t weapon_identifier, const DamageDetails& damage_details);
+        void EmitTrigger(uint32_t trigger_hash);
+        void SetBodyVelocity(uint32_t entity_id, const math::Vector& velocity);
+        void SetBodyPosition(uint32_t entity_id, const math::Vector& position);
+
+        // For anything else, context has to be valid until the buffer is applied.
+        void Call(DeferredFunc function, void* context, uint32_t entity_id);
+
+        // Applies the commands not applied yet, up to end_index or all of them, and keeps track of how far it got.
+        void ApplyUntil(const LogicCommandTargets& targets, uint32_t end_index);
+        void Apply(const LogicCommandTargets& targets);
+
+        void Clear();
+        uint32_t Size() const;
+
+    private:
+
+        enum class CommandType : uint32_t
+        {
+            RELEASE_ENTITY,
+            SPAWN_ENTITY,
+            APPLY_DAMAGE,
+            EMIT_TRIGGER,
+            SET_BODY_VELOCITY,
+            SET_BODY_POSITION,
+            CALL
+        };
+
+        struct Command
+        {
+            CommandType type;
+            uint32_t entity_id;
+            uint32_t other_id;
+            uint32_t hash;
+            DamageDetails damage_details;
+            math::Vector vector;
+            const char* entity_file;
+            DeferredFunc function;
+            void* context;
+        };
+
+        Command& PushCommand(CommandType type, uint32_t entity_id);
+        void ApplyCommand(const Command& command, const LogicCommandTargets& targets);
+
+        std::vector<Command> m_commands;
+        uint32_t m_applied = 0;
+    };
+}
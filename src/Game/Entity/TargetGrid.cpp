@@ -0,0 +1,185 @@
+
+#include "TargetGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace game;
+
+namespace
+{
+    // Large layers get bigger cells instead of more of them.
+    constexpr float MaxCellsPerAxis = 64.0f;
+
+    int CellCoordinate(float value, float origin, float cell_size, int n_cells)
+    {
+        // Clamp before the conversion, positions far outside of the grid would overflow the int.
+        const float cell = std::floor((value - origin) / cell_size);
+        return int(std::clamp(cell, -1.0f, float(n_cells)));
+    }
+}
+
+TargetGrid::TargetGrid(float cell_size)
+    : m_cell_size(cell_size)
+{ }
+
+void TargetGrid::Clear()
+{
+    m_layers.clear();
+    m_cell_offsets.clear();
+    m_cell_points.clear();
+}
+
+void TargetGrid::Build(const std::vector<TargetGridPoint>& points)
+{
+    Clear();
+
+    m_sorted_points = points;
+    const auto sort_by_priority = [](const TargetGridPoint& left, const TargetGridPoint& right) {
+        return left.priority > right.priority;
+    };
+    std::stable_sort(m_sorted_points.begin(), m_sorted_points.end(), sort_by_priority);
+
+    m_cell_points.resize(m_sorted_points.size());
+
+    uint32_t layer_begin = 0;
+    while(layer_begin < m_sorted_points.size())
+    {
+        const int priority = m_sorted_points[layer_begin].priority;
+
+        uint32_t layer_end = layer_begin;
+        math::Vector min = m_sorted_points[layer_begin].position;
+        math::Vector max = min;
+
+        for(; layer_end < m_sorted_points.size() && m_sorted_points[layer_end].priority == priority; ++layer_end)
+        {
+            const math::Vector& position = m_sorted_points[layer_end].position;
+            min.x = std::min(min.x, position.x);
+            min.y = std::min(min.y, position.y);
+            max.x = std::max(max.x, position.x);
+            max.y = std::max(max.y, position.y);
+        }
+
+        const float extent = std::max(max.x - min.x, max.y - min.y);
+
+        PriorityLayer layer;
+        layer.priority = priority;
+        layer.origin = min;
+        layer.cell_size = std::max(m_cell_size, extent / MaxCellsPerAxis);
+        layer.width = int((max.x - min.x) / layer.cell_size) + 1;
+        layer.height = int((max.y - min.y) / layer.cell_size) + 1;
+        layer.cell_offset = m_cell_offsets.size();
+
+        const uint32_t n_cells = layer.width * layer.height;
+        m_cell_offsets.resize(m_cell_offsets.size() + n_cells + 1, 0);
+        uint32_t* offsets = m_cell_offsets.data() + layer.cell_offset;
+
+        const auto cell_index = [&layer](const math::Vector& position) {
+            const int cell_x = std::min(int((position.x - layer.origin.x) / layer.cell_size), layer.width - 1);
+            const int cell_y = std::min(int((position.y - layer.origin.y) / layer.cell_size), layer.height - 1);
+            return uint32_t(cell_y * layer.width + cell_x);
+        };
+
+        // Counting sort on cell, the offsets index straight into m_cell_points.
+        for(uint32_t index = layer_begin; index < layer_end; ++index)
+            offsets[cell_index(m_sorted_points[index].position) + 1]++;
+
+        offsets[0] = layer_begin;
+        for(uint32_t cell = 0; cell < n_cells; ++cell)
+            offsets[cell + 1] += offsets[cell];
+
+        for(uint32_t index = layer_begin; index < layer_end; ++index)
+        {
+            const TargetGridPoint& point = m_sorted_points[index];
+            m_cell_points[offsets[cell_index(point.position)]++] = point;
+        }
+
+        // The fill moved every offset one cell forward, shift them back.
+        for(uint32_t cell = n_cells; cell > 0; --cell)
+            offsets[cell] = offsets[cell - 1];
+        offsets[0] = layer_begin;
+
+        m_layers.push_back(layer);
+        layer_begin = layer_end;
+    }
+}
+
+bool TargetGrid::FindTarget(const math::Vector& position, float max_distance, TargetGridPoint& out_point) const
+{
+    const float max_distance_sq = max_distance * max_distance;
+
+    for(const PriorityLayer& layer : m_layers)
+    {
+        uint32_t found_index;
+        if(FindNearestInLayer(layer, position, max_distance_sq, found_index))
+        {
+            out_point = m_cell_points[found_index];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TargetGrid::FindNearestInLayer(
+    const PriorityLayer& layer, const math::Vector& position, float max_distance_sq, uint32_t& out_index) const
+{
+    const int query_x = CellCoordinate(position.x, layer.origin.x, layer.cell_size, layer.width);
+    const int query_y = CellCoordinate(position.y, layer.origin.y, layer.cell_size, layer.height);
+
+    const int first_ring = std::max({ 0, -query_x, query_x - (layer.width - 1), -query_y, query_y - (layer.height - 1) });
+    const int last_ring = std::max({ query_x, layer.width - 1 - query_x, query_y, layer.height - 1 - query_y });
+
+    const uint32_t* offsets = m_cell_offsets.data() + layer.cell_offset;
+
+    float best_distance_sq = max_distance_sq;
+    bool found = false;
+
+    const auto test_cell = [&](int cell_x, int cell_y) {
+        const uint32_t cell = cell_y * layer.width + cell_x;
+        for(uint32_t index = offsets[cell]; index < offsets[cell + 1]; ++index)
+        {
+            const math::Vector delta = m_cell_points[index].position - position;
+            const float distance_sq = delta.x * delta.x + delta.y * delta.y;
+            if(distance_sq < best_distance_sq)
+            {
+                best_distance_sq = distance_sq;
+                out_index = index;
+                found = true;
+            }
+        }
+    };
+
+    // Walk square rings of cells outwards from the query cell, everything in ring n is
+    // at least n - 1 cells away so stop when that is further than the best so far.
+    for(int ring = first_ring; ring <= last_ring; ++ring)
+    {
+        const float ring_distance = float(ring - 1) * layer.cell_size;
+        if(ring_distance > 0.0f && ring_distance * ring_distance >= best_distance_sq)
+            break;
+
+        const int min_x = std::max(query_x - ring, 0);
+        const int max_x = std::min(query_x + ring, layer.width - 1);
+        const int min_y = std::max(query_y - ring, 0);
+        const int max_y = std::min(query_y + ring, layer.height - 1);
+
+        for(int cell_y = min_y; cell_y <= max_y; ++cell_y)
+        {
+            const bool is_edge_row = (cell_y == query_y - ring || cell_y == query_y + ring);
+            if(is_edge_row)
+            {
+                for(int cell_x = min_x; cell_x <= max_x; ++cell_x)
+                    test_cell(cell_x, cell_y);
+            }
+            else
+            {
+                if(query_x - ring >= 0)
+                    test_cell(query_x - ring, cell_y);
+                if(ring > 0 && query_x + ring < layer.width)
+                    test_cell(query_x + ring, cell_y);
+            }
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include "Math/Vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    struct TargetGridPoint
+    {
+        uint32_t entity_id;
+        math::Vector position;
+        int priority;
+    };
+
+    // Target points bucketed in uniform grids, one grid per priority level. Rebuilt from scratch
+    // when the points change, queried with radius bounded nearest searches.
+    class TargetGrid
+    {
+    public:
+
+        TargetGrid(float cell_size);
+
+        void Clear();
+        void Build(const std::vector<TargetGridPoint>& points);
+
+        // Finds the nearest point closer than max_distance among the points with the highest priority that has
+        // any point in range. Returns false if there is no point in range.
+        bool FindTarget(const math::Vector& position, float max_distance, TargetGridPoint& out_point) const;
+
+    private:
+
+        struct PriorityLayer
+        {
+            int priority;
+            math::Vector origin;
+            float cell_size;
+            int width;
+            int height;
+            uint32_t cell_offset;   // First entry in m_cell_offsets
+        };
+
+        bool FindNearestInLayer(
+            const PriorityLayer& layer, const math::Vector& position, float max_distance_sq, uint32_t& out_index) const;
+
+        const float m_cell_size;
+
+        std::vector<PriorityLayer> m_layers;
+        std::vector<uint32_t> m_cell_offsets;
+        std::vector<TargetGridPoint> m_cell_points;
+        std::vector<TargetGridPoint> m_sorted_points;
+    };
+}
@@ -2,7 +2,8 @@
 #include "TargetSystem.h"
 #include "DamageSystem/DamageSystem.h"
 #include "EntitySystem/Entity.h"
-#include "Util/Algorithm.h"
+#include "System/System.h"
+#include "System/Debug.h"
 #include "CollisionConfiguration.h"
 
 #include "Math/MathFunctions.h"
@@ -12,62 +13,89 @@
 
 using namespace game;
 
-namespace game
+namespace
 {
-    class TargetImpl : public game::ITarget
-    {
-    public:
+    constexpr float TargetGridCellSize = 8.0f;
 
-        TargetImpl(uint32_t target_entity_id, const mono::TransformSystem* transform_system)
-            : m_target_id(target_entity_id)
-            , m_transform_system(transform_system)
-        { }
+    // Cached line of sight is refreshed when older than this, with a limit on raycasts per frame.
+    // Pairs that are not queried for a while are dropped.
+    constexpr uint32_t MaxVisibilityAgeMs = 100;
+    constexpr uint32_t MaxVisibilityRaycastsPerFrame = 32;
+    constexpr uint32_t VisibilityPairTimeoutMs = 2000;
 
-        uint32_t TargetId() const override
-        {
-            return m_target_id;
-        }
+    // Room for every entity watching a couple of targets, past that the queries raycast without caching.
+    constexpr uint32_t VisibilityPairsPerEntity = 2;
+}
 
-        bool IsValid() const override
-        {
-            return (m_target_id != mono::INVALID_ID);
-        }
+Target::Target()
+    : m_target_system(nullptr)
+    , m_handle({ mono::INVALID_ID, 0 })
+{ }
 
-        const math::Vector Position() const override
-        {
-            return m_transform_system->GetWorldPosition(m_target_id);
-        }
+Target::Target(std::nullptr_t)
+    : Target()
+{ }
 
-        bool IsWithinDistance(const math::Vector& position, float distance) const override
-        {
-            return math::DistanceBetweenSquared(Position(), position) <= math::Square(distance);
-        }
+Target::Target(const TargetSystem* target_system, TargetHandle handle)
+    : m_target_system(target_system)
+    , m_handle(handle)
+{ }
 
-        bool IsWithinRange(const math::Vector& position, float min_range, float max_range) const override
-        {
-            const float distance_sq = math::DistanceBetweenSquared(Position(), position);
-            return 
-                distance_sq >= math::Square(min_range) && 
-                distance_sq <= math::Square(max_range);
-        }
+uint32_t Target::TargetId() const
+{
+    return IsValid() ? m_handle.entity_id : mono::INVALID_ID;
+}
 
-        void InvalidateTarget()
-        {
-            m_target_id = mono::INVALID_ID;
-        }
+bool Target::IsValid() const
+{
+    return m_target_system && m_target_system->IsValidTarget(m_handle);
+}
 
-        uint32_t m_target_id;
-        const mono::TransformSystem* m_transform_system;
-    };
+const math::Vector Target::Position() const
+{
+    return m_target_system->GetTargetPosition(m_handle);
 }
 
-TargetSystem::TargetSystem(const mono::TransformSystem* transform_system, mono::PhysicsSystem* physics_system, DamageSystem* damage_system)
+bool Target::IsWithinDistance(const math::Vector& position, float distance) const
+{
+    return math::DistanceBetweenSquared(Position(), position) <= math::Square(distance);
+}
+
+bool Target::IsWithinRange(const math::Vector& position, float min_range, float max_range) const
+{
+    const float distance_sq = math::DistanceBetweenSquared(Position(), position);
+    return 
+        distance_sq >= math::Square(min_range) && 
+        distance_sq <= math::Square(max_range);
+}
+
+TargetSystem::TargetSystem(
+    uint32_t n, const mono::TransformSystem* transform_system, mono::PhysicsSystem* physics_system, DamageSystem* damage_system)
     : m_transform_system(transform_system)
     , m_physics_system(physics_system)
     , m_damage_system(damage_system)
-    , m_targets_dirty(false)
+    , m_targets(n)
+    , m_target_grids_dirty(true)
+    , m_player_targets(TargetGridCellSize)
+    , m_enemy_targets(TargetGridCellSize)
+    , m_horde_targets{ mono::INVALID_ID, mono::INVALID_ID }
+    , m_timestamp(0)
+    , m_visibility_pairs(n * VisibilityPairsPerEntity)
+    , m_visibility_stats({ 0, 0, 0 })
+    , m_frame_raycasts(0)
+    , m_frame_cache_hits(0)
     , m_global_target_mode(EnemyTargetMode::Normal)
-{ }
+{
+    for(TargetComponent& target : m_targets)
+    {
+        target.allocated = false;
+        target.enabled = false;
+        target.generation = 0;
+    }
+
+    m_allocated_ids.reserve(n);
+    m_stale_visibility_pairs.reserve(n * VisibilityPairsPerEntity);
+}
 
 const char* TargetSystem::Name() const
 {
@@ -76,90 +104,110 @@ const char* TargetSystem::Name() const
 
 void TargetSystem::Update(const mono::UpdateContext& update_context)
 {
-    if(m_targets_dirty)
-    {
-        const auto sort_by_id = [](const TargetComponent& left, const TargetComponent& right) {
-            return left.priority < right.priority;
-        };
-        std::sort(m_targets.begin(), m_targets.end(), sort_by_id);
+    m_timestamp = update_context.timestamp;
 
-        m_targets_dirty = false;
-    }
+    RebuildTargetGrids();
+    UpdateVisibility();
+}
+
+void TargetSystem::RebuildTargetGrids()
+{
+    const auto build_grid = [this](TargetFaction faction, TargetGrid& grid) {
+        m_grid_points.clear();
+
+        uint32_t& horde_target = m_horde_targets[uint32_t(faction)];
+        horde_target = mono::INVALID_ID;
+
+        for(uint32_t entity_id : m_allocated_ids)
+        {
+            const TargetComponent& target = m_targets[entity_id];
+            if(!target.enabled || target.faction != faction)
+                continue;
+
+            m_grid_points.push_back({ entity_id, m_transform_system->GetWorldPosition(entity_id), target.priority });
+
+            if(horde_target == mono::INVALID_ID || target.priority < m_targets[horde_target].priority)
+                horde_target = entity_id;
+        }
+        grid.Build(m_grid_points);
+    };
+
+    build_grid(TargetFaction::Player, m_player_targets);
+    build_grid(TargetFaction::Enemies, m_enemy_targets);
+
+    m_target_grids_dirty = false;
 }
 
 void TargetSystem::AllocateTarget(uint32_t entity_id)
 {
-    TargetComponent target_component;
-    target_component.entity_id = entity_id;
-    target_component.enabled = true;
+    if(entity_id >= m_targets.size())
+    {
+        System::Log("TargetSystem|Entity id %u out of range.", entity_id);
+        return;
+    }
+
+    TargetComponent& target_component = m_targets[entity_id];
+    if(target_component.allocated)
+        return;
+
+    target_component.faction = TargetFaction::Player;
     target_component.priority = 0;
+    target_component.allocated = true;
+    target_component.enabled = true;
+    target_component.generation++;
+    target_component.allocated_index = m_allocated_ids.size();
 
     const DamageCallback& on_destroyed = [this](uint32_t damaged_entity_id, uint32_t who_did_damage, uint32_t weapon_identifier, int damage, DamageType type) {
-        const auto it = m_active_targets.find(damaged_entity_id);
-        if(it != m_active_targets.end())
-        {
-            it->second->InvalidateTarget();
-            m_active_targets.erase(damaged_entity_id);
-        }
+        m_targets[damaged_entity_id].generation++;
     };
     target_component.callback_handle = m_damage_system->SetDamageCallback(entity_id, DamageType::DESTROYED, on_destroyed);
 
-    m_targets.push_back(target_component);
+    m_allocated_ids.push_back(entity_id);
+    m_target_grids_dirty = true;
 }
 
 void TargetSystem::ReleaseTarget(uint32_t entity_id)
 {
-    const auto remove_on_id = [this, entity_id](const TargetComponent& target) {
-        const bool is_target = target.entity_id == entity_id;
-        if(is_target)
-            m_damage_system->RemoveDamageCallback(entity_id, target.callback_handle);
+    if(entity_id >= m_targets.size() || !m_targets[entity_id].allocated)
+        return;
 
-        return is_target;
-    };
-    mono::remove_if(m_targets, remove_on_id);
+    TargetComponent& target_component = m_targets[entity_id];
+    m_damage_system->RemoveDamageCallback(entity_id, target_component.callback_handle);
 
-    const auto it = m_active_targets.find(entity_id);
-    if(it != m_active_targets.end())
-    {
-        it->second->InvalidateTarget();
-        m_active_targets.erase(entity_id);
-    }
+    const uint32_t last_id = m_allocated_ids.back();
+    m_allocated_ids[target_component.allocated_index] = last_id;
+    m_targets[last_id].allocated_index = target_component.allocated_index;
+    m_allocated_ids.pop_back();
+
+    target_component.allocated = false;
+    target_component.enabled = false;
+    target_component.generation++;
+
+    m_target_grids_dirty = true;
 }
 
 void TargetSystem::SetTargetData(uint32_t entity_id, TargetFaction faction, int priority)
 {
-    const auto find_on_id = [entity_id](const TargetComponent& target) {
-        return target.entity_id == entity_id;
-    };
-    TargetComponent* component = mono::find_if(m_targets, find_on_id);
-    if(component)
-    {
-        component->faction = faction;
-        component->priority = priority;
-    }
+    if(entity_id >= m_targets.size() || !m_targets[entity_id].allocated)
+        return;
+
+    TargetComponent& target_component = m_targets[entity_id];
+    target_component.faction = faction;
+    target_component.priority = priority;
 
-    m_targets_dirty = true;
+    m_target_grids_dirty = true;
 }
 
 void TargetSystem::SetTargetEnabled(uint32_t entity_id, bool enabled)
 {
-    const auto find_on_id = [entity_id](const TargetComponent& target) {
-        return target.entity_id == entity_id;
-    };
-    TargetComponent* component = mono::find_if(m_targets, find_on_id);
-    if(component)
-    {
-        component->enabled = enabled;
-        if(!enabled)
-        {
-            const auto it = m_active_targets.find(entity_id);
-            if(it != m_active_targets.end())
-            {
-                it->second->InvalidateTarget();
-                m_active_targets.erase(it);
-            }
-        }
-    }
+    if(entity_id >= m_targets.size() || !m_targets[entity_id].allocated)
+        return;
+
+    m_targets[entity_id].enabled = enabled;
+    m_target_grids_dirty = true;
+
+    if(!enabled)
+        m_targets[entity_id].generation++;
 }
 
 void TargetSystem::SetGlobalTargetMode(EnemyTargetMode target_mode)
@@ -169,52 +217,71 @@ void TargetSystem::SetGlobalTargetMode(EnemyTargetMode target_mode)
 
 ITargetPtr TargetSystem::AquireTarget(TargetFaction faction, const math::Vector& world_position, float max_distance)
 {
+    // Positions are from the last rebuild, targets only move a fraction of the radius in between.
+    if(m_target_grids_dirty)
+        RebuildTargetGrids();
+
     uint32_t found_target_entity_id = mono::INVALID_ID;
-    const float max_distance_sq = max_distance * max_distance;
-    float current_best_distance_sq = math::INF;
-    int current_best_priority = -1000;
 
-    for(const TargetComponent& target : m_targets)
+    if(m_global_target_mode == EnemyTargetMode::Normal || faction == TargetFaction::Enemies)
+    {
+        const TargetGrid& grid = (faction == TargetFaction::Player) ? m_player_targets : m_enemy_targets;
+
+        TargetGridPoint found_point;
+        if(grid.FindTarget(world_position, max_distance, found_point))
+            found_target_entity_id = found_point.entity_id;
+    }
+    else
     {
-        if(!target.enabled)
-            continue;
+        found_target_entity_id = m_horde_targets[uint32_t(faction)];
+    }
 
-        if(target.faction != faction)
-            continue;
+    return MakeTarget(found_target_entity_id);
+}
 
-        if(target.priority < current_best_priority)
-            continue;
+bool TargetSystem::SeesTarget(uint32_t entity_id, const ITarget* target)
+{
+    return QueryVisibility(entity_id, target).sees_target;
+}
 
-        current_best_priority = target.priority;
+VisibilityResult TargetSystem::QueryVisibility(uint32_t observer_id, const ITarget* target)
+{
+    const uint32_t target_id = target->TargetId();
+    if(target_id == mono::INVALID_ID)
+        return { false, 0 };
 
-        if(m_global_target_mode == EnemyTargetMode::Normal || faction == TargetFaction::Enemies)
-        {
-            const math::Vector& target_world_position = m_transform_system->GetWorldPosition(target.entity_id);
-            const float target_distance_sq = math::DistanceBetweenSquared(target_world_position, world_position);
-            if(target_distance_sq < max_distance_sq && target_distance_sq < current_best_distance_sq)
-            {
-                found_target_entity_id = target.entity_id;
-                current_best_distance_sq = target_distance_sq;
-            }
-        }
-        else
-        {
-            found_target_entity_id = target.entity_id;
-            break;
-        }
+    VisibilityPair* pair = m_visibility_pairs.Find(observer_id, target_id);
+    if(pair)
+    {
+        pair->query_timestamp = m_timestamp;
+        m_frame_cache_hits++;
+
+        return { pair->sees_target, m_timestamp - pair->raycast_timestamp };
+    }
+
+    const bool sees_target = RaycastVisibility(observer_id, target_id);
+    m_frame_raycasts++;
+
+    VisibilityPair* new_pair = m_visibility_pairs.Insert(observer_id, target_id);
+    if(new_pair)
+    {
+        new_pair->sees_target = sees_target;
+        new_pair->raycast_timestamp = m_timestamp;
+        new_pair->query_timestamp = m_timestamp;
     }
 
-    const auto it = m_active_targets.find(found_target_entity_id);
-    if(it != m_active_targets.end())
-        return it->second;
+    return { sees_target, 0 };
+}
 
-    return MakeAndCacheTarget(found_target_entity_id);
+const VisibilityStats& TargetSystem::GetVisibilityStats() const
+{
+    return m_visibility_stats;
 }
 
-bool TargetSystem::SeesTarget(uint32_t entity_id, const ITarget* target)
+bool TargetSystem::RaycastVisibility(uint32_t observer_id, uint32_t target_id) const
 {
-    const math::Vector& origin_world_position = m_transform_system->GetWorldPosition(entity_id);
-    const math::Vector& target_world_position = m_transform_system->GetWorldPosition(target->TargetId());
+    const math::Vector& origin_world_position = m_transform_system->GetWorldPosition(observer_id);
+    const math::Vector& target_world_position = m_transform_system->GetWorldPosition(target_id);
 
     const uint32_t query_category = CollisionCategory::PLAYER | CollisionCategory::PROPS | CollisionCategory::STATIC;
     const mono::PhysicsSpace* space = m_physics_system->GetSpace();
@@ -222,47 +289,96 @@ bool TargetSystem::SeesTarget(uint32_t entity_id, const ITarget* target)
     return (result.body != nullptr && (result.collision_category & ~CollisionCategory::STATIC));
 }
 
-TargetFaction TargetSystem::GetFaction(uint32_t entity_id) const
+void TargetSystem::UpdateVisibility()
 {
-    const auto find_on_id = [entity_id](const TargetComponent& target) {
-        return target.entity_id == entity_id;
+    // The counters cover the queries since the last update and the batch below.
+    m_visibility_stats.active_pairs = m_visibility_pairs.Size();
+    m_visibility_stats.raycasts = m_frame_raycasts;
+    m_visibility_stats.cache_hits = m_frame_cache_hits;
+    m_frame_raycasts = 0;
+    m_frame_cache_hits = 0;
+
+    m_stale_visibility_pairs.clear();
+
+    const auto remove_or_collect_stale = [this](VisibilityPair& pair) {
+        if(m_timestamp - pair.query_timestamp > VisibilityPairTimeoutMs)
+            return true;
+
+        if(m_timestamp - pair.raycast_timestamp >= MaxVisibilityAgeMs)
+            m_stale_visibility_pairs.push_back(&pair);
+
+        return false;
     };
-    const TargetComponent* component = mono::find_if(m_targets, find_on_id);
-    if(component)
-        return component->faction;
+    m_visibility_pairs.RemoveIf(remove_or_collect_stale);
+
+    // Oldest first when there are more stale pairs than the budget, the rest waits for the next frame.
+    if(m_stale_visibility_pairs.size() > MaxVisibilityRaycastsPerFrame)
+    {
+        const auto sort_by_age = [](const VisibilityPair* left, const VisibilityPair* right) {
+            return left->raycast_timestamp < right->raycast_timestamp;
+        };
+        std::nth_element(
+            m_stale_visibility_pairs.begin(),
+            m_stale_visibility_pairs.begin() + MaxVisibilityRaycastsPerFrame,
+            m_stale_visibility_pairs.end(),
+            sort_by_age);
+        m_stale_visibility_pairs.resize(MaxVisibilityRaycastsPerFrame);
+    }
+
+    for(VisibilityPair* pair : m_stale_visibility_pairs)
+    {
+        pair->sees_target = RaycastVisibility(pair->observer_id, pair->target_id);
+        pair->raycast_timestamp = m_timestamp;
+    }
+
+    m_frame_raycasts += m_stale_visibility_pairs.size();
+}
+
+TargetFaction TargetSystem::GetFaction(uint32_t entity_id) const
+{
+    if(entity_id < m_targets.size() && m_targets[entity_id].allocated)
+        return m_targets[entity_id].faction;
 
     return TargetFaction::Player;
 }
 
 int TargetSystem::GetPriority(uint32_t entity_id) const
 {
-    const auto find_on_id = [entity_id](const TargetComponent& target) {
-        return target.entity_id == entity_id;
-    };
-    const TargetComponent* component = mono::find_if(m_targets, find_on_id);
-    if(component)
-        return component->priority;
+    if(entity_id < m_targets.size() && m_targets[entity_id].allocated)
+        return m_targets[entity_id].priority;
 
     return -1;
 }
 
+bool TargetSystem::IsValidTarget(const TargetHandle& handle) const
+{
+    return
+        handle.entity_id < m_targets.size() &&
+        m_targets[handle.entity_id].allocated &&
+        m_targets[handle.entity_id].generation == handle.generation;
+}
+
+math::Vector TargetSystem::GetTargetPosition(const TargetHandle& handle) const
+{
+    return m_transform_system->GetWorldPosition(handle.entity_id);
+}
+
 std::vector<ITargetPtr> TargetSystem::GetActiveTargets() const
 {
     std::vector<ITargetPtr> targets;
-    for(const auto& pair : m_active_targets)
+    for(uint32_t entity_id : m_allocated_ids)
     {
-        if(pair.second.use_count() > 1)
-            targets.push_back(pair.second);
+        if(m_targets[entity_id].enabled)
+            targets.push_back(MakeTarget(entity_id));
     }
     return targets;    
 }
 
-ITargetPtr TargetSystem::MakeAndCacheTarget(uint32_t target_entity_id)
+ITargetPtr TargetSystem::MakeTarget(uint32_t entity_id) const
 {
-    std::shared_ptr<TargetImpl> new_target = std::make_shared<TargetImpl>(target_entity_id, m_transform_system);
- 
-    if(target_entity_id != mono::INVALID_ID)
-        m_active_targets[target_entity_id] = new_target;
+    if(entity_id == mono::INVALID_ID)
+        return Target();
 
-    return new_target;
+    MONO_ASSERT(entity_id < m_targets.size());
+    return Target(this, { entity_id, m_targets[entity_id].generation });
 }
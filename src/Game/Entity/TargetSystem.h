@@ -5,43 +5,44 @@
 #include "IGameSystem.h"
 #include "Math/Vector.h"
 #include "TargetTypes.h"
+#include "TargetGrid.h"
+#include "VisibilityPairTable.h"
 
 #include <vector>
-#include <unordered_map>
-#include <memory>
 
 namespace game
 {
     struct TargetComponent
     {
-        uint32_t entity_id;
-
         TargetFaction faction;
         int priority;
 
         // Internal data
+        bool allocated;
         bool enabled;
+        uint32_t generation; // Bumped when aquired targets should turn invalid
+        uint32_t allocated_index;
         uint32_t callback_handle;
     };
 
-    class ITarget
+    struct VisibilityResult
     {
-    public:
-
-        virtual ~ITarget() = default;
+        bool sees_target;
+        uint32_t age_ms; // Since the raycast
+    };
 
-        virtual uint32_t TargetId() const = 0;
-        virtual bool IsValid() const = 0;
-        virtual const math::Vector Position() const = 0;
-        virtual bool IsWithinDistance(const math::Vector& position, float distance) const = 0;
-        virtual bool IsWithinRange(const math::Vector& position, float min_range, float max_range) const = 0;
+    struct VisibilityStats
+    {
+        uint32_t active_pairs;
+        uint32_t raycasts;
+        uint32_t cache_hits;
     };
 
     class TargetSystem : public mono::IGameSystem
     {
     public:
 
-        TargetSystem(const mono::TransformSystem* transform_system, mono::PhysicsSystem* physics_system, class DamageSystem* damage_system);
+        TargetSystem(uint32_t n, const mono::TransformSystem* transform_system, mono::PhysicsSystem* physics_system, class DamageSystem* damage_system);
         const char* Name() const override;
         void Update(const mono::UpdateContext& update_context) override;
 
@@ -54,22 +55,52 @@ namespace game
 
         ITargetPtr AquireTarget(TargetFaction faction, const math::Vector& world_position, float max_distance);
         bool SeesTarget(uint32_t entity_id, const ITarget* target);
+
+        // Line of sight from observer to target. The pair is raycast right away the first time it is queried,
+        // after that the cached result is refreshed in batches from Update when it gets too old.
+        VisibilityResult QueryVisibility(uint32_t observer_id, const ITarget* target);
+
+        // Counters for the last frame.
+        const VisibilityStats& GetVisibilityStats() const;
+
         TargetFaction GetFaction(uint32_t entity_id) const;
         int GetPriority(uint32_t entity_id) const;
 
+        bool IsValidTarget(const TargetHandle& handle) const;
+        math::Vector GetTargetPosition(const TargetHandle& handle) const;
+
+        // All enabled targets, for debug drawing.
         std::vector<ITargetPtr> GetActiveTargets() const;
 
     private:
 
-        ITargetPtr MakeAndCacheTarget(uint32_t entity_id);
+        ITargetPtr MakeTarget(uint32_t entity_id) const;
+        void RebuildTargetGrids();
+        bool RaycastVisibility(uint32_t observer_id, uint32_t target_id) const;
+        void UpdateVisibility();
 
         const mono::TransformSystem* m_transform_system;
         mono::PhysicsSystem* m_physics_system;
         class DamageSystem* m_damage_system;
 
-        bool m_targets_dirty;
+        // Indexed on entity id, m_allocated_ids lists the allocated ones.
         std::vector<TargetComponent> m_targets;
-        std::unordered_map<uint32_t, std::shared_ptr<class TargetImpl>> m_active_targets;
+        std::vector<uint32_t> m_allocated_ids;
+
+        // Enabled targets per faction, rebuilt every update and when the targets change. The horde
+        // targets are what the non enemy factions aquire when the global target mode is not Normal.
+        bool m_target_grids_dirty;
+        TargetGrid m_player_targets;
+        TargetGrid m_enemy_targets;
+        std::vector<TargetGridPoint> m_grid_points;
+        uint32_t m_horde_targets[2];
+
+        uint32_t m_timestamp;
+        VisibilityPairTable m_visibility_pairs;
+        std::vector<VisibilityPair*> m_stale_visibility_pairs;
+        VisibilityStats m_visibility_stats;
+        uint32_t m_frame_raycasts;
+        uint32_t m_frame_cache_hits;
 
         EnemyTargetMode m_global_target_mode;
     };
@@ -1,7 +1,10 @@
 
 #pragma once
 
-#include <memory>
+#include "Math/Vector.h"
+
+#include <cstdint>
+#include <cstddef>
 
 namespace game
 {
@@ -35,5 +38,39 @@ namespace game
         return "Unknown";
     }
 
-    using ITargetPtr = std::shared_ptr<class ITarget>;
+    struct TargetHandle
+    {
+        uint32_t entity_id;
+        uint32_t generation;
+    };
+
+    // A target aquired from the TargetSystem, the handle is validated against the system when used so the
+    // target turns invalid when it is destroyed, disabled or released. Cheap to copy, no reference counting.
+    class Target
+    {
+    public:
+
+        Target();
+        Target(std::nullptr_t);
+        Target(const class TargetSystem* target_system, TargetHandle handle);
+
+        uint32_t TargetId() const;
+        bool IsValid() const;
+        const math::Vector Position() const;
+        bool IsWithinDistance(const math::Vector& position, float distance) const;
+        bool IsWithinRange(const math::Vector& position, float min_range, float max_range) const;
+
+        // Pointer like interface, targets used to be shared pointers.
+        const Target* operator->() const { return this; }
+        const Target* get() const { return this; }
+        explicit operator bool() const { return IsValid(); }
+
+    private:
+
+        const class TargetSystem* m_target_system;
+        TargetHandle m_handle;
+    };
+
+    using ITarget = Target;
+    using ITargetPtr = Target;
 }
@@ -0,0 +1,108 @@
+
+#include "VisibilityPairTable.h"
+
+using namespace game;
+
+namespace
+{
+    uint32_t SlotCountForPairs(uint32_t max_pairs)
+    {
+        // At most half full with live pairs, the rest for tombstones before a rehash.
+        uint32_t n_slots = 16;
+        while(n_slots < max_pairs * 2)
+            n_slots *= 2;
+        return n_slots;
+    }
+}
+
+VisibilityPairTable::VisibilityPairTable(uint32_t max_pairs)
+    : m_max_pairs(max_pairs)
+    , m_slot_mask(SlotCountForPairs(max_pairs) - 1)
+    , m_size(0)
+    , m_removed(0)
+{
+    Slot empty_slot;
+    empty_slot.state = SlotState::EMPTY;
+    empty_slot.pair = { 0, 0, false, 0, 0 };
+
+    m_slots.resize(m_slot_mask + 1, empty_slot);
+    m_rehash_slots.resize(m_slot_mask + 1, empty_slot);
+}
+
+VisibilityPair* VisibilityPairTable::Find(uint32_t observer_id, uint32_t target_id)
+{
+    uint32_t index = SlotIndex(observer_id, target_id);
+    while(true)
+    {
+        Slot& slot = m_slots[index];
+        if(slot.state == SlotState::EMPTY)
+            return nullptr;
+
+        if(slot.state == SlotState::USED && slot.pair.observer_id == observer_id && slot.pair.target_id == target_id)
+            return &slot.pair;
+
+        index = (index + 1) & m_slot_mask;
+    }
+}
+
+VisibilityPair* VisibilityPairTable::Insert(uint32_t observer_id, uint32_t target_id)
+{
+    VisibilityPair* existing_pair = Find(observer_id, target_id);
+    if(existing_pair)
+        return existing_pair;
+
+    if(m_size >= m_max_pairs)
+        return nullptr;
+
+    // Keep empty slots around so the probes always end.
+    const uint32_t n_slots = m_slot_mask + 1;
+    if((m_size + m_removed + 1) * 4 > n_slots * 3)
+        Rehash();
+
+    uint32_t index = SlotIndex(observer_id, target_id);
+    while(m_slots[index].state == SlotState::USED)
+        index = (index + 1) & m_slot_mask;
+
+    Slot& slot = m_slots[index];
+    if(slot.state == SlotState::REMOVED)
+        m_removed--;
+
+    slot.state = SlotState::USED;
+    slot.pair = { observer_id, target_id, false, 0, 0 };
+    m_size++;
+
+    return &slot.pair;
+}
+
+uint32_t VisibilityPairTable::Size() const
+{
+    return m_size;
+}
+
+uint32_t VisibilityPairTable::SlotIndex(uint32_t observer_id, uint32_t target_id) const
+{
+    const uint64_t key = (uint64_t(observer_id) << 32) | target_id;
+    const uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    return uint32_t(hash >> 32) & m_slot_mask;
+}
+
+void VisibilityPairTable::Rehash()
+{
+    for(Slot& slot : m_rehash_slots)
+        slot.state = SlotState::EMPTY;
+
+    for(const Slot& slot : m_slots)
+    {
+        if(slot.state != SlotState::USED)
+            continue;
+
+        uint32_t index = SlotIndex(slot.pair.observer_id, slot.pair.target_id);
+        while(m_rehash_slots[index].state == SlotState::USED)
+            index = (index + 1) & m_slot_mask;
+
+        m_rehash_slots[index] = slot;
+    }
+
+    m_slots.swap(m_rehash_slots);
+    m_removed = 0;
+}
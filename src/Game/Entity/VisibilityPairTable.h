@@ -0,0 +1,75 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    struct VisibilityPair
+    {
+        uint32_t observer_id;
+        uint32_t target_id;
+        bool sees_target;
+        uint32_t raycast_timestamp;
+        uint32_t query_timestamp;
+    };
+
+    // Observer/target pairs in a fixed size open addressing table with linear probing, allocated up front
+    // so queries and inserts in a full horde wave do not touch the heap. Removed slots are left as
+    // tombstones and cleared by rehashing into a second preallocated slot array.
+    class VisibilityPairTable
+    {
+    public:
+
+        VisibilityPairTable(uint32_t max_pairs);
+
+        VisibilityPair* Find(uint32_t observer_id, uint32_t target_id);
+
+        // Returns nullptr when the table already holds max_pairs pairs. Pointers to pairs are
+        // invalidated by Insert.
+        VisibilityPair* Insert(uint32_t observer_id, uint32_t target_id);
+
+        uint32_t Size() const;
+
+        // Visits every pair, the ones where remove_pair returns true are removed.
+        template <typename T>
+        void RemoveIf(T&& remove_pair)
+        {
+            for(Slot& slot : m_slots)
+            {
+                if(slot.state == SlotState::USED && remove_pair(slot.pair))
+                {
+                    slot.state = SlotState::REMOVED;
+                    m_size--;
+                    m_removed++;
+                }
+            }
+        }
+
+    private:
+
+        enum class SlotState : uint8_t
+        {
+            EMPTY,
+            USED,
+            REMOVED
+        };
+
+        struct Slot
+        {
+            SlotState state;
+            VisibilityPair pair;
+        };
+
+        uint32_t SlotIndex(uint32_t observer_id, uint32_t target_id) const;
+        void Rehash();
+
+        const uint32_t m_max_pairs;
+        uint32_t m_slot_mask;
+        uint32_t m_size;
+        uint32_t m_removed;
+        std::vector<Slot> m_slots;
+        std::vector<Slot> m_rehash_slots;
+    };
+}
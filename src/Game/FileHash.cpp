@@ -0,0 +1,23 @@
+
+#include "FileHash.h"
+#include "MappedFile.h"
+
+uint64_t game::HashBytes(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t index = 0; index < size; ++index)
+    {
+        hash ^= bytes[index];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+bool game::HashFile(const char* filename, uint64_t hash, uint64_t& out_hash)
+{
+    game::MappedFile mapped_file;
+    const bool opened = mapped_file.Open(filename);
+    out_hash = HashBytes(mapped_file.Data(), mapped_file.Size(), hash);
+    return opened;
+}
@@ -0,0 +1,16 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace game
+{
+    constexpr uint64_t Fnv1aOffsetBasis = 0xCBF29CE484222325ull;
+
+    // 64 bit FNV-1a, pass the previous hash to continue it over more data.
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash = Fnv1aOffsetBasis);
+
+    // The file contents through a memory mapping, returns false if the file could not be opened.
+    bool HashFile(const char* filename, uint64_t hash, uint64_t& out_hash);
+}
@@ -20,7 +20,9 @@ bool game::LoadConfig(const char* config_file, game::Config& config)
     config.port_range_start             = json.value("port_range_start", config.port_range_start);
     config.port_range_end               = json.value("port_range_end", config.port_range_end);
     config.server_replication_interval  = json.value("server_replication_interval", config.server_replication_interval);
+    config.server_snapshot_replication  = json.value("server_snapshot_replication", config.server_snapshot_replication);
     config.client_time_offset           = json.value("client_time_offset", config.client_time_offset);
+    config.logic_update_threads         = json.value("logic_update_threads", config.logic_update_threads);
 
     config.application                  = json.value("application", config.application);
     config.organization                 = json.value("organization", config.organization);
@@ -13,7 +13,9 @@ namespace game
         int port_range_start = 21000;
         int port_range_end = 22000;
         int server_replication_interval = 100;
+        bool server_snapshot_replication = true;
         int client_time_offset = 200;
+        int logic_update_threads = 1;
 
         std::string application;
         std::string organization;
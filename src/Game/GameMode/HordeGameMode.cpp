@@ -14,6 +14,7 @@
 #include "Hud/PlayerUIElement.h"
 #include "InteractionSystem/InteractionSystem.h"
 #include "Mission/MissionSystem.h"
+#include "Navigation/NavigationSystem.h"
 #include "Pickups/PickupSystem.h"
 #include "Player/PlayerDaemonSystem.h"
 #include "Player/PlayerAuxiliaryDrawer.h"
@@ -44,6 +45,7 @@
 #include "SystemContext.h"
 #include "TransformSystem/TransformSystem.h"
 #include "Util/Random.h"
+#include "Util/Algorithm.h"
 #include "Zone/IZone.h"
 
 #include "System/Hash.h"
@@ -107,6 +109,7 @@ void HordeGameMode::Begin(
     m_spawn_system = system_context->GetSystem<game::SpawnSystem>();
     m_mission_system = system_context->GetSystem<game::MissionSystem>();
     m_perk_system = system_context->GetSystem<game::PerkSystem>();
+    m_navigation_system = system_context->GetSystem<game::NavigationSystem>();
 
     const uint32_t loot_tag = hash::Hash("loot_point");
     m_loot_box_entities = m_entity_manager->CollectEntitiesWithTag(loot_tag);
@@ -204,6 +207,8 @@ int HordeGameMode::End(mono::IZone* zone)
 
     m_trigger_system->RemoveTriggerCallback(g_show_shop_screen_hash, m_show_shop_screen_trigger, mono::INVALID_ID);
 
+    ClearFlowFieldTargets();
+
     return 0;
 }
 
@@ -414,6 +419,45 @@ void HordeGameMode::RunGameMode(const mono::UpdateContext& update_context)
         SpawnLootBoxes();
         m_spawn_wave_timer = tweak_values::spawn_wave_interval_s;
     }
+
+    UpdateFlowFieldTargets();
+}
+
+void HordeGameMode::UpdateFlowFieldTargets()
+{
+    std::vector<uint32_t> active_targets;
+
+    for(const game::PlayerInfo& player_info : game::g_players)
+    {
+        if(player_info.player_state != game::PlayerState::ALIVE)
+            continue;
+
+        m_navigation_system->SetFlowFieldTarget(player_info.entity_id, player_info.position);
+        active_targets.push_back(player_info.entity_id);
+    }
+
+    if(m_package_entity_id != mono::INVALID_ID)
+    {
+        const math::Vector package_position = m_transform_system->GetWorldPosition(m_package_entity_id);
+        m_navigation_system->SetFlowFieldTarget(m_package_entity_id, package_position);
+        active_targets.push_back(m_package_entity_id);
+    }
+
+    for(uint32_t target_id : m_flow_field_targets)
+    {
+        if(!mono::contains(active_targets, target_id))
+            m_navigation_system->RemoveFlowFieldTarget(target_id);
+    }
+
+    m_flow_field_targets = std::move(active_targets);
+}
+
+void HordeGameMode::ClearFlowFieldTargets()
+{
+    for(uint32_t target_id : m_flow_field_targets)
+        m_navigation_system->RemoveFlowFieldTarget(target_id);
+
+    m_flow_field_targets.clear();
 }
 
 void HordeGameMode::ToPackageDestroyed()
@@ -42,6 +42,9 @@ namespace game
         void ToRunGameMode();
         void RunGameMode(const mono::UpdateContext& update_context);
 
+        void UpdateFlowFieldTargets();
+        void ClearFlowFieldTargets();
+
         void ToPackageDestroyed();
         void ToLevelCompleted();
         void ToLevelAborted();
@@ -84,6 +87,7 @@ namespace game
         class SpawnSystem* m_spawn_system;
         class MissionSystem* m_mission_system;
         class PerkSystem* m_perk_system;
+        class NavigationSystem* m_navigation_system;
 
         mono::EventToken<struct GameOverEvent> m_gameover_token;
         mono::EventToken<struct PlayerLevelUpEvent> m_levelup_token;
@@ -124,5 +128,8 @@ namespace game
 
         uint32_t m_loot_box_index;
         std::vector<uint32_t> m_loot_box_entities;
+
+        // Players and package that the enemies navigate towards using flow fields
+        std::vector<uint32_t> m_flow_field_targets;
     };
 }
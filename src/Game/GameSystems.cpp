@@ -20,6 +20,7 @@
 #include "Entity/AnimationSystem.h"
 #include "Entity/EntityAnnotationSystem.h"
 #include "Entity/EntityLogicSystem.h"
+#include "Entity/EntityPrefabSystem.h"
 #include "Entity/TargetSystem.h"
 #include "Entity/EntityLifetimeTriggerSystem.h"
 #include "GameCamera/CameraSystem.h"
@@ -48,6 +49,8 @@
 
 #include "Entity/Component.h"
 
+#include <algorithm>
+
 
 void game::CreateGameSystems(
     uint32_t max_entities,
@@ -81,8 +84,9 @@ void game::CreateGameSystems(
 
     game::DamageSystem* damage_system =
         system_context.CreateSystem<game::DamageSystem>(max_entities, transform_system, sprite_system, physics_system, entity_system, trigger_system);
+    game::EntityPrefabSystem* prefab_system = system_context.CreateSystem<game::EntityPrefabSystem>(entity_system);
     game::SpawnSystem* spawn_system =
-        system_context.CreateSystem<game::SpawnSystem>(max_entities, trigger_system, entity_system, transform_system);
+        system_context.CreateSystem<game::SpawnSystem>(max_entities, trigger_system, entity_system, prefab_system, transform_system);
     game::EntityAnnotationSystem* annotation_system =
         system_context.CreateSystem<game::EntityAnnotationSystem>(transform_system, entity_system);
     system_context.CreateSystem<game::PickupSystem>(
@@ -104,13 +108,14 @@ void game::CreateGameSystems(
     system_context.CreateSystem<game::TeleportSystem>(camera_system, trigger_system, render_system, transform_system);
     system_context.CreateSystem<game::WorldEntityTrackingSystem>();
     game::TargetSystem* target_system =
-        system_context.CreateSystem<game::TargetSystem>(transform_system, physics_system, damage_system);
+        system_context.CreateSystem<game::TargetSystem>(max_entities, transform_system, physics_system, damage_system);
     
     game::EntityLogicSystem* logic_system =
         system_context.CreateSystem<game::EntityLogicSystem>(max_entities, &system_context, &event_handler);
+    logic_system->SetUpdateThreads(std::max(game_config.logic_update_threads, 1));
     
     system_context.CreateSystem<game::WeaponSystem>(
-        transform_system, sprite_system, physics_system, entity_system, damage_system, camera_system, logic_system, target_system, &system_context);
+        transform_system, sprite_system, physics_system, entity_system, prefab_system, damage_system, camera_system, logic_system, target_system, &system_context);
         
     system_context.CreateSystem<game::MissionSystem>(entity_system, transform_system, trigger_system);
         
@@ -0,0 +1,36 @@
+
+#include "TargetStatsDrawer.h"
+#include "Entity/TargetSystem.h"
+
+#include "Math/Quad.h"
+#include "Debug/GameDebugVariables.h"
+
+#include "imgui/imgui.h"
+
+using namespace game;
+
+TargetStatsDrawer::TargetStatsDrawer(const TargetSystem* target_system)
+    : m_target_system(target_system)
+{ }
+
+void TargetStatsDrawer::Draw(mono::IRenderer& renderer) const
+{
+    if(!game::g_draw_target_stats)
+        return;
+
+    const VisibilityStats& stats = m_target_system->GetVisibilityStats();
+
+    constexpr int flags =
+        ImGuiWindowFlags_AlwaysAutoResize |
+        ImGuiWindowFlags_NoResize;
+
+    ImGui::Begin("Target Stats", &game::g_draw_target_stats, flags);
+    ImGui::Text("visibility pairs: %u", stats.active_pairs);
+    ImGui::Text("raycasts: %u cache hits: %u", stats.raycasts, stats.cache_hits);
+    ImGui::End();
+}
+
+math::Quad TargetStatsDrawer::BoundingBox() const
+{
+    return math::InfQuad;
+}
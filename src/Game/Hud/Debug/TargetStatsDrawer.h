@@ -0,0 +1,18 @@
+
+#pragma once
+
+#include "Rendering/IDrawable.h"
+
+namespace game
+{
+    class TargetStatsDrawer : public mono::IDrawable
+    {
+    public:
+
+        TargetStatsDrawer(const class TargetSystem* target_system);
+        void Draw(mono::IRenderer& renderer) const override;
+        math::Quad BoundingBox() const override;
+
+        const class TargetSystem* m_target_system;
+    };
+}
@@ -0,0 +1,123 @@
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace game;
+
+MappedFile::MappedFile()
+    : m_data(nullptr)
+    , m_size(0)
+#ifdef _WIN32
+    , m_file_handle(INVALID_HANDLE_VALUE)
+    , m_mapping_handle(nullptr)
+#endif
+{ }
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const char* filename)
+{
+    Close();
+
+#ifdef _WIN32
+
+    m_file_handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(m_file_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size;
+    if(!GetFileSizeEx(m_file_handle, &file_size) || file_size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    m_mapping_handle = CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!m_mapping_handle)
+    {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    m_size = size_t(file_size.QuadPart);
+
+#else
+
+    const int file_descriptor = open(filename, O_RDONLY);
+    if(file_descriptor < 0)
+        return false;
+
+    struct stat file_stat;
+    if(fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close(file_descriptor);
+        return false;
+    }
+
+    void* mapped_data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+
+    if(mapped_data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(mapped_data);
+    m_size = size_t(file_stat.st_size);
+
+#endif
+
+    if(!m_data)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+
+    if(m_data)
+        UnmapViewOfFile(m_data);
+    if(m_mapping_handle)
+        CloseHandle(m_mapping_handle);
+    if(m_file_handle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file_handle);
+
+    m_mapping_handle = nullptr;
+    m_file_handle = INVALID_HANDLE_VALUE;
+
+#else
+
+    if(m_data)
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const unsigned char* MappedFile::Data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::Size() const
+{
+    return m_size;
+}
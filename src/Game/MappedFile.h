@@ -0,0 +1,36 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace game
+{
+    // Read only memory mapping of a whole file, unmapped when it goes out of scope.
+    class MappedFile
+    {
+    public:
+
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const char* filename);
+        void Close();
+
+        const unsigned char* Data() const;
+        size_t Size() const;
+
+    private:
+
+        const unsigned char* m_data;
+        size_t m_size;
+
+#ifdef _WIN32
+        void* m_file_handle;
+        void* m_mapping_handle;
+#endif
+    };
+}
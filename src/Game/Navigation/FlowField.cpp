@@ -0,0 +1,114 @@
+
+#include "FlowField.h"
+#include "NavMesh.h"
+#include "Math/MathFunctions.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+using namespace game;
+
+void game::BeginFlowField(const NavmeshContext& context, const math::Vector& target_position, FlowFieldBuilder& builder)
+{
+    FlowField& field = builder.field;
+    field.target_position = target_position;
+    field.target_index = context.nodes.empty() ? -1 : FindClosestIndex(context, target_position);
+
+    field.distances.assign(context.nodes.size(), math::INF);
+    field.next_index.assign(context.nodes.size(), -1);
+
+    builder.open.clear();
+    builder.finished = (field.target_index == -1);
+
+    if(field.target_index != -1)
+    {
+        field.distances[field.target_index] = 0.0f;
+        builder.open.push_back({ 0.0f, field.target_index });
+    }
+}
+
+bool game::ContinueFlowField(const NavmeshContext& context, FlowFieldBuilder& builder, int max_nodes)
+{
+    using OpenNode = std::pair<float, int>;
+    constexpr std::greater<OpenNode> min_heap_compare;
+
+    FlowField& field = builder.field;
+    int nodes_settled = 0;
+
+    while(!builder.open.empty() && nodes_settled < max_nodes)
+    {
+        std::pop_heap(builder.open.begin(), builder.open.end(), min_heap_compare);
+        const OpenNode current = builder.open.back();
+        builder.open.pop_back();
+
+        // Stale entry, the node has already been reached with a shorter distance.
+        if(current.first > field.distances[current.second])
+            continue;
+
+        nodes_settled++;
+
+        const NavmeshNode& node = context.nodes[current.second];
+        const math::Vector& node_point = context.points[node.data_index];
+
+        for(int neighbour_index : node.neighbours_index)
+        {
+            if(neighbour_index == -1)
+                continue;
+
+            const math::Vector& neighbour_point = context.points[context.nodes[neighbour_index].data_index];
+            const float distance = current.first + math::DistanceBetween(node_point, neighbour_point);
+            if(distance >= field.distances[neighbour_index])
+                continue;
+
+            field.distances[neighbour_index] = distance;
+            field.next_index[neighbour_index] = current.second;
+
+            builder.open.push_back({ distance, neighbour_index });
+            std::push_heap(builder.open.begin(), builder.open.end(), min_heap_compare);
+        }
+    }
+
+    builder.finished = builder.open.empty();
+    return builder.finished;
+}
+
+FlowField game::CalculateFlowField(const NavmeshContext& context, const math::Vector& target_position)
+{
+    FlowFieldBuilder builder;
+    BeginFlowField(context, target_position, builder);
+    ContinueFlowField(context, builder, std::numeric_limits<int>::max());
+
+    return std::move(builder.field);
+}
+
+bool game::SampleFlowField(
+    const NavmeshContext& context,
+    const FlowField& field,
+    const math::Vector& position,
+    math::Vector& out_direction,
+    float& out_distance)
+{
+    if(field.target_index == -1 || field.distances.size() != context.nodes.size())
+        return false;
+
+    const int closest_index = FindClosestIndex(context, position);
+    if(closest_index == -1 || field.distances[closest_index] == math::INF)
+        return false;
+
+    const int next_index = field.next_index[closest_index];
+    const math::Vector& steer_towards =
+        (next_index == -1) ? field.target_position : context.points[context.nodes[next_index].data_index];
+
+    const math::Vector delta = steer_towards - position;
+    const float delta_length = math::Length(delta);
+
+    out_direction = (delta_length > 0.0f) ? (delta / delta_length) : math::ZeroVec;
+
+    if(next_index == -1)
+        out_distance = math::DistanceBetween(position, field.target_position);
+    else
+        out_distance = field.distances[closest_index] + math::DistanceBetween(position, context.points[context.nodes[closest_index].data_index]);
+
+    return true;
+}
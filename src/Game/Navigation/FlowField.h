@@ -0,0 +1,44 @@
+
+#pragma once
+
+#include "NavmeshData.h"
+
+#include <utility>
+#include <vector>
+
+namespace game
+{
+    // Distance field from every navmesh node to a target (a Dijkstra map). Any number of agents
+    // can steer towards the target by looking up their closest node, no search per agent.
+    struct FlowField
+    {
+        int target_index = -1;
+        math::Vector target_position;
+
+        std::vector<float> distances;   // Path distance to the target per navmesh node, math::INF if unreachable
+        std::vector<int> next_index;    // Neighbour towards the target per navmesh node, -1 at the target or if unreachable
+    };
+
+    // Time sliced calculation of a flow field, the buffers are reused between calculations.
+    struct FlowFieldBuilder
+    {
+        FlowField field;
+        std::vector<std::pair<float, int>> open;
+        bool finished = true;
+    };
+
+    void BeginFlowField(const NavmeshContext& context, const math::Vector& target_position, FlowFieldBuilder& builder);
+
+    // Settles at most max_nodes nodes, returns true when the field is complete.
+    bool ContinueFlowField(const NavmeshContext& context, FlowFieldBuilder& builder, int max_nodes);
+
+    FlowField CalculateFlowField(const NavmeshContext& context, const math::Vector& target_position);
+
+    // Returns false if the position is not connected to the target.
+    bool SampleFlowField(
+        const NavmeshContext& context,
+        const FlowField& field,
+        const math::Vector& position,
+        math::Vector& out_direction,
+        float& out_distance);
+}
@@ -2,11 +2,26 @@
 #include "NavMesh.h"
 #include "NavmeshFactory.h"
 #include "Math/MathFunctions.h"
-#include "Util/Algorithm.h"
 
-#include <unordered_map>
+#include <algorithm>
 #include <cmath>
 
+namespace
+{
+    int CellCoordinate(float value, float origin, float cell_size, int n_cells)
+    {
+        const int cell = int(std::floor((value - origin) / cell_size));
+        return std::clamp(cell, 0, n_cells - 1);
+    }
+
+    int CellIndex(const game::NavmeshGrid& grid, const math::Vector& point)
+    {
+        const int cell_x = CellCoordinate(point.x, grid.origin.x, grid.cell_size, grid.width);
+        const int cell_y = CellCoordinate(point.y, grid.origin.y, grid.cell_size, grid.height);
+        return cell_y * grid.width + cell_x;
+    }
+}
+
 std::vector<math::Vector> game::GenerateMeshPoints(const math::Vector start, const math::Vector& end, float density)
 {
     const math::Vector delta = end - start;
@@ -32,14 +47,67 @@ std::vector<math::Vector> game::GenerateMeshPoints(const math::Vector start, con
     return nav_mesh;
 }
 
+game::NavmeshGrid game::GenerateMeshGrid(const std::vector<math::Vector>& points, float cell_size)
+{
+    NavmeshGrid grid;
+    if(points.empty() || cell_size <= 0.0f)
+        return grid;
+
+    math::Vector min_point = points.front();
+    math::Vector max_point = points.front();
+
+    for(const math::Vector& point : points)
+    {
+        min_point.x = std::min(min_point.x, point.x);
+        min_point.y = std::min(min_point.y, point.y);
+        max_point.x = std::max(max_point.x, point.x);
+        max_point.y = std::max(max_point.y, point.y);
+    }
+
+    grid.origin = min_point;
+    grid.cell_size = cell_size;
+    grid.width = int((max_point.x - min_point.x) / cell_size) + 1;
+    grid.height = int((max_point.y - min_point.y) / cell_size) + 1;
+
+    // Counting sort of the points into the cells
+    std::vector<int> point_cells(points.size());
+    grid.cell_offsets.resize(grid.width * grid.height + 1, 0);
+
+    for(uint32_t index = 0; index < points.size(); ++index)
+    {
+        const int cell = CellIndex(grid, points[index]);
+        point_cells[index] = cell;
+        grid.cell_offsets[cell + 1]++;
+    }
+
+    for(uint32_t cell = 1; cell < grid.cell_offsets.size(); ++cell)
+        grid.cell_offsets[cell] += grid.cell_offsets[cell - 1];
+
+    std::vector<int> insert_offsets(grid.cell_offsets.begin(), grid.cell_offsets.end() - 1);
+    grid.point_indices.resize(points.size());
+
+    for(uint32_t index = 0; index < points.size(); ++index)
+    {
+        const int cell = point_cells[index];
+        grid.point_indices[insert_offsets[cell]++] = index;
+    }
+
+    return grid;
+}
+
 std::vector<game::NavmeshNode> game::GenerateMeshNodes(
     const std::vector<math::Vector>& points,  float connection_distance, const NavmeshConnectionFilter& filter_function)
 {
     const float connection_distance_squared = connection_distance * connection_distance;
 
+    // With the cell size same as the connection distance all candidates are in the surrounding 3x3 cells.
+    const NavmeshGrid grid = GenerateMeshGrid(points, connection_distance);
+
     std::vector<game::NavmeshNode> nodes;
     nodes.reserve(points.size());
 
+    std::vector<int> candidates;
+
     for(uint32_t index = 0; index < points.size(); ++index)
     {
         const math::Vector& point = points[index];
@@ -48,19 +116,53 @@ std::vector<game::NavmeshNode> game::GenerateMeshNodes(
         node.data_index = index;
         std::fill(std::begin(node.neighbours_index), std::end(node.neighbours_index), -1);
 
+        candidates.clear();
+
+        const int cell_x = CellCoordinate(point.x, grid.origin.x, grid.cell_size, grid.width);
+        const int cell_y = CellCoordinate(point.y, grid.origin.y, grid.cell_size, grid.height);
+
+        for(int y = std::max(cell_y - 1, 0), end_y = std::min(cell_y + 1, grid.height - 1); y <= end_y; ++y)
+        {
+            for(int x = std::max(cell_x - 1, 0), end_x = std::min(cell_x + 1, grid.width - 1); x <= end_x; ++x)
+            {
+                const int cell = y * grid.width + x;
+                for(int offset = grid.cell_offsets[cell]; offset < grid.cell_offsets[cell + 1]; ++offset)
+                {
+                    const int inner_index = grid.point_indices[offset];
+                    const float distance_squared = math::DistanceBetweenSquared(point, points[inner_index]);
+                    if(distance_squared == 0.0f)
+                        continue;
+
+                    if(distance_squared > connection_distance_squared)
+                        continue;
+
+                    candidates.push_back(inner_index);
+                }
+            }
+        }
+
+        // Keep the same neighbour order as a full scan would produce.
+        std::sort(candidates.begin(), candidates.end());
+
         uint32_t neighbour_count = 0;
 
-        for(uint32_t inner_index = 0; inner_index < points.size() && neighbour_count < std::size(node.neighbours_index); ++inner_index)
+        for(uint32_t candidate_index = 0; candidate_index < candidates.size() && neighbour_count < std::size(node.neighbours_index); ++candidate_index)
         {
-            const math::Vector& inner_point = points[inner_index];
-            const float distance_squared = math::DistanceBetweenSquared(point, inner_point);
-            if(distance_squared == 0.0f)
-                continue;
+            const int inner_index = candidates[candidate_index];
 
-            if(distance_squared > connection_distance_squared)
-                continue;
+            // The connection has already been tested from the other node, unless that node ran out of neighbour slots first.
+            bool discard_connection;
+            const NavmeshNode* tested_node = (inner_index < int(index)) ? &nodes[inner_index] : nullptr;
+            if(tested_node && tested_node->neighbours_index[std::size(tested_node->neighbours_index) - 1] == -1)
+            {
+                const int* neighbours_end = std::end(tested_node->neighbours_index);
+                discard_connection = (std::find(std::begin(tested_node->neighbours_index), neighbours_end, int(index)) == neighbours_end);
+            }
+            else
+            {
+                discard_connection = filter_function(point, points[inner_index]);
+            }
 
-            const bool discard_connection = filter_function(point, inner_point);
             if(!discard_connection)
             {
                 node.neighbours_index[neighbour_count] = inner_index;
@@ -74,9 +176,154 @@ std::vector<game::NavmeshNode> game::GenerateMeshNodes(
     return nodes;
 }
 
-float Heuristics(const game::NavmeshContext& context, int from, int to)
+namespace
 {
-    return math::DistanceBetweenSquared(context.points[from], context.points[to]);
+    float Heuristics(const game::NavmeshContext& context, int from, int to)
+    {
+        return math::DistanceBetweenSquared(context.points[from], context.points[to]);
+    }
+
+    struct AStarNode
+    {
+        uint32_t generation;
+        float g_score;
+        float f_score;
+        int came_from;
+        int heap_position; // -1 when the node is not in the open set
+        bool closed;
+    };
+
+    // Scratch memory for the search, kept per thread and reused between searches. Instead of clearing
+    // the node array for each search the generation is bumped, any node with an old generation
+    // is treated as untouched.
+    struct AStarScratch
+    {
+        uint32_t generation = 0;
+        std::vector<AStarNode> nodes;
+        std::vector<int> open_heap;
+
+        void Prepare(size_t n_nodes)
+        {
+            if(nodes.size() < n_nodes)
+                nodes.resize(n_nodes, AStarNode{ 0, 0.0f, 0.0f, -1, -1, false });
+
+            generation++;
+            if(generation == 0)
+            {
+                // Wrapped around, need to reset all the stamps once.
+                for(AStarNode& node : nodes)
+                    node.generation = 0;
+                generation = 1;
+            }
+
+            open_heap.clear();
+        }
+
+        AStarNode& Touch(int index)
+        {
+            AStarNode& node = nodes[index];
+            if(node.generation != generation)
+            {
+                node.generation = generation;
+                node.g_score = math::INF;
+                node.f_score = math::INF;
+                node.came_from = -1;
+                node.heap_position = -1;
+                node.closed = false;
+            }
+
+            return node;
+        }
+
+        bool Less(int first, int second) const
+        {
+            return nodes[first].f_score < nodes[second].f_score;
+        }
+
+        void Place(int heap_position, int node_index)
+        {
+            open_heap[heap_position] = node_index;
+            nodes[node_index].heap_position = heap_position;
+        }
+
+        void SiftUp(int heap_position)
+        {
+            const int node_index = open_heap[heap_position];
+            while(heap_position > 0)
+            {
+                const int parent_position = (heap_position - 1) / 2;
+                const int parent_index = open_heap[parent_position];
+                if(!Less(node_index, parent_index))
+                    break;
+
+                Place(heap_position, parent_index);
+                heap_position = parent_position;
+            }
+
+            Place(heap_position, node_index);
+        }
+
+        void SiftDown(int heap_position)
+        {
+            const int heap_size = open_heap.size();
+            const int node_index = open_heap[heap_position];
+
+            while(true)
+            {
+                const int left_position = heap_position * 2 + 1;
+                if(left_position >= heap_size)
+                    break;
+
+                const int right_position = left_position + 1;
+                int child_position = left_position;
+                if(right_position < heap_size && Less(open_heap[right_position], open_heap[left_position]))
+                    child_position = right_position;
+
+                const int child_index = open_heap[child_position];
+                if(!Less(child_index, node_index))
+                    break;
+
+                Place(heap_position, child_index);
+                heap_position = child_position;
+            }
+
+            Place(heap_position, node_index);
+        }
+
+        void PushOrUpdate(int node_index)
+        {
+            const int heap_position = nodes[node_index].heap_position;
+            if(heap_position == -1)
+            {
+                open_heap.push_back(node_index);
+                SiftUp(open_heap.size() - 1);
+            }
+            else
+            {
+                // The score only ever decreases for a node in the open set.
+                SiftUp(heap_position);
+            }
+        }
+
+        int PopLowest()
+        {
+            const int lowest_index = open_heap.front();
+            nodes[lowest_index].heap_position = -1;
+
+            const int last_index = open_heap.back();
+            open_heap.pop_back();
+
+            if(!open_heap.empty())
+            {
+                Place(0, last_index);
+                SiftDown(0);
+            }
+
+            return lowest_index;
+        }
+    };
+
+    thread_local AStarScratch g_astar_scratch;
 }
 
 game::NavigationResult game::AStar(const game::NavmeshContext& context, int start_index, int end_index)
@@ -97,45 +344,24 @@ game::NavigationResult game::AStar(const game::NavmeshContext& context, int star
         return result;
     }
 
-    std::unordered_map<int, int> came_from;
-
-    std::vector<int> closed_set;
-    std::vector<int> open_set;
-
-    std::vector<float> g_score(context.nodes.size(), math::INF);
-    std::vector<float> f_score(context.nodes.size(), math::INF);
-
-    g_score[start_index] = 0;
-    f_score[start_index] = Heuristics(context, start_index, end_index);
-    
-    const auto find_lowest_f = [&f_score](const std::vector<int>& open_set) {
+    AStarScratch& scratch = g_astar_scratch;
+    scratch.Prepare(context.nodes.size());
 
-        float lowest_f = math::INF;
-        int lowest_index = 0;
-        
-        for(int open_node : open_set)
-        {
-            const float f_value = f_score[open_node];
-            if(f_value < lowest_f)
-            {
-                lowest_f = f_value;
-                lowest_index = open_node;
-            }
-        }
-
-        return lowest_index;
-    };
+    AStarNode& start_node = scratch.Touch(start_index);
+    start_node.g_score = 0.0f;
+    start_node.f_score = Heuristics(context, start_index, end_index);
+    scratch.PushOrUpdate(start_index);
 
     bool found_goal = false;
+    int nodes_evaluated = 0;
 
-    open_set.push_back(start_index);
-
-    while(!open_set.empty())
+    while(!scratch.open_heap.empty())
     {
-        const int current_index = find_lowest_f(open_set);
+        const int current_index = scratch.PopLowest();
 
-        mono::remove(open_set, current_index);
-        closed_set.push_back(current_index);
+        AStarNode& current_node = scratch.nodes[current_index];
+        current_node.closed = true;
+        nodes_evaluated++;
 
         // We are at the goal!
         if(current_index == end_index)
@@ -144,6 +370,7 @@ game::NavigationResult game::AStar(const game::NavmeshContext& context, int star
             break;
         }
 
+        const float current_g_score = current_node.g_score;
         const NavmeshNode& node = context.nodes[current_index];
 
         for(int neighbour_index : node.neighbours_index)
@@ -151,43 +378,37 @@ game::NavigationResult game::AStar(const game::NavmeshContext& context, int star
             if(neighbour_index == -1)
                 continue;
 
-            const bool already_evaluated = mono::contains(closed_set, neighbour_index);
-            if (already_evaluated)
+            AStarNode& neighbour_node = scratch.Touch(neighbour_index);
+            if(neighbour_node.closed)
                 continue;
 
-            const bool in_open_set = mono::contains(open_set, neighbour_index);
-            if (!in_open_set)
-                open_set.push_back(neighbour_index);
-
-            const float tentative_g_score = g_score[current_index] + Heuristics(context, current_index, neighbour_index);
+            const float tentative_g_score = current_g_score + Heuristics(context, current_index, neighbour_index);
 
             // Not better path
-            if(tentative_g_score >= g_score[neighbour_index])
+            if(tentative_g_score >= neighbour_node.g_score)
                 continue;
 
-            came_from[neighbour_index] = current_index;
-            g_score[neighbour_index] = tentative_g_score;
-            f_score[neighbour_index] = tentative_g_score + Heuristics(context, neighbour_index, end_index);
+            neighbour_node.came_from = current_index;
+            neighbour_node.g_score = tentative_g_score;
+            neighbour_node.f_score = tentative_g_score + Heuristics(context, neighbour_index, end_index);
+            scratch.PushOrUpdate(neighbour_index);
         }
     }
 
     if(!found_goal)
     {
         result.result = AStarResult::NO_PATH;
+        result.nodes_evaluated = nodes_evaluated;
         return result;
     }
-    
+
     int current = end_index;
 
     // Unravel the path
-    while(current != start_index)
+    while(current != start_index && current != -1)
     {
         result.path_indices.push_back(current);
-        const auto it = came_from.find(current);
-        if(it == came_from.end())
-            break;
-
-        current = it->second;
+        current = scratch.nodes[current].came_from;
     }
 
     if(current == start_index)
@@ -196,7 +417,7 @@ game::NavigationResult game::AStar(const game::NavmeshContext& context, int star
     std::reverse(result.path_indices.begin(), result.path_indices.end());
 
     result.result = AStarResult::SUCCESS;
-    result.nodes_evaluated = closed_set.size();
+    result.nodes_evaluated = nodes_evaluated;
 
     return result;
 }
@@ -225,15 +446,62 @@ int game::FindClosestIndex(const game::NavmeshContext& context, const math::Vect
     int closest_index = -1;
     float closest_distance = math::INF;
 
-    for(uint32_t index = 0, end = context.points.size(); index < end; ++index)
-    {
-        const math::Vector& node_point = context.points[index];
-        const float distance = math::DistanceBetweenSquared(point, node_point);
-        if(distance < closest_distance)
+    const auto test_point = [&](int index) {
+        const float distance = math::DistanceBetweenSquared(point, context.points[index]);
+        if(distance < closest_distance || (distance == closest_distance && index < closest_index))
         {
             closest_distance = distance;
             closest_index = index;
         }
+    };
+
+    const NavmeshGrid& grid = context.grid;
+    if(grid.cell_offsets.empty())
+    {
+        for(uint32_t index = 0, end = context.points.size(); index < end; ++index)
+            test_point(index);
+
+        return closest_index;
+    }
+
+    const int cell_x = CellCoordinate(point.x, grid.origin.x, grid.cell_size, grid.width);
+    const int cell_y = CellCoordinate(point.y, grid.origin.y, grid.cell_size, grid.height);
+    const int max_ring = std::max(grid.width, grid.height);
+
+    // Search rings of cells around the point, anything in ring n + 1 is at least n cells away.
+    for(int ring = 0; ring <= max_ring; ++ring)
+    {
+        const int min_y = cell_y - ring;
+        const int max_y = cell_y + ring;
+        const int min_x = cell_x - ring;
+        const int max_x = cell_x + ring;
+
+        const auto test_cell = [&](int x, int y) {
+            const int cell = y * grid.width + x;
+            for(int offset = grid.cell_offsets[cell]; offset < grid.cell_offsets[cell + 1]; ++offset)
+                test_point(grid.point_indices[offset]);
+        };
+
+        for(int y = std::max(min_y, 0), end_y = std::min(max_y, grid.height - 1); y <= end_y; ++y)
+        {
+            const bool full_row = (y == min_y || y == max_y);
+            if(full_row)
+            {
+                for(int x = std::max(min_x, 0), end_x = std::min(max_x, grid.width - 1); x <= end_x; ++x)
+                    test_cell(x, y);
+            }
+            else
+            {
+                if(min_x >= 0)
+                    test_cell(min_x, y);
+                if(max_x < grid.width)
+                    test_cell(max_x, y);
+            }
+        }
+
+        const float ring_distance = ring * grid.cell_size;
+        if(closest_index != -1 && closest_distance < ring_distance * ring_distance)
+            break;
     }
 
     return closest_index;
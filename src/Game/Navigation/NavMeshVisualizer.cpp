@@ -68,6 +68,9 @@ void NavmeshVisualizer::Draw(mono::IRenderer& renderer) const
     if(game::g_draw_navmesh_subcomponents & game::NavigationDebugComponents::DRAW_RECENT_PATHS)
         DrawPaths(renderer);
 
+    if(game::g_draw_navmesh_subcomponents & game::NavigationDebugComponents::DRAW_FLOW_FIELDS)
+        DrawFlowFields(renderer);
+
     const int n_pathfinds = m_navigation_system->GetNumFindPath();
     if(n_pathfinds > 0)
         System::Log("[%u] PathFinds: %d", renderer.GetTimestamp(), n_pathfinds);
@@ -154,6 +157,46 @@ void NavmeshVisualizer::DrawInteractivePath(mono::IRenderer& renderer) const
     renderer.DrawPoints(start_node_points, selected_color, 4.0f);
 }
 
+void NavmeshVisualizer::DrawFlowFields(mono::IRenderer& renderer) const
+{
+    const NavmeshContext* navmesh_context = m_navigation_system->GetNavmeshContext();
+    if(!navmesh_context)
+        return;
+
+    // Short line from each node towards the next node, with a point at the end as the arrow head.
+    std::vector<math::Vector> arrows;
+    std::vector<math::Vector> arrow_heads;
+    std::vector<math::Vector> targets;
+
+    for(const FlowField* flow_field : m_navigation_system->GetFlowFields())
+    {
+        if(flow_field->next_index.size() != navmesh_context->nodes.size())
+            continue;
+
+        for(size_t index = 0; index < flow_field->next_index.size(); ++index)
+        {
+            const int next_index = flow_field->next_index[index];
+            if(next_index == -1)
+                continue;
+
+            const math::Vector& from = navmesh_context->points[navmesh_context->nodes[index].data_index];
+            const math::Vector& to = navmesh_context->points[navmesh_context->nodes[next_index].data_index];
+            const math::Vector arrow_end = from + (to - from) * 0.4f;
+
+            arrows.push_back(from);
+            arrows.push_back(arrow_end);
+            arrow_heads.push_back(arrow_end);
+        }
+
+        targets.push_back(flow_field->target_position);
+    }
+
+    constexpr mono::Color::RGBA arrow_color(1.0f, 0.5f, 0.0f, 0.4f);
+    renderer.DrawLines(arrows, arrow_color, 1.0f);
+    renderer.DrawPoints(arrow_heads, arrow_color, 3.0f);
+    renderer.DrawPoints(targets, mono::Color::RED, 8.0f);
+}
+
 mono::EventResult NavmeshVisualizer::OnMouseUp(const event::MouseUpEvent& event)
 {
     const NavmeshContext* navmesh_context = m_navigation_system->GetNavmeshContext();
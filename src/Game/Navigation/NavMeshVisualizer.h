@@ -26,6 +26,7 @@ namespace game
         void DrawNavmesh(mono::IRenderer& renderer) const;
         void DrawPaths(mono::IRenderer& renderer) const;
         void DrawInteractivePath(mono::IRenderer& renderer) const;
+        void DrawFlowFields(mono::IRenderer& renderer) const;
 
         mono::EventResult OnMouseUp(const event::MouseUpEvent& event);
         mono::EventResult OnMouseMove(const event::MouseMotionEvent& event);
@@ -2,25 +2,112 @@
 #include "NavigationSystem.h"
 #include "Navigation/NavmeshFactory.h"
 #include "Navigation/NavMesh.h"
+#include "Navigation/NavmeshHierarchy.h"
+#include "Navigation/NavmeshCache.h"
+#include "Navigation/FlowField.h"
 #include "CollisionConfiguration.h"
 
 #include "Physics/PhysicsSpace.h"
-#include "System/Debug.h"
+#include "System/System.h"
 #include "Util/Algorithm.h"
-#include "Util/ScopedTimer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <string>
 
 namespace
 {
     constexpr int NumRecentPaths = 10;
+    constexpr float FindPathBudgetMs = 2.0f;
+    constexpr uint32_t MaxPathWorkers = 3;
+    constexpr float JobTimeSmoothing = 0.1f;
+    constexpr float ClusterSizeInNodes = 16.0f;
+    constexpr int FlowFieldNodesPerFrame = 4096;
+
+    game::NavigationSystem::PathJobResult RunPathJob(
+        const game::NavmeshContext& navmesh, const game::NavmeshHierarchy& hierarchy, const game::NavigationSystem::PathJob& job)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+        const auto start_time = Clock::now();
+
+        game::NavigationSystem::PathJobResult job_result;
+        job_result.ticket = job.ticket;
+        job_result.nodes_evaluated = 0;
+        job_result.path.result = game::AStarResult::FAILED;
+
+        const int start_index = game::FindClosestIndex(navmesh, job.start);
+        const int end_index = game::FindClosestIndex(navmesh, job.end);
+
+        game::NavigationResult nav_path;
+        nav_path.result = game::AStarResult::FAILED;
+        nav_path.nodes_evaluated = 0;
+
+        if(!game::IsShortPath(hierarchy, start_index, end_index))
+            nav_path = game::HierarchicalAStar(navmesh, hierarchy, start_index, end_index);
+
+        if(nav_path.result != game::AStarResult::SUCCESS)
+        {
+            const int hierarchical_nodes_evaluated = nav_path.nodes_evaluated;
+            nav_path = game::AStar(navmesh, start_index, end_index);
+            nav_path.nodes_evaluated += hierarchical_nodes_evaluated;
+        }
+
+        job_result.path.result = nav_path.result;
+        job_result.nodes_evaluated = nav_path.nodes_evaluated;
+
+        if(nav_path.result == game::AStarResult::SUCCESS && nav_path.path_indices.empty())
+        {
+            job_result.path.result = game::AStarResult::FAILED;
+        }
+        else if(nav_path.result == game::AStarResult::SUCCESS)
+        {
+            job_result.path.nav_points = game::PathToPoints(navmesh, nav_path.path_indices);
+
+            // Replace the first navmesh node position with current position, this creates a much better start and when updating a path.
+            job_result.path.nav_points.front() = job.start;
+        }
+
+        const std::chrono::duration<float, std::milli> delta = Clock::now() - start_time;
+        job_result.time_ms = delta.count();
+
+        return job_result;
+    }
 }
 
 using namespace game;
 
 NavigationSystem::NavigationSystem()
+    : m_timestamp(0)
+    , m_next_ticket(InvalidPathTicket + 1)
+    , m_stop(false)
+    , m_jobs_in_flight(0)
+    , m_average_job_ms(FindPathBudgetMs)
+    , m_dispatched_ms_this_frame(0.0f)
 {
     m_current_path_index = 0;
     m_recent_paths.resize(NumRecentPaths);
     m_findpath_this_frame = 0;
+    m_findpath_time_this_frame = 0.0f;
+
+    // With a single core the jobs are run on the game thread in Sync instead.
+    const uint32_t n_cores = std::thread::hardware_concurrency();
+    const uint32_t n_workers = (n_cores > 1) ? std::min(n_cores - 1, MaxPathWorkers) : 0;
+
+    for(uint32_t index = 0; index < n_workers; ++index)
+        m_workers.emplace_back(&NavigationSystem::WorkerFunc, this);
+}
+
+NavigationSystem::~NavigationSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_job_mutex);
+        m_stop = true;
+    }
+    m_job_signal.notify_all();
+
+    for(std::thread& worker : m_workers)
+        worker.join();
 }
 
 const char* NavigationSystem::Name() const
@@ -30,36 +117,135 @@ const char* NavigationSystem::Name() const
 
 void NavigationSystem::Reset()
 {
+    CancelAllPaths();
+    m_flow_fields.clear();
+
     m_navmesh.points.clear();
     m_navmesh.nodes.clear();
+    m_navmesh.grid = NavmeshGrid();
+    m_hierarchy = NavmeshHierarchy();
 }
 
 void NavigationSystem::Update(const mono::UpdateContext& update_context)
 {
     m_timestamp = update_context.timestamp;
+
+    for(auto& [target_id, flow_field_target] : m_flow_fields)
+    {
+        FlowFieldBuilder& builder = flow_field_target.builder;
+        if(builder.finished)
+            continue;
+
+        const bool finished = game::ContinueFlowField(m_navmesh, builder, FlowFieldNodesPerFrame);
+        if(finished)
+            std::swap(flow_field_target.field, builder.field);
+    }
 }
 
 void NavigationSystem::Sync()
 {
     m_findpath_this_frame = 0;
+
+    if(m_workers.empty())
+    {
+        // No workers, run as many jobs as the budget allows and leave the rest for the coming frames.
+        while(!m_requested_jobs.empty() && m_findpath_time_this_frame < FindPathBudgetMs)
+        {
+            const PathJob job = m_requested_jobs.front();
+            m_requested_jobs.pop_front();
+
+            PathJobResult job_result = RunPathJob(m_navmesh, m_hierarchy, job);
+            m_findpath_time_this_frame += job_result.time_ms;
+            DeliverPathResult(job_result);
+        }
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_job_mutex);
+            std::move(m_finished_jobs.begin(), m_finished_jobs.end(), std::back_inserter(m_deliver_jobs));
+            m_finished_jobs.clear();
+        }
+
+        // Results are delivered until the frame budget is spent, the rest are kept in order for the next frame.
+        using Clock = std::chrono::high_resolution_clock;
+        const auto deliver_start = Clock::now();
+
+        size_t n_delivered = 0;
+        while(n_delivered < m_deliver_jobs.size())
+        {
+            PathJobResult& job_result = m_deliver_jobs[n_delivered++];
+            m_average_job_ms += (job_result.time_ms - m_average_job_ms) * JobTimeSmoothing;
+            DeliverPathResult(job_result);
+
+            const std::chrono::duration<float, std::milli> elapsed = Clock::now() - deliver_start;
+            if(elapsed.count() >= FindPathBudgetMs)
+                break;
+        }
+
+        m_deliver_jobs.erase(m_deliver_jobs.begin(), m_deliver_jobs.begin() + n_delivered);
+
+        m_dispatched_ms_this_frame = 0.0f;
+        DispatchPathJobs();
+    }
+
+    m_findpath_time_this_frame = 0.0f;
 }
 
-void NavigationSystem::SetupNavmesh(const math::Vector& start, const math::Vector& end, float density, mono::PhysicsSpace* physics_space)
+void NavigationSystem::DispatchPathJobs()
 {
-    m_navmesh.points = game::GenerateMeshPoints(start, end, density);
+    // Each worker gets about a frame budget of searching per frame, estimated from the time of the recent jobs.
+    const float dispatch_budget_ms = FindPathBudgetMs * m_workers.size();
+    uint32_t n_dispatched = 0;
 
-    const auto remove_on_collision = [physics_space](const math::Vector& point) {
-        const mono::QueryResult query_result = physics_space->QueryNearest(point, 0.0f, game::CollisionCategory::STATIC);
-        return query_result.body != nullptr;
-    };
-    mono::remove_if(m_navmesh.points, remove_on_collision);
+    {
+        std::lock_guard<std::mutex> lock(m_job_mutex);
+        while(!m_requested_jobs.empty() && m_dispatched_ms_this_frame < dispatch_budget_ms)
+        {
+            m_pending_jobs.push_back(m_requested_jobs.front());
+            m_requested_jobs.pop_front();
+            m_dispatched_ms_this_frame += m_average_job_ms;
+            n_dispatched++;
+        }
+    }
 
-    const auto filter_connection_func = [physics_space](const math::Vector& first, const math::Vector& second){
-        const mono::QueryResult query_result = physics_space->QueryFirst(first, second, game::CollisionCategory::STATIC);
-        return query_result.body != nullptr;
-    };
+    if(n_dispatched > 0)
+        m_job_signal.notify_all();
+}
+
+void NavigationSystem::SetupNavmesh(
+    const math::Vector& start, const math::Vector& end, float density, mono::PhysicsSpace* physics_space, const char* world_file)
+{
+    CancelAllPaths();
+    m_flow_fields.clear();
+
+    const std::string cache_file = std::string(world_file) + ".navmesh";
+    const uint64_t cache_key = game::MakeNavmeshCacheKey(world_file, start, end, density);
+
+    const bool cache_loaded = game::ReadNavmeshCache(cache_file.c_str(), cache_key, m_navmesh);
+    if(!cache_loaded)
+    {
+        System::Log("NavigationSystem|Baking navmesh for '%s'.", world_file);
 
-    m_navmesh.nodes = game::GenerateMeshNodes(m_navmesh.points, density * 1.5f, filter_connection_func);
+        m_navmesh.points = game::GenerateMeshPoints(start, end, density);
+
+        const auto remove_on_collision = [physics_space](const math::Vector& point) {
+            const mono::QueryResult query_result = physics_space->QueryNearest(point, 0.0f, game::CollisionCategory::STATIC);
+            return query_result.body != nullptr;
+        };
+        mono::remove_if(m_navmesh.points, remove_on_collision);
+
+        const auto filter_connection_func = [physics_space](const math::Vector& first, const math::Vector& second){
+            const mono::QueryResult query_result = physics_space->QueryFirst(first, second, game::CollisionCategory::STATIC);
+            return query_result.body != nullptr;
+        };
+
+        m_navmesh.nodes = game::GenerateMeshNodes(m_navmesh.points, density * 1.5f, filter_connection_func);
+        game::WriteNavmeshCache(cache_file.c_str(), cache_key, m_navmesh);
+    }
+
+    m_navmesh.grid = game::GenerateMeshGrid(m_navmesh.points, density);
+    m_hierarchy = game::GenerateNavmeshHierarchy(m_navmesh, density * ClusterSizeInNodes);
 }
 
 const NavmeshContext* NavigationSystem::GetNavmeshContext() const
@@ -67,50 +253,215 @@ const NavmeshContext* NavigationSystem::GetNavmeshContext() const
     return &m_navmesh;
 }
 
-FindPathResult NavigationSystem::FindPath(const math::Vector& start_position, const math::Vector& end_position)
+const NavmeshHierarchy* NavigationSystem::GetNavmeshHierarchy() const
 {
-    FindPathResult find_path_result;
-    find_path_result.result = AStarResult::FAILED;
+    return &m_hierarchy;
+}
 
-    if(m_findpath_this_frame == NumRecentPaths)
+FindPathResult NavigationSystem::FindPath(const math::Vector& start_position, const math::Vector& end_position)
+{
+    if(m_findpath_time_this_frame >= FindPathBudgetMs)
+    {
+        FindPathResult find_path_result;
+        find_path_result.result = AStarResult::FAILED;
         return find_path_result;
-    
+    }
+
     m_findpath_this_frame++;
-    
-    RecentPath& recent_path = m_recent_paths[m_current_path_index % NumRecentPaths];
 
-    {
-        const auto timer_callback = [&recent_path](float delta_ms) {
-            recent_path.time_ms = delta_ms;
-        };
-        SCOPED_TIMER_AUTO_CB(timer_callback);
+    const PathJob job = { InvalidPathTicket, start_position, end_position };
+    PathJobResult job_result = RunPathJob(m_navmesh, m_hierarchy, job);
+    m_findpath_time_this_frame += job_result.time_ms;
+
+    if(job_result.path.result == AStarResult::SUCCESS)
+        StoreRecentPath(job_result);
 
-        const game::NavigationResult& nav_path = game::AStar(m_navmesh, start_position, end_position);
-        find_path_result.result = nav_path.result;
+    return std::move(job_result.path);
+}
+
+uint32_t NavigationSystem::RequestPath(uint32_t requester_id, const math::Vector& start, const math::Vector& end)
+{
+    const uint32_t ticket = m_next_ticket++;
+    if(m_next_ticket == InvalidPathTicket)
+        m_next_ticket++;
 
-        if(nav_path.result == AStarResult::FAILED || nav_path.result == AStarResult::NO_PATH)
-            return find_path_result;
-        else if(nav_path.result == AStarResult::SUCCESS && nav_path.path_indices.empty())
-            return find_path_result;
+    PathTicket& path_ticket = m_tickets[ticket];
+    path_ticket.requester_id = requester_id;
+    path_ticket.finished = false;
+    path_ticket.result.result = AStarResult::FAILED;
 
-        MONO_ASSERT(!nav_path.path_indices.empty());
+    m_requested_jobs.push_back({ ticket, start, end });
+    if(!m_workers.empty())
+        DispatchPathJobs();
+
+    return ticket;
+}
+
+bool NavigationSystem::IsPathPending(uint32_t ticket) const
+{
+    const auto it = m_tickets.find(ticket);
+    return (it != m_tickets.end() && !it->second.finished);
+}
+
+bool NavigationSystem::TakePathResult(uint32_t ticket, FindPathResult& out_result)
+{
+    const auto it = m_tickets.find(ticket);
+    if(it == m_tickets.end() || !it->second.finished)
+        return false;
+
+    out_result = std::move(it->second.result);
+    m_tickets.erase(it);
+
+    return true;
+}
+
+void NavigationSystem::CancelPath(uint32_t ticket)
+{
+    const size_t n_erased = m_tickets.erase(ticket);
+    if(n_erased == 0)
+        return;
 
-        recent_path.timestamp = m_timestamp;
-        recent_path.nodes_evaluated = nav_path.nodes_evaluated;
-        recent_path.points = game::PathToPoints(m_navmesh, nav_path.path_indices);
+    // Results for tickets that are in flight are discarded in Sync.
+    const auto remove_job = [ticket](const PathJob& job) {
+        return job.ticket == ticket;
+    };
+    m_requested_jobs.erase(std::remove_if(m_requested_jobs.begin(), m_requested_jobs.end(), remove_job), m_requested_jobs.end());
+
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_pending_jobs.erase(std::remove_if(m_pending_jobs.begin(), m_pending_jobs.end(), remove_job), m_pending_jobs.end());
+}
+
+void NavigationSystem::CancelPaths(uint32_t requester_id)
+{
+    std::vector<uint32_t> tickets_to_cancel;
+
+    for(const auto& [ticket, path_ticket] : m_tickets)
+    {
+        if(path_ticket.requester_id == requester_id)
+            tickets_to_cancel.push_back(ticket);
     }
 
-    if (!recent_path.points.empty())
+    for(uint32_t ticket : tickets_to_cancel)
+        CancelPath(ticket);
+}
+
+void NavigationSystem::WorkerFunc()
+{
+    while(true)
     {
-        // Replace the first navmesh node position with current position, this creates a much better start and when updating a path.
-        recent_path.points.front() = start_position;
+        PathJob job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_job_mutex);
+            m_job_signal.wait(lock, [this] { return m_stop || !m_pending_jobs.empty(); });
+            if(m_stop)
+                return;
+
+            job = m_pending_jobs.front();
+            m_pending_jobs.pop_front();
+            m_jobs_in_flight++;
+        }
+
+        // The navmesh is immutable while there are jobs in flight, see CancelAllPaths.
+        PathJobResult job_result = RunPathJob(m_navmesh, m_hierarchy, job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_job_mutex);
+            m_finished_jobs.push_back(std::move(job_result));
+            m_jobs_in_flight--;
+        }
+        m_idle_signal.notify_all();
     }
+}
 
-    find_path_result.nav_points = recent_path.points;
+void NavigationSystem::CancelAllPaths()
+{
+    m_tickets.clear();
+    m_requested_jobs.clear();
+    m_deliver_jobs.clear();
+
+    std::unique_lock<std::mutex> lock(m_job_mutex);
+    m_pending_jobs.clear();
+    m_idle_signal.wait(lock, [this] { return m_jobs_in_flight == 0; });
+    m_finished_jobs.clear();
+}
+
+void NavigationSystem::DeliverPathResult(PathJobResult& job_result)
+{
+    // Cancelled while in flight
+    const auto it = m_tickets.find(job_result.ticket);
+    if(it == m_tickets.end())
+        return;
+
+    m_findpath_this_frame++;
+
+    if(job_result.path.result == AStarResult::SUCCESS)
+        StoreRecentPath(job_result);
+
+    it->second.finished = true;
+    it->second.result = std::move(job_result.path);
+}
+
+void NavigationSystem::StoreRecentPath(const PathJobResult& job_result)
+{
+    RecentPath& recent_path = m_recent_paths[m_current_path_index % NumRecentPaths];
+    recent_path.timestamp = m_timestamp;
+    recent_path.time_ms = job_result.time_ms;
+    recent_path.nodes_evaluated = job_result.nodes_evaluated;
+    recent_path.points = job_result.path.nav_points;
 
     m_current_path_index++;
+}
+
+void NavigationSystem::SetFlowFieldTarget(uint32_t target_id, const math::Vector& target_position)
+{
+    if(m_navmesh.nodes.empty())
+        return;
+
+    const auto it = m_flow_fields.find(target_id);
+    if(it == m_flow_fields.end())
+    {
+        // First time, calculate the whole field so that it can be sampled right away.
+        m_flow_fields[target_id].field = game::CalculateFlowField(m_navmesh, target_position);
+        return;
+    }
+
+    FlowFieldTarget& flow_field_target = it->second;
+    flow_field_target.field.target_position = target_position;
+
+    // Keep the current field while the new one is built, a moving target is picked up when that one is done.
+    if(!flow_field_target.builder.finished)
+        return;
+
+    const int target_index = game::FindClosestIndex(m_navmesh, target_position);
+    if(target_index != flow_field_target.field.target_index)
+        game::BeginFlowField(m_navmesh, target_position, flow_field_target.builder);
+}
+
+void NavigationSystem::RemoveFlowFieldTarget(uint32_t target_id)
+{
+    m_flow_fields.erase(target_id);
+}
+
+bool NavigationSystem::SampleFlowField(
+    uint32_t target_id, const math::Vector& position, math::Vector& out_direction, float& out_distance) const
+{
+    const auto it = m_flow_fields.find(target_id);
+    if(it == m_flow_fields.end())
+        return false;
+
+    return game::SampleFlowField(m_navmesh, it->second.field, position, out_direction, out_distance);
+}
+
+std::vector<const FlowField*> NavigationSystem::GetFlowFields() const
+{
+    std::vector<const FlowField*> flow_fields;
+    flow_fields.reserve(m_flow_fields.size());
+
+    for(const auto& [target_id, flow_field_target] : m_flow_fields)
+        flow_fields.push_back(&flow_field_target.field);
 
-    return find_path_result;
+    return flow_fields;
 }
 
 const std::vector<RecentPath>& NavigationSystem::GetRecentPaths() const
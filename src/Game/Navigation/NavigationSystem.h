@@ -4,8 +4,17 @@
 #include "IGameSystem.h"
 #include "NavMesh.h"
 #include "NavmeshData.h"
+#include "NavmeshHierarchy.h"
+#include "FlowField.h"
 #include "Physics/PhysicsFwd.h"
 
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 namespace game
 {
     struct RecentPath
@@ -22,30 +31,111 @@ namespace game
         std::vector<math::Vector> nav_points;
     };
 
+    constexpr uint32_t InvalidPathTicket = 0;
+
     class NavigationSystem : public mono::IGameSystem
     {
     public:
 
         NavigationSystem();
+        ~NavigationSystem();
+
         const char* Name() const override;
         void Reset() override;
         void Update(const mono::UpdateContext& update_context) override;
         void Sync() override;
 
-        void SetupNavmesh(const math::Vector& start, const math::Vector& end, float density, mono::PhysicsSpace* physics_space);
+        // The baked navmesh is cached in a file next to the world file and only rebuilt when the world or the navmesh settings change.
+        void SetupNavmesh(
+            const math::Vector& start, const math::Vector& end, float density, mono::PhysicsSpace* physics_space, const char* world_file);
         const NavmeshContext* GetNavmeshContext() const;
+        const NavmeshHierarchy* GetNavmeshHierarchy() const;
+
+        // Synchronous path finding, limited by the per frame time budget. Long paths are searched on
+        // the navmesh hierarchy first, with a fallback to a search on the full navmesh.
         FindPathResult FindPath(const math::Vector& start, const math::Vector& end);
+
+        // Asynchronous path finding, the search is run on a worker thread and the result is delivered in Sync.
+        // Requests are handed to the workers and results delivered within the per frame time budget, the rest
+        // wait for the coming frames.
+        // The requester id is usually the entity id and is used to cancel all requests for that requester.
+        uint32_t RequestPath(uint32_t requester_id, const math::Vector& start, const math::Vector& end);
+        bool IsPathPending(uint32_t ticket) const;
+        bool TakePathResult(uint32_t ticket, FindPathResult& out_result);
+        void CancelPath(uint32_t ticket);
+        void CancelPaths(uint32_t requester_id);
+
+        // Flow fields are shared by all agents chasing the same target, the field is rebuilt over a few
+        // frames when the target moves to another navmesh node. Call every frame with the current position.
+        void SetFlowFieldTarget(uint32_t target_id, const math::Vector& target_position);
+        void RemoveFlowFieldTarget(uint32_t target_id);
+        bool SampleFlowField(uint32_t target_id, const math::Vector& position, math::Vector& out_direction, float& out_distance) const;
+        std::vector<const FlowField*> GetFlowFields() const;
+
         const std::vector<RecentPath>& GetRecentPaths() const;
         int GetNumFindPath() const;
 
+        struct PathJob
+        {
+            uint32_t ticket;
+            math::Vector start;
+            math::Vector end;
+        };
+
+        struct PathJobResult
+        {
+            uint32_t ticket;
+            float time_ms;
+            int nodes_evaluated;
+            FindPathResult path;
+        };
+
     private:
 
+        void WorkerFunc();
+        void CancelAllPaths();
+        void DispatchPathJobs();
+        void DeliverPathResult(PathJobResult& job_result);
+        void StoreRecentPath(const PathJobResult& job_result);
+
         NavmeshContext m_navmesh;
+        NavmeshHierarchy m_hierarchy;
         uint32_t m_timestamp;
 
         int m_current_path_index;
         std::vector<RecentPath> m_recent_paths;
 
         int m_findpath_this_frame;
+        float m_findpath_time_this_frame;
+
+        struct PathTicket
+        {
+            uint32_t requester_id;
+            bool finished;
+            FindPathResult result;
+        };
+
+        struct FlowFieldTarget
+        {
+            FlowField field;
+            FlowFieldBuilder builder;
+        };
+        std::unordered_map<uint32_t, FlowFieldTarget> m_flow_fields;
+
+        uint32_t m_next_ticket;
+        std::unordered_map<uint32_t, PathTicket> m_tickets;
+
+        bool m_stop;
+        int m_jobs_in_flight;
+        std::mutex m_job_mutex;
+        std::condition_variable m_job_signal;
+        std::condition_variable m_idle_signal;
+        std::deque<PathJob> m_pending_jobs;
+        std::deque<PathJob> m_requested_jobs;
+        float m_average_job_ms;
+        float m_dispatched_ms_this_frame;
+        std::vector<PathJobResult> m_finished_jobs;
+        std::vector<PathJobResult> m_deliver_jobs;
+        std::vector<std::thread> m_workers;
     };
 }
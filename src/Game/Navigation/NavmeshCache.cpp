@@ -0,0 +1,106 @@
+
+#include "NavmeshCache.h"
+#include "FileHash.h"
+#include "MappedFile.h"
+#include "System/File.h"
+#include "System/System.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    constexpr uint32_t NavmeshCacheMagic = 0x4E41564D; // 'NAVM'
+    constexpr uint32_t NavmeshCacheVersion = 1;
+
+    struct NavmeshCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t cache_key;
+        uint32_t n_points;
+        uint32_t n_nodes;
+    };
+
+    static_assert(sizeof(math::Vector) == sizeof(float) * 2);
+    static_assert(sizeof(game::NavmeshNode) == sizeof(int) * 9);
+
+    using BinaryFilePtr = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+    BinaryFilePtr OpenBinaryFile(const char* filename, const char* mode)
+    {
+        return BinaryFilePtr(std::fopen(filename, mode), &std::fclose);
+    }
+}
+
+uint64_t game::MakeNavmeshCacheKey(const char* world_file, const math::Vector& start, const math::Vector& end, float density)
+{
+    uint64_t hash = game::Fnv1aOffsetBasis;
+    game::HashFile(world_file, hash, hash);
+
+    const float metadata[] = { start.x, start.y, end.x, end.y, density };
+    hash = game::HashBytes(metadata, sizeof(metadata), hash);
+    hash = game::HashBytes(&NavmeshCacheVersion, sizeof(NavmeshCacheVersion), hash);
+
+    return hash;
+}
+
+bool game::ReadNavmeshCache(const char* cache_file, uint64_t cache_key, NavmeshContext& out_context)
+{
+    // Mapped instead of read, the arrays are copied straight out of the mapping.
+    MappedFile file;
+    if(!file.Open(cache_file))
+        return false;
+
+    if(file.Size() < sizeof(NavmeshCacheHeader))
+        return false;
+
+    NavmeshCacheHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    if(header.magic != NavmeshCacheMagic || header.version != NavmeshCacheVersion || header.cache_key != cache_key)
+        return false;
+
+    const size_t points_size = header.n_points * sizeof(math::Vector);
+    const size_t nodes_size = header.n_nodes * sizeof(NavmeshNode);
+    if(file.Size() != sizeof(header) + points_size + nodes_size)
+    {
+        System::Log("NavmeshCache|Unexpected size of '%s', ignoring it.", cache_file);
+        return false;
+    }
+
+    const unsigned char* points_data = file.Data() + sizeof(header);
+    const unsigned char* nodes_data = points_data + points_size;
+
+    out_context.points.resize(header.n_points);
+    std::memcpy(out_context.points.data(), points_data, points_size);
+
+    out_context.nodes.resize(header.n_nodes);
+    std::memcpy(out_context.nodes.data(), nodes_data, nodes_size);
+
+    return true;
+}
+
+bool game::WriteNavmeshCache(const char* cache_file, uint64_t cache_key, const NavmeshContext& context)
+{
+    BinaryFilePtr file = OpenBinaryFile(cache_file, "wb");
+    if(!file)
+    {
+        System::Log("NavmeshCache|Unable to write navmesh cache '%s'.", cache_file);
+        return false;
+    }
+
+    NavmeshCacheHeader header;
+    header.magic = NavmeshCacheMagic;
+    header.version = NavmeshCacheVersion;
+    header.cache_key = cache_key;
+    header.n_points = context.points.size();
+    header.n_nodes = context.nodes.size();
+
+    std::fwrite(&header, sizeof(header), 1, file.get());
+    std::fwrite(context.points.data(), sizeof(math::Vector), context.points.size(), file.get());
+    std::fwrite(context.nodes.data(), sizeof(NavmeshNode), context.nodes.size(), file.get());
+
+    return true;
+}
@@ -0,0 +1,14 @@
+
+#pragma once
+
+#include "NavmeshData.h"
+#include <cstdint>
+
+namespace game
+{
+    // Baked navmesh points and nodes stored next to the world file. The key is a hash of the world file
+    // (where all the static geometry comes from) and the navmesh metadata, a cache with another key is stale.
+    uint64_t MakeNavmeshCacheKey(const char* world_file, const math::Vector& start, const math::Vector& end, float density);
+    bool ReadNavmeshCache(const char* cache_file, uint64_t cache_key, NavmeshContext& out_context);
+    bool WriteNavmeshCache(const char* cache_file, uint64_t cache_key, const NavmeshContext& context);
+}
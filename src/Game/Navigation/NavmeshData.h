@@ -13,12 +13,14 @@ namespace game
         DRAW_NAVMESH = 1,
         DRAW_RECENT_PATHS = 2,
         DRAW_INTERACTIVE_PATH = 4,
+        DRAW_FLOW_FIELDS = 8,
     };
 
     constexpr uint32_t all_navigation_debug_component[] = {
         NavigationDebugComponents::DRAW_NAVMESH,
         NavigationDebugComponents::DRAW_RECENT_PATHS,
         NavigationDebugComponents::DRAW_INTERACTIVE_PATH,
+        NavigationDebugComponents::DRAW_FLOW_FIELDS,
     };
 
     inline const char* NavigationDebugComponentToString(uint32_t debug_component)
@@ -33,6 +35,8 @@ namespace game
             return "Recent Paths";
         case DRAW_INTERACTIVE_PATH:
             return "Interactive Path";
+        case DRAW_FLOW_FIELDS:
+            return "Flow Fields";
         }
 
         return "Unknown";
@@ -44,9 +48,22 @@ namespace game
         int neighbours_index[8];
     };
 
+    // Uniform grid over the navmesh points, the point indices are bucketed per cell and
+    // cell_offsets[cell] to cell_offsets[cell + 1] is the range in point_indices for that cell.
+    struct NavmeshGrid
+    {
+        math::Vector origin;
+        float cell_size = 0.0f;
+        int width = 0;
+        int height = 0;
+        std::vector<int> cell_offsets;
+        std::vector<int> point_indices;
+    };
+
     struct NavmeshContext
     {
         std::vector<math::Vector> points;
         std::vector<NavmeshNode> nodes;
+        NavmeshGrid grid;
     };
 }
@@ -6,8 +6,11 @@
 
 namespace game
 {
+    // Returns true if the connection between the points should be discarded. The filter is expected to be symmetric,
+    // each pair of points is only tested once.
     using NavmeshConnectionFilter = std::function<bool (const math::Vector& first, const math::Vector& second)>;
 
     std::vector<math::Vector> GenerateMeshPoints(const math::Vector start, const math::Vector& end, float density);
+    NavmeshGrid GenerateMeshGrid(const std::vector<math::Vector>& points, float cell_size);
     std::vector<NavmeshNode> GenerateMeshNodes(const std::vector<math::Vector>& points, float connection_distance, const NavmeshConnectionFilter& filter_function);
 }
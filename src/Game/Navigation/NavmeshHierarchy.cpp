@@ -0,0 +1,559 @@
+
+#include "NavmeshHierarchy.h"
+#include "Math/MathFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <thread>
+
+namespace
+{
+    float EdgeCost(const game::NavmeshContext& context, int from, int to)
+    {
+        return math::DistanceBetween(context.points[from], context.points[to]);
+    }
+
+    bool IsNeighbour(const game::NavmeshContext& context, int from, int to)
+    {
+        const game::NavmeshNode& node = context.nodes[from];
+        return std::find(std::begin(node.neighbours_index), std::end(node.neighbours_index), to) != std::end(node.neighbours_index);
+    }
+
+    int ClusterCoordinate(float value, float origin, float cluster_size, int n_clusters)
+    {
+        const int cluster = int(std::floor((value - origin) / cluster_size));
+        return std::clamp(cluster, 0, n_clusters - 1);
+    }
+
+    using HeapEntry = std::pair<float, int>;
+
+    // Scratch memory for searches restricted to a cluster, kept per thread and invalidated with a generation stamp.
+    struct LocalSearch
+    {
+        uint32_t generation = 0;
+        std::vector<uint32_t> stamps;
+        std::vector<float> g_score;
+        std::vector<int> came_from;
+        std::vector<HeapEntry> open_heap;
+
+        void Prepare(size_t n_nodes)
+        {
+            if(stamps.size() < n_nodes)
+            {
+                stamps.resize(n_nodes, 0);
+                g_score.resize(n_nodes, math::INF);
+                came_from.resize(n_nodes, -1);
+            }
+
+            generation++;
+            if(generation == 0)
+            {
+                std::fill(stamps.begin(), stamps.end(), 0);
+                generation = 1;
+            }
+
+            open_heap.clear();
+        }
+
+        float G(int index) const
+        {
+            return (stamps[index] == generation) ? g_score[index] : math::INF;
+        }
+
+        void Set(int index, float g, int from)
+        {
+            stamps[index] = generation;
+            g_score[index] = g;
+            came_from[index] = from;
+        }
+
+        void Push(float f, int index)
+        {
+            open_heap.emplace_back(f, index);
+            std::push_heap(open_heap.begin(), open_heap.end(), std::greater<HeapEntry>());
+        }
+
+        HeapEntry Pop()
+        {
+            std::pop_heap(open_heap.begin(), open_heap.end(), std::greater<HeapEntry>());
+            const HeapEntry entry = open_heap.back();
+            open_heap.pop_back();
+            return entry;
+        }
+    };
+
+    thread_local LocalSearch g_local_search;
+
+    // Search from start_index restricted to the nodes in the cluster. With a goal index the search stops
+    // at the goal, otherwise the distance to all reachable nodes in the cluster is calculated.
+    // Returns the number of nodes evaluated.
+    int ClusterSearch(
+        const game::NavmeshContext& context,
+        const game::NavmeshHierarchy& hierarchy,
+        int cluster,
+        int start_index,
+        int goal_index,
+        LocalSearch& search)
+    {
+        search.Prepare(context.nodes.size());
+        search.Set(start_index, 0.0f, -1);
+        search.Push(0.0f, start_index);
+
+        const auto heuristics = [&](int index) {
+            return (goal_index != -1) ? EdgeCost(context, index, goal_index) : 0.0f;
+        };
+
+        int nodes_evaluated = 0;
+
+        while(!search.open_heap.empty())
+        {
+            const auto [f_score, current_index] = search.Pop();
+            const float current_g = search.G(current_index);
+
+            // Stale entry, the node has been reached with a lower score after this was pushed.
+            if(f_score > current_g + heuristics(current_index))
+                continue;
+
+            nodes_evaluated++;
+
+            if(current_index == goal_index)
+                break;
+
+            for(int neighbour_index : context.nodes[current_index].neighbours_index)
+            {
+                if(neighbour_index == -1 || hierarchy.node_cluster[neighbour_index] != cluster)
+                    continue;
+
+                const float tentative_g = current_g + EdgeCost(context, current_index, neighbour_index);
+                if(tentative_g >= search.G(neighbour_index))
+                    continue;
+
+                search.Set(neighbour_index, tentative_g, current_index);
+                search.Push(tentative_g + heuristics(neighbour_index), neighbour_index);
+            }
+        }
+
+        return nodes_evaluated;
+    }
+
+    int GetOrAddAbstractNode(game::NavmeshHierarchy& hierarchy, int navmesh_index)
+    {
+        int& abstract_index = hierarchy.node_to_abstract[navmesh_index];
+        if(abstract_index == -1)
+        {
+            abstract_index = hierarchy.abstract_nodes.size();
+
+            game::NavmeshHierarchy::AbstractNode abstract_node;
+            abstract_node.navmesh_index = navmesh_index;
+            abstract_node.cluster = hierarchy.node_cluster[navmesh_index];
+            hierarchy.abstract_nodes.push_back(abstract_node);
+            hierarchy.cluster_entrances[abstract_node.cluster].push_back(abstract_index);
+        }
+
+        return abstract_index;
+    }
+
+    void AddAbstractEdge(game::NavmeshHierarchy& hierarchy, int from, int to, float cost)
+    {
+        std::vector<game::NavmeshHierarchy::AbstractEdge>& edges = hierarchy.abstract_nodes[from].edges;
+        for(const game::NavmeshHierarchy::AbstractEdge& edge : edges)
+        {
+            if(edge.to == to)
+                return;
+        }
+
+        edges.push_back({ to, cost });
+    }
+
+    struct AbstractSearch
+    {
+        std::vector<float> g_score;
+        std::vector<int> came_from;
+        std::vector<bool> closed;
+        std::vector<HeapEntry> open_heap;
+    };
+
+    thread_local AbstractSearch g_abstract_search;
+}
+
+game::NavmeshHierarchy game::GenerateNavmeshHierarchy(const NavmeshContext& context, float cluster_size)
+{
+    NavmeshHierarchy hierarchy;
+    if(context.points.empty() || context.nodes.empty() || cluster_size <= 0.0f)
+        return hierarchy;
+
+    math::Vector min_point = context.points.front();
+    math::Vector max_point = context.points.front();
+
+    for(const math::Vector& point : context.points)
+    {
+        min_point.x = std::min(min_point.x, point.x);
+        min_point.y = std::min(min_point.y, point.y);
+        max_point.x = std::max(max_point.x, point.x);
+        max_point.y = std::max(max_point.y, point.y);
+    }
+
+    hierarchy.origin = min_point;
+    hierarchy.cluster_size = cluster_size;
+    hierarchy.clusters_width = int((max_point.x - min_point.x) / cluster_size) + 1;
+    hierarchy.clusters_height = int((max_point.y - min_point.y) / cluster_size) + 1;
+    hierarchy.cluster_entrances.resize(hierarchy.clusters_width * hierarchy.clusters_height);
+    hierarchy.node_to_abstract.resize(context.nodes.size(), -1);
+    hierarchy.node_cluster.reserve(context.nodes.size());
+
+    for(const math::Vector& point : context.points)
+    {
+        const int cluster_x = ClusterCoordinate(point.x, hierarchy.origin.x, cluster_size, hierarchy.clusters_width);
+        const int cluster_y = ClusterCoordinate(point.y, hierarchy.origin.y, cluster_size, hierarchy.clusters_height);
+        hierarchy.node_cluster.push_back(cluster_y * hierarchy.clusters_width + cluster_x);
+    }
+
+    // Collect the border nodes for each pair of connected clusters.
+    std::map<std::pair<int, int>, std::vector<int>> border_nodes;
+
+    for(uint32_t index = 0; index < context.nodes.size(); ++index)
+    {
+        const int cluster = hierarchy.node_cluster[index];
+        for(int neighbour_index : context.nodes[index].neighbours_index)
+        {
+            if(neighbour_index == -1)
+                continue;
+
+            const int neighbour_cluster = hierarchy.node_cluster[neighbour_index];
+            if(neighbour_cluster > cluster)
+                border_nodes[{ cluster, neighbour_cluster }].push_back(index);
+        }
+    }
+
+    // Each connected run of border nodes is one entrance, the node closest to the middle of the run
+    // and its neighbour on the other side becomes the abstract nodes.
+    std::vector<int> run;
+    std::vector<bool> visited;
+
+    for(auto& [cluster_pair, nodes] : border_nodes)
+    {
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+        const auto border_index = [&nodes](int navmesh_index) {
+            const auto it = std::lower_bound(nodes.begin(), nodes.end(), navmesh_index);
+            return (it != nodes.end() && *it == navmesh_index) ? int(std::distance(nodes.begin(), it)) : -1;
+        };
+
+        visited.assign(nodes.size(), false);
+
+        for(uint32_t node_index = 0; node_index < nodes.size(); ++node_index)
+        {
+            if(visited[node_index])
+                continue;
+
+            run.clear();
+            run.push_back(nodes[node_index]);
+            visited[node_index] = true;
+
+            for(uint32_t run_index = 0; run_index < run.size(); ++run_index)
+            {
+                for(int neighbour_index : context.nodes[run[run_index]].neighbours_index)
+                {
+                    const int neighbour_border_index = (neighbour_index != -1) ? border_index(neighbour_index) : -1;
+                    if(neighbour_border_index != -1 && !visited[neighbour_border_index])
+                    {
+                        visited[neighbour_border_index] = true;
+                        run.push_back(neighbour_index);
+                    }
+                }
+            }
+
+            math::Vector center;
+            for(int run_node : run)
+                center += context.points[run_node];
+            center = center / float(run.size());
+
+            const auto closest_to_center = [&](int first, int second) {
+                return math::DistanceBetweenSquared(context.points[first], center) < math::DistanceBetweenSquared(context.points[second], center);
+            };
+            const int entrance_index = *std::min_element(run.begin(), run.end(), closest_to_center);
+
+            int other_side_index = -1;
+            float other_side_cost = math::INF;
+
+            for(int neighbour_index : context.nodes[entrance_index].neighbours_index)
+            {
+                if(neighbour_index == -1 || hierarchy.node_cluster[neighbour_index] != cluster_pair.second)
+                    continue;
+
+                const float cost = EdgeCost(context, entrance_index, neighbour_index);
+                if(cost < other_side_cost)
+                {
+                    other_side_cost = cost;
+                    other_side_index = neighbour_index;
+                }
+            }
+
+            const int abstract_from = GetOrAddAbstractNode(hierarchy, entrance_index);
+            const int abstract_to = GetOrAddAbstractNode(hierarchy, other_side_index);
+            AddAbstractEdge(hierarchy, abstract_from, abstract_to, other_side_cost);
+            AddAbstractEdge(hierarchy, abstract_to, abstract_from, other_side_cost);
+        }
+    }
+
+    // Intra cluster distances between all entrances of a cluster. Each abstract node belongs to one cluster
+    // so the clusters can be processed in parallel without touching the same edge lists.
+    const auto calculate_intra_cluster_edges = [&context, &hierarchy](uint32_t first_cluster, uint32_t cluster_stride) {
+        LocalSearch& search = g_local_search;
+
+        for(uint32_t cluster = first_cluster; cluster < hierarchy.cluster_entrances.size(); cluster += cluster_stride)
+        {
+            const std::vector<int>& entrances = hierarchy.cluster_entrances[cluster];
+
+            for(int abstract_index : entrances)
+            {
+                ClusterSearch(context, hierarchy, cluster, hierarchy.abstract_nodes[abstract_index].navmesh_index, -1, search);
+
+                for(int other_abstract_index : entrances)
+                {
+                    if(other_abstract_index == abstract_index)
+                        continue;
+
+                    const float cost = search.G(hierarchy.abstract_nodes[other_abstract_index].navmesh_index);
+                    if(cost != math::INF)
+                        AddAbstractEdge(hierarchy, abstract_index, other_abstract_index, cost);
+                }
+            }
+        }
+    };
+
+    const uint32_t n_threads = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+    std::vector<std::thread> workers;
+    for(uint32_t index = 1; index < n_threads; ++index)
+        workers.emplace_back(calculate_intra_cluster_edges, index, n_threads);
+
+    calculate_intra_cluster_edges(0, n_threads);
+
+    for(std::thread& worker : workers)
+        worker.join();
+
+    return hierarchy;
+}
+
+game::HierarchicalPath game::FindHierarchicalPath(
+    const NavmeshContext& context, const NavmeshHierarchy& hierarchy, int start_index, int end_index)
+{
+    HierarchicalPath path;
+    path.result = AStarResult::FAILED;
+    path.nodes_evaluated = 0;
+    path.next_segment = 0;
+
+    if(hierarchy.node_cluster.empty() || start_index == -1 || end_index == -1)
+        return path;
+
+    if(start_index == end_index)
+    {
+        path.result = AStarResult::SUCCESS;
+        return path;
+    }
+
+    const int start_cluster = hierarchy.node_cluster[start_index];
+    const int end_cluster = hierarchy.node_cluster[end_index];
+
+    // Connect start and end to the entrances of their clusters
+    using TempEdge = std::pair<int, float>;
+    std::vector<TempEdge> start_edges;
+    std::vector<TempEdge> end_edges;
+    float direct_cost = math::INF;
+
+    LocalSearch& local_search = g_local_search;
+
+    path.nodes_evaluated += ClusterSearch(context, hierarchy, start_cluster, start_index, -1, local_search);
+    for(int abstract_index : hierarchy.cluster_entrances[start_cluster])
+    {
+        const float cost = local_search.G(hierarchy.abstract_nodes[abstract_index].navmesh_index);
+        if(cost != math::INF)
+            start_edges.emplace_back(abstract_index, cost);
+    }
+
+    if(start_cluster == end_cluster)
+        direct_cost = local_search.G(end_index);
+
+    path.nodes_evaluated += ClusterSearch(context, hierarchy, end_cluster, end_index, -1, local_search);
+    for(int abstract_index : hierarchy.cluster_entrances[end_cluster])
+    {
+        const float cost = local_search.G(hierarchy.abstract_nodes[abstract_index].navmesh_index);
+        if(cost != math::INF)
+            end_edges.emplace_back(abstract_index, cost);
+    }
+
+    // A* over the abstract nodes with start and end added last
+    const int n_abstract_nodes = hierarchy.abstract_nodes.size();
+    const int start_node = n_abstract_nodes;
+    const int end_node = n_abstract_nodes + 1;
+
+    AbstractSearch& search = g_abstract_search;
+    search.g_score.assign(n_abstract_nodes + 2, math::INF);
+    search.came_from.assign(n_abstract_nodes + 2, -1);
+    search.closed.assign(n_abstract_nodes + 2, false);
+    search.open_heap.clear();
+
+    const math::Vector& end_position = context.points[end_index];
+    const auto navmesh_index = [&](int node) {
+        if(node == start_node)
+            return start_index;
+        else if(node == end_node)
+            return end_index;
+        return hierarchy.abstract_nodes[node].navmesh_index;
+    };
+
+    const auto relax = [&](int from, int to, float cost) {
+        const float tentative_g = search.g_score[from] + cost;
+        if(search.closed[to] || tentative_g >= search.g_score[to])
+            return;
+
+        search.g_score[to] = tentative_g;
+        search.came_from[to] = from;
+
+        const float f_score = tentative_g + math::DistanceBetween(context.points[navmesh_index(to)], end_position);
+        search.open_heap.emplace_back(f_score, to);
+        std::push_heap(search.open_heap.begin(), search.open_heap.end(), std::greater<HeapEntry>());
+    };
+
+    search.g_score[start_node] = 0.0f;
+    search.open_heap.emplace_back(0.0f, start_node);
+
+    bool found_goal = false;
+
+    while(!search.open_heap.empty())
+    {
+        std::pop_heap(search.open_heap.begin(), search.open_heap.end(), std::greater<HeapEntry>());
+        const int current = search.open_heap.back().second;
+        search.open_heap.pop_back();
+
+        if(search.closed[current])
+            continue;
+
+        search.closed[current] = true;
+        path.nodes_evaluated++;
+
+        if(current == end_node)
+        {
+            found_goal = true;
+            break;
+        }
+
+        if(current == start_node)
+        {
+            for(const TempEdge& edge : start_edges)
+                relax(current, edge.first, edge.second);
+
+            if(direct_cost != math::INF)
+                relax(current, end_node, direct_cost);
+
+            continue;
+        }
+
+        for(const NavmeshHierarchy::AbstractEdge& edge : hierarchy.abstract_nodes[current].edges)
+            relax(current, edge.to, edge.cost);
+
+        if(hierarchy.abstract_nodes[current].cluster == end_cluster)
+        {
+            for(const TempEdge& edge : end_edges)
+            {
+                if(edge.first == current)
+                    relax(current, end_node, edge.second);
+            }
+        }
+    }
+
+    if(!found_goal)
+    {
+        path.result = AStarResult::NO_PATH;
+        return path;
+    }
+
+    for(int node = end_node; node != -1; node = search.came_from[node])
+    {
+        const int waypoint = navmesh_index(node);
+        if(path.waypoints.empty() || path.waypoints.back() != waypoint)
+            path.waypoints.push_back(waypoint);
+    }
+
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    path.result = AStarResult::SUCCESS;
+
+    return path;
+}
+
+bool game::RefineNextSegment(
+    const NavmeshContext& context, const NavmeshHierarchy& hierarchy, HierarchicalPath& path, std::vector<int>& out_path_indices)
+{
+    if(path.result != AStarResult::SUCCESS || path.next_segment + 1 >= path.waypoints.size())
+        return false;
+
+    const int from_index = path.waypoints[path.next_segment];
+    const int to_index = path.waypoints[path.next_segment + 1];
+
+    if(out_path_indices.empty() || out_path_indices.back() != from_index)
+        out_path_indices.push_back(from_index);
+
+    if(IsNeighbour(context, from_index, to_index))
+    {
+        out_path_indices.push_back(to_index);
+    }
+    else
+    {
+        LocalSearch& search = g_local_search;
+
+        const int cluster = hierarchy.node_cluster[from_index];
+        path.nodes_evaluated += ClusterSearch(context, hierarchy, cluster, from_index, to_index, search);
+
+        if(search.G(to_index) == math::INF)
+        {
+            path.result = AStarResult::FAILED;
+            return false;
+        }
+
+        const size_t segment_start = out_path_indices.size();
+        for(int current = to_index; current != from_index; current = search.came_from[current])
+            out_path_indices.push_back(current);
+
+        std::reverse(out_path_indices.begin() + segment_start, out_path_indices.end());
+    }
+
+    path.next_segment++;
+    return true;
+}
+
+game::NavigationResult game::HierarchicalAStar(
+    const NavmeshContext& context, const NavmeshHierarchy& hierarchy, int start_index, int end_index)
+{
+    HierarchicalPath hierarchical_path = FindHierarchicalPath(context, hierarchy, start_index, end_index);
+
+    NavigationResult result;
+
+    while(RefineNextSegment(context, hierarchy, hierarchical_path, result.path_indices))
+    { }
+
+    result.result = hierarchical_path.result;
+    result.nodes_evaluated = hierarchical_path.nodes_evaluated;
+
+    if(result.result != AStarResult::SUCCESS)
+        result.path_indices.clear();
+
+    return result;
+}
+
+bool game::IsShortPath(const NavmeshHierarchy& hierarchy, int start_index, int end_index)
+{
+    if(hierarchy.node_cluster.empty() || start_index == -1 || end_index == -1)
+        return true;
+
+    const int start_cluster = hierarchy.node_cluster[start_index];
+    const int end_cluster = hierarchy.node_cluster[end_index];
+
+    const int delta_x = std::abs(start_cluster % hierarchy.clusters_width - end_cluster % hierarchy.clusters_width);
+    const int delta_y = std::abs(start_cluster / hierarchy.clusters_width - end_cluster / hierarchy.clusters_width);
+
+    // Within the same or a neighbouring cluster, a flat search is cheaper.
+    return std::max(delta_x, delta_y) <= 1;
+}
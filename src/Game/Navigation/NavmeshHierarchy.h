@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include "NavMesh.h"
+#include "NavmeshData.h"
+
+#include <vector>
+
+namespace game
+{
+    // Abstract graph on top of the navmesh. The navmesh nodes are divided into square clusters and the
+    // nodes connecting two clusters are entrances. Entrances within the same cluster are connected
+    // with the precomputed distance between them.
+    struct NavmeshHierarchy
+    {
+        struct AbstractEdge
+        {
+            int to;
+            float cost;
+        };
+
+        struct AbstractNode
+        {
+            int navmesh_index;
+            int cluster;
+            std::vector<AbstractEdge> edges;
+        };
+
+        math::Vector origin;
+        float cluster_size = 0.0f;
+        int clusters_width = 0;
+        int clusters_height = 0;
+
+        std::vector<int> node_cluster;              // Cluster index per navmesh node
+        std::vector<int> node_to_abstract;          // Abstract node index per navmesh node, -1 if not an entrance
+        std::vector<std::vector<int>> cluster_entrances;
+        std::vector<AbstractNode> abstract_nodes;
+    };
+
+    struct HierarchicalPath
+    {
+        AStarResult result;
+        int nodes_evaluated;
+
+        // Navmesh indices of start, the entrances passed and the end. Consecutive waypoints
+        // are either neighbours or in the same cluster.
+        std::vector<int> waypoints;
+        uint32_t next_segment;
+    };
+
+    NavmeshHierarchy GenerateNavmeshHierarchy(const NavmeshContext& context, float cluster_size);
+
+    // Searches the abstract graph, the returned path is refined segment by segment with RefineNextSegment.
+    HierarchicalPath FindHierarchicalPath(
+        const NavmeshContext& context, const NavmeshHierarchy& hierarchy, int start_index, int end_index);
+
+    // Appends the navmesh indices of the next segment to out_path_indices, returns false when there are no more segments.
+    bool RefineNextSegment(
+        const NavmeshContext& context, const NavmeshHierarchy& hierarchy, HierarchicalPath& path, std::vector<int>& out_path_indices);
+
+    // Abstract search followed by refinement of all segments, same result as AStar.
+    NavigationResult HierarchicalAStar(
+        const NavmeshContext& context, const NavmeshHierarchy& hierarchy, int start_index, int end_index);
+
+    bool IsShortPath(const NavmeshHierarchy& hierarchy, int start_index, int end_index);
+}
@@ -0,0 +1,161 @@
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+using byte = uint8_t;
+
+namespace game
+{
+    // Writes values with an arbitrary number of bits (max 32), least significant bit first.
+    // Writing past the end of the buffer sets the overflow flag and leaves the buffer untouched.
+    class BitWriter
+    {
+    public:
+
+        BitWriter(byte* buffer, uint32_t buffer_size)
+            : m_buffer(buffer)
+            , m_buffer_bits(buffer_size * 8)
+            , m_bit_position(0)
+            , m_overflow(false)
+        {
+            std::memset(m_buffer, 0, buffer_size);
+        }
+
+        void Write(uint32_t value, uint32_t n_bits)
+        {
+            if(m_bit_position + n_bits > m_buffer_bits)
+            {
+                m_overflow = true;
+                return;
+            }
+
+            while(n_bits > 0)
+            {
+                const uint32_t bit_offset = m_bit_position % 8;
+                const uint32_t bits_in_byte = (8 - bit_offset < n_bits) ? (8 - bit_offset) : n_bits;
+                const uint32_t mask = (1u << bits_in_byte) - 1;
+
+                m_buffer[m_bit_position / 8] |= byte((value & mask) << bit_offset);
+
+                value >>= bits_in_byte;
+                n_bits -= bits_in_byte;
+                m_bit_position += bits_in_byte;
+            }
+        }
+
+        void WriteBool(bool value)
+        {
+            Write(value ? 1 : 0, 1);
+        }
+
+        // Discards everything written after bit_position and clears the overflow flag.
+        void Rewind(uint32_t bit_position)
+        {
+            const uint32_t first_byte = bit_position / 8;
+            const uint32_t bit_offset = bit_position % 8;
+            const uint32_t end_byte = (m_bit_position + 7) / 8;
+
+            if(first_byte < end_byte)
+            {
+                m_buffer[first_byte] &= byte((1u << bit_offset) - 1);
+                if(end_byte > first_byte + 1)
+                    std::memset(m_buffer + first_byte + 1, 0, end_byte - first_byte - 1);
+            }
+
+            m_bit_position = bit_position;
+            m_overflow = false;
+        }
+
+        uint32_t BitPosition() const
+        {
+            return m_bit_position;
+        }
+
+        uint32_t BytesWritten() const
+        {
+            return (m_bit_position + 7) / 8;
+        }
+
+        bool Overflow() const
+        {
+            return m_overflow;
+        }
+
+    private:
+
+        byte* m_buffer;
+        uint32_t m_buffer_bits;
+        uint32_t m_bit_position;
+        bool m_overflow;
+    };
+
+    class BitReader
+    {
+    public:
+
+        BitReader(const byte* buffer, uint32_t buffer_size)
+            : m_buffer(buffer)
+            , m_buffer_bits(buffer_size * 8)
+            , m_bit_position(0)
+            , m_overflow(false)
+        { }
+
+        uint32_t Read(uint32_t n_bits)
+        {
+            if(m_bit_position + n_bits > m_buffer_bits)
+            {
+                m_overflow = true;
+                return 0;
+            }
+
+            uint32_t value = 0;
+            uint32_t value_offset = 0;
+
+            while(n_bits > 0)
+            {
+                const uint32_t bit_offset = m_bit_position % 8;
+                const uint32_t bits_in_byte = (8 - bit_offset < n_bits) ? (8 - bit_offset) : n_bits;
+                const uint32_t mask = (1u << bits_in_byte) - 1;
+
+                const uint32_t bits = (m_buffer[m_bit_position / 8] >> bit_offset) & mask;
+                value |= (bits << value_offset);
+
+                value_offset += bits_in_byte;
+                n_bits -= bits_in_byte;
+                m_bit_position += bits_in_byte;
+            }
+
+            return value;
+        }
+
+        bool ReadBool()
+        {
+            return Read(1) != 0;
+        }
+
+        bool Overflow() const
+        {
+            return m_overflow;
+        }
+
+    private:
+
+        const byte* m_buffer;
+        uint32_t m_buffer_bits;
+        uint32_t m_bit_position;
+        bool m_overflow;
+    };
+
+    // Maps signed values to unsigned so that small negative values use few bits, 0, -1, 1, -2, 2...
+    inline uint32_t ZigZagEncode(int32_t value)
+    {
+        return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+    }
+
+    inline int32_t ZigZagDecode(uint32_t value)
+    {
+        return int32_t(value >> 1) ^ -int32_t(value & 1);
+    }
+}
@@ -141,6 +141,9 @@ void ClientManager::Update(const mono::UpdateContext& update_context)
     m_states.UpdateState(update_context);
     m_dispatcher.Update(update_context);
 
+    if(m_remote_connection)
+        m_remote_connection->Update();
+
     m_client_time = update_context.timestamp;
     m_server_time_predicted += update_context.delta_ms;
 }
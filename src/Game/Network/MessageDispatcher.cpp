@@ -2,6 +2,7 @@
 #include "MessageDispatcher.h"
 #include "NetworkMessage.h"
 #include "NetworkSerialize.h"
+#include "Snapshot.h"
 #include "System/System.h"
 
 #include "EventHandler/EventHandler.h"
@@ -60,6 +61,8 @@ MessageDispatcher::MessageDispatcher(mono::EventHandler* event_handler)
     REGISTER_MESSAGE_HANDLER_WITH_SENDER(RemoteInputMessage);
     REGISTER_MESSAGE_HANDLER(RemoteCameraMessage);
     REGISTER_MESSAGE_HANDLER_WITH_SENDER(ViewportMessage);
+    REGISTER_MESSAGE_HANDLER(SnapshotMessage);
+    REGISTER_MESSAGE_HANDLER_WITH_SENDER(SnapshotAckMessage);
 }
 
 void MessageDispatcher::PushNewMessage(const NetworkMessage& message)
@@ -141,6 +141,35 @@ namespace game
         math::Quad viewport;
     };
 
+    // Quantized and bit packed entity states, delta encoded against the snapshot with baseline_id.
+    // Only data_size bytes of data are serialized, see Snapshot.h.
+    constexpr uint32_t SnapshotMessageDataSize = 984;
+
+    struct SnapshotMessage
+    {
+        DECLARE_NETWORK_MESSAGE();
+        uint32_t timestamp;
+        uint16_t snapshot_id;
+        uint16_t baseline_id;
+        uint16_t n_entities;
+        uint16_t data_size;
+        uint8_t data[SnapshotMessageDataSize];
+    };
+
+    struct SnapshotAckMessage
+    {
+        DECLARE_NETWORK_MESSAGE();
+        network::Address sender;
+        uint16_t snapshot_id;
+    };
+
+    // Envelope for messages on a reliable channel, the wrapped message follows the id. See ReliableChannel.h.
+    struct ReliableMessageHeader
+    {
+        DECLARE_NETWORK_MESSAGE();
+        uint16_t message_id;
+    };
+
     inline void PrintNetworkMessageSize()
     {
         #define PRINT_NETWORK_MESSAGE_SIZE(message_name) \
@@ -164,5 +193,8 @@ namespace game
         PRINT_NETWORK_MESSAGE_SIZE(RemoteInputMessage);
         PRINT_NETWORK_MESSAGE_SIZE(RemoteCameraMessage);
         PRINT_NETWORK_MESSAGE_SIZE(ViewportMessage);
+        PRINT_NETWORK_MESSAGE_SIZE(SnapshotMessage);
+        PRINT_NETWORK_MESSAGE_SIZE(SnapshotAckMessage);
+        PRINT_NETWORK_MESSAGE_SIZE(ReliableMessageHeader);
     }
 }
@@ -22,8 +22,10 @@ namespace game
 
     struct NetworkMessageHeader
     {
-        uint32_t id;
+        uint32_t id;            // Packet sequence on a reliable channel, 0 if not sent on one
         uint32_t n_messages;
+        uint32_t ack;           // Latest packet sequence received from the other end
+        uint32_t ack_bits;      // Bit n set if packet ack - 1 - n was received
         uint16_t payload_length;
         uint8_t compressed_payload;
         //uint8_t padding;
@@ -0,0 +1,298 @@
+
+#include "ReliableChannel.h"
+#include "NetworkMessage.h"
+
+#include <cstring>
+
+using namespace game;
+
+namespace
+{
+    constexpr size_t MessageLengthSize = sizeof(uint32_t);
+    constexpr size_t ReliableEnvelopeSize = sizeof(ReliableMessageHeader::message_type) + sizeof(uint16_t);
+    constexpr uint32_t AckBits = 32;
+
+    bool FitsInBuffer(const std::vector<byte>& message_buffer, size_t message_size)
+    {
+        return message_buffer.size() + MessageLengthSize + message_size <= NetworkMessageBufferTotalSize;
+    }
+
+    // Same layout as SerializeMessageToBuffer, but the buffer grows if needed.
+    void AppendMessage(std::vector<byte>& message_buffer, const byte* envelope, size_t envelope_size, const byte_view& message)
+    {
+        NetworkMessageHeader header = GetMessageBufferHeader(message_buffer);
+        ++header.n_messages;
+        SetMessageBufferHeader(message_buffer, header);
+
+        const uint32_t message_size = envelope_size + message.size();
+        const byte* message_size_bytes = reinterpret_cast<const byte*>(&message_size);
+
+        message_buffer.insert(message_buffer.end(), message_size_bytes, message_size_bytes + MessageLengthSize);
+        message_buffer.insert(message_buffer.end(), envelope, envelope + envelope_size);
+        message_buffer.insert(message_buffer.end(), message.begin(), message.end());
+    }
+}
+
+MessageReliability game::GetMessageReliability(uint32_t message_type)
+{
+    switch(message_type)
+    {
+    case ConnectAcceptedMessage::message_type:
+    case ClientPlayerSpawned::message_type:
+    case TextMessage::message_type:
+    case LevelMetadataMessage::message_type:
+    case SpawnMessage::message_type:
+    case SpriteMessage::message_type:
+    case DamageInfoMessage::message_type:
+        return MessageReliability::RELIABLE_ORDERED;
+    default:
+        return MessageReliability::UNRELIABLE;
+    }
+}
+
+ReliableChannel::ReliableChannel(uint32_t resend_time_ms, uint32_t ack_time_ms)
+    : m_resend_time_ms(resend_time_ms)
+    , m_ack_time_ms(ack_time_ms)
+    , m_local_sequence(1)
+    , m_next_message_id(0)
+    , m_last_send_timestamp(0)
+    , m_remote_sequence(0)
+    , m_received_bits(0)
+    , m_ack_pending(false)
+    , m_next_receive_id(0)
+{
+    PrepareMessageBuffer(m_packet);
+}
+
+void ReliableChannel::SendPacket(
+    const std::vector<byte>& message_buffer, uint32_t timestamp, std::vector<std::vector<byte>>& out_packets)
+{
+    std::vector<byte_view> unreliable_messages;
+
+    for(const byte_view& message : UnpackMessageBuffer(message_buffer))
+    {
+        if(GetMessageReliability(PeekMessageType(message)) == MessageReliability::UNRELIABLE)
+        {
+            unreliable_messages.push_back(message);
+            continue;
+        }
+
+        OutgoingMessage outgoing_message;
+        outgoing_message.message_id = m_next_message_id++;
+        outgoing_message.sent = false;
+        outgoing_message.acked = false;
+        outgoing_message.sent_timestamp = 0;
+        outgoing_message.data.assign(message.begin(), message.end());
+        m_outgoing_messages.push_back(std::move(outgoing_message));
+    }
+
+    Flush(timestamp, unreliable_messages, false, out_packets);
+}
+
+void ReliableChannel::Update(uint32_t timestamp, std::vector<std::vector<byte>>& out_packets)
+{
+    const bool send_ack = m_ack_pending && (timestamp - m_last_send_timestamp) >= m_ack_time_ms;
+    Flush(timestamp, { }, send_ack, out_packets);
+}
+
+void ReliableChannel::Flush(
+    uint32_t timestamp, const std::vector<byte_view>& unreliable_messages, bool send_ack, std::vector<std::vector<byte>>& out_packets)
+{
+    const auto has_messages = [this]() {
+        return GetMessageBufferHeader(m_packet).n_messages > 0;
+    };
+
+    // Reliable messages first, new ones and the ones that have waited too long for an ack. Nothing past
+    // the window is sent since the other end has nowhere to put it.
+    const uint16_t first_message_id = m_outgoing_messages.empty() ? 0 : m_outgoing_messages.front().message_id;
+
+    for(OutgoingMessage& message : m_outgoing_messages)
+    {
+        if(uint16_t(message.message_id - first_message_id) >= ReliableWindowSize)
+            break;
+
+        const bool resend = message.sent && (timestamp - message.sent_timestamp) >= m_resend_time_ms;
+        if(message.acked || (message.sent && !resend))
+            continue;
+
+        if(!FitsInBuffer(m_packet, ReliableEnvelopeSize + message.data.size()) && has_messages())
+            FinishPacket(timestamp, out_packets);
+
+        byte envelope[ReliableEnvelopeSize];
+        std::memcpy(envelope, &ReliableMessageHeader::message_type, sizeof(ReliableMessageHeader::message_type));
+        std::memcpy(envelope + sizeof(ReliableMessageHeader::message_type), &message.message_id, sizeof(uint16_t));
+        AppendMessage(m_packet, envelope, ReliableEnvelopeSize, byte_view(message.data.data(), message.data.size()));
+        m_packet_message_ids.push_back(message.message_id);
+
+        if(resend)
+            m_stats.messages_resent++;
+
+        message.sent = true;
+        message.sent_timestamp = timestamp;
+    }
+
+    for(const byte_view& message : unreliable_messages)
+    {
+        if(!FitsInBuffer(m_packet, message.size()) && has_messages())
+            FinishPacket(timestamp, out_packets);
+
+        AppendMessage(m_packet, nullptr, 0, message);
+    }
+
+    if(has_messages() || send_ack)
+        FinishPacket(timestamp, out_packets);
+}
+
+void ReliableChannel::FinishPacket(uint32_t timestamp, std::vector<std::vector<byte>>& out_packets)
+{
+    const uint32_t sequence = m_local_sequence++;
+
+    NetworkMessageHeader header = GetMessageBufferHeader(m_packet);
+    header.id = sequence;
+    header.ack = m_remote_sequence;
+    header.ack_bits = m_received_bits;
+    SetMessageBufferHeader(m_packet, header);
+
+    SentPacket& sent_packet = m_sent_packets[sequence % PacketHistorySize];
+    sent_packet.sequence = sequence;
+    sent_packet.message_ids.swap(m_packet_message_ids);
+    m_packet_message_ids.clear();
+
+    out_packets.push_back(m_packet);
+
+    m_packet.clear();
+    PrepareMessageBuffer(m_packet);
+
+    m_ack_pending = false;
+    m_last_send_timestamp = timestamp;
+    m_stats.packets_sent++;
+}
+
+bool ReliableChannel::ReceivePacket(const std::vector<byte>& packet, std::vector<byte>& out_message_buffer)
+{
+    if(packet.size() < sizeof(NetworkMessageHeader))
+        return false;
+
+    const NetworkMessageHeader header = GetMessageBufferHeader(packet);
+    const uint32_t sequence = header.id;
+    if(sequence == 0)
+        return false;
+
+    if(sequence > m_remote_sequence)
+    {
+        const uint32_t shift = sequence - m_remote_sequence;
+        if(m_remote_sequence == 0 || shift > AckBits)
+            m_received_bits = 0;
+        else
+            m_received_bits = ((shift < AckBits) ? (m_received_bits << shift) : 0) | (1u << (shift - 1));
+
+        m_remote_sequence = sequence;
+    }
+    else
+    {
+        // Duplicated or out of order, if it is too old there is no way to tell if it is a duplicate.
+        const uint32_t age = m_remote_sequence - sequence;
+        const uint32_t received_bit = (age > 0 && age <= AckBits) ? (1u << (age - 1)) : 0;
+        if(received_bit == 0 || (m_received_bits & received_bit))
+        {
+            m_stats.packets_dropped++;
+            return false;
+        }
+
+        m_received_bits |= received_bit;
+    }
+
+    m_stats.packets_received++;
+    m_ack_pending = true;
+
+    if(header.ack != 0)
+    {
+        AckPacket(header.ack);
+        for(uint32_t bit = 0; bit < AckBits; ++bit)
+        {
+            if((header.ack_bits & (1u << bit)) && header.ack > bit + 1)
+                AckPacket(header.ack - bit - 1);
+        }
+
+        while(!m_outgoing_messages.empty() && m_outgoing_messages.front().acked)
+            m_outgoing_messages.pop_front();
+    }
+
+    out_message_buffer.clear();
+    PrepareMessageBuffer(out_message_buffer);
+
+    for(const byte_view& message : UnpackMessageBuffer(packet))
+    {
+        if(message.size() < sizeof(uint32_t))
+            continue;
+
+        const bool is_reliable = (PeekMessageType(message) == ReliableMessageHeader::message_type);
+        if(is_reliable && message.size() > ReliableEnvelopeSize)
+        {
+            uint16_t message_id = 0;
+            std::memcpy(&message_id, message.data() + sizeof(ReliableMessageHeader::message_type), sizeof(uint16_t));
+            ReceiveReliableMessage(message_id, message.substr(ReliableEnvelopeSize), out_message_buffer);
+        }
+        else if(!is_reliable)
+        {
+            AppendMessage(out_message_buffer, nullptr, 0, message);
+        }
+    }
+
+    return true;
+}
+
+void ReliableChannel::AckPacket(uint32_t sequence)
+{
+    SentPacket& sent_packet = m_sent_packets[sequence % PacketHistorySize];
+    if(sent_packet.sequence != sequence || m_outgoing_messages.empty())
+        return;
+
+    const uint16_t first_message_id = m_outgoing_messages.front().message_id;
+    for(uint16_t message_id : sent_packet.message_ids)
+    {
+        const uint16_t index = message_id - first_message_id;
+        if(index < m_outgoing_messages.size())
+            m_outgoing_messages[index].acked = true;
+    }
+
+    sent_packet.sequence = 0;
+    sent_packet.message_ids.clear();
+}
+
+void ReliableChannel::ReceiveReliableMessage(uint16_t message_id, const byte_view& message, std::vector<byte>& out_message_buffer)
+{
+    // Already dispatched, or too far ahead. It will be resent in that case.
+    const uint16_t distance = message_id - m_next_receive_id;
+    if(distance >= ReliableWindowSize)
+        return;
+
+    IncomingMessage& incoming_message = m_incoming_messages[message_id % ReliableWindowSize];
+    if(!incoming_message.received)
+    {
+        incoming_message.received = true;
+        incoming_message.data.assign(message.begin(), message.end());
+    }
+
+    while(true)
+    {
+        IncomingMessage& next_message = m_incoming_messages[m_next_receive_id % ReliableWindowSize];
+        if(!next_message.received)
+            break;
+
+        AppendMessage(out_message_buffer, nullptr, 0, byte_view(next_message.data.data(), next_message.data.size()));
+        next_message.received = false;
+        next_message.data.clear();
+        m_next_receive_id++;
+    }
+}
+
+uint32_t ReliableChannel::UnackedMessages() const
+{
+    return m_outgoing_messages.size();
+}
+
+const ReliableChannelStats& ReliableChannel::GetStats() const
+{
+    return m_stats;
+}
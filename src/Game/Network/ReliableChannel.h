@@ -0,0 +1,103 @@
+
+#pragma once
+
+#include "NetworkSerialize.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace game
+{
+    enum class MessageReliability
+    {
+        UNRELIABLE,         // Fire and forget, newer state replaces it anyway
+        RELIABLE_ORDERED,   // Resent until acknowledged and dispatched in the order it was sent
+    };
+
+    MessageReliability GetMessageReliability(uint32_t message_type);
+
+    constexpr uint32_t ReliableWindowSize = 256;
+    constexpr uint32_t PacketHistorySize = 256;
+
+    struct ReliableChannelStats
+    {
+        uint32_t packets_sent = 0;
+        uint32_t packets_received = 0;
+        uint32_t packets_dropped = 0;   // Duplicates and packets too old to ack
+        uint32_t messages_resent = 0;
+    };
+
+    // Reliability on top of the message buffers from BatchedMessageSender, one channel per remote address.
+    // Every packet gets a sequence and acknowledges the latest 33 packets from the other end. Reliable
+    // messages are wrapped with an id, kept until a packet they were in is acknowledged and resent if
+    // that takes longer than the resend time. The receiving side buffers them and releases them in order.
+    class ReliableChannel
+    {
+    public:
+
+        ReliableChannel(uint32_t resend_time_ms = 100, uint32_t ack_time_ms = 50);
+
+        // Repacks a message buffer into one or more packets, together with any pending resends.
+        void SendPacket(const std::vector<byte>& message_buffer, uint32_t timestamp, std::vector<std::vector<byte>>& out_packets);
+
+        // Resends what is overdue and acknowledges received packets if nothing has been sent for a while.
+        void Update(uint32_t timestamp, std::vector<std::vector<byte>>& out_packets);
+
+        // Returns false if the packet should be ignored. out_message_buffer gets the messages that are ready
+        // to dispatch, unwrapped and in order.
+        bool ReceivePacket(const std::vector<byte>& packet, std::vector<byte>& out_message_buffer);
+
+        uint32_t UnackedMessages() const;
+        const ReliableChannelStats& GetStats() const;
+
+    private:
+
+        void Flush(uint32_t timestamp, const std::vector<byte_view>& unreliable_messages, bool send_ack, std::vector<std::vector<byte>>& out_packets);
+        void FinishPacket(uint32_t timestamp, std::vector<std::vector<byte>>& out_packets);
+        void AckPacket(uint32_t sequence);
+        void ReceiveReliableMessage(uint16_t message_id, const byte_view& message, std::vector<byte>& out_message_buffer);
+
+        uint32_t m_resend_time_ms;
+        uint32_t m_ack_time_ms;
+
+        // Sending
+        struct OutgoingMessage
+        {
+            uint16_t message_id;
+            bool sent;
+            bool acked;
+            uint32_t sent_timestamp;
+            std::vector<byte> data;     // Message type and message
+        };
+
+        struct SentPacket
+        {
+            uint32_t sequence = 0;
+            std::vector<uint16_t> message_ids;
+        };
+
+        uint32_t m_local_sequence;
+        uint16_t m_next_message_id;
+        std::deque<OutgoingMessage> m_outgoing_messages;
+        SentPacket m_sent_packets[PacketHistorySize];
+        std::vector<byte> m_packet;
+        std::vector<uint16_t> m_packet_message_ids;
+        uint32_t m_last_send_timestamp;
+
+        // Receiving
+        struct IncomingMessage
+        {
+            bool received = false;
+            std::vector<byte> data;
+        };
+
+        uint32_t m_remote_sequence;
+        uint32_t m_received_bits;
+        bool m_ack_pending;
+        uint16_t m_next_receive_id;
+        IncomingMessage m_incoming_messages[ReliableWindowSize];
+
+        ReliableChannelStats m_stats;
+    };
+}
@@ -13,7 +13,11 @@ using namespace game;
 namespace
 {
     void ReceiveFunc(
-        network::ISocket* socket, MessageDispatcher* dispatcher, ConnectionStats& connection_stats, bool& stop)
+        network::ISocket* socket,
+        MessageDispatcher* dispatcher,
+        RemoteConnection::Channels* channels,
+        ConnectionStats& connection_stats,
+        bool& stop)
     {
         unsigned char huffbuf_heap[HUFFHEAP_SIZE];
         std::vector<byte> message_buffer(NetworkMessageBufferTotalSize, '\0');
@@ -21,6 +25,8 @@ namespace
         NetworkMessage message;
         message.payload.resize(NetworkMessageBufferTotalSize);
 
+        NetworkMessage channel_message;
+
         while(!stop)
         {
             const int bytes_received = socket->Receive(message_buffer, &message.address);
@@ -37,7 +43,25 @@ namespace
                 connection_stats.total_byte_received += decompressed_size;
                 connection_stats.total_compressed_byte_received += bytes_received;
 
-                dispatcher->PushNewMessage(message);
+                const NetworkMessageHeader header = GetMessageBufferHeader(message.payload);
+                if(header.id == 0)
+                {
+                    dispatcher->PushNewMessage(message);
+                    continue;
+                }
+
+                bool dispatch_message = false;
+                {
+                    std::lock_guard<std::mutex> lock(channels->channel_mutex);
+                    ReliableChannel& channel = channels->channels[message.address];
+                    dispatch_message = channel.ReceivePacket(message.payload, channel_message.payload);
+                }
+
+                if(dispatch_message && GetMessageBufferHeader(channel_message.payload).n_messages > 0)
+                {
+                    channel_message.address = message.address;
+                    dispatcher->PushNewMessage(channel_message);
+                }
             }
         }
     };
@@ -98,10 +122,9 @@ namespace
 RemoteConnection::RemoteConnection(MessageDispatcher* dispatcher, network::ISocketPtr socket)
     : m_stop(false)
     , m_socket(std::move(socket))
-    , m_sequence_id(0)
 {
     m_stats = { 0, 0, 0, 0, 0, 0 };
-    m_receive_thread = std::thread(ReceiveFunc, m_socket.get(), dispatcher, std::ref(m_stats), std::ref(m_stop));
+    m_receive_thread = std::thread(ReceiveFunc, m_socket.get(), dispatcher, &m_channels, std::ref(m_stats), std::ref(m_stop));
     m_send_thread = std::thread(SendFunc, m_socket.get(), &m_messages, std::ref(m_stats), std::ref(m_stop));
 }
 
@@ -122,22 +145,72 @@ void RemoteConnection::SendData(const std::vector<byte>& data, const network::Ad
 
 void RemoteConnection::SendData(const std::vector<byte>& data, const std::vector<network::Address>& addresses)
 {
+    const uint32_t timestamp = System::GetMilliseconds();
+
     {
-        std::lock_guard<std::mutex> lock(m_messages.message_mutex);
+        std::lock_guard<std::mutex> channel_lock(m_channels.channel_mutex);
+        std::lock_guard<std::mutex> message_lock(m_messages.message_mutex);
 
-        ++m_sequence_id;
+        for(const network::Address& address : addresses)
+        {
+            m_channel_packets.clear();
+            m_channels.channels[address].SendPacket(data, timestamp, m_channel_packets);
+
+            for(std::vector<byte>& packet : m_channel_packets)
+                m_messages.unhandled_messages.push_back({ std::move(packet), { address } });
+        }
+    }
 
-        std::vector<byte>& mutable_data = const_cast<std::vector<byte>&>(data);
-        NetworkMessageHeader header = GetMessageBufferHeader(mutable_data);
-        header.id = m_sequence_id;
-        SetMessageBufferHeader(mutable_data, header);
+    m_messages.message_signal.notify_one();
+}
 
-        m_messages.unhandled_messages.push_back({ data, addresses });
+void RemoteConnection::SendUnsequencedData(const std::vector<byte>& data, const network::Address& target)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_messages.message_mutex);
+        m_messages.unhandled_messages.push_back({ data, { target } });
     }
 
     m_messages.message_signal.notify_one();
 }
 
+void RemoteConnection::Update()
+{
+    const uint32_t timestamp = System::GetMilliseconds();
+    bool has_packets = false;
+
+    {
+        std::lock_guard<std::mutex> channel_lock(m_channels.channel_mutex);
+        std::lock_guard<std::mutex> message_lock(m_messages.message_mutex);
+
+        for(auto& channel_pair : m_channels.channels)
+        {
+            m_channel_packets.clear();
+            channel_pair.second.Update(timestamp, m_channel_packets);
+
+            for(std::vector<byte>& packet : m_channel_packets)
+                m_messages.unhandled_messages.push_back({ std::move(packet), { channel_pair.first } });
+
+            has_packets |= !m_channel_packets.empty();
+        }
+    }
+
+    if(has_packets)
+        m_messages.message_signal.notify_one();
+}
+
+void RemoteConnection::ResetChannel(const network::Address& address)
+{
+    std::lock_guard<std::mutex> lock(m_channels.channel_mutex);
+    m_channels.channels[address] = ReliableChannel();
+}
+
+void RemoteConnection::RemoveChannel(const network::Address& address)
+{
+    std::lock_guard<std::mutex> lock(m_channels.channel_mutex);
+    m_channels.channels.erase(address);
+}
+
 const ConnectionStats& RemoteConnection::GetConnectionStats() const
 {
     return m_stats;
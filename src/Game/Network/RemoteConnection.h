@@ -3,11 +3,13 @@
 
 #include "NetworkMessage.h"
 #include "ConnectionStats.h"
+#include "ReliableChannel.h"
 #include "System/Network.h"
 #include <thread>
 #include <mutex>
 #include <vector>
 #include <condition_variable>
+#include <unordered_map>
 
 namespace game
 {
@@ -20,6 +22,17 @@ namespace game
 
         void SendData(const std::vector<byte>& data, const network::Address& target);
         void SendData(const std::vector<byte>& data, const std::vector<network::Address>& addresses);
+
+        // Bypasses the reliable channels, for broadcasts and other addresses that are not a connection.
+        void SendUnsequencedData(const std::vector<byte>& data, const network::Address& target);
+
+        // Resends and acks, call once per frame.
+        void Update();
+
+        // Starts over with a fresh channel, for a new connection from the address.
+        void ResetChannel(const network::Address& address);
+        void RemoveChannel(const network::Address& address);
+
         const ConnectionStats& GetConnectionStats() const;
 
         struct Message
@@ -35,6 +48,12 @@ namespace game
             std::vector<Message> unhandled_messages;
         };
 
+        struct Channels
+        {
+            std::mutex channel_mutex;
+            std::unordered_map<network::Address, ReliableChannel> channels;
+        };
+
     private:
 
         bool m_stop;
@@ -43,8 +62,9 @@ namespace game
         std::thread m_send_thread;
 
         OutgoingMessages m_messages;
+        Channels m_channels;
         ConnectionStats m_stats;
 
-        uint32_t m_sequence_id;
+        std::vector<std::vector<byte>> m_channel_packets;
     };
 }
@@ -0,0 +1,116 @@
+
+#include "ReplicationTables.h"
+
+#include <cmath>
+
+using namespace game;
+
+void TransformTable::Resize(uint32_t n_entities)
+{
+    position_x.assign(n_entities, 0.0f);
+    position_y.assign(n_entities, 0.0f);
+    rotation.assign(n_entities, 0.0f);
+    parent_transform.assign(n_entities, 0);
+}
+
+void TransformTable::Copy(uint32_t entity_id, const TransformTable& from)
+{
+    position_x[entity_id] = from.position_x[entity_id];
+    position_y[entity_id] = from.position_y[entity_id];
+    rotation[entity_id] = from.rotation[entity_id];
+    parent_transform[entity_id] = from.parent_transform[entity_id];
+}
+
+void SpriteTable::Resize(uint32_t n_entities)
+{
+    filename_hash.assign(n_entities, 0);
+    hex_color.assign(n_entities, 0);
+    properties.assign(n_entities, 0);
+    animation_id.assign(n_entities, 0);
+}
+
+void SpriteTable::Copy(uint32_t entity_id, const SpriteTable& from)
+{
+    filename_hash[entity_id] = from.filename_hash[entity_id];
+    hex_color[entity_id] = from.hex_color[entity_id];
+    properties[entity_id] = from.properties[entity_id];
+    animation_id[entity_id] = from.animation_id[entity_id];
+}
+
+void ClientReplicationState::Resize(uint32_t n_entities)
+{
+    transforms.Resize(n_entities);
+    transform_time_to_replicate.assign(n_entities, 0);
+    sprites.Resize(n_entities);
+    health.assign(n_entities, 0);
+
+    transform_changed.assign(n_entities, 0);
+    sprite_changed.assign(n_entities, 0);
+    health_changed.assign(n_entities, 0);
+}
+
+void game::MarkChangedTransforms(
+    const TransformTable& current, const TransformTable& sent, float tolerance, std::vector<uint8_t>& out_changed)
+{
+    const size_t n_entities = current.position_x.size();
+
+    const float* __restrict current_x = current.position_x.data();
+    const float* __restrict current_y = current.position_y.data();
+    const float* __restrict current_rotation = current.rotation.data();
+    const uint16_t* __restrict current_parent = current.parent_transform.data();
+
+    const float* __restrict sent_x = sent.position_x.data();
+    const float* __restrict sent_y = sent.position_y.data();
+    const float* __restrict sent_rotation = sent.rotation.data();
+    const uint16_t* __restrict sent_parent = sent.parent_transform.data();
+
+    uint8_t* __restrict changed = out_changed.data();
+
+    // Branch free so that the compiler can vectorize it.
+    for(size_t index = 0; index < n_entities; ++index)
+    {
+        changed[index] = uint8_t(
+            (std::fabs(current_x[index] - sent_x[index]) > tolerance) |
+            (std::fabs(current_y[index] - sent_y[index]) > tolerance) |
+            (std::fabs(current_rotation[index] - sent_rotation[index]) > tolerance) |
+            (current_parent[index] != sent_parent[index]));
+    }
+}
+
+void game::MarkChangedSprites(const SpriteTable& current, const SpriteTable& sent, std::vector<uint8_t>& out_changed)
+{
+    const size_t n_entities = current.filename_hash.size();
+
+    const uint32_t* __restrict current_hash = current.filename_hash.data();
+    const uint32_t* __restrict current_color = current.hex_color.data();
+    const uint32_t* __restrict current_properties = current.properties.data();
+    const int16_t* __restrict current_animation = current.animation_id.data();
+
+    const uint32_t* __restrict sent_hash = sent.filename_hash.data();
+    const uint32_t* __restrict sent_color = sent.hex_color.data();
+    const uint32_t* __restrict sent_properties = sent.properties.data();
+    const int16_t* __restrict sent_animation = sent.animation_id.data();
+
+    uint8_t* __restrict changed = out_changed.data();
+
+    for(size_t index = 0; index < n_entities; ++index)
+    {
+        changed[index] = uint8_t(
+            (current_hash[index] != sent_hash[index]) |
+            (current_color[index] != sent_color[index]) |
+            (current_properties[index] != sent_properties[index]) |
+            (current_animation[index] != sent_animation[index]));
+    }
+}
+
+void game::MarkChangedValues(const std::vector<int>& current, const std::vector<int>& sent, std::vector<uint8_t>& out_changed)
+{
+    const size_t n_entities = current.size();
+
+    const int* __restrict current_values = current.data();
+    const int* __restrict sent_values = sent.data();
+    uint8_t* __restrict changed = out_changed.data();
+
+    for(size_t index = 0; index < n_entities; ++index)
+        changed[index] = uint8_t(current_values[index] != sent_values[index]);
+}
@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // Replicated values indexed on entity id, one array per value so that the change checks vectorize.
+    struct TransformTable
+    {
+        void Resize(uint32_t n_entities);
+        void Copy(uint32_t entity_id, const TransformTable& from);
+
+        std::vector<float> position_x;
+        std::vector<float> position_y;
+        std::vector<float> rotation;
+        std::vector<uint16_t> parent_transform;
+    };
+
+    struct SpriteTable
+    {
+        void Resize(uint32_t n_entities);
+        void Copy(uint32_t entity_id, const SpriteTable& from);
+
+        std::vector<uint32_t> filename_hash;
+        std::vector<uint32_t> hex_color;
+        std::vector<uint32_t> properties;
+        std::vector<int16_t> animation_id;
+    };
+
+    // What has been sent to a client, and when.
+    struct ClientReplicationState
+    {
+        void Resize(uint32_t n_entities);
+
+        TransformTable transforms;
+        std::vector<int> transform_time_to_replicate;
+        SpriteTable sprites;
+        std::vector<int> health;
+
+        // Scratch, non zero for entities where the current value differs from what was sent.
+        std::vector<uint8_t> transform_changed;
+        std::vector<uint8_t> sprite_changed;
+        std::vector<uint8_t> health_changed;
+    };
+
+    // Compares the whole tables, all arrays need to be the same size.
+    void MarkChangedTransforms(
+        const TransformTable& current, const TransformTable& sent, float tolerance, std::vector<uint8_t>& out_changed);
+    void MarkChangedSprites(const SpriteTable& current, const SpriteTable& sent, std::vector<uint8_t>& out_changed);
+    void MarkChangedValues(const std::vector<int>& current, const std::vector<int>& sent, std::vector<uint8_t>& out_changed);
+}
@@ -147,6 +147,10 @@ mono::EventResult ServerManager::HandleConnectMessage(const ConnectMessage& mess
         const std::string& address_string = network::AddressToString(message.sender);
         System::Log("ServerManager|Client connected: %s", address_string.c_str());
 
+        // Whatever was left from an earlier connection from the same address is out of sync.
+        if(m_remote_connection)
+            m_remote_connection->ResetChannel(message.sender);
+
         NetworkMessage reply_message;
         reply_message.payload = SerializeMessage(ConnectAcceptedMessage());
         SendMessageTo(reply_message, message.sender);
@@ -165,6 +169,8 @@ mono::EventResult ServerManager::HandleDisconnectMessage(const DisconnectMessage
 {
     System::Log("ServerManager|Disconnect client");
     m_connected_clients.erase(message.sender);
+    if(m_remote_connection)
+        m_remote_connection->RemoveChannel(message.sender);
     m_event_handler->DispatchEvent(PlayerDisconnectedEvent(message.sender));
 
     return mono::EventResult::PASS_ON;
@@ -210,6 +216,8 @@ void ServerManager::PurgeZombieClients()
     {
         System::Log("ServerManager|Purging client: %s", network::AddressToString(key).c_str());
         m_connected_clients.erase(key);
+        if(m_remote_connection)
+            m_remote_connection->RemoveChannel(key);
         m_event_handler->DispatchEvent(PlayerDisconnectedEvent(key));
     }
 }
@@ -226,13 +234,14 @@ void ServerManager::Update(const mono::UpdateContext& update_context)
     PurgeZombieClients();
     m_dispatcher.Update(update_context);
 
+    if(m_remote_connection)
+        m_remote_connection->Update();
+
     m_beacon_timer_s += update_context.delta_s;
 
     if(m_beacon_timer_s >= 0.5f && m_remote_connection)
     {
-        NetworkMessage message;
-        message.payload = SerializeMessage(ServerBeaconMessage());
-        SendMessageTo(message, m_broadcast_address);
+        m_remote_connection->SendUnsequencedData(SerializeMessage(ServerBeaconMessage()), m_broadcast_address);
 
         m_beacon_timer_s = 0.0f;
     }
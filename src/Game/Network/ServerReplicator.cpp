@@ -27,11 +27,33 @@
 #include "Camera/ICamera.h"
 #include "Entity/Component.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 using namespace game;
 
+namespace
+{
+    constexpr float ReplicationCellSize = 10.0f;
+    constexpr float ViewportMargin = 5.0f;
+    constexpr float SpawnedPriority = 100.0f;
+    constexpr float TransformTolerance = 0.001f;
+
+    template <typename Map, typename Predicate>
+    void EraseIf(Map& map, const Predicate& predicate)
+    {
+        for(auto it = map.begin(); it != map.end();)
+        {
+            if(predicate(*it))
+                it = map.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
 ServerReplicator::ServerReplicator(
+    uint32_t num_entities,
     mono::EventHandler* event_handler,
     mono::EntitySystem* entity_system,
     mono::TransformSystem* transform_system,
@@ -39,18 +61,21 @@ ServerReplicator::ServerReplicator(
     DamageSystem* damage_system,
     ServerManager* server_manager,
     const LevelMetadata& level_metadata,
-    uint32_t replication_interval)
-    : m_event_handler(event_handler)
+    uint32_t replication_interval,
+    bool snapshot_replication)
+    : m_num_entities(num_entities)
+    , m_event_handler(event_handler)
     , m_entity_system(entity_system)
     , m_transform_system(transform_system)
     , m_sprite_system(sprite_system)
     , m_damage_system(damage_system)
     , m_server_manager(server_manager)
     , m_replication_interval(replication_interval)
+    , m_snapshot_replication(snapshot_replication)
 {
-    std::memset(&m_transform_data, 0, sizeof(m_transform_data));
-    std::memset(&m_sprite_data, 0, sizeof(m_sprite_data));
-    std::memset(&m_health_data, 0, sizeof(m_health_data));
+    m_current_transforms.Resize(num_entities);
+    m_current_sprites.Resize(num_entities);
+    m_current_health.resize(num_entities, 0);
 
     const PlayerConnectedFunc connected_func = [server_manager, level_metadata](const PlayerConnectedEvent& event) {
 
@@ -68,11 +93,28 @@ ServerReplicator::ServerReplicator(
         return mono::EventResult::PASS_ON;
     };
     m_connected_token = m_event_handler->AddListener(connected_func);
+
+    const std::function<mono::EventResult (const SnapshotAckMessage&)> snapshot_ack_func = [this](const SnapshotAckMessage& ack_message) {
+        const auto it = m_client_snapshots.find(ack_message.sender);
+        if(it != m_client_snapshots.end())
+        {
+            ClientSnapshots& client_snapshots = it->second;
+            const bool newer_ack =
+                client_snapshots.acked_snapshot_id == NoSnapshot ||
+                IsNewerSnapshot(ack_message.snapshot_id, client_snapshots.acked_snapshot_id);
+            if(newer_ack)
+                client_snapshots.acked_snapshot_id = ack_message.snapshot_id;
+        }
+
+        return mono::EventResult::HANDLED;
+    };
+    m_snapshot_ack_token = m_event_handler->AddListener(snapshot_ack_func);
 }
 
 ServerReplicator::~ServerReplicator()
 {
     m_event_handler->RemoveListener(m_connected_token);
+    m_event_handler->RemoveListener(m_snapshot_ack_token);
 }
 
 void ServerReplicator::Update(const mono::UpdateContext& update_context)
@@ -87,6 +129,12 @@ void ServerReplicator::Update(const mono::UpdateContext& update_context)
         std::vector<uint32_t> spawns_this_frame;
 
         const auto collect_entities = [&](const mono::Entity& entity) {
+            if(entity.id >= m_num_entities)
+            {
+                System::Log("ServerReplicator|Entity %u is outside of the replication capacity %u.", entity.id, m_num_entities);
+                return;
+            }
+
             transforms_to_replicate.push_back(entity.id);
 
             if(mono::contains(entity.components, SPRITE_COMPONENT))
@@ -97,38 +145,96 @@ void ServerReplicator::Update(const mono::UpdateContext& update_context)
         };
         m_entity_system->ForEachEntity(collect_entities);
 
+        m_spawned_this_frame.clear();
+
         for(const auto& spawn_event : m_entity_system->GetSpawnEvents())
         {
-            if(spawn_event.spawned)
-                spawns_this_frame.push_back(spawn_event.entity_id);
+            if(!spawn_event.spawned)
+                continue;
+
+            spawns_this_frame.push_back(spawn_event.entity_id);
+
+            if(spawn_event.entity_id >= m_spawned_this_frame.size())
+                m_spawned_this_frame.resize(spawn_event.entity_id + 1, false);
+            m_spawned_this_frame[spawn_event.entity_id] = true;
+        }
+
+        std::sort(spawns_this_frame.begin(), spawns_this_frame.end());
+        std::sort(transforms_to_replicate.begin(), transforms_to_replicate.end());
+
+        // Bounds and spatial hash are shared by all the clients.
+        m_entity_bounds.clear();
+        m_spawn_indices.clear();
+
+        for(uint32_t index = 0; index < transforms_to_replicate.size(); ++index)
+        {
+            const uint32_t entity_id = transforms_to_replicate[index];
+            m_entity_bounds.push_back(m_transform_system->GetWorldBoundingBox(entity_id));
+
+            if(IsSpawnedThisFrame(entity_id))
+                m_spawn_indices.push_back(index);
         }
 
+        m_spatial_hash.Build(m_entity_bounds, ReplicationCellSize);
+
+        if(m_snapshot_replication)
+            CollectSnapshotStates(transforms_to_replicate, sprites_to_replicate);
+
+        static const std::vector<uint32_t> no_entities;
+        CollectCurrentValues(
+            m_snapshot_replication ? no_entities : transforms_to_replicate,
+            m_snapshot_replication ? no_entities : sprites_to_replicate,
+            damage_info_to_replicate);
+
         std::unordered_set<network::Address> known_clients;
 
         for(const auto& client : clients)
         {
             const bool force_replicate = (m_known_clients.find(client.first) == m_known_clients.end());
 
+            ClientReplicationState& client_state = m_client_states[client.first];
+            if(force_replicate)
+                client_state.Resize(m_num_entities);
+
             BatchedMessageSender batch_sender(client.first, m_message_queue);
             ReplicateSpawns(batch_sender, update_context);
 
-            const int replicated_transforms =
-                ReplicateTransforms(transforms_to_replicate, spawns_this_frame, force_replicate, batch_sender, client.second.viewport, update_context);
-            const int replicated_sprites =
-                ReplicateSprites(sprites_to_replicate, spawns_this_frame, force_replicate, batch_sender, update_context);
-            const int replicated_damages =
-                ReplicateDamageInfos(damage_info_to_replicate, spawns_this_frame, force_replicate, batch_sender, update_context);
-        
-            System::Log(
-                "replications, transforms: %u, sprites: %u, damages: %u",
-                replicated_transforms,
-                replicated_sprites,
-                replicated_damages);
+            if(m_snapshot_replication)
+            {
+                const int replicated_entities =
+                    ReplicateSnapshot(client.first, spawns_this_frame, force_replicate, batch_sender, client.second.viewport, update_context);
+                const int replicated_damages =
+                    ReplicateDamageInfos(damage_info_to_replicate, force_replicate, client_state, batch_sender, update_context);
+
+                System::Log("replications, snapshot entities: %u, damages: %u", replicated_entities, replicated_damages);
+            }
+            else
+            {
+                const int replicated_transforms =
+                    ReplicateTransforms(transforms_to_replicate, force_replicate, client_state, batch_sender, client.second.viewport, update_context);
+                const int replicated_sprites =
+                    ReplicateSprites(sprites_to_replicate, force_replicate, client_state, batch_sender, update_context);
+                const int replicated_damages =
+                    ReplicateDamageInfos(damage_info_to_replicate, force_replicate, client_state, batch_sender, update_context);
+
+                System::Log(
+                    "replications, transforms: %u, sprites: %u, damages: %u",
+                    replicated_transforms,
+                    replicated_sprites,
+                    replicated_damages);
+            }
 
             known_clients.insert(client.first);
         }
 
         m_known_clients = known_clients;
+
+        // Drop the replication state of disconnected clients
+        const auto is_disconnected = [&known_clients](const auto& client_pair) {
+            return known_clients.find(client_pair.first) == known_clients.end();
+        };
+        EraseIf(m_client_snapshots, is_disconnected);
+        EraseIf(m_client_states, is_disconnected);
     }
 
     while(!m_message_queue.empty())
@@ -151,87 +257,273 @@ void ServerReplicator::ReplicateSpawns(BatchedMessageSender& batched_sender, con
     }
 }
 
+void ServerReplicator::CollectCurrentValues(
+    const std::vector<uint32_t>& transform_entities,
+    const std::vector<uint32_t>& sprite_entities,
+    const std::vector<uint32_t>& damage_entities)
+{
+    for(uint32_t entity_id : transform_entities)
+    {
+        const math::Matrix& transform = m_transform_system->GetTransform(entity_id);
+        const math::Vector position = math::GetPosition(transform);
+
+        m_current_transforms.position_x[entity_id] = position.x;
+        m_current_transforms.position_y[entity_id] = position.y;
+        m_current_transforms.rotation[entity_id] = math::GetZRotation(transform);
+        m_current_transforms.parent_transform[entity_id] = m_transform_system->GetParent(entity_id);
+    }
+
+    for(uint32_t entity_id : sprite_entities)
+    {
+        const mono::ISprite* sprite = m_sprite_system->GetSprite(entity_id);
+        m_current_sprites.filename_hash[entity_id] = sprite->GetSpriteHash();
+        m_current_sprites.hex_color[entity_id] = mono::Color::ToHex(sprite->GetShade());
+        m_current_sprites.properties[entity_id] = sprite->GetProperties();
+        m_current_sprites.animation_id[entity_id] = sprite->GetActiveAnimation();
+    }
+
+    for(uint32_t entity_id : damage_entities)
+        m_current_health[entity_id] = m_damage_system->GetDamageRecord(entity_id)->health;
+}
+
 int ServerReplicator::ReplicateTransforms(
     const std::vector<uint32_t>& entities,
-    const std::vector<uint32_t>& spawn_entities,
     bool force_replicate,
+    ClientReplicationState& client_state,
     BatchedMessageSender& batched_sender,
     const math::Quad& client_viewport,
     const mono::UpdateContext& update_context)
 {
     int replicated_transforms = 0;
 
-    const auto transform_func = [&, this](const math::Matrix& transform, uint32_t id) {
+    MarkChangedTransforms(m_current_transforms, client_state.transforms, TransformTolerance, client_state.transform_changed);
 
-        TransformData& last_transform_message = m_transform_data[id];
-        last_transform_message.time_to_replicate -= update_context.delta_ms;
+    const auto transform_func = [&, this](uint32_t id) {
 
-        const bool time_to_replicate = (last_transform_message.time_to_replicate < 0);
-        const bool spawned_this_frame = mono::contains(spawn_entities, id);
+        int& time_to_replicate = client_state.transform_time_to_replicate[id];
+        time_to_replicate -= update_context.delta_ms;
 
-        if(!time_to_replicate && !force_replicate && !spawned_this_frame)
+        const bool spawned_this_frame = IsSpawnedThisFrame(id);
+        if(time_to_replicate >= 0 && !force_replicate && !spawned_this_frame)
             return;
 
-        if(!force_replicate && !spawned_this_frame)
-        {
-             // Expand by 5 meter to send positions before in sight
-            const math::Quad& client_bb = math::ResizeQuad(client_viewport, 5.0f);
-            const math::Quad& world_bb = m_transform_system->GetWorldBoundingBox(id);
-
-            const bool overlaps = math::QuadOverlaps(client_bb, world_bb);
-            if(!overlaps)
-                return;
-        }
+        const bool same_as_last_time = (client_state.transform_changed[id] == 0);
+        if(same_as_last_time && !spawned_this_frame && !force_replicate)
+            return;
 
         TransformMessage transform_message;
         transform_message.timestamp = update_context.timestamp;
         transform_message.entity_id = id;
-        transform_message.parent_transform = m_transform_system->GetParent(id);
-        transform_message.position = math::GetPosition(transform);
-        transform_message.rotation = math::GetZRotation(transform);
-
-        const bool same_as_last_time = 
-            math::IsPrettyMuchEquals(last_transform_message.position, transform_message.position, 0.001f) &&
-            math::IsPrettyMuchEquals(last_transform_message.rotation, transform_message.rotation, 0.001f) &&
-            last_transform_message.parent_transform == transform_message.parent_transform;
+        transform_message.parent_transform = m_current_transforms.parent_transform[id];
+        transform_message.position = math::Vector(m_current_transforms.position_x[id], m_current_transforms.position_y[id]);
+        transform_message.rotation = m_current_transforms.rotation[id];
 
-        if(!same_as_last_time || spawned_this_frame || force_replicate)
-        {
-            batched_sender.SendMessage(transform_message);
+        batched_sender.SendMessage(transform_message);
 
-            last_transform_message.position = transform_message.position;
-            last_transform_message.rotation = transform_message.rotation;
-            last_transform_message.parent_transform = transform_message.parent_transform;
-            last_transform_message.time_to_replicate = m_replication_interval;
+        client_state.transforms.Copy(id, m_current_transforms);
+        time_to_replicate = m_replication_interval;
 
-            replicated_transforms++;
-       }
+        replicated_transforms++;
     };
 
-    for(uint32_t entity_id : entities)
-        transform_func(m_transform_system->GetTransform(entity_id), entity_id);
+    if(force_replicate)
+    {
+        for(uint32_t entity_id : entities)
+            transform_func(entity_id);
+    }
+    else
+    {
+        CollectClientEntities(client_viewport);
+        for(uint32_t index : m_client_indices)
+            transform_func(entities[index]);
+    }
 
     return replicated_transforms;
 }
 
+void ServerReplicator::CollectClientEntities(const math::Quad& client_viewport)
+{
+    // Expand by 5 meter to send positions before in sight, spawned entities are always sent.
+    m_client_indices.clear();
+    m_spatial_hash.Query(math::ResizeQuad(client_viewport, ViewportMargin), m_client_indices);
+
+    const size_t n_visible = m_client_indices.size();
+    m_client_indices.insert(m_client_indices.end(), m_spawn_indices.begin(), m_spawn_indices.end());
+    std::inplace_merge(m_client_indices.begin(), m_client_indices.begin() + n_visible, m_client_indices.end());
+    m_client_indices.erase(std::unique(m_client_indices.begin(), m_client_indices.end()), m_client_indices.end());
+}
+
+bool ServerReplicator::IsSpawnedThisFrame(uint32_t entity_id) const
+{
+    return entity_id < m_spawned_this_frame.size() && m_spawned_this_frame[entity_id];
+}
+
+void ServerReplicator::CollectSnapshotStates(const std::vector<uint32_t>& entities, const std::vector<uint32_t>& sprite_entities)
+{
+    // Entities are sorted on id, same order as the bounds.
+    m_entity_states.clear();
+
+    for(uint32_t entity_id : entities)
+    {
+        const math::Matrix& transform = m_transform_system->GetTransform(entity_id);
+
+        EntitySnapshotState state;
+        state.entity_id = entity_id;
+        state.parent_transform = m_transform_system->GetParent(entity_id);
+
+        const math::Vector position = math::GetPosition(transform);
+        state.position_x = QuantizePosition(position.x);
+        state.position_y = QuantizePosition(position.y);
+        state.rotation = QuantizeRotation(math::GetZRotation(transform));
+
+        m_entity_states.push_back(state);
+    }
+
+    const auto sort_on_id = [](const EntitySnapshotState& first, const EntitySnapshotState& second) {
+        return first.entity_id < second.entity_id;
+    };
+
+    for(uint32_t entity_id : sprite_entities)
+    {
+        EntitySnapshotState search_state;
+        search_state.entity_id = entity_id;
+
+        const auto it = std::lower_bound(m_entity_states.begin(), m_entity_states.end(), search_state, sort_on_id);
+        if(it == m_entity_states.end() || it->entity_id != entity_id)
+            continue;
+
+        const mono::ISprite* sprite = m_sprite_system->GetSprite(entity_id);
+        it->filename_hash = sprite->GetSpriteHash();
+        it->hex_color = mono::Color::ToHex(sprite->GetShade());
+        it->animation_id = sprite->GetActiveAnimation();
+        it->properties = sprite->GetProperties();
+
+        const math::Vector shadow_offset = sprite->GetShadowOffset();
+        it->shadow_offset_x = QuantizeShadow(shadow_offset.x);
+        it->shadow_offset_y = QuantizeShadow(shadow_offset.y);
+        it->shadow_size = QuantizeShadow(sprite->GetShadowSize());
+    }
+}
+
+int ServerReplicator::ReplicateSnapshot(
+    const network::Address& client_address,
+    const std::vector<uint32_t>& spawn_entities,
+    bool force_replicate,
+    BatchedMessageSender& batched_sender,
+    const math::Quad& client_viewport,
+    const mono::UpdateContext& update_context)
+{
+    if(force_replicate)
+        m_client_snapshots.erase(client_address);
+
+    ClientSnapshots& client_snapshots = m_client_snapshots[client_address];
+    client_snapshots.time_to_replicate -= update_context.delta_ms;
+
+    const bool time_to_replicate = (client_snapshots.time_to_replicate < 0);
+    if(!time_to_replicate && !force_replicate && spawn_entities.empty())
+        return 0;
+
+    client_snapshots.time_to_replicate = m_replication_interval;
+
+    CollectClientEntities(client_viewport);
+
+    m_client_entity_states.clear();
+    m_client_priorities.clear();
+
+    // Entities close to the center of the viewport matter the most, entities that were left out last time
+    // keep their priority so that everything is sent eventually when the snapshot is full.
+    const math::Vector viewport_center = (client_viewport.bottom_left + client_viewport.top_right) * 0.5f;
+    std::vector<float>& priority_accumulators = client_snapshots.priority_accumulators;
+
+    for(uint32_t index : m_client_indices)
+    {
+        const EntitySnapshotState& state = m_entity_states[index];
+        if(state.entity_id >= priority_accumulators.size())
+            priority_accumulators.resize(state.entity_id + 1, 0.0f);
+
+        const math::Quad& bounds = m_entity_bounds[index];
+        const math::Vector bounds_center = (bounds.bottom_left + bounds.top_right) * 0.5f;
+        const float distance = math::DistanceBetween(viewport_center, bounds_center);
+        const float priority = IsSpawnedThisFrame(state.entity_id) ? SpawnedPriority : 1.0f + 10.0f / (1.0f + distance);
+
+        m_client_entity_states.push_back(state);
+        m_client_priorities.push_back(priority_accumulators[state.entity_id] + priority);
+    }
+
+    const uint16_t snapshot_id = client_snapshots.next_snapshot_id++;
+    if(client_snapshots.next_snapshot_id == NoSnapshot)
+        client_snapshots.next_snapshot_id++;
+
+    // The baseline is only valid as long as it is in the history, otherwise send everything.
+    const Snapshot no_baseline;
+    const uint16_t acked_snapshot_id = client_snapshots.acked_snapshot_id;
+    const Snapshot& acked_snapshot = client_snapshots.history[acked_snapshot_id % SnapshotHistorySize];
+    const bool valid_baseline =
+        acked_snapshot_id != NoSnapshot &&
+        acked_snapshot.snapshot_id == acked_snapshot_id &&
+        uint16_t(snapshot_id - acked_snapshot_id) < SnapshotHistorySize;
+
+    Snapshot& sent_snapshot = client_snapshots.history[snapshot_id % SnapshotHistorySize];
+
+    m_snapshot_message.timestamp = update_context.timestamp;
+    m_snapshot_message.snapshot_id = snapshot_id;
+    WriteSnapshotDelta(
+        valid_baseline ? acked_snapshot : no_baseline,
+        m_client_entity_states,
+        m_client_priorities,
+        spawn_entities,
+        m_snapshot_message,
+        sent_snapshot);
+    sent_snapshot.snapshot_id = snapshot_id;
+
+    // Entities that are up to date start over, the others keep what they have.
+    size_t sent_index = 0;
+    for(size_t index = 0; index < m_client_entity_states.size(); ++index)
+    {
+        const EntitySnapshotState& state = m_client_entity_states[index];
+        while(sent_index < sent_snapshot.entities.size() && sent_snapshot.entities[sent_index].entity_id < state.entity_id)
+            sent_index++;
+
+        const bool up_to_date =
+            sent_index < sent_snapshot.entities.size() &&
+            sent_snapshot.entities[sent_index].entity_id == state.entity_id &&
+            SnapshotFieldsChanged(sent_snapshot.entities[sent_index], state) == 0;
+
+        priority_accumulators[state.entity_id] = up_to_date ? 0.0f : m_client_priorities[index];
+    }
+
+    batched_sender.SendMessage(m_snapshot_message);
+
+    return m_snapshot_message.n_entities;
+}
+
 int ServerReplicator::ReplicateSprites(
     const std::vector<uint32_t>& entities,
-    const std::vector<uint32_t>& spawn_entities,
     bool force_replicate,
+    ClientReplicationState& client_state,
     BatchedMessageSender& batched_sender,
     const mono::UpdateContext& update_context)
 {
     int replicated_sprites = 0;
 
-    const auto sprite_func = [&, this](mono::ISprite* sprite, uint32_t id) {
+    MarkChangedSprites(m_current_sprites, client_state.sprites, client_state.sprite_changed);
+
+    for(uint32_t id : entities)
+    {
+        const bool same_as_last_time = (client_state.sprite_changed[id] == 0);
+        const bool spawned_this_frame = IsSpawnedThisFrame(id);
+
+        if(same_as_last_time && !spawned_this_frame && !force_replicate)
+            continue;
+
+        const mono::ISprite* sprite = m_sprite_system->GetSprite(id);
 
         SpriteMessage sprite_message;
         sprite_message.entity_id = id;
-        sprite_message.filename_hash = sprite->GetSpriteHash();
-        sprite_message.hex_color = mono::Color::ToHex(sprite->GetShade());
-        sprite_message.animation_id = sprite->GetActiveAnimation();
-        
-        sprite_message.properties = sprite->GetProperties();
+        sprite_message.filename_hash = m_current_sprites.filename_hash[id];
+        sprite_message.hex_color = m_current_sprites.hex_color[id];
+        sprite_message.animation_id = m_current_sprites.animation_id[id];
+        sprite_message.properties = m_current_sprites.properties[id];
         sprite_message.layer = 0; //m_sprite_system->GetSpriteLayer(id);
         sprite_message.shadow_size = sprite->GetShadowSize();
 
@@ -239,54 +531,36 @@ int ServerReplicator::ReplicateSprites(
         sprite_message.shadow_offset_x = shadow_offset.x;
         sprite_message.shadow_offset_y = shadow_offset.y;
 
-        SpriteData& last_sprite_data = m_sprite_data[id];
-
-        const bool same_as_last_time =
-            last_sprite_data.animation_id == sprite_message.animation_id &&
-            last_sprite_data.filename_hash == sprite_message.filename_hash &&
-            last_sprite_data.hex_color == sprite_message.hex_color &&
-            last_sprite_data.properties == sprite_message.properties;
-        const bool spawned_this_frame = mono::contains(spawn_entities, id);
+        batched_sender.SendMessage(sprite_message);
+        client_state.sprites.Copy(id, m_current_sprites);
 
-        if(!same_as_last_time || spawned_this_frame || force_replicate)
-        {
-            batched_sender.SendMessage(sprite_message);
-            
-            last_sprite_data.animation_id = sprite_message.animation_id;
-            last_sprite_data.filename_hash = sprite_message.filename_hash;
-            last_sprite_data.hex_color = sprite_message.hex_color;
-            last_sprite_data.properties = sprite_message.properties;
-
-            replicated_sprites++;
-        }
-    };
-
-    for(uint32_t entity_id : entities)
-        sprite_func(m_sprite_system->GetSprite(entity_id), entity_id);
+        replicated_sprites++;
+    }
 
     return replicated_sprites;
 }
 
 int ServerReplicator::ReplicateDamageInfos(
     const std::vector<uint32_t>& entities,
-    const std::vector<uint32_t>& spawn_entities,
     bool force_replicate,
+    ClientReplicationState& client_state,
     BatchedMessageSender& batch_sender,
     const mono::UpdateContext& update_context)
 {
     int replicated_damages = 0;
 
-    const auto damage_info_func = [&, this](const DamageRecord* damage_record, uint32_t entity_id) {
-
-        HealthData& last_health = m_health_data[entity_id];
+    MarkChangedValues(m_current_health, client_state.health, client_state.health_changed);
 
-        const bool same_as_last_time = (last_health.health == damage_record->health);
-        const bool spawned_this_frame = mono::contains(spawn_entities, entity_id);
+    for(uint32_t entity_id : entities)
+    {
+        const bool same_as_last_time = (client_state.health_changed[entity_id] == 0);
+        const bool spawned_this_frame = IsSpawnedThisFrame(entity_id);
 
         if(same_as_last_time && !spawned_this_frame && !force_replicate)
-            return;
+            continue;
 
-        last_health.health = damage_record->health;
+        const DamageRecord* damage_record = m_damage_system->GetDamageRecord(entity_id);
+        client_state.health[entity_id] = m_current_health[entity_id];
 
         DamageInfoMessage damage_info;
         damage_info.entity_id = entity_id;
@@ -298,10 +572,7 @@ int ServerReplicator::ReplicateDamageInfos(
         batch_sender.SendMessage(damage_info);
 
         replicated_damages++;
-    };
-
-    for(uint32_t entity_id : entities)
-        damage_info_func(m_damage_system->GetDamageRecord(entity_id), entity_id);
+    }
 
     return replicated_damages;
 }
@@ -6,8 +6,12 @@
 #include "IUpdatable.h"
 #include "NetworkMessage.h"
 #include "NetworkSerialize.h"
+#include "ReplicationTables.h"
+#include "Snapshot.h"
+#include "SpatialHash.h"
 
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace game
@@ -28,6 +32,7 @@ namespace game
     public:
 
         ServerReplicator(
+            uint32_t num_entities,
             mono::EventHandler* event_handler,
             mono::EntitySystem* entity_system,
             mono::TransformSystem* transform_system,
@@ -35,33 +40,49 @@ namespace game
             DamageSystem* damage_system,
             ServerManager* server_manager,
             const game::LevelMetadata& level_metadata,
-            uint32_t replication_interval);
+            uint32_t replication_interval,
+            bool snapshot_replication);
         ~ServerReplicator();
 
     private:
         void Update(const mono::UpdateContext& update_context) override;
 
         void ReplicateSpawns(BatchedMessageSender& batched_sender, const mono::UpdateContext& update_context);
+        void CollectCurrentValues(
+            const std::vector<uint32_t>& transform_entities,
+            const std::vector<uint32_t>& sprite_entities,
+            const std::vector<uint32_t>& damage_entities);
         int ReplicateTransforms(
             const std::vector<uint32_t>& entities,
-            const std::vector<uint32_t>& spawn_entities,
             bool force_replicate,
+            ClientReplicationState& client_state,
             BatchedMessageSender& batched_sender,
             const math::Quad& client_viewport,
             const mono::UpdateContext& update_context);
         int ReplicateSprites(
             const std::vector<uint32_t>& entities,
+            bool force_replicate,
+            ClientReplicationState& client_state,
+            BatchedMessageSender& batched_sender,
+            const mono::UpdateContext& update_context);
+        void CollectClientEntities(const math::Quad& client_viewport);
+        bool IsSpawnedThisFrame(uint32_t entity_id) const;
+        void CollectSnapshotStates(const std::vector<uint32_t>& entities, const std::vector<uint32_t>& sprite_entities);
+        int ReplicateSnapshot(
+            const network::Address& client_address,
             const std::vector<uint32_t>& spawn_entities,
             bool force_replicate,
             BatchedMessageSender& batched_sender,
+            const math::Quad& client_viewport,
             const mono::UpdateContext& update_context);
         int ReplicateDamageInfos(
             const std::vector<uint32_t>& entities,
-            const std::vector<uint32_t>& spawn_entities,
             bool force_replicate,
+            ClientReplicationState& client_state,
             BatchedMessageSender& batch_sender,
             const mono::UpdateContext& update_context);
 
+        uint32_t m_num_entities;
         mono::EventHandler* m_event_handler;
         mono::EntitySystem* m_entity_system;
         mono::TransformSystem* m_transform_system;
@@ -69,29 +90,41 @@ namespace game
         DamageSystem* m_damage_system;
         ServerManager* m_server_manager;
         uint32_t m_replication_interval;
+        bool m_snapshot_replication;
 
         mono::EventToken<PlayerConnectedEvent> m_connected_token;
+        mono::EventToken<SnapshotAckMessage> m_snapshot_ack_token;
 
-        struct TransformData
-        {
-            int time_to_replicate;
-            math::Vector position;
-            float rotation;
-            uint16_t parent_transform;
-        } m_transform_data[500];
+        // Values of this replication, compared against what each client has been sent.
+        TransformTable m_current_transforms;
+        SpriteTable m_current_sprites;
+        std::vector<int> m_current_health;
+        std::unordered_map<network::Address, ClientReplicationState> m_client_states;
 
-        struct SpriteData
+        // Snapshot replication, entity states are delta encoded against the last snapshot the client acknowledged.
+        struct ClientSnapshots
         {
-            uint32_t filename_hash;
-            uint32_t hex_color;
-            uint32_t properties;
-            short animation_id;
-        } m_sprite_data[500];
+            int time_to_replicate = 0;
+            uint16_t next_snapshot_id = NoSnapshot + 1;
+            uint16_t acked_snapshot_id = NoSnapshot;
+            Snapshot history[SnapshotHistorySize];
 
-        struct HealthData
-        {
-            int health;
-        } m_health_data[500];
+            // Indexed on entity id, grows every time an entity is left out so that it gets in eventually.
+            std::vector<float> priority_accumulators;
+        };
+
+        std::unordered_map<network::Address, ClientSnapshots> m_client_snapshots;
+        std::vector<EntitySnapshotState> m_entity_states;
+        std::vector<EntitySnapshotState> m_client_entity_states;
+        std::vector<float> m_client_priorities;
+        SnapshotMessage m_snapshot_message;
+
+        // Rebuilt every replication, indices are into the entities sorted on id.
+        std::vector<math::Quad> m_entity_bounds;
+        SpatialHash m_spatial_hash;
+        std::vector<bool> m_spawned_this_frame;
+        std::vector<uint32_t> m_spawn_indices;
+        std::vector<uint32_t> m_client_indices;
 
         std::queue<NetworkMessage> m_message_queue;
         std::unordered_set<network::Address> m_known_clients;
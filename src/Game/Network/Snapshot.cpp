@@ -0,0 +1,566 @@
+
+#include "Snapshot.h"
+#include "BitStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace game;
+
+namespace
+{
+    constexpr float PositionPrecision = 1.0f / 128.0f;
+    constexpr float ShadowPrecision = 1.0f / 256.0f;
+    constexpr uint32_t PositionBits = 24;
+    constexpr uint32_t PositionDeltaBits = 9;
+    constexpr uint32_t RotationBits = 12;
+    constexpr uint32_t RotationSteps = 1 << RotationBits;
+    constexpr uint32_t IdGapBits = 4;
+
+    constexpr int32_t MaxQuantizedPosition = (1 << (PositionBits - 1)) - 1;
+    constexpr float TwoPi = 6.28318530718f;
+
+    const EntitySnapshotState g_default_state;
+
+    void WriteEntity(
+        BitWriter& writer,
+        int previous_id,
+        const EntitySnapshotState& base_state,
+        const EntitySnapshotState& state,
+        uint32_t fields)
+    {
+        // Entities are sorted on id, usually with small gaps.
+        const int id_gap = int(state.entity_id) - previous_id - 1;
+        const bool small_gap = (id_gap < (1 << IdGapBits));
+        writer.WriteBool(small_gap);
+        if(small_gap)
+            writer.Write(id_gap, IdGapBits);
+        else
+            writer.Write(state.entity_id, 16);
+
+        // Most of the time only position and rotation change.
+        const bool only_position_rotation = (fields & ~(SF_POSITION | SF_ROTATION)) == 0;
+        writer.WriteBool(only_position_rotation);
+        if(only_position_rotation)
+            writer.Write(fields, 2);
+        else
+            writer.Write(fields, SnapshotFieldBits);
+
+        if(fields & SF_REMOVED)
+            return;
+
+        if(fields & SF_POSITION)
+        {
+            const uint32_t delta_x = ZigZagEncode(state.position_x - base_state.position_x);
+            const uint32_t delta_y = ZigZagEncode(state.position_y - base_state.position_y);
+            const bool small_delta = (delta_x < (1u << PositionDeltaBits)) && (delta_y < (1u << PositionDeltaBits));
+
+            writer.WriteBool(small_delta);
+            if(small_delta)
+            {
+                writer.Write(delta_x, PositionDeltaBits);
+                writer.Write(delta_y, PositionDeltaBits);
+            }
+            else
+            {
+                writer.Write(ZigZagEncode(state.position_x), PositionBits);
+                writer.Write(ZigZagEncode(state.position_y), PositionBits);
+            }
+        }
+
+        if(fields & SF_ROTATION)
+            writer.Write(state.rotation, RotationBits);
+        if(fields & SF_PARENT)
+            writer.Write(state.parent_transform, 16);
+        if(fields & SF_SPRITE_FILE)
+            writer.Write(state.filename_hash, 32);
+        if(fields & SF_COLOR)
+            writer.Write(state.hex_color, 32);
+        if(fields & SF_ANIMATION)
+            writer.Write(state.animation_id, 8);
+        if(fields & SF_PROPERTIES)
+            writer.Write(state.properties, 32);
+
+        if(fields & SF_SHADOW)
+        {
+            writer.Write(uint16_t(state.shadow_offset_x), 16);
+            writer.Write(uint16_t(state.shadow_offset_y), 16);
+            writer.Write(uint16_t(state.shadow_size), 16);
+        }
+    }
+
+    constexpr uint32_t MaxIdBits = 1 + 16;
+    constexpr float RemovedPriority = std::numeric_limits<float>::max();
+
+    uint32_t IdBits(int previous_id, int entity_id)
+    {
+        const int id_gap = entity_id - previous_id - 1;
+        return (id_gap < (1 << IdGapBits)) ? (1 + IdGapBits) : (1 + 16);
+    }
+
+    // Same as WriteEntity without the id.
+    uint32_t EntityBits(const EntitySnapshotState& base_state, const EntitySnapshotState& state, uint32_t fields)
+    {
+        const bool only_position_rotation = (fields & ~(SF_POSITION | SF_ROTATION)) == 0;
+        uint32_t bits = 1 + (only_position_rotation ? 2 : SnapshotFieldBits);
+
+        if(fields & SF_REMOVED)
+            return bits;
+
+        if(fields & SF_POSITION)
+        {
+            const uint32_t delta_x = ZigZagEncode(state.position_x - base_state.position_x);
+            const uint32_t delta_y = ZigZagEncode(state.position_y - base_state.position_y);
+            const bool small_delta = (delta_x < (1u << PositionDeltaBits)) && (delta_y < (1u << PositionDeltaBits));
+            bits += 1 + (small_delta ? PositionDeltaBits : PositionBits) * 2;
+        }
+
+        if(fields & SF_ROTATION)
+            bits += RotationBits;
+        if(fields & SF_PARENT)
+            bits += 16;
+        if(fields & SF_SPRITE_FILE)
+            bits += 32;
+        if(fields & SF_COLOR)
+            bits += 32;
+        if(fields & SF_ANIMATION)
+            bits += 8;
+        if(fields & SF_PROPERTIES)
+            bits += 32;
+        if(fields & SF_SHADOW)
+            bits += 16 * 3;
+
+        return bits;
+    }
+
+    struct SnapshotRecord
+    {
+        const EntitySnapshotState* base_state;      // What the delta is written against
+        const EntitySnapshotState* state;
+        const EntitySnapshotState* previous_state;  // What the client has if nothing is written, null if nothing
+        uint32_t fields;
+        float priority;
+        uint32_t bits = 0;
+        bool new_entity = false;
+        bool selected = false;
+    };
+
+    // Scratch buffers, the replication runs on one thread.
+    std::vector<SnapshotRecord> g_snapshot_records;
+    std::vector<uint32_t> g_snapshot_candidates;
+    std::vector<uint32_t> g_snapshot_selected;
+
+    void ReadEntityFields(BitReader& reader, uint32_t fields, EntitySnapshotState& state)
+    {
+        if(fields & SF_POSITION)
+        {
+            const bool small_delta = reader.ReadBool();
+            if(small_delta)
+            {
+                state.position_x += ZigZagDecode(reader.Read(PositionDeltaBits));
+                state.position_y += ZigZagDecode(reader.Read(PositionDeltaBits));
+            }
+            else
+            {
+                state.position_x = ZigZagDecode(reader.Read(PositionBits));
+                state.position_y = ZigZagDecode(reader.Read(PositionBits));
+            }
+        }
+
+        if(fields & SF_ROTATION)
+            state.rotation = reader.Read(RotationBits);
+        if(fields & SF_PARENT)
+            state.parent_transform = reader.Read(16);
+        if(fields & SF_SPRITE_FILE)
+            state.filename_hash = reader.Read(32);
+        if(fields & SF_COLOR)
+            state.hex_color = reader.Read(32);
+        if(fields & SF_ANIMATION)
+            state.animation_id = reader.Read(8);
+        if(fields & SF_PROPERTIES)
+            state.properties = reader.Read(32);
+
+        if(fields & SF_SHADOW)
+        {
+            state.shadow_offset_x = int16_t(reader.Read(16));
+            state.shadow_offset_y = int16_t(reader.Read(16));
+            state.shadow_size = int16_t(reader.Read(16));
+        }
+    }
+}
+
+int32_t game::QuantizePosition(float value)
+{
+    const int32_t quantized = int32_t(std::lround(value / PositionPrecision));
+    return std::clamp(quantized, -MaxQuantizedPosition, MaxQuantizedPosition);
+}
+
+float game::DequantizePosition(int32_t value)
+{
+    return float(value) * PositionPrecision;
+}
+
+uint16_t game::QuantizeRotation(float radians)
+{
+    const long steps = std::lround(radians / TwoPi * RotationSteps);
+    return uint16_t(steps & (RotationSteps - 1));
+}
+
+float game::DequantizeRotation(uint16_t value)
+{
+    // Back to -pi to pi, same range as the rotation of a transform.
+    const int32_t steps = (value >= RotationSteps / 2) ? int32_t(value) - int32_t(RotationSteps) : int32_t(value);
+    return float(steps) * TwoPi / float(RotationSteps);
+}
+
+int16_t game::QuantizeShadow(float value)
+{
+    const long quantized = std::lround(value / ShadowPrecision);
+    return int16_t(std::clamp(quantized, -32767l, 32767l));
+}
+
+float game::DequantizeShadow(int16_t value)
+{
+    return float(value) * ShadowPrecision;
+}
+
+uint32_t game::SnapshotFieldsChanged(const EntitySnapshotState& baseline, const EntitySnapshotState& current)
+{
+    uint32_t fields = 0;
+
+    if(baseline.position_x != current.position_x || baseline.position_y != current.position_y)
+        fields |= SF_POSITION;
+    if(baseline.rotation != current.rotation)
+        fields |= SF_ROTATION;
+    if(baseline.parent_transform != current.parent_transform)
+        fields |= SF_PARENT;
+    if(baseline.filename_hash != current.filename_hash)
+        fields |= SF_SPRITE_FILE;
+    if(baseline.hex_color != current.hex_color)
+        fields |= SF_COLOR;
+    if(baseline.animation_id != current.animation_id)
+        fields |= SF_ANIMATION;
+    if(baseline.properties != current.properties)
+        fields |= SF_PROPERTIES;
+
+    const bool shadow_changed =
+        baseline.shadow_offset_x != current.shadow_offset_x ||
+        baseline.shadow_offset_y != current.shadow_offset_y ||
+        baseline.shadow_size != current.shadow_size;
+    if(shadow_changed)
+        fields |= SF_SHADOW;
+
+    return fields;
+}
+
+void game::WriteSnapshotDelta(
+    const Snapshot& baseline,
+    const std::vector<EntitySnapshotState>& current,
+    const std::vector<float>& priorities,
+    const std::vector<uint32_t>& spawned_entities,
+    SnapshotMessage& out_message,
+    Snapshot& out_sent_snapshot)
+{
+    // First collect what needs to be written, merged on entity id.
+    std::vector<SnapshotRecord>& records = g_snapshot_records;
+    records.clear();
+
+    const std::vector<EntitySnapshotState>& baseline_entities = baseline.entities;
+    size_t baseline_index = 0;
+    size_t current_index = 0;
+
+    while(baseline_index < baseline_entities.size() || current_index < current.size())
+    {
+        const bool has_baseline = baseline_index < baseline_entities.size();
+        const bool has_current = current_index < current.size();
+
+        SnapshotRecord record;
+
+        if(!has_current || (has_baseline && baseline_entities[baseline_index].entity_id < current[current_index].entity_id))
+        {
+            // Not in the snapshot any more, cheap to send and keeps the client from showing stale entities.
+            const EntitySnapshotState& base_state = baseline_entities[baseline_index];
+            record = { &base_state, &base_state, nullptr, SF_REMOVED, RemovedPriority };
+            baseline_index++;
+        }
+        else if(!has_baseline || current[current_index].entity_id < baseline_entities[baseline_index].entity_id)
+        {
+            // New in the snapshot, also written when all fields are default so that the client knows about it.
+            const EntitySnapshotState& state = current[current_index];
+            const float priority = priorities.empty() ? 0.0f : priorities[current_index];
+            record = { &g_default_state, &state, nullptr, SnapshotFieldsChanged(g_default_state, state), priority };
+            record.new_entity = true;
+            current_index++;
+        }
+        else
+        {
+            const EntitySnapshotState& base_state = baseline_entities[baseline_index];
+            const EntitySnapshotState& state = current[current_index];
+            const float priority = priorities.empty() ? 0.0f : priorities[current_index];
+
+            const bool spawned = std::binary_search(spawned_entities.begin(), spawned_entities.end(), state.entity_id);
+            if(spawned)
+                record = { &g_default_state, &state, &base_state, SnapshotFieldsChanged(g_default_state, state) | SF_RESET, priority };
+            else
+                record = { &base_state, &state, &base_state, SnapshotFieldsChanged(base_state, state), priority };
+
+            baseline_index++;
+            current_index++;
+        }
+
+        records.push_back(record);
+    }
+
+    // Pick the most important records that fit. Costs are estimated with full ids, when that does not
+    // fit any more the cost of the selection is calculated with the real id gaps before giving up on a record.
+    std::vector<uint32_t>& candidates = g_snapshot_candidates;
+    candidates.clear();
+
+    for(uint32_t index = 0; index < records.size(); ++index)
+    {
+        SnapshotRecord& record = records[index];
+        if(record.fields != 0 || record.new_entity)
+        {
+            record.bits = EntityBits(*record.base_state, *record.state, record.fields);
+            candidates.push_back(index);
+        }
+    }
+
+    const auto sort_on_priority = [&records](uint32_t first, uint32_t second) {
+        return records[first].priority > records[second].priority;
+    };
+    std::stable_sort(candidates.begin(), candidates.end(), sort_on_priority);
+
+    std::vector<uint32_t>& selected = g_snapshot_selected;
+    selected.clear();
+
+    const uint32_t budget_bits = SnapshotMessageDataSize * 8;
+    uint32_t used_bits = 0;
+    bool estimated = false;
+
+    for(uint32_t index : candidates)
+    {
+        const uint32_t record_bits = MaxIdBits + records[index].bits;
+        if(used_bits + record_bits > budget_bits && estimated)
+        {
+            std::sort(selected.begin(), selected.end());
+
+            used_bits = 0;
+            int previous_id = -1;
+            for(uint32_t selected_index : selected)
+            {
+                const SnapshotRecord& selected_record = records[selected_index];
+                used_bits += IdBits(previous_id, selected_record.state->entity_id) + selected_record.bits;
+                previous_id = selected_record.state->entity_id;
+            }
+
+            estimated = false;
+        }
+
+        if(used_bits + record_bits > budget_bits)
+            continue;
+
+        records[index].selected = true;
+        selected.push_back(index);
+        used_bits += record_bits;
+        estimated = true;
+    }
+
+    // Write the selection in id order, records that are left out keep the baseline state.
+    BitWriter writer(out_message.data, SnapshotMessageDataSize);
+    int previous_id = -1;
+    uint16_t n_entities = 0;
+
+    std::vector<EntitySnapshotState>& sent_entities = out_sent_snapshot.entities;
+    sent_entities.clear();
+    sent_entities.reserve(records.size());
+
+    for(const SnapshotRecord& record : records)
+    {
+        bool written = false;
+        if(record.selected)
+        {
+            const uint32_t bit_position = writer.BitPosition();
+            WriteEntity(writer, previous_id, *record.base_state, *record.state, record.fields);
+            written = !writer.Overflow();
+            if(written)
+            {
+                previous_id = record.state->entity_id;
+                n_entities++;
+            }
+            else
+            {
+                writer.Rewind(bit_position);
+            }
+        }
+
+        if(record.fields & SF_REMOVED)
+        {
+            if(!written)
+                sent_entities.push_back(*record.base_state);
+        }
+        else if(written || (record.fields == 0 && !record.new_entity))
+        {
+            sent_entities.push_back(*record.state);
+        }
+        else if(record.previous_state)
+        {
+            sent_entities.push_back(*record.previous_state);
+        }
+    }
+
+    out_message.baseline_id = baseline.snapshot_id;
+    out_message.n_entities = n_entities;
+    out_message.data_size = writer.BytesWritten();
+}
+
+bool game::ReadSnapshotDelta(
+    const SnapshotMessage& message,
+    const Snapshot& baseline,
+    Snapshot& out_snapshot,
+    std::vector<EntitySnapshotChange>& out_changes)
+{
+    if(message.baseline_id != baseline.snapshot_id || message.data_size > SnapshotMessageDataSize)
+        return false;
+
+    BitReader reader(message.data, message.data_size);
+
+    out_snapshot.snapshot_id = message.snapshot_id;
+    out_snapshot.entities.clear();
+    out_changes.clear();
+
+    const std::vector<EntitySnapshotState>& baseline_entities = baseline.entities;
+    size_t baseline_index = 0;
+    int previous_id = -1;
+
+    for(uint32_t index = 0; index < message.n_entities; ++index)
+    {
+        const bool small_gap = reader.ReadBool();
+        const int entity_id = small_gap ? (previous_id + 1 + int(reader.Read(IdGapBits))) : int(reader.Read(16));
+
+        const bool only_position_rotation = reader.ReadBool();
+        const uint32_t fields = reader.Read(only_position_rotation ? 2 : SnapshotFieldBits);
+
+        if(reader.Overflow() || entity_id <= previous_id || entity_id > 0xFFFF)
+            return false;
+
+        previous_id = entity_id;
+
+        while(baseline_index < baseline_entities.size() && baseline_entities[baseline_index].entity_id < entity_id)
+            out_snapshot.entities.push_back(baseline_entities[baseline_index++]);
+
+        const bool in_baseline =
+            (baseline_index < baseline_entities.size() && baseline_entities[baseline_index].entity_id == entity_id);
+        const bool use_baseline = in_baseline && !(fields & SF_RESET);
+
+        EntitySnapshotState state = use_baseline ? baseline_entities[baseline_index] : g_default_state;
+        state.entity_id = entity_id;
+
+        if(in_baseline)
+            baseline_index++;
+
+        if(fields & SF_REMOVED)
+            continue;
+
+        ReadEntityFields(reader, fields, state);
+
+        // Everything is new for the client if there was no baseline.
+        const uint32_t changed_fields = use_baseline ? fields : (fields | SnapshotTransformFields | SnapshotSpriteFields);
+        out_changes.push_back({ uint32_t(out_snapshot.entities.size()), changed_fields });
+        out_snapshot.entities.push_back(state);
+    }
+
+    while(baseline_index < baseline_entities.size())
+        out_snapshot.entities.push_back(baseline_entities[baseline_index++]);
+
+    return !reader.Overflow();
+}
+
+TransformMessage game::MakeTransformMessage(const EntitySnapshotState& state, uint32_t timestamp)
+{
+    TransformMessage transform_message;
+    transform_message.timestamp = timestamp;
+    transform_message.entity_id = state.entity_id;
+    transform_message.parent_transform = state.parent_transform;
+    transform_message.position = math::Vector(DequantizePosition(state.position_x), DequantizePosition(state.position_y));
+    transform_message.rotation = DequantizeRotation(state.rotation);
+
+    return transform_message;
+}
+
+SpriteMessage game::MakeSpriteMessage(const EntitySnapshotState& state)
+{
+    SpriteMessage sprite_message;
+    sprite_message.entity_id = state.entity_id;
+    sprite_message.filename_hash = state.filename_hash;
+    sprite_message.hex_color = state.hex_color;
+    sprite_message.animation_id = state.animation_id;
+    sprite_message.layer = 0;
+    sprite_message.properties = state.properties;
+    sprite_message.shadow_offset_x = DequantizeShadow(state.shadow_offset_x);
+    sprite_message.shadow_offset_y = DequantizeShadow(state.shadow_offset_y);
+    sprite_message.shadow_size = DequantizeShadow(state.shadow_size);
+
+    return sprite_message;
+}
+
+bool game::IsNewerSnapshot(uint16_t first, uint16_t second)
+{
+    const uint16_t delta = first - second;
+    return delta != 0 && delta < 0x8000;
+}
+
+SnapshotReceiver::SnapshotReceiver()
+    : m_latest_snapshot_id(NoSnapshot)
+{ }
+
+bool SnapshotReceiver::ReadSnapshot(
+    const SnapshotMessage& message, std::vector<TransformMessage>& out_transforms, std::vector<SpriteMessage>& out_sprites)
+{
+    if(message.snapshot_id == NoSnapshot)
+        return false;
+
+    static const Snapshot empty_snapshot;
+    const Snapshot* baseline = &empty_snapshot;
+
+    if(message.baseline_id != NoSnapshot)
+    {
+        baseline = &m_snapshots[message.baseline_id % SnapshotHistorySize];
+        if(baseline->snapshot_id != message.baseline_id)
+        {
+            System::Log("SnapshotReceiver|Missing baseline %u for snapshot %u.", message.baseline_id, message.snapshot_id);
+            return false;
+        }
+    }
+
+    const bool success = ReadSnapshotDelta(message, *baseline, m_read_snapshot, m_changes);
+    if(!success)
+    {
+        System::Log("SnapshotReceiver|Failed to read snapshot %u.", message.snapshot_id);
+        return false;
+    }
+
+    Snapshot& snapshot = m_snapshots[message.snapshot_id % SnapshotHistorySize];
+    std::swap(snapshot, m_read_snapshot);
+
+    // An old snapshot is kept as baseline, but the states are outdated.
+    const bool is_latest = (m_latest_snapshot_id == NoSnapshot || IsNewerSnapshot(message.snapshot_id, m_latest_snapshot_id));
+    if(!is_latest)
+        return true;
+
+    m_latest_snapshot_id = message.snapshot_id;
+
+    for(const EntitySnapshotChange& change : m_changes)
+    {
+        const EntitySnapshotState& state = snapshot.entities[change.entity_index];
+
+        if(change.changed_fields & SnapshotTransformFields)
+            out_transforms.push_back(MakeTransformMessage(state, message.timestamp));
+
+        if((change.changed_fields & SnapshotSpriteFields) && state.filename_hash != 0)
+            out_sprites.push_back(MakeSpriteMessage(state));
+    }
+
+    return true;
+}
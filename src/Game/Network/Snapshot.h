@@ -0,0 +1,182 @@
+
+#pragma once
+
+#include "NetworkMessage.h"
+#include "NetworkSerialize.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    enum SnapshotField : uint32_t
+    {
+        SF_POSITION     = 1 << 0,
+        SF_ROTATION     = 1 << 1,
+        SF_PARENT       = 1 << 2,
+        SF_SPRITE_FILE  = 1 << 3,
+        SF_COLOR        = 1 << 4,
+        SF_ANIMATION    = 1 << 5,
+        SF_PROPERTIES   = 1 << 6,
+        SF_SHADOW       = 1 << 7,
+        SF_REMOVED      = 1 << 8,   // Not part of the snapshot any more
+        SF_RESET        = 1 << 9,   // New entity with the same id, ignore the baseline
+    };
+
+    constexpr uint32_t SnapshotFieldBits = 10;
+    constexpr uint32_t SnapshotTransformFields = SF_POSITION | SF_ROTATION | SF_PARENT;
+    constexpr uint32_t SnapshotSpriteFields = SF_SPRITE_FILE | SF_COLOR | SF_ANIMATION | SF_PROPERTIES | SF_SHADOW;
+
+    constexpr uint16_t NoSnapshot = 0;
+    constexpr uint16_t SnapshotNoParent = 0xFFFF;
+    constexpr uint32_t SnapshotHistorySize = 32;
+
+    // Quantized replication state of an entity. A default constructed state is the baseline for
+    // entities that the client has not seen, so fields that are still default are not sent.
+    struct EntitySnapshotState
+    {
+        uint16_t entity_id = 0;
+        uint16_t parent_transform = SnapshotNoParent;
+        int32_t position_x = 0;
+        int32_t position_y = 0;
+        uint16_t rotation = 0;
+
+        uint32_t filename_hash = 0;
+        uint32_t hex_color = 0;
+        uint32_t properties = 0;
+        uint8_t animation_id = 0;
+        int16_t shadow_offset_x = 0;
+        int16_t shadow_offset_y = 0;
+        int16_t shadow_size = 0;
+    };
+
+    // Entity states sorted on entity id.
+    struct Snapshot
+    {
+        uint16_t snapshot_id = NoSnapshot;
+        std::vector<EntitySnapshotState> entities;
+    };
+
+    int32_t QuantizePosition(float value);
+    float DequantizePosition(int32_t value);
+    uint16_t QuantizeRotation(float radians);
+    float DequantizeRotation(uint16_t value);
+    int16_t QuantizeShadow(float value);
+    float DequantizeShadow(int16_t value);
+
+    // Bitmask of SnapshotField that differ between the two states.
+    uint32_t SnapshotFieldsChanged(const EntitySnapshotState& baseline, const EntitySnapshotState& current);
+
+    // Writes the entities of current that differ from baseline, both sorted on entity id. Entities that do not
+    // fit in the message are left out and out_sent_snapshot is what the client will have after reading it,
+    // use that as baseline when the client acknowledges the snapshot. spawned_entities (sorted) are sent in full.
+    // priorities is parallel to current and decides what goes in first when everything does not fit, removed
+    // entities always go first. With no priorities the lowest ids go first.
+    void WriteSnapshotDelta(
+        const Snapshot& baseline,
+        const std::vector<EntitySnapshotState>& current,
+        const std::vector<float>& priorities,
+        const std::vector<uint32_t>& spawned_entities,
+        SnapshotMessage& out_message,
+        Snapshot& out_sent_snapshot);
+
+    struct EntitySnapshotChange
+    {
+        uint32_t entity_index;      // Index in the read snapshot
+        uint32_t changed_fields;    // SnapshotField mask
+    };
+
+    // Applies the message on baseline, returns false if the data is corrupt or the baseline does not match.
+    bool ReadSnapshotDelta(
+        const SnapshotMessage& message,
+        const Snapshot& baseline,
+        Snapshot& out_snapshot,
+        std::vector<EntitySnapshotChange>& out_changes);
+
+    TransformMessage MakeTransformMessage(const EntitySnapshotState& state, uint32_t timestamp);
+    SpriteMessage MakeSpriteMessage(const EntitySnapshotState& state);
+
+    // Returns true if snapshot id first is more recent than second, handles wrap around.
+    bool IsNewerSnapshot(uint16_t first, uint16_t second);
+
+    // Client side snapshot history, decodes snapshot messages into transform and sprite messages.
+    class SnapshotReceiver
+    {
+    public:
+
+        SnapshotReceiver();
+
+        // Returns false if the message could not be read, it should not be acknowledged then.
+        bool ReadSnapshot(
+            const SnapshotMessage& message, std::vector<TransformMessage>& out_transforms, std::vector<SpriteMessage>& out_sprites);
+
+    private:
+
+        uint16_t m_latest_snapshot_id;
+        Snapshot m_snapshots[SnapshotHistorySize];
+        Snapshot m_read_snapshot;
+        std::vector<EntitySnapshotChange> m_changes;
+    };
+
+    // The snapshot message is variable size, only the used part of the data is serialized.
+    constexpr size_t SnapshotMessageHeaderSize = offsetof(SnapshotMessage, data);
+    static_assert(sizeof(uint32_t) * 2 + SnapshotMessageHeaderSize + SnapshotMessageDataSize <= NetworkMessageBufferSize);
+
+    inline bool SerializeMessageToBuffer(const SnapshotMessage& message, std::vector<byte>& message_buffer)
+    {
+        constexpr size_t payload_type_size = sizeof(uint32_t);
+        constexpr size_t type_hash_size = sizeof(SnapshotMessage::message_type);
+        const size_t message_size = SnapshotMessageHeaderSize + message.data_size;
+
+        const size_t total_size_needed = payload_type_size + type_hash_size + message_size;
+        const size_t avalible_space = message_buffer.capacity() - message_buffer.size();
+
+        if(avalible_space < total_size_needed)
+            return false;
+
+        NetworkMessageHeader header = GetMessageBufferHeader(message_buffer);
+        ++header.n_messages;
+        SetMessageBufferHeader(message_buffer, header);
+
+        const size_t current_size = message_buffer.size();
+        message_buffer.resize(current_size + total_size_needed, '\0');
+
+        const uint32_t type_and_message_size = type_hash_size + message_size;
+
+        byte* write_pointer = message_buffer.data() + current_size;
+        std::memcpy(write_pointer, &type_and_message_size, payload_type_size);
+        std::memcpy(write_pointer + payload_type_size, &SnapshotMessage::message_type, type_hash_size);
+        std::memcpy(write_pointer + payload_type_size + type_hash_size, &message, message_size);
+
+        return true;
+    }
+
+    inline bool DeserializeMessage(const byte_view& message, SnapshotMessage& deserialized_message)
+    {
+        constexpr size_t message_type_size = sizeof(SnapshotMessage::message_type);
+        constexpr size_t min_size = message_type_size + SnapshotMessageHeaderSize;
+
+        if(message.size() < min_size || message.size() > min_size + SnapshotMessageDataSize)
+        {
+            System::Log("NetworkSerialize|Snapshot payload size missmatch! %zu", message.size());
+            return false;
+        }
+
+        if(PeekMessageType(message) != SnapshotMessage::message_type)
+        {
+            System::Log("NetworkSerialize|Message id missmatch!");
+            return false;
+        }
+
+        std::memcpy(&deserialized_message, message.data() + message_type_size, message.size() - message_type_size);
+
+        if(deserialized_message.data_size != message.size() - min_size)
+        {
+            System::Log("NetworkSerialize|Snapshot data size missmatch!");
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,159 @@
+
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace game;
+
+namespace
+{
+    constexpr int MaxCellsPerBox = 16;
+    constexpr uint32_t MinBuckets = 64;
+
+    struct CellRange
+    {
+        int min_x;
+        int min_y;
+        int max_x;
+        int max_y;
+    };
+
+    CellRange CalculateCellRange(const math::Quad& quad, float cell_size)
+    {
+        CellRange range;
+        range.min_x = int(std::floor(quad.bottom_left.x / cell_size));
+        range.min_y = int(std::floor(quad.bottom_left.y / cell_size));
+        range.max_x = int(std::floor(quad.top_right.x / cell_size));
+        range.max_y = int(std::floor(quad.top_right.y / cell_size));
+        return range;
+    }
+
+    bool Overlaps(const math::Quad& first, const math::Quad& second)
+    {
+        return
+            first.bottom_left.x <= second.top_right.x && first.top_right.x >= second.bottom_left.x &&
+            first.bottom_left.y <= second.top_right.y && first.top_right.y >= second.bottom_left.y;
+    }
+}
+
+SpatialHash::SpatialHash()
+    : m_bounds(nullptr)
+    , m_cell_size(1.0f)
+    , m_query_stamp(0)
+{ }
+
+void SpatialHash::Build(const std::vector<math::Quad>& bounds, float cell_size)
+{
+    m_bounds = &bounds;
+    m_cell_size = cell_size;
+    m_large_indices.clear();
+
+    uint32_t n_buckets = MinBuckets;
+    while(n_buckets < bounds.size() * 2)
+        n_buckets *= 2;
+
+    m_bucket_offsets.assign(n_buckets + 1, 0);
+
+    const auto for_each_cell = [this](const CellRange& range, auto&& callback) {
+        for(int cell_y = range.min_y; cell_y <= range.max_y; ++cell_y)
+        {
+            for(int cell_x = range.min_x; cell_x <= range.max_x; ++cell_x)
+                callback(CellHash(cell_x, cell_y));
+        }
+    };
+
+    const auto is_large = [](const CellRange& range) {
+        return (range.max_x - range.min_x + 1) * (range.max_y - range.min_y + 1) > MaxCellsPerBox;
+    };
+
+    // Counting sort on bucket, first count and then fill.
+    for(uint32_t index = 0; index < bounds.size(); ++index)
+    {
+        const CellRange range = CalculateCellRange(bounds[index], m_cell_size);
+        if(is_large(range))
+        {
+            m_large_indices.push_back(index);
+            continue;
+        }
+
+        for_each_cell(range, [this](uint32_t bucket) { m_bucket_offsets[bucket + 1]++; });
+    }
+
+    for(uint32_t bucket = 0; bucket < n_buckets; ++bucket)
+        m_bucket_offsets[bucket + 1] += m_bucket_offsets[bucket];
+
+    m_bucket_indices.resize(m_bucket_offsets.back());
+    std::vector<uint32_t> write_offsets(m_bucket_offsets.begin(), m_bucket_offsets.end() - 1);
+
+    for(uint32_t index = 0; index < bounds.size(); ++index)
+    {
+        const CellRange range = CalculateCellRange(bounds[index], m_cell_size);
+        if(is_large(range))
+            continue;
+
+        for_each_cell(range, [&, index](uint32_t bucket) { m_bucket_indices[write_offsets[bucket]++] = index; });
+    }
+
+    m_query_stamps.assign(bounds.size(), 0);
+    m_query_stamp = 0;
+}
+
+void SpatialHash::Query(const math::Quad& area, std::vector<uint32_t>& out_indices) const
+{
+    if(!m_bounds)
+        return;
+
+    m_query_stamp++;
+    if(m_query_stamp == 0)
+    {
+        std::fill(m_query_stamps.begin(), m_query_stamps.end(), 0);
+        m_query_stamp = 1;
+    }
+
+    const std::vector<math::Quad>& bounds = *m_bounds;
+    const size_t first_output = out_indices.size();
+
+    const auto test_index = [&](uint32_t index) {
+        if(m_query_stamps[index] == m_query_stamp)
+            return;
+
+        m_query_stamps[index] = m_query_stamp;
+        if(Overlaps(area, bounds[index]))
+            out_indices.push_back(index);
+    };
+
+    const CellRange range = CalculateCellRange(area, m_cell_size);
+    const uint32_t n_buckets = m_bucket_offsets.size() - 1;
+    const int64_t n_cells = int64_t(range.max_x - range.min_x + 1) * int64_t(range.max_y - range.min_y + 1);
+
+    if(n_cells >= n_buckets)
+    {
+        // The area covers more cells than there are buckets, just test every bucket.
+        for(uint32_t index : m_bucket_indices)
+            test_index(index);
+    }
+    else
+    {
+        for(int cell_y = range.min_y; cell_y <= range.max_y; ++cell_y)
+        {
+            for(int cell_x = range.min_x; cell_x <= range.max_x; ++cell_x)
+            {
+                const uint32_t bucket = CellHash(cell_x, cell_y);
+                for(uint32_t offset = m_bucket_offsets[bucket]; offset < m_bucket_offsets[bucket + 1]; ++offset)
+                    test_index(m_bucket_indices[offset]);
+            }
+        }
+    }
+
+    for(uint32_t index : m_large_indices)
+        test_index(index);
+
+    std::sort(out_indices.begin() + first_output, out_indices.end());
+}
+
+uint32_t SpatialHash::CellHash(int cell_x, int cell_y) const
+{
+    const uint32_t hash = (uint32_t(cell_x) * 73856093u) ^ (uint32_t(cell_y) * 19349663u);
+    return hash & (m_bucket_offsets.size() - 2);
+}
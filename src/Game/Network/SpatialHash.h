@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include "Math/Quad.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // Bounding boxes bucketed on hashed grid cells, rebuilt from scratch when the boxes change.
+    // Boxes are referenced by their index in the vector passed to Build.
+    class SpatialHash
+    {
+    public:
+
+        SpatialHash();
+
+        void Build(const std::vector<math::Quad>& bounds, float cell_size);
+
+        // Appends the indices of the boxes overlapping area, sorted and without duplicates.
+        void Query(const math::Quad& area, std::vector<uint32_t>& out_indices) const;
+
+    private:
+
+        uint32_t CellHash(int cell_x, int cell_y) const;
+
+        const std::vector<math::Quad>* m_bounds;
+        float m_cell_size;
+
+        std::vector<uint32_t> m_bucket_offsets;
+        std::vector<uint32_t> m_bucket_indices;
+
+        // Boxes that span too many cells are always tested instead.
+        std::vector<uint32_t> m_large_indices;
+
+        mutable std::vector<uint32_t> m_query_stamps;
+        mutable uint32_t m_query_stamp;
+    };
+}
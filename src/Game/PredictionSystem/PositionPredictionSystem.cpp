@@ -101,6 +101,12 @@ void PositionPredictionSystem::Update(const mono::UpdateContext& update_context)
 
 void PositionPredictionSystem::HandlePredicitonMessage(const TransformMessage& transform_message)
 {
+    if(transform_message.entity_id >= m_prediction_data.size())
+    {
+        System::Log("PositionPredictionSystem|Entity %u is outside of the prediction capacity.", transform_message.entity_id);
+        return;
+    }
+
     PredictionData& prediction_data = m_prediction_data[transform_message.entity_id];
     RemoteTransformBuffer& prediction_buffer = prediction_data.prediction_buffer;
 
@@ -127,6 +133,9 @@ void PositionPredictionSystem::HandlePredicitonMessage(const TransformMessage& t
 
 void PositionPredictionSystem::ClearPredictionsForEntity(uint32_t entity_id)
 {
+    if(entity_id >= m_prediction_data.size())
+        return;
+
     PredictionData& prediction_data = m_prediction_data[entity_id];
     prediction_data.predicted_position = math::ZeroVec;
 
@@ -0,0 +1,122 @@
+
+#include "ProcessMemory.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <cstring>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+
+    // The VmRSS and VmHWM lines of /proc/self/status, in kb.
+    size_t ReadProcStatusKb(const char* field)
+    {
+        std::FILE* file = std::fopen("/proc/self/status", "r");
+        if(!file)
+            return 0;
+
+        const size_t field_length = std::strlen(field);
+        size_t value_kb = 0;
+
+        char line[256];
+        while(std::fgets(line, sizeof(line), file))
+        {
+            if(std::strncmp(line, field, field_length) == 0 && line[field_length] == ':')
+            {
+                std::sscanf(line + field_length + 1, "%zu", &value_kb);
+                break;
+            }
+        }
+
+        std::fclose(file);
+        return value_kb;
+    }
+
+#endif
+}
+
+size_t game::ResidentBytes()
+{
+#if defined(_WIN32)
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize;
+
+#elif defined(__APPLE__)
+
+    mach_task_basic_info_data_t task_info_data;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&task_info_data), &count) != KERN_SUCCESS)
+        return 0;
+    return task_info_data.resident_size;
+
+#elif defined(__linux__)
+
+    return ReadProcStatusKb("VmRSS") * 1024;
+
+#else
+
+    return PeakResidentBytes();
+
+#endif
+}
+
+size_t game::PeakResidentBytes()
+{
+#if defined(_WIN32)
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+
+#elif defined(__APPLE__)
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return size_t(usage.ru_maxrss); // Bytes on macOS.
+
+#elif defined(__linux__)
+
+    return ReadProcStatusKb("VmHWM") * 1024;
+
+#else
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return size_t(usage.ru_maxrss) * 1024;
+
+#endif
+}
+
+bool game::ResetPeakResidentBytes()
+{
+#if defined(__linux__)
+
+    // Writing 5 to clear_refs resets VmHWM to the current resident size.
+    std::FILE* file = std::fopen("/proc/self/clear_refs", "w");
+    if(!file)
+        return false;
+
+    const bool written = (std::fputs("5", file) >= 0);
+    return (std::fclose(file) == 0) && written;
+
+#else
+
+    return false;
+
+#endif
+}
@@ -0,0 +1,15 @@
+
+#pragma once
+
+#include <cstddef>
+
+namespace game
+{
+    // Resident memory of the whole process in bytes, for the load benchmarks.
+    size_t ResidentBytes();
+    size_t PeakResidentBytes();
+
+    // Starts the peak over from the current resident memory. Only Linux can do this, elsewhere it returns
+    // false and the peak stays the highest since the process started.
+    bool ResetPeakResidentBytes();
+}
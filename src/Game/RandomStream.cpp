@@ -0,0 +1,10 @@
+
+#include "RandomStream.h"
+#include "Util/Random.h"
+
+#include <limits>
+
+uint32_t game::MakeRandomSeed()
+{
+    return mono::RandomInt(0, std::numeric_limits<int>::max());
+}
@@ -0,0 +1,51 @@
+
+#pragma once
+
+#include <cstdint>
+
+namespace game
+{
+    // Small seedable random number generator (splitmix64), for logics that need to be repeatable. Seeded
+    // per entity, so the numbers one entity gets do not depend on how many numbers the others used or
+    // in which order the entities were updated.
+    class RandomStream
+    {
+    public:
+
+        RandomStream()
+            : m_state(0)
+        { }
+
+        RandomStream(uint32_t seed, uint32_t entity_id)
+            : m_state((uint64_t(seed) << 32) | entity_id)
+        { }
+
+        // In [min_value, max_value).
+        float Random(float min_value, float max_value)
+        {
+            const float unit = float(Next() >> 40) * (1.0f / 16777216.0f);
+            return min_value + unit * (max_value - min_value);
+        }
+
+        // True percentage out of 100 times.
+        bool Chance(int percentage)
+        {
+            return Random(0.0f, 100.0f) < float(percentage);
+        }
+
+    private:
+
+        uint64_t Next()
+        {
+            uint64_t value = (m_state += 0x9E3779B97F4A7C15ull);
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+
+        uint64_t m_state;
+    };
+
+    // A seed from the global random generator, for when nothing needs to be repeated.
+    uint32_t MakeRandomSeed();
+}
@@ -0,0 +1,97 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game
+{
+    // Fixed size blocks carved out of larger pages, freed blocks are reused before a new page is allocated.
+    // Pages are never returned, so pointers stay valid until the allocator is destroyed.
+    class SlabAllocator
+    {
+    public:
+
+        static size_t BlockSizeFor(size_t size)
+        {
+            constexpr size_t alignment = alignof(std::max_align_t);
+            const size_t block_size = std::max(size, sizeof(FreeBlock));
+            return (block_size + alignment - 1) / alignment * alignment;
+        }
+
+        SlabAllocator(size_t block_size, uint32_t blocks_per_page)
+            : m_block_size(BlockSizeFor(block_size))
+            , m_blocks_per_page(blocks_per_page)
+            , m_free_list(nullptr)
+            , m_blocks_in_use(0)
+        { }
+
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        void* Allocate()
+        {
+            if(!m_free_list)
+                AddPage();
+
+            FreeBlock* block = m_free_list;
+            m_free_list = block->next;
+            m_blocks_in_use++;
+            return block;
+        }
+
+        void Free(void* memory)
+        {
+            FreeBlock* block = static_cast<FreeBlock*>(memory);
+            block->next = m_free_list;
+            m_free_list = block;
+            m_blocks_in_use--;
+        }
+
+        size_t BlockSize() const
+        {
+            return m_block_size;
+        }
+
+        uint32_t BlocksInUse() const
+        {
+            return m_blocks_in_use;
+        }
+
+        uint32_t Pages() const
+        {
+            return m_pages.size();
+        }
+
+    private:
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void AddPage()
+        {
+            // new[] of max_align_t keeps every block aligned for any logic type.
+            const size_t n_elements = (m_block_size * m_blocks_per_page) / sizeof(std::max_align_t);
+            m_pages.push_back(std::make_unique<std::max_align_t[]>(n_elements));
+
+            std::byte* page = reinterpret_cast<std::byte*>(m_pages.back().get());
+            for(uint32_t index = m_blocks_per_page; index > 0; --index)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(page + (index - 1) * m_block_size);
+                block->next = m_free_list;
+                m_free_list = block;
+            }
+        }
+
+        const size_t m_block_size;
+        const uint32_t m_blocks_per_page;
+        FreeBlock* m_free_list;
+        uint32_t m_blocks_in_use;
+        std::vector<std::unique_ptr<std::max_align_t[]>> m_pages;
+    };
+}
@@ -1,5 +1,6 @@
 
 #include "SpawnSystem.h"
+#include "Entity/EntityPrefabSystem.h"
 #include "EntitySystem/IEntityManager.h"
 #include "TransformSystem/TransformSystem.h"
 #include "TriggerSystem/TriggerSystem.h"
@@ -24,9 +25,15 @@ namespace
     constexpr uint32_t NO_CALLBACK_SET = std::numeric_limits<uint32_t>::max();
 }
 
-SpawnSystem::SpawnSystem(uint32_t n, mono::TriggerSystem* trigger_system, mono::IEntityManager* entity_manager, mono::TransformSystem* transform_system)
+SpawnSystem::SpawnSystem(
+    uint32_t n,
+    mono::TriggerSystem* trigger_system,
+    mono::IEntityManager* entity_manager,
+    EntityPrefabSystem* prefab_system,
+    mono::TransformSystem* transform_system)
     : m_trigger_system(trigger_system)
     , m_entity_manager(entity_manager)
+    , m_prefab_system(prefab_system)
     , m_transform_system(transform_system)
     , m_spawn_points(n)
     , m_entity_spawn_points(n)
@@ -161,6 +168,9 @@ void SpawnSystem::SetEntitySpawnPointData(uint32_t entity_id, const std::string&
     component->radius = spawn_radius;
     component->spawn_trigger = spawn_trigger;
 
+    if(!entity_file.empty())
+        m_prefab_system->Preload(entity_file.c_str());
+
     if(component->callback_id != NO_CALLBACK_SET)
         m_trigger_system->RemoveTriggerCallback(component->spawn_trigger, component->callback_id, entity_id);
 
@@ -253,6 +263,12 @@ const char* SpawnSystem::Name() const
     return "spawnsystem";
 }
 
+void SpawnSystem::Begin()
+{
+    for(const SpawnDefinition& spawn_definition : m_spawn_definitions)
+        m_prefab_system->Preload(spawn_definition.entity_file.c_str());
+}
+
 void SpawnSystem::Update(const mono::UpdateContext& update_context)
 {
     const auto collect_spawn_points = [&](uint32_t entity_id, SpawnPointComponent& spawn_point) {
@@ -352,7 +368,7 @@ void SpawnSystem::Update(const mono::UpdateContext& update_context)
             spawn_definition = m_spawn_definitions[clamped_spawn_def_index];
         }
 
-        mono::Entity spawned_entity = m_entity_manager->SpawnEntity(spawn_definition.entity_file.c_str());
+        mono::Entity spawned_entity = m_prefab_system->SpawnEntity(spawn_definition.entity_file.c_str());
         m_transform_system->SetTransform(spawned_entity.id, spawn_event.transform, mono::TransformState::CLIENT);
         spawn_event.spawned_entity_id = spawned_entity.id;
 
@@ -90,7 +90,12 @@ namespace game
 
         static const uint32_t spawn_delay_time_ms = 500;
 
-        SpawnSystem(uint32_t n, mono::TriggerSystem* trigger_system, mono::IEntityManager* entity_manager, mono::TransformSystem* transform_system);
+        SpawnSystem(
+            uint32_t n,
+            mono::TriggerSystem* trigger_system,
+            mono::IEntityManager* entity_manager,
+            class EntityPrefabSystem* prefab_system,
+            mono::TransformSystem* transform_system);
 
         SpawnPointComponent* AllocateSpawnPoint(uint32_t entity_id);
         void ReleaseSpawnPoint(uint32_t entity_id);
@@ -112,6 +117,7 @@ namespace game
         void RemoveGlobalSpawnCallback(uint32_t callback_id);
 
         const char* Name() const override;
+        void Begin() override;
         void Update(const mono::UpdateContext& update_context) override;
         void Sync() override;
         void Reset() override;
@@ -132,6 +138,7 @@ namespace game
 
         mono::TriggerSystem* m_trigger_system;
         mono::IEntityManager* m_entity_manager;
+        game::EntityPrefabSystem* m_prefab_system;
         mono::TransformSystem* m_transform_system;
 
         std::vector<audio::ISoundPtr> m_spawn_sounds;
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <unordered_map>
 
@@ -108,3 +109,107 @@ private:
     StateId m_wanted_state{ -1 };
     StateTable m_states;
 };
+
+// Same interface as StateMachine, but for states that are member functions of the owner. The state table is
+// an array indexed by the state id that calls the member functions directly, so it can be a static constexpr
+// table shared by all instances. No std::function, no hash lookups and nothing allocated per instance.
+// The table has to list the states in enum order starting at zero, check it with IsStateTableOrdered.
+template <typename T, typename StateId, typename UpdateContext>
+class StaticStateMachine
+{
+public:
+
+    using EnterFunc = void (T::*)();
+    using UpdateFunc = void (T::*)(UpdateContext);
+    using ExitFunc = void (T::*)();
+
+    struct State
+    {
+        StateId id;
+        EnterFunc enter_state;
+        UpdateFunc update_state;
+        ExitFunc exit_state;
+    };
+
+    static constexpr State MakeState(StateId id, EnterFunc enter_func, UpdateFunc update_func, ExitFunc exit_func)
+    {
+        return { id, enter_func, update_func, exit_func };
+    }
+
+    static constexpr State MakeState(StateId id, EnterFunc enter_func, UpdateFunc update_func)
+    {
+        return { id, enter_func, update_func, nullptr };
+    }
+
+    static constexpr State MakeState(StateId id, EnterFunc enter_func)
+    {
+        return { id, enter_func, nullptr, nullptr };
+    }
+
+    template <size_t N>
+    static constexpr bool IsStateTableOrdered(const State (&state_table)[N])
+    {
+        for(size_t index = 0; index < N; ++index)
+        {
+            if(size_t(state_table[index].id) != index)
+                return false;
+        }
+
+        return true;
+    }
+
+    template <size_t N>
+    void SetStateTableAndState(T* owner, const State (&state_table)[N], StateId initial_state)
+    {
+        m_owner = owner;
+        m_states = state_table;
+        m_wanted_state = initial_state;
+    }
+
+    void TransitionTo(StateId new_state)
+    {
+        m_wanted_state = new_state;
+    }
+
+    StateId ActiveState() const
+    {
+        return m_active_state;
+    }
+
+    StateId PreviousState() const
+    {
+        return m_previous_state;
+    }
+
+    void UpdateState(UpdateContext argument)
+    {
+        if(m_active_state != m_wanted_state)
+        {
+            if(m_active_state != StateId(-1))
+            {
+                const State& old_state = m_states[size_t(m_active_state)];
+                if(old_state.exit_state)
+                    (m_owner->*old_state.exit_state)();
+            }
+
+            const State& state = m_states[size_t(m_wanted_state)];
+            if(state.enter_state)
+                (m_owner->*state.enter_state)();
+
+            m_previous_state = m_active_state;
+            m_active_state = m_wanted_state;
+        }
+
+        const State& state = m_states[size_t(m_active_state)];
+        if(state.update_state)
+            (m_owner->*state.update_state)(argument);
+    }
+
+private:
+
+    StateId m_previous_state{ -1 };
+    StateId m_active_state{ -1 };
+    StateId m_wanted_state{ -1 };
+    T* m_owner = nullptr;
+    const State* m_states = nullptr;
+};
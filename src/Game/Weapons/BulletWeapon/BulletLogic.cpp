@@ -1,8 +1,8 @@
 
 #include "BulletLogic.h"
+#include "BulletSoundPool.h"
 #include "CollisionConfiguration.h"
 
-#include "System/Audio.h"
 #include "Util/Random.h"
 #include "Math/MathFunctions.h"
 
@@ -12,6 +12,7 @@
 #include "TransformSystem/TransformSystem.h"
 
 #include "System/System.h"
+#include "System/Hash.h"
 
 #include "DamageSystem/DamageSystem.h"
 #include "Debug/IDebugDrawer.h"
@@ -39,7 +40,8 @@ BulletLogic::BulletLogic(
     const CollisionConfiguration& collision_config,
     mono::TransformSystem* transform_system,
     mono::PhysicsSystem* physics_system,
-    TargetSystem* target_system)
+    TargetSystem* target_system,
+    BulletSoundPool* sound_pool)
     : m_entity_id(entity_id)
     , m_owner_entity_id(owner_entity_id)
     , m_weapon_identifier_hash(weapon_identifier_hash)
@@ -49,9 +51,10 @@ BulletLogic::BulletLogic(
     , m_physics_system(physics_system)
     , m_target_system(target_system)
     , m_damage(0)
-    , m_impact_entity(bullet_config.impact_entity_file)
+    , m_impact_entity_hash(bullet_config.impact_entity_hash)
     , m_bullet_collision_behaviour(bullet_config.bullet_collision_behaviour)
     , m_bullet_movement_behaviour(bullet_config.bullet_movement_behaviour)
+    , m_sound_pool(sound_pool)
     , m_circulating_behaviour(transform_system)
 {
     m_critical_hit = mono::Chance(bullet_config.critical_hit_chance);
@@ -65,10 +68,7 @@ BulletLogic::BulletLogic(
     m_is_player_faction = (collision_config.collision_category & CollisionCategory::PLAYER_BULLET);
     m_jumps_left = 3;
 
-    m_sound = bullet_config.sound_file.empty() ?
-        audio::CreateNullSound() :
-        audio::CreateSound(bullet_config.sound_file.c_str(), audio::SoundPlayback::LOOPING, audio::SoundSpatiality::NONE);
-    m_sound->Play();
+    m_sound_voice = m_sound_pool->AcquireVoice(bullet_config.sound_file);
 
     mono::IBody* bullet_body = m_physics_system->GetBody(entity_id);
     bullet_body->AddCollisionHandler(this);
@@ -95,22 +95,17 @@ BulletLogic::BulletLogic(
     m_origin = bullet_position;
 }
 
+BulletLogic::~BulletLogic()
+{
+    m_sound_pool->ReleaseVoice(m_sound_voice);
+}
+
 void BulletLogic::Update(const mono::UpdateContext& update_context)
 {
     m_life_span -= update_context.delta_s;
     if(m_life_span < 0.0f)
     {
-        DamageDetails damage_details;
-        damage_details.damage = 0;
-        damage_details.critical_hit = false;
-
-        CollisionDetails details;
-        details.body = nullptr;
-        details.point = math::ZeroVec;
-        details.normal = math::ZeroVec;
-        details.material = 0;
-
-        m_collision_callback(m_entity_id, m_owner_entity_id, m_weapon_identifier_hash, nullptr, BulletImpactFlag::DESTROY_THIS, damage_details, details);
+        Expire();
         return;
     }
 
@@ -139,6 +134,53 @@ void BulletLogic::Update(const mono::UpdateContext& update_context)
     }
 }
 
+bool BulletLogic::IsThreadSafe() const
+{
+    // Homing acquires targets from the target system. The circulating and sine wave bullets only read transforms
+    // and record the body changes, setting them from the workers would wake up the bodies they touch.
+    return (m_bullet_movement_behaviour & BulletMovementFlag::HOMING) == 0;
+}
+
+void BulletLogic::UpdateWithCommands(const mono::UpdateContext& update_context, LogicCommandBuffer& commands)
+{
+    m_life_span -= update_context.delta_s;
+    if(m_life_span < 0.0f)
+    {
+        commands.Call(&BulletLogic::ExpireDeferred, this, m_entity_id);
+        return;
+    }
+
+    if(m_bullet_movement_behaviour & BulletMovementFlag::CIRCULATING)
+    {
+        commands.SetBodyVelocity(m_entity_id, m_circulating_behaviour.NextVelocity(update_context));
+    }
+    else if(m_bullet_movement_behaviour & BulletMovementFlag::SINEWAVE)
+    {
+        commands.SetBodyPosition(m_entity_id, m_sinewave_behaviour.NextPosition(update_context));
+        commands.SetBodyVelocity(m_entity_id, math::ZeroVec);
+    }
+}
+
+void BulletLogic::Expire()
+{
+    DamageDetails damage_details;
+    damage_details.damage = 0;
+    damage_details.critical_hit = false;
+
+    CollisionDetails details;
+    details.body = nullptr;
+    details.point = math::ZeroVec;
+    details.normal = math::ZeroVec;
+    details.material = 0;
+
+    (*m_collision_callback)(m_entity_id, m_owner_entity_id, m_weapon_identifier_hash, nullptr, BulletImpactFlag::DESTROY_THIS, damage_details, details);
+}
+
+void BulletLogic::ExpireDeferred(void* context, uint32_t entity_id)
+{
+    static_cast<BulletLogic*>(context)->Expire();
+}
+
 mono::CollisionResolve BulletLogic::OnCollideWith(
     mono::IBody* colliding_body, const math::Vector& collision_point, const math::Vector& collision_normal, uint32_t categories)
 {
@@ -207,7 +249,7 @@ mono::CollisionResolve BulletLogic::OnCollideWith(
         //System::Log("EXPLODE THE BULLET PLX");
     }
    
-    const char* impact_entity = m_impact_entity.empty() ? nullptr : m_impact_entity.c_str();
+    const char* impact_entity = (m_impact_entity_hash != 0) ? hash::HashLookup(m_impact_entity_hash) : nullptr;
     
     mono::CollisionResolve resolve_type = mono::CollisionResolve::NORMAL;
     BulletImpactFlag collision_flags = BulletImpactFlag(APPLY_DAMAGE | DESTROY_THIS);
@@ -238,7 +280,7 @@ mono::CollisionResolve BulletLogic::OnCollideWith(
     collision_details.normal = collision_normal;
     collision_details.material = colliding_body->GetMaterial();
 
-    m_collision_callback(
+    (*m_collision_callback)(
         m_entity_id,
         m_owner_entity_id,
         m_weapon_identifier_hash,
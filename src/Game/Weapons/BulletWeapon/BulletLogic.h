@@ -2,10 +2,10 @@
 #pragma once
 
 #include "MonoFwd.h"
-#include "System/Audio.h"
 #include "Physics/IBody.h"
 
 #include "Entity/IEntityLogic.h"
+#include "Entity/LogicCommandBuffer.h"
 #include "Weapons/WeaponConfiguration.h"
 #include "Behaviour/HomingBehaviour.h"
 #include "Behaviour/CirculatingBehaviour.h"
@@ -32,9 +32,14 @@ namespace game
             const CollisionConfiguration& collision_config,
             mono::TransformSystem* transform_system,
             mono::PhysicsSystem* physics_system,
-            class TargetSystem* target_system);
+            class TargetSystem* target_system,
+            class BulletSoundPool* sound_pool);
+
+        ~BulletLogic();
         
         void Update(const mono::UpdateContext& update_context) override;
+        bool IsThreadSafe() const override;
+        void UpdateWithCommands(const mono::UpdateContext& update_context, LogicCommandBuffer& commands) override;
         
         mono::CollisionResolve OnCollideWith(
             mono::IBody* body,
@@ -44,6 +49,11 @@ namespace game
         
         void OnSeparateFrom(mono::IBody* body) override;
 
+    private:
+
+        void Expire();
+        static void ExpireDeferred(void* context, uint32_t entity_id);
+
         const uint32_t m_entity_id;
         const uint32_t m_owner_entity_id;
         uint32_t m_weapon_identifier_hash;
@@ -51,14 +61,14 @@ namespace game
 
         math::Vector m_origin;
 
-        BulletImpactCallback m_collision_callback;
+        const BulletImpactCallback* m_collision_callback;
         mono::TransformSystem* m_transform_system;
         mono::PhysicsSystem* m_physics_system;
         class TargetSystem* m_target_system;
 
         bool m_critical_hit;
         int m_damage;
-        std::string m_impact_entity;
+        uint32_t m_impact_entity_hash;
         uint32_t m_bullet_collision_behaviour;
         uint32_t m_bullet_movement_behaviour;
 
@@ -70,7 +80,8 @@ namespace game
         bool m_is_player_faction;
         int m_jumps_left;
 
-        audio::ISoundPtr m_sound;
+        class BulletSoundPool* m_sound_pool;
+        uint32_t m_sound_voice;
         ITargetPtr m_aquired_target;
 
         std::vector<uint32_t> m_jump_ids;
@@ -0,0 +1,73 @@
+
+#include "BulletSoundPool.h"
+#include "System/Hash.h"
+
+using namespace game;
+
+audio::ISoundPtr BulletSoundPool::CreateLoopingSound(const char* sound_file)
+{
+    return audio::CreateSound(sound_file, audio::SoundPlayback::LOOPING, audio::SoundSpatiality::NONE);
+}
+
+BulletSoundPool::BulletSoundPool(uint32_t voices_per_sound, CreateSoundFunc create_sound)
+    : m_voices_per_sound(voices_per_sound)
+    , m_create_sound(create_sound)
+    , m_stats({ })
+{ }
+
+uint32_t BulletSoundPool::AcquireVoice(const std::string& sound_file)
+{
+    if(sound_file.empty())
+        return NoVoice;
+
+    const uint32_t sound_hash = hash::Hash(sound_file.c_str());
+    auto it = m_sound_to_first_voice.find(sound_hash);
+    if(it == m_sound_to_first_voice.end())
+    {
+        it = m_sound_to_first_voice.emplace(sound_hash, m_voices.size()).first;
+        for(uint32_t index = 0; index < m_voices_per_sound; ++index)
+        {
+            m_voices.push_back({ m_create_sound(sound_file.c_str()), 0 });
+        }
+
+        m_stats.sounds_created += m_voices_per_sound;
+    }
+
+    // The least used voice, when all of them are playing the new bullet shares one.
+    const uint32_t first_voice = it->second;
+    uint32_t voice = first_voice;
+    for(uint32_t index = first_voice + 1; index < first_voice + m_voices_per_sound; ++index)
+    {
+        if(m_voices[index].users < m_voices[voice].users)
+            voice = index;
+    }
+
+    Voice& selected_voice = m_voices[voice];
+    if(selected_voice.users == 0)
+    {
+        selected_voice.sound->Play();
+        m_stats.voices_playing++;
+    }
+
+    selected_voice.users++;
+    return voice;
+}
+
+void BulletSoundPool::ReleaseVoice(uint32_t voice)
+{
+    if(voice == NoVoice)
+        return;
+
+    Voice& released_voice = m_voices[voice];
+    released_voice.users--;
+    if(released_voice.users == 0)
+    {
+        released_voice.sound->Stop();
+        m_stats.voices_playing--;
+    }
+}
+
+const BulletSoundStats& BulletSoundPool::GetStats() const
+{
+    return m_stats;
+}
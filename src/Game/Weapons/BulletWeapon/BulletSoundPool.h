@@ -0,0 +1,50 @@
+
+#pragma once
+
+#include "System/Audio.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace game
+{
+    struct BulletSoundStats
+    {
+        uint32_t sounds_created;
+        uint32_t voices_playing;
+    };
+
+    // A few looping voices per bullet sound, shared by all bullets in flight instead of one sound per bullet.
+    class BulletSoundPool
+    {
+    public:
+
+        static constexpr uint32_t NoVoice = uint32_t(-1);
+
+        using CreateSoundFunc = audio::ISoundPtr (*)(const char* sound_file);
+        static audio::ISoundPtr CreateLoopingSound(const char* sound_file);
+
+        BulletSoundPool(uint32_t voices_per_sound, CreateSoundFunc create_sound = CreateLoopingSound);
+
+        uint32_t AcquireVoice(const std::string& sound_file);
+        void ReleaseVoice(uint32_t voice);
+
+        const BulletSoundStats& GetStats() const;
+
+    private:
+
+        struct Voice
+        {
+            audio::ISoundPtr sound;
+            uint32_t users;
+        };
+
+        const uint32_t m_voices_per_sound;
+        const CreateSoundFunc m_create_sound;
+        std::unordered_map<uint32_t, uint32_t> m_sound_to_first_voice;
+        std::vector<Voice> m_voices;
+        BulletSoundStats m_stats;
+    };
+}
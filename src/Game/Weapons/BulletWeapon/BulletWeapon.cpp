@@ -8,8 +8,8 @@
 #include "BulletLogic.h"
 #include "Entity/Component.h"
 #include "Entity/TargetSystem.h"
-#include "Effects/MuzzleFlash.h"
 #include "Effects/BulletTrailEffect.h"
+#include "Effects/MuzzleFlash.h"
 
 #include "SystemContext.h"
 #include "EntitySystem/IEntityManager.h"
@@ -17,7 +17,6 @@
 #include "Math/Vector.h"
 #include "Math/MathFunctions.h"
 #include "Physics/PhysicsSystem.h"
-#include "Particle/ParticleSystem.h"
 #include "Rendering/Sprite/SpriteSystem.h"
 #include "System/Audio.h"
 #include "TransformSystem/TransformSystem.h"
@@ -40,8 +39,8 @@ Weapon::Weapon(
     : m_owner_id(owner_id)
     , m_weapon_setup(weapon_setup)
     , m_weapon_config(weapon_config)
-    , m_bullet_config(bullet_config)
     , m_collision_config(collision_config)
+    , m_effective_config(weapon_config, bullet_config)
     , m_entity_manager(entity_manager)
     , m_last_fire_timestamp(0)
     , m_last_reload_timestamp(0)
@@ -67,22 +66,35 @@ Weapon::Weapon(
     if(!m_weapon_config.reload_finished_sound.empty())
         m_reload_finished_sound = audio::CreateSound(m_weapon_config.reload_sound.c_str(), audio::SoundPlayback::ONCE, audio::SoundSpatiality::NONE);
 
-    m_transform_system = system_context->GetSystem<mono::TransformSystem>();
-    m_physics_system = system_context->GetSystem<mono::PhysicsSystem>();
-    m_particle_system = system_context->GetSystem<mono::ParticleSystem>();
-    m_sprite_system = system_context->GetSystem<mono::SpriteSystem>();
-    m_logic_system = system_context->GetSystem<EntityLogicSystem>();
-    m_target_system = system_context->GetSystem<TargetSystem>();
     m_weapon_system = system_context->GetSystem<WeaponSystem>();
 
-    m_muzzle_flash = std::make_unique<MuzzleFlash>(m_particle_system, m_entity_manager);
-    m_bullet_trail = std::make_unique<BulletTrailEffect>(m_transform_system, m_particle_system, m_entity_manager);
+    m_release_callback = [this](uint32_t entity_id, mono::ReleasePhase phase) {
+        BulletTrailEffect* bullet_trail = m_weapon_system->GetBulletTrail();
+        if(bullet_trail)
+            bullet_trail->RemoveEmitterFromBullet(entity_id);
+
+        const auto it = std::find_if(m_bullet_callbacks.begin(), m_bullet_callbacks.end(), [entity_id](const BulletReleaseCallback& callback) {
+            return callback.bullet_id == entity_id;
+        });
+        if(it != m_bullet_callbacks.end())
+        {
+            *it = m_bullet_callbacks.back();
+            m_bullet_callbacks.pop_back();
+        }
+    };
 }
 
 Weapon::~Weapon()
 {
-    for(const auto& pair : m_bullet_id_to_callback)
-        m_entity_manager->RemoveReleaseCallback(pair.first, pair.second);
+    // The trail effect is shared, so the trails of bullets still in flight are removed here.
+    BulletTrailEffect* bullet_trail = m_weapon_system->GetBulletTrail();
+
+    for(const BulletReleaseCallback& callback : m_bullet_callbacks)
+    {
+        m_entity_manager->RemoveReleaseCallback(callback.bullet_id, callback.callback_id);
+        if(bullet_trail)
+            bullet_trail->RemoveEmitterFromBullet(callback.bullet_id);
+    }
 }
 
 WeaponState Weapon::Fire(const math::Vector& position, const math::Vector& target, uint32_t timestamp)
@@ -101,11 +113,15 @@ WeaponState Weapon::Fire(const math::Vector& position, const math::Vector& targe
         return m_state;
     }
 
-    WeaponConfiguration local_weapon_config = m_weapon_config;
+    const uint32_t modifiers_version = m_weapon_system->ModifiersVersion();
+    if(!m_effective_config.IsCurrent(modifiers_version))
+    {
+        m_effective_config.Rebuild(
+            modifiers_version, m_weapon_system->GetWeaponModifiersForIdAndWeapon(m_owner_id, m_weapon_setup.weapon_identifier_hash));
+    }
 
-    const WeaponModifierList& modifier_list = m_weapon_system->GetWeaponModifiersForIdAndWeapon(m_owner_id, m_weapon_setup.weapon_identifier_hash);
-    for(const auto& modifier : modifier_list)
-        local_weapon_config = modifier->ModifyWeapon(local_weapon_config);
+    const WeaponConfiguration& local_weapon_config = m_effective_config.Weapon();
+    const BulletConfiguration& local_bullet_config = m_effective_config.Bullet();
 
     const float rps_hz = 1.0f / local_weapon_config.rounds_per_second;
     const uint32_t weapon_delta = rps_hz * 1000.0f;
@@ -124,21 +140,12 @@ WeaponState Weapon::Fire(const math::Vector& position, const math::Vector& targe
 
     m_last_fire_timestamp = timestamp;
 
-    const WeaponEntityFactory entity_factory(
-        m_entity_manager, m_sprite_system, m_transform_system, m_physics_system, m_logic_system, m_target_system);
-
-    const mono::ReleaseCallback release_callback = [this](uint32_t entity_id, mono::ReleasePhase phase) {
-        m_bullet_trail->RemoveEmitterFromBullet(entity_id);
-        m_bullet_id_to_callback.erase(entity_id);
-    };
+    const WeaponEntityFactory& entity_factory = m_weapon_system->GetWeaponEntityFactory();
+    BulletTrailEffect* bullet_trail = m_weapon_system->GetBulletTrail();
 
     const math::Vector fire_direction = math::Normalized(target - position);
     const math::Vector perpendicular_fire_direction = math::Perpendicular(fire_direction);
 
-    BulletConfiguration local_bullet_config = m_bullet_config;
-    for(const auto& modifier : modifier_list)
-        local_bullet_config = modifier->ModifyBullet(local_bullet_config);
-
     for(int n_bullet = 0; n_bullet < local_weapon_config.projectiles_per_fire; ++n_bullet)
     {
         const float fire_direction_deviation =
@@ -162,12 +169,18 @@ WeaponState Weapon::Fire(const math::Vector& position, const math::Vector& targe
         mono::Entity bullet_entity = entity_factory.CreateBulletEntity(
             m_owner_id, m_weapon_setup.weapon_identifier_hash, local_bullet_config, m_collision_config, target, velocity, bullet_direction, transform);
 
-        m_bullet_trail->AttachEmitterToBullet(bullet_entity.id);
+        if(bullet_trail)
+            bullet_trail->AttachEmitterToBullet(bullet_entity.id);
 
-        const uint32_t callback_id = m_entity_manager->AddReleaseCallback(bullet_entity.id, mono::ReleasePhase::POST_RELEASE, release_callback);
-        m_bullet_id_to_callback[bullet_entity.id] = callback_id;
+        const uint32_t callback_id = m_entity_manager->AddReleaseCallback(bullet_entity.id, mono::ReleasePhase::POST_RELEASE, m_release_callback);
+        m_bullet_callbacks.push_back({ bullet_entity.id, callback_id });
     }
 
+    // One flash per shot from the shared pool, not one per projectile.
+    MuzzleFlash* muzzle_flash = m_weapon_system->GetMuzzleFlash();
+    if(muzzle_flash)
+        muzzle_flash->EmittAt(position, math::AngleFromVector(fire_direction));
+
     m_fire_sound->Play();
 
     m_current_fire_rate *= local_weapon_config.fire_rate_multiplier;
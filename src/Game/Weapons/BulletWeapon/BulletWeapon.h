@@ -4,11 +4,13 @@
 #include "MonoFwd.h"
 #include "Weapons/IWeapon.h"
 #include "Weapons/WeaponConfiguration.h"
+#include "Weapons/EffectiveWeaponConfig.h"
+#include "EntitySystem/IEntityManager.h"
 
 #include "System/Audio.h"
 #include "Math/MathFwd.h"
 
-#include <unordered_map>
+#include <vector>
 
 namespace game
 {
@@ -44,8 +46,8 @@ namespace game
         const uint32_t m_owner_id;
         const WeaponSetup m_weapon_setup;
         const WeaponConfiguration m_weapon_config;
-        const BulletConfiguration m_bullet_config;
         const CollisionConfiguration m_collision_config;
+        EffectiveWeaponConfig m_effective_config;
         mono::IEntityManager* m_entity_manager;
         uint32_t m_last_fire_timestamp;
         uint32_t m_last_reload_timestamp;
@@ -59,17 +61,14 @@ namespace game
         audio::ISoundPtr m_reload_sound;
         audio::ISoundPtr m_reload_finished_sound;
 
-        mono::TransformSystem* m_transform_system;
-        mono::PhysicsSystem* m_physics_system;
-        mono::ParticleSystem* m_particle_system;
-        mono::SpriteSystem* m_sprite_system;
-        EntityLogicSystem* m_logic_system;
-        class TargetSystem* m_target_system;
         class WeaponSystem* m_weapon_system;
 
-        std::unique_ptr<class MuzzleFlash> m_muzzle_flash;
-        std::unique_ptr<class BulletTrailEffect> m_bullet_trail;
-
-        std::unordered_map<uint32_t, uint32_t> m_bullet_id_to_callback;
+        struct BulletReleaseCallback
+        {
+            uint32_t bullet_id;
+            uint32_t callback_id;
+        };
+        std::vector<BulletReleaseCallback> m_bullet_callbacks;
+        mono::ReleaseCallback m_release_callback;
     };
 }
@@ -0,0 +1,43 @@
+
+#include "EffectiveWeaponConfig.h"
+
+using namespace game;
+
+EffectiveWeaponConfig::EffectiveWeaponConfig(const WeaponConfiguration& weapon_config, const BulletConfiguration& bullet_config)
+    : m_base_weapon_config(weapon_config)
+    , m_base_bullet_config(bullet_config)
+    , m_weapon_config(weapon_config)
+    , m_bullet_config(bullet_config)
+    , m_modifiers_version(0)
+    , m_valid(false)
+{ }
+
+bool EffectiveWeaponConfig::IsCurrent(uint32_t modifiers_version) const
+{
+    return m_valid && m_modifiers_version == modifiers_version;
+}
+
+void EffectiveWeaponConfig::Rebuild(uint32_t modifiers_version, const WeaponModifierList& modifiers)
+{
+    m_weapon_config = m_base_weapon_config;
+    m_bullet_config = m_base_bullet_config;
+
+    for(IWeaponModifier* modifier : modifiers)
+    {
+        m_weapon_config = modifier->ModifyWeapon(m_weapon_config);
+        m_bullet_config = modifier->ModifyBullet(m_bullet_config);
+    }
+
+    m_modifiers_version = modifiers_version;
+    m_valid = true;
+}
+
+const WeaponConfiguration& EffectiveWeaponConfig::Weapon() const
+{
+    return m_weapon_config;
+}
+
+const BulletConfiguration& EffectiveWeaponConfig::Bullet() const
+{
+    return m_bullet_config;
+}
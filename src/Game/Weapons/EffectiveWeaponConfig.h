@@ -0,0 +1,34 @@
+
+#pragma once
+
+#include "Weapons/IWeaponModifier.h"
+#include "Weapons/WeaponConfiguration.h"
+
+#include <cstdint>
+
+namespace game
+{
+    // The weapon and bullet configuration with all modifiers applied. Rebuilt when the modifiers version
+    // from the weapon system changes, so firing reads the configuration without copying it.
+    class EffectiveWeaponConfig
+    {
+    public:
+
+        EffectiveWeaponConfig(const WeaponConfiguration& weapon_config, const BulletConfiguration& bullet_config);
+
+        bool IsCurrent(uint32_t modifiers_version) const;
+        void Rebuild(uint32_t modifiers_version, const WeaponModifierList& modifiers);
+
+        const WeaponConfiguration& Weapon() const;
+        const BulletConfiguration& Bullet() const;
+
+    private:
+
+        const WeaponConfiguration m_base_weapon_config;
+        const BulletConfiguration m_base_bullet_config;
+        WeaponConfiguration m_weapon_config;
+        BulletConfiguration m_bullet_config;
+        uint32_t m_modifiers_version;
+        bool m_valid;
+    };
+}
@@ -3,6 +3,7 @@
 
 #include "Weapons/WeaponConfiguration.h"
 #include <cstdint>
+#include <vector>
 
 namespace game
 {
@@ -16,4 +17,6 @@ namespace game
         virtual WeaponConfiguration ModifyWeapon(const WeaponConfiguration& weapon_config) { return weapon_config; }
         virtual BulletConfiguration ModifyBullet(const BulletConfiguration& bullet_config) { return bullet_config; }
     };
+
+    using WeaponModifierList = std::vector<IWeaponModifier*>;
 }
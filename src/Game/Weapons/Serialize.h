@@ -22,6 +22,7 @@ namespace game
         bullet_config.entity_file                   = json["entity_file"].get<std::string>();
         bullet_config.impact_entity_file            = json["impact_entity_file"].get<std::string>();
         bullet_config.sound_file                    = json["sound_file"].get<std::string>();
+        bullet_config.impact_entity_hash            = 0;
         bullet_config.bullet_collision_behaviour    = 0;
         bullet_config.bullet_movement_behaviour     = 0;
 
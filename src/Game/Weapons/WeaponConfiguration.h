@@ -112,6 +112,7 @@ namespace game
         std::string entity_file;
         std::string impact_entity_file;
         std::string sound_file;
+        uint32_t impact_entity_hash; // Registered with hash::HashRegisterString, 0 without an impact entity.
 
         uint32_t bullet_collision_behaviour;
         uint32_t bullet_movement_behaviour;
@@ -150,6 +151,6 @@ namespace game
     {
         CollisionCategory collision_category;
         uint32_t collision_mask;
-        BulletImpactCallback collision_callback;
+        const BulletImpactCallback* collision_callback; // Owned by the weapon system, outlives the bullets.
     };
 }
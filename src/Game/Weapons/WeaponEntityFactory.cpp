@@ -2,9 +2,11 @@
 #include "WeaponEntityFactory.h"
 #include "WeaponConfiguration.h"
 #include "BulletWeapon/BulletLogic.h"
+#include "BulletWeapon/BulletSoundPool.h"
 #include "BulletWeapon/WebberLogic.h"
 #include "BulletWeapon/ThrowableLogic.h"
 #include "Entity/EntityLogicSystem.h"
+#include "Entity/EntityPrefabSystem.h"
 
 #include "EntitySystem/IEntityManager.h"
 #include "Math/Matrix.h"
@@ -19,17 +21,21 @@ using namespace game;
 
 WeaponEntityFactory::WeaponEntityFactory(
     mono::IEntityManager* entity_manager,
+    game::EntityPrefabSystem* prefab_system,
     mono::SpriteSystem* sprite_system,
     mono::TransformSystem* transform_system,
     mono::PhysicsSystem* physics_system,
     game::EntityLogicSystem* logic_system,
-    game::TargetSystem* target_system)
+    game::TargetSystem* target_system,
+    game::BulletSoundPool* bullet_sound_pool)
     : m_entity_manager(entity_manager)
+    , m_prefab_system(prefab_system)
     , m_sprite_system(sprite_system)
     , m_transform_system(transform_system)
     , m_physics_system(physics_system)
     , m_logic_system(logic_system)
     , m_target_system(target_system)
+    , m_bullet_sound_pool(bullet_sound_pool)
 { }
 
 mono::Entity WeaponEntityFactory::CreateBulletEntity(
@@ -42,17 +48,19 @@ mono::Entity WeaponEntityFactory::CreateBulletEntity(
     float bullet_direction,
     const math::Matrix& transform) const
 {
-    mono::Entity bullet_entity = m_entity_manager->SpawnEntity(bullet_config.entity_file.c_str());
+    mono::Entity bullet_entity = m_prefab_system->SpawnEntity(bullet_config.entity_file.c_str());
     m_transform_system->SetTransform(bullet_entity.id, transform, mono::TransformState::CLIENT);
 
 
     const bool is_throwable_weapon = (bullet_config.bullet_movement_behaviour & BulletMovementFlag::ARC_TRAJECTORY);
 
-    IEntityLogic* bullet_logic = nullptr;
-    
+    m_entity_manager->AddComponent(bullet_entity.id, BEHAVIOUR_COMPONENT);
+
+    // Bullets come and go at the fire rate, keep their logic in the logic system slabs.
     if(is_throwable_weapon)
     {
-        bullet_logic = new ThrowableLogic(
+        m_logic_system->AddPooledLogic<ThrowableLogic>(
+            bullet_entity.id,
             bullet_entity.id,
             owner_id,
             math::GetPosition(transform),
@@ -65,7 +73,8 @@ mono::Entity WeaponEntityFactory::CreateBulletEntity(
     }
     else
     {
-        bullet_logic = new BulletLogic(
+        m_logic_system->AddPooledLogic<BulletLogic>(
+            bullet_entity.id,
             bullet_entity.id,
             owner_id,
             weapon_identifier_hash,
@@ -76,12 +85,10 @@ mono::Entity WeaponEntityFactory::CreateBulletEntity(
             collision_config,
             m_transform_system,
             m_physics_system,
-            m_target_system);
+            m_target_system,
+            m_bullet_sound_pool);
     }
 
-    m_entity_manager->AddComponent(bullet_entity.id, BEHAVIOUR_COMPONENT);
-    m_logic_system->AddLogic(bullet_entity.id, bullet_logic);
-
     return bullet_entity;
 }
 
@@ -14,11 +14,13 @@ namespace game
 
         WeaponEntityFactory(
             mono::IEntityManager* entity_manager,
+            class EntityPrefabSystem* prefab_system,
             mono::SpriteSystem* sprite_system,
             mono::TransformSystem* transform_system,
             mono::PhysicsSystem* physics_system,
             class EntityLogicSystem* logic_system,
-            class TargetSystem* target_system);
+            class TargetSystem* target_system,
+            class BulletSoundPool* bullet_sound_pool);
 
         mono::Entity CreateBulletEntity(
             uint32_t owner_id,
@@ -36,10 +38,12 @@ namespace game
     private:
 
         mono::IEntityManager* m_entity_manager;
+        game::EntityPrefabSystem* m_prefab_system;
         mono::SpriteSystem* m_sprite_system;
         mono::TransformSystem* m_transform_system;
         mono::PhysicsSystem* m_physics_system;
         game::EntityLogicSystem* m_logic_system;
         game::TargetSystem* m_target_system;
+        game::BulletSoundPool* m_bullet_sound_pool;
     };
 }
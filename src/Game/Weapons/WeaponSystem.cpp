@@ -8,9 +8,13 @@
 #include "Weapons/CollisionCallbacks.h"
 #include "Weapons/Modifiers/WeaponModifierFactory.h"
 #include "DamageSystem/DamageSystem.h"
+#include "Entity/EntityPrefabSystem.h"
+#include "Effects/MuzzleFlash.h"
+#include "Effects/BulletTrailEffect.h"
 
 #include "SystemContext.h"
 #include "EntitySystem/IEntityManager.h"
+#include "Particle/ParticleSystem.h"
 #include "Physics/PhysicsSystem.h"
 #include "Rendering/Sprite/SpriteSystem.h"
 #include "TransformSystem/TransformSystem.h"
@@ -18,6 +22,15 @@
 #include <algorithm>
 #include <functional>
 
+namespace tweak_values
+{
+    constexpr uint32_t voices_per_bullet_sound = 4;
+
+    // Shared by every weapon, sized for a horde wave instead of a single weapon.
+    constexpr uint32_t muzzle_flash_particles = 1000;
+    constexpr uint32_t bullet_trail_particles = 3000;
+}
+
 namespace
 {
     class NullWeapon : public game::IWeapon
@@ -66,6 +79,7 @@ WeaponSystem::WeaponSystem(
     mono::SpriteSystem* sprite_system,
     mono::PhysicsSystem* physics_system,
     mono::IEntityManager* entity_manager,
+    game::EntityPrefabSystem* prefab_system,
     game::DamageSystem* damage_system,
     game::CameraSystem* camera_system,
     game::EntityLogicSystem* logic_system,
@@ -73,9 +87,13 @@ WeaponSystem::WeaponSystem(
     mono::SystemContext* system_context)
     : m_transform_system(transform_system)
     , m_entity_manager(entity_manager)
+    , m_prefab_system(prefab_system)
     , m_system_context(system_context)
-    , m_weapon_entity_factory(entity_manager, sprite_system, transform_system, physics_system, logic_system, target_system)
+    , m_bullet_sound_pool(tweak_values::voices_per_bullet_sound)
+    , m_weapon_entity_factory(
+        entity_manager, prefab_system, sprite_system, transform_system, physics_system, logic_system, target_system, &m_bullet_sound_pool)
     , m_modifier_id(0)
+    , m_modifiers_version(0)
 {
     m_weapon_configuration = LoadWeaponConfig("res/configs/weapon_config.json");
     m_modifier_configuration = LoadModifiersConfig("res/configs/modifiers_config.json");
@@ -98,11 +116,26 @@ const char* WeaponSystem::Name() const
 void WeaponSystem::Begin()
 {
     InitWeaponCallbacks(m_system_context);
+
+    mono::ParticleSystem* particle_system = m_system_context->GetSystem<mono::ParticleSystem>();
+    m_muzzle_flash = std::make_unique<MuzzleFlash>(particle_system, m_entity_manager, tweak_values::muzzle_flash_particles);
+    m_bullet_trail = std::make_unique<BulletTrailEffect>(
+        m_transform_system, particle_system, m_entity_manager, tweak_values::bullet_trail_particles);
+
+    for(const auto& pair : m_weapon_configuration.bullet_configs)
+    {
+        const BulletConfiguration& bullet_config = pair.second;
+        if(!bullet_config.entity_file.empty())
+            m_prefab_system->Preload(bullet_config.entity_file.c_str());
+    }
 }
 
 void WeaponSystem::Reset()
 {
     CleanupWeaponCallbacks();
+
+    m_muzzle_flash = nullptr;
+    m_bullet_trail = nullptr;
 }
 
 void WeaponSystem::Update(const mono::UpdateContext& update_context)
@@ -134,6 +167,9 @@ void WeaponSystem::Update(const mono::UpdateContext& update_context)
             pair.second.modifiers.erase(pair.second.modifiers.begin() + index_to_remove);
             pair.second.ids.erase(pair.second.ids.begin() + index_to_remove);
         }
+
+        if(!indices_to_remove.empty())
+            m_modifiers_version++;
     }
 }
 
@@ -205,7 +241,7 @@ IWeaponPtr WeaponSystem::CreateWeapon(WeaponSetup setup, WeaponFaction faction,
     CollisionConfiguration collision_config;
     collision_config.collision_category = enemy_weapon ? CollisionCategory::ENEMY_BULLET : CollisionCategory::PLAYER_BULLET;
     collision_config.collision_mask = enemy_weapon ? ENEMY_BULLET_MASK : PLAYER_BULLET_MASK;
-    collision_config.collision_callback = (impact_callback_it != m_bullet_callbacks.end()) ? impact_callback_it->second : m_standard_collision;
+    collision_config.collision_callback = (impact_callback_it != m_bullet_callbacks.end()) ? &impact_callback_it->second : &m_standard_collision;
 
     return std::make_unique<game::Weapon>(
         owner_id, setup, weapon_config, bullet_config, collision_config, m_entity_manager, m_system_context);
@@ -265,6 +301,8 @@ int WeaponSystem::AddModifierForIdWithDuration(uint32_t id, float duration_s, IW
     context.modifiers.push_back(weapon_modifier);
     context.ids.push_back(m_modifier_id);
 
+    m_modifiers_version++;
+
     return m_modifier_id;
 }
 
@@ -283,6 +321,8 @@ int WeaponSystem::AddModifierForIdAndWeapon(uint32_t id, uint32_t weapon_identif
     context.modifiers.push_back(weapon_modifier);
     context.ids.push_back(m_modifier_id);
 
+    m_modifiers_version++;
+
     return m_modifier_id;
 }
 
@@ -301,6 +341,8 @@ void WeaponSystem::RemoveModifierForEntity(uint32_t entity_id, int modifier_slot
     context.modifiers.erase(context.modifiers.begin() + index);
     context.durations.erase(context.durations.begin() + index);
     context.ids.erase(id_it);
+
+    m_modifiers_version++;
 }
 
 WeaponLevelExperience WeaponSystem::GetWeaponLevelForExperience(uint32_t weapon_identifier_hash, int weapon_experience)
@@ -377,6 +419,26 @@ WeaponModifierList WeaponSystem::GetWeaponModifiersForIdAndWeapon(uint32_t id, u
     return modifier_list;
 }
 
+uint32_t WeaponSystem::ModifiersVersion() const
+{
+    return m_modifiers_version;
+}
+
+const WeaponEntityFactory& WeaponSystem::GetWeaponEntityFactory() const
+{
+    return m_weapon_entity_factory;
+}
+
+MuzzleFlash* WeaponSystem::GetMuzzleFlash()
+{
+    return m_muzzle_flash.get();
+}
+
+BulletTrailEffect* WeaponSystem::GetBulletTrail()
+{
+    return m_bullet_trail.get();
+}
+
 const ModifiersConfig& WeaponSystem::GetModifiersConfig() const
 {
     return m_modifier_configuration;
@@ -8,6 +8,7 @@
 #include "WeaponTypes.h"
 #include "WeaponConfiguration.h"
 #include "WeaponEntityFactory.h"
+#include "BulletWeapon/BulletSoundPool.h"
 
 #include <unordered_map>
 #include <memory>
@@ -17,7 +18,6 @@
 namespace game
 {
     using IWeaponPtr = std::unique_ptr<class IWeapon>;
-    using WeaponModifierList = std::vector<IWeaponModifier*>;
 
     struct WeaponLevelExperience
     {
@@ -35,6 +35,7 @@ namespace game
             mono::SpriteSystem* sprite_system,
             mono::PhysicsSystem* physics_system,
             mono::IEntityManager* entity_manager,
+            class EntityPrefabSystem* prefab_system,
             class DamageSystem* damage_system,
             class CameraSystem* camera_system,
             class EntityLogicSystem* logic_system,
@@ -75,6 +76,15 @@ namespace game
         WeaponModifierList GetWeaponModifiersForEntity(uint32_t entity_id) const;
         WeaponModifierList GetWeaponModifiersForIdAndWeapon(uint32_t id, uint32_t weapon_identifier_hash) const;
 
+        // Changes every time a modifier is added or removed, weapons rebuild their configuration when it does.
+        uint32_t ModifiersVersion() const;
+
+        // Effects shared by all weapons, one particle pool each with an emitter per muzzle flash or bullet.
+        // Only valid between Begin and Reset.
+        const WeaponEntityFactory& GetWeaponEntityFactory() const;
+        class MuzzleFlash* GetMuzzleFlash();
+        class BulletTrailEffect* GetBulletTrail();
+
         const ModifiersConfig& GetModifiersConfig() const;
         const ModifierInfo& GetModifierSpriteFileForNameId(uint32_t weapon_modifier_hash) const; 
 
@@ -82,8 +92,12 @@ namespace game
 
         mono::TransformSystem* m_transform_system;
         mono::IEntityManager* m_entity_manager;
+        game::EntityPrefabSystem* m_prefab_system;
         mono::SystemContext* m_system_context;
+        game::BulletSoundPool m_bullet_sound_pool;
         game::WeaponEntityFactory m_weapon_entity_factory;
+        std::unique_ptr<class MuzzleFlash> m_muzzle_flash;
+        std::unique_ptr<class BulletTrailEffect> m_bullet_trail;
 
         WeaponConfig m_weapon_configuration;
         ModifiersConfig m_modifier_configuration;
@@ -115,6 +129,7 @@ namespace game
         std::unordered_map<uint32_t, WeaponModifierContext> m_weapon_level_modifiers;
 
         uint32_t m_modifier_id;
+        uint32_t m_modifiers_version;
 
         class DamageEffect* m_damage_effect = nullptr;
         class ImpactEffect* m_impact_effect = nullptr;
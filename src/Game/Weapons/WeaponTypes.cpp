@@ -20,8 +20,16 @@ game::WeaponConfig game::LoadWeaponConfig(const char* weapon_config_file)
 
     weapon_config.weapon_pickup_entity = json.value("weapon_pickup_entity", "");
 
-    for(const BulletConfiguration bullet : json["bullets"])
+    for(BulletConfiguration bullet : json["bullets"])
+    {
+        if(!bullet.impact_entity_file.empty())
+        {
+            bullet.impact_entity_hash = hash::Hash(bullet.impact_entity_file.c_str());
+            hash::HashRegisterString(bullet.impact_entity_file.c_str());
+        }
+
         weapon_config.bullet_configs[hash::Hash(bullet.name.c_str())] =  bullet;
+    }
 
     for(const WeaponConfiguration weapon : json["weapons"])
         weapon_config.weapon_configs[hash::Hash(weapon.name.c_str())] =  weapon;
@@ -0,0 +1,527 @@
+
+#include "WorldBinary.h"
+#include "FileHash.h"
+#include "Math/Serialize.h"
+#include "Rendering/Serialize.h"
+
+#include "EntitySystem/Serialize.h"
+#include "System/File.h"
+#include "System/System.h"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace game
+{
+    struct WorldBinaryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t world_hash;
+        uint32_t n_strings;
+        uint32_t n_entities;
+        uint32_t n_components;
+        uint32_t n_attributes;
+        uint32_t metadata_string;
+        uint32_t string_data_size;
+        uint32_t blob_data_size;
+        uint32_t padding;
+    };
+
+    struct WorldBinaryString
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct WorldBinaryEntity
+    {
+        uint32_t name_string;
+        uint32_t uuid;
+        uint32_t properties;
+        uint32_t first_component;
+        uint32_t n_components;
+    };
+
+    struct WorldBinaryComponent
+    {
+        uint32_t hash;
+        uint32_t first_attribute;
+        uint32_t n_attributes;
+    };
+
+    struct WorldBinaryAttribute
+    {
+        uint32_t id;
+        uint32_t variant_index;
+        uint32_t blob_offset;
+        uint32_t blob_size;
+    };
+}
+
+namespace
+{
+    constexpr uint32_t WorldBinaryMagic = 0x57524C44; // 'WRLD'
+    constexpr uint32_t WorldBinaryVersion = 1;
+    constexpr uint32_t BlobAlignment = 8;
+
+    using BinaryFilePtr = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+    BinaryFilePtr OpenBinaryFile(const char* filename, const char* mode)
+    {
+        return BinaryFilePtr(std::fopen(filename, mode), &std::fclose);
+    }
+
+    template <typename T>
+    struct IsTrivialVector : std::false_type
+    { };
+
+    template <typename T>
+    struct IsTrivialVector<std::vector<T>> : std::is_trivially_copyable<T>
+    { };
+
+    class WorldBinaryWriter
+    {
+    public:
+
+        uint32_t AddString(const std::string& string)
+        {
+            const auto it = m_string_lookup.find(string);
+            if(it != m_string_lookup.end())
+                return it->second;
+
+            const uint32_t string_index = m_strings.size();
+            m_strings.push_back({ uint32_t(m_string_data.size()), uint32_t(string.size()) });
+            m_string_data.insert(m_string_data.end(), string.begin(), string.end());
+            m_string_data.push_back(0);
+
+            m_string_lookup.emplace(string, string_index);
+            return string_index;
+        }
+
+        void AddAttribute(const Attribute& attribute)
+        {
+            game::WorldBinaryAttribute binary_attribute;
+            binary_attribute.id = attribute.id;
+            binary_attribute.variant_index = attribute.value.index();
+
+            const auto add_value = [this, &attribute, &binary_attribute](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+
+                if constexpr(std::is_same_v<T, std::string>)
+                {
+                    const uint32_t string_index = AddString(value);
+                    AddBlob(&string_index, sizeof(string_index), binary_attribute);
+                }
+                else if constexpr(std::is_trivially_copyable_v<T>)
+                {
+                    AddBlob(&value, sizeof(T), binary_attribute);
+                }
+                else if constexpr(IsTrivialVector<T>::value)
+                {
+                    AddBlob(value.data(), value.size() * sizeof(typename T::value_type), binary_attribute);
+                }
+                else
+                {
+                    // Anything with pointers inside, keep the json representation but packed.
+                    const std::vector<uint8_t> packed = nlohmann::json::to_msgpack(nlohmann::json(attribute));
+                    AddBlob(packed.data(), packed.size(), binary_attribute);
+                }
+            };
+            std::visit(add_value, attribute.value);
+
+            m_attributes.push_back(binary_attribute);
+        }
+
+        void AddComponent(const mono::ComponentData& component_data)
+        {
+            game::WorldBinaryComponent binary_component;
+            binary_component.hash = component_data.hash;
+            binary_component.first_attribute = m_attributes.size();
+            binary_component.n_attributes = component_data.properties.size();
+
+            for(const Attribute& attribute : component_data.properties)
+                AddAttribute(attribute);
+
+            m_components.push_back(binary_component);
+        }
+
+        void AddEntity(const mono::EntityData& entity_data)
+        {
+            game::WorldBinaryEntity binary_entity;
+            binary_entity.name_string = AddString(entity_data.entity_name);
+            binary_entity.uuid = entity_data.entity_uuid;
+            binary_entity.properties = entity_data.entity_properties;
+            binary_entity.first_component = m_components.size();
+            binary_entity.n_components = entity_data.entity_components.size();
+
+            for(const mono::ComponentData& component_data : entity_data.entity_components)
+                AddComponent(component_data);
+
+            m_entities.push_back(binary_entity);
+        }
+
+        bool Write(const char* binary_file, uint64_t world_hash, const std::string& metadata)
+        {
+            game::WorldBinaryHeader header = { };
+            header.magic = WorldBinaryMagic;
+            header.version = WorldBinaryVersion;
+            header.world_hash = world_hash;
+            header.metadata_string = AddString(metadata);
+            header.n_strings = m_strings.size();
+            header.n_entities = m_entities.size();
+            header.n_components = m_components.size();
+            header.n_attributes = m_attributes.size();
+
+            // Keep the blobs aligned in the file.
+            m_string_data.resize((m_string_data.size() + BlobAlignment - 1) / BlobAlignment * BlobAlignment, 0);
+            header.string_data_size = m_string_data.size();
+            header.blob_data_size = m_blob_data.size();
+
+            BinaryFilePtr file = OpenBinaryFile(binary_file, "wb");
+            if(!file)
+                return false;
+
+            std::fwrite(&header, sizeof(header), 1, file.get());
+            std::fwrite(m_strings.data(), sizeof(game::WorldBinaryString), m_strings.size(), file.get());
+            std::fwrite(m_entities.data(), sizeof(game::WorldBinaryEntity), m_entities.size(), file.get());
+            std::fwrite(m_components.data(), sizeof(game::WorldBinaryComponent), m_components.size(), file.get());
+            std::fwrite(m_attributes.data(), sizeof(game::WorldBinaryAttribute), m_attributes.size(), file.get());
+
+            // The arrays above are all multiples of four bytes, pad to the blob alignment.
+            const size_t arrays_size =
+                sizeof(header) +
+                m_strings.size() * sizeof(game::WorldBinaryString) +
+                m_entities.size() * sizeof(game::WorldBinaryEntity) +
+                m_components.size() * sizeof(game::WorldBinaryComponent) +
+                m_attributes.size() * sizeof(game::WorldBinaryAttribute);
+            const byte padding[BlobAlignment] = { };
+            std::fwrite(padding, 1, (BlobAlignment - arrays_size % BlobAlignment) % BlobAlignment, file.get());
+
+            std::fwrite(m_string_data.data(), 1, m_string_data.size(), file.get());
+            std::fwrite(m_blob_data.data(), 1, m_blob_data.size(), file.get());
+
+            return std::ferror(file.get()) == 0;
+        }
+
+    private:
+
+        void AddBlob(const void* data, size_t size, game::WorldBinaryAttribute& binary_attribute)
+        {
+            binary_attribute.blob_offset = m_blob_data.size();
+            binary_attribute.blob_size = size;
+
+            const byte* bytes = static_cast<const byte*>(data);
+            m_blob_data.insert(m_blob_data.end(), bytes, bytes + size);
+            m_blob_data.resize((m_blob_data.size() + BlobAlignment - 1) / BlobAlignment * BlobAlignment, 0);
+        }
+
+        std::vector<game::WorldBinaryString> m_strings;
+        std::vector<game::WorldBinaryEntity> m_entities;
+        std::vector<game::WorldBinaryComponent> m_components;
+        std::vector<game::WorldBinaryAttribute> m_attributes;
+        std::vector<byte> m_string_data;
+        std::vector<byte> m_blob_data;
+        std::unordered_map<std::string, uint32_t> m_string_lookup;
+    };
+
+    struct BlobContext
+    {
+        const byte* data;
+        uint32_t size;
+        const game::WorldBinaryString* strings;
+        const byte* string_data;
+    };
+
+    template <size_t I>
+    void DecodeValue(const BlobContext& context, Attribute& out_attribute)
+    {
+        using T = std::variant_alternative_t<I, Variant>;
+
+        if constexpr(std::is_same_v<T, std::string>)
+        {
+            uint32_t string_index;
+            std::memcpy(&string_index, context.data, sizeof(string_index));
+            const game::WorldBinaryString& binary_string = context.strings[string_index];
+            const char* string = reinterpret_cast<const char*>(context.string_data + binary_string.offset);
+            out_attribute.value = std::string(string, binary_string.length);
+        }
+        else if constexpr(std::is_trivially_copyable_v<T>)
+        {
+            alignas(T) byte storage[sizeof(T)];
+            std::memcpy(storage, context.data, sizeof(T));
+            out_attribute.value = *reinterpret_cast<const T*>(storage);
+        }
+        else if constexpr(IsTrivialVector<T>::value)
+        {
+            using ValueType = typename T::value_type;
+            T values(context.size / sizeof(ValueType));
+            std::memcpy(values.data(), context.data, values.size() * sizeof(ValueType));
+            out_attribute.value = std::move(values);
+        }
+        else
+        {
+            const nlohmann::json& json = nlohmann::json::from_msgpack(context.data, context.data + context.size);
+            out_attribute.value = json.get<Attribute>().value;
+        }
+    }
+
+    // The blob has to hold what DecodeValue reads for the alternative.
+    template <size_t I>
+    bool ValidateValue(const BlobContext& context, uint32_t n_strings)
+    {
+        using T = std::variant_alternative_t<I, Variant>;
+
+        if constexpr(std::is_same_v<T, std::string>)
+        {
+            if(context.size < sizeof(uint32_t))
+                return false;
+
+            uint32_t string_index;
+            std::memcpy(&string_index, context.data, sizeof(string_index));
+            return string_index < n_strings;
+        }
+        else if constexpr(std::is_trivially_copyable_v<T>)
+        {
+            return context.size >= sizeof(T);
+        }
+        else if constexpr(IsTrivialVector<T>::value)
+        {
+            return (context.size % sizeof(typename T::value_type)) == 0;
+        }
+        else
+        {
+            const nlohmann::json& json = nlohmann::json::from_msgpack(context.data, context.data + context.size, true, false);
+            if(json.is_discarded())
+                return false;
+
+            try
+            {
+                json.get<Attribute>();
+            }
+            catch(const nlohmann::json::exception&)
+            {
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    template <size_t... I>
+    bool ValidateAttributeValue(uint32_t variant_index, const BlobContext& context, uint32_t n_strings, std::index_sequence<I...>)
+    {
+        using ValidateFunc = bool (*)(const BlobContext&, uint32_t);
+        static constexpr ValidateFunc validate_functions[] = { ValidateValue<I>... };
+        return variant_index < sizeof...(I) && validate_functions[variant_index](context, n_strings);
+    }
+
+    // The variant index is only known at runtime, one decode function per alternative.
+    template <size_t... I>
+    void DecodeAttributeValue(uint32_t variant_index, const BlobContext& context, Attribute& out_attribute, std::index_sequence<I...>)
+    {
+        using DecodeFunc = void (*)(const BlobContext&, Attribute&);
+        static constexpr DecodeFunc decode_functions[] = { DecodeValue<I>... };
+        if(variant_index < sizeof...(I))
+            decode_functions[variant_index](context, out_attribute);
+    }
+}
+
+std::string game::WorldBinaryFilename(const char* world_file)
+{
+    return std::string(world_file) + ".bin";
+}
+
+bool game::ConvertWorldToBinary(const char* world_file, const char* binary_file)
+{
+    uint64_t world_hash = 0;
+    if(!HashFile(world_file, Fnv1aOffsetBasis, world_hash))
+    {
+        System::Log("WorldBinary|Unable to open world '%s'.", world_file);
+        return false;
+    }
+
+    const std::vector<byte> file_data = file::FileReadAll(world_file);
+    const nlohmann::json& json = nlohmann::json::parse(file_data);
+
+    const std::string metadata = json.contains("metadata") ? json["metadata"].dump() : std::string();
+    const std::vector<mono::EntityData>& loaded_entity_data = json["entities"];
+
+    WorldBinaryWriter writer;
+    for(const mono::EntityData& entity_data : loaded_entity_data)
+        writer.AddEntity(entity_data);
+
+    const bool write_result = writer.Write(binary_file, world_hash, metadata);
+    if(!write_result)
+        System::Log("WorldBinary|Unable to write '%s'.", binary_file);
+
+    return write_result;
+}
+
+bool game::WorldBinaryReader::Open(const char* binary_file, const char* world_file)
+{
+    if(!m_file.Open(binary_file))
+        return false;
+
+    const byte* data = m_file.Data();
+    const size_t size = m_file.Size();
+
+    if(size < sizeof(WorldBinaryHeader))
+        return false;
+
+    m_header = reinterpret_cast<const WorldBinaryHeader*>(data);
+    if(m_header->magic != WorldBinaryMagic || m_header->version != WorldBinaryVersion)
+        return false;
+
+    // 64 bit sums, the counts come from the file and could overflow the offsets.
+    uint64_t offset = sizeof(WorldBinaryHeader);
+    const uint64_t strings_offset = offset;
+    offset += uint64_t(m_header->n_strings) * sizeof(WorldBinaryString);
+    const uint64_t entities_offset = offset;
+    offset += uint64_t(m_header->n_entities) * sizeof(WorldBinaryEntity);
+    const uint64_t components_offset = offset;
+    offset += uint64_t(m_header->n_components) * sizeof(WorldBinaryComponent);
+    const uint64_t attributes_offset = offset;
+    offset += uint64_t(m_header->n_attributes) * sizeof(WorldBinaryAttribute);
+    offset = (offset + BlobAlignment - 1) / BlobAlignment * BlobAlignment;
+
+    if(offset + m_header->string_data_size + m_header->blob_data_size != size)
+    {
+        System::Log("WorldBinary|Unexpected size of '%s', ignoring it.", binary_file);
+        return false;
+    }
+
+    m_strings = reinterpret_cast<const WorldBinaryString*>(data + strings_offset);
+    m_entities = reinterpret_cast<const WorldBinaryEntity*>(data + entities_offset);
+    m_components = reinterpret_cast<const WorldBinaryComponent*>(data + components_offset);
+    m_attributes = reinterpret_cast<const WorldBinaryAttribute*>(data + attributes_offset);
+    m_string_data = data + offset;
+    m_blob_data = m_string_data + m_header->string_data_size;
+
+    if(!ValidateTables())
+    {
+        System::Log("WorldBinary|Invalid index or offset in '%s', ignoring it.", binary_file);
+        return false;
+    }
+
+    uint64_t world_hash = 0;
+    const bool hash_success = HashFile(world_file, Fnv1aOffsetBasis, world_hash);
+    if(!hash_success || world_hash != m_header->world_hash)
+    {
+        System::Log("WorldBinary|'%s' is out of date with '%s', convert the world again.", binary_file, world_file);
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t game::WorldBinaryReader::EntityCount() const
+{
+    return m_header->n_entities;
+}
+
+std::string game::WorldBinaryReader::Metadata() const
+{
+    return String(m_header->metadata_string);
+}
+
+void game::WorldBinaryReader::ReadEntity(uint32_t index, mono::EntityData& out_entity_data) const
+{
+    const WorldBinaryEntity& binary_entity = m_entities[index];
+    out_entity_data.entity_name = String(binary_entity.name_string);
+    out_entity_data.entity_uuid = binary_entity.uuid;
+    out_entity_data.entity_properties = binary_entity.properties;
+}
+
+void game::WorldBinaryReader::ReadEntityComponents(uint32_t index, std::vector<mono::ComponentData>& out_components) const
+{
+    const WorldBinaryEntity& binary_entity = m_entities[index];
+    out_components.resize(binary_entity.n_components);
+
+    for(uint32_t component_index = 0; component_index < binary_entity.n_components; ++component_index)
+    {
+        const WorldBinaryComponent& binary_component = m_components[binary_entity.first_component + component_index];
+        mono::ComponentData& component_data = out_components[component_index];
+        component_data.hash = binary_component.hash;
+        component_data.properties.resize(binary_component.n_attributes);
+
+        for(uint32_t attribute_index = 0; attribute_index < binary_component.n_attributes; ++attribute_index)
+        {
+            const WorldBinaryAttribute& binary_attribute = m_attributes[binary_component.first_attribute + attribute_index];
+            Attribute& attribute = component_data.properties[attribute_index];
+            attribute.id = binary_attribute.id;
+
+            const BlobContext context = {
+                m_blob_data + binary_attribute.blob_offset, binary_attribute.blob_size, m_strings, m_string_data
+            };
+            DecodeAttributeValue(
+                binary_attribute.variant_index, context, attribute, std::make_index_sequence<std::variant_size_v<Variant>>());
+        }
+    }
+}
+
+bool game::WorldBinaryReader::ValidateTables() const
+{
+    const WorldBinaryHeader& header = *m_header;
+
+    for(uint32_t index = 0; index < header.n_strings; ++index)
+    {
+        const WorldBinaryString& binary_string = m_strings[index];
+        if(uint64_t(binary_string.offset) + binary_string.length > header.string_data_size)
+            return false;
+    }
+
+    if(header.metadata_string >= header.n_strings)
+        return false;
+
+    for(uint32_t index = 0; index < header.n_entities; ++index)
+    {
+        const WorldBinaryEntity& binary_entity = m_entities[index];
+        if(binary_entity.name_string >= header.n_strings)
+            return false;
+
+        if(uint64_t(binary_entity.first_component) + binary_entity.n_components > header.n_components)
+            return false;
+    }
+
+    for(uint32_t index = 0; index < header.n_components; ++index)
+    {
+        const WorldBinaryComponent& binary_component = m_components[index];
+        if(uint64_t(binary_component.first_attribute) + binary_component.n_attributes > header.n_attributes)
+            return false;
+    }
+
+    for(uint32_t index = 0; index < header.n_attributes; ++index)
+    {
+        const WorldBinaryAttribute& binary_attribute = m_attributes[index];
+        if(uint64_t(binary_attribute.blob_offset) + binary_attribute.blob_size > header.blob_data_size)
+            return false;
+
+        const BlobContext context = {
+            m_blob_data + binary_attribute.blob_offset, binary_attribute.blob_size, m_strings, m_string_data
+        };
+        if(!ValidateAttributeValue(
+            binary_attribute.variant_index, context, header.n_strings, std::make_index_sequence<std::variant_size_v<Variant>>()))
+            return false;
+    }
+
+    return true;
+}
+
+size_t game::WorldBinaryReader::MappedSize() const
+{
+    return m_file.Size();
+}
+
+std::string game::WorldBinaryReader::String(uint32_t index) const
+{
+    const WorldBinaryString& binary_string = m_strings[index];
+    return std::string(reinterpret_cast<const char*>(m_string_data + binary_string.offset), binary_string.length);
+}
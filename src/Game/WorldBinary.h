@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include "MappedFile.h"
+#include "EntitySystem/Entity.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    struct WorldBinaryHeader;
+    struct WorldBinaryString;
+    struct WorldBinaryEntity;
+    struct WorldBinaryComponent;
+    struct WorldBinaryAttribute;
+
+    // Compact binary version of a json world file. Made offline by ConvertWorldToBinary and stored
+    // next to the world file, the json is still the authoring format. A string table, flat arrays of
+    // entities, components and attributes, and the attribute values as blobs.
+    std::string WorldBinaryFilename(const char* world_file);
+    bool ConvertWorldToBinary(const char* world_file, const char* binary_file);
+
+    // Maps the binary file and decodes one entity at a time.
+    class WorldBinaryReader
+    {
+    public:
+
+        // Fails if the binary is missing, of another version, has an index or offset outside its tables,
+        // or is not made from the world file as it is now. The caller loads the json world instead.
+        bool Open(const char* binary_file, const char* world_file);
+
+        uint32_t EntityCount() const;
+        std::string Metadata() const;
+
+        // Name, uuid and properties, no components.
+        void ReadEntity(uint32_t index, mono::EntityData& out_entity_data) const;
+        void ReadEntityComponents(uint32_t index, std::vector<mono::ComponentData>& out_components) const;
+
+        size_t MappedSize() const;
+
+    private:
+
+        bool ValidateTables() const;
+        std::string String(uint32_t index) const;
+
+        MappedFile m_file;
+        const WorldBinaryHeader* m_header = nullptr;
+        const WorldBinaryString* m_strings = nullptr;
+        const WorldBinaryEntity* m_entities = nullptr;
+        const WorldBinaryComponent* m_components = nullptr;
+        const WorldBinaryAttribute* m_attributes = nullptr;
+        const unsigned char* m_string_data = nullptr;
+        const unsigned char* m_blob_data = nullptr;
+    };
+}
@@ -1,5 +1,6 @@
 
 #include "WorldFile.h"
+#include "WorldBinary.h"
 #include "Math/Serialize.h"
 #include "Rendering/Serialize.h"
 
@@ -11,87 +12,146 @@
 #include "System/System.h"
 
 #include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <thread>
+
+namespace tweak_values
+{
+    // Small worlds are not worth starting threads for.
+    constexpr uint32_t min_entities_per_thread = 64;
+}
 
 namespace
 {
-    game::LevelData ReadWorldComponents(
-        const char* filename,
-        mono::IEntityManager* entity_manager,
-        game::EntityCreationCallback creation_callback)
+    game::LevelMetadata ReadMetadata(const nlohmann::json& json_metadata)
     {
-        System::Log("WorldFile|Loading world '%s'.", filename);
-        const std::vector<byte> file_data = file::FileReadAll(filename);
-        const nlohmann::json& json = nlohmann::json::parse(file_data);
+        game::LevelMetadata metadata;
+        metadata.level_name = json_metadata.value("level_name", "");
+        metadata.level_description = json_metadata.value("level_description", "");
+        metadata.level_game_mode = json_metadata.value("level_game_mode", "");
+        metadata.camera_position = json_metadata.value("camera_position", math::ZeroVec);
+        metadata.camera_size = json_metadata.value("camera_size", math::ZeroVec);
+        metadata.player_spawn_point = json_metadata.value("player_spawn_point", math::ZeroVec);
+        metadata.spawn_package = json_metadata.value("spawn_package", true);
+        metadata.use_package_spawn_position = json_metadata.value("use_custom_package_spawn_position", false);
+        metadata.package_spawn_position = json_metadata.value("package_spawn_position", math::ZeroVec);
 
-        game::LevelData level_data;
+        metadata.background_size = json_metadata.value("background_size", math::ZeroVec);
+        metadata.background_color = json_metadata.value("background_color", mono::Color::BLACK);
+        metadata.ambient_shade = json_metadata.value("ambient_shade", mono::Color::WHITE);
+        metadata.background_texture = json_metadata.value("background_texture", "");
+        metadata.background_music = json_metadata.value("background_music", std::string());
+        metadata.triggers = json_metadata.value("triggers", std::vector<std::string>());
 
-        const bool has_metadata = json.contains("metadata");
-        if(has_metadata)
+        metadata.navmesh_start = json_metadata.value("navmesh_start", math::ZeroVec);
+        metadata.navmesh_end = json_metadata.value("navmesh_end", math::ZeroVec);
+        metadata.navmesh_density = json_metadata.value("navmesh_density", 1.0f);
+
+        metadata.completed_trigger = json_metadata.value("completed_trigger", "");
+        metadata.completed_alt_trigger = json_metadata.value("completed_alt_trigger", "");
+        metadata.aborted_trigger = json_metadata.value("aborted_trigger", "");
+        metadata.failed_trigger = json_metadata.value("failed_trigger", "");
+
+        return metadata;
+    }
+
+    struct DecodedEntity
+    {
+        mono::EntityData entity_data;
+        std::vector<Component> components;
+    };
+
+    float MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Reads every entity and merges its components with the defaults, split in ranges over a few threads.
+    // read_entity needs to be safe to call from several threads at once.
+    template <typename T>
+    std::vector<DecodedEntity> DecodeEntities(uint32_t n_entities, const T& read_entity, uint32_t& out_threads)
+    {
+        std::vector<DecodedEntity> decoded_entities(n_entities);
+
+        const auto decode_entities = [&](uint32_t begin, uint32_t end) {
+            for(uint32_t index = begin; index < end; ++index)
+            {
+                DecodedEntity& decoded = decoded_entities[index];
+                read_entity(index, decoded.entity_data);
+
+                std::vector<mono::ComponentData>& entity_components = decoded.entity_data.entity_components;
+                decoded.components.reserve(entity_components.size());
+
+                for(const mono::ComponentData& component_data : entity_components)
+                {
+                    Component component = component::DefaultComponentFromHash(component_data.hash);
+                    MergeAttributes(component.properties, component_data.properties);
+                    decoded.components.push_back(std::move(component));
+                }
+
+                entity_components.clear();
+            }
+        };
+
+        const uint32_t max_threads = std::max(n_entities / tweak_values::min_entities_per_thread, 1u);
+        const uint32_t n_threads = std::clamp(std::thread::hardware_concurrency(), 1u, std::min(max_threads, 8u));
+        const uint32_t entities_per_thread = (n_entities + n_threads - 1) / n_threads;
+
+        std::vector<std::thread> workers;
+        for(uint32_t index = 1; index < n_threads; ++index)
         {
-            const nlohmann::json& json_metadata = json["metadata"];
-            level_data.metadata.level_name = json_metadata.value("level_name", "");
-            level_data.metadata.level_description = json_metadata.value("level_description", "");
-            level_data.metadata.level_game_mode = json_metadata.value("level_game_mode", "");
-            level_data.metadata.camera_position = json_metadata.value("camera_position", math::ZeroVec);
-            level_data.metadata.camera_size = json_metadata.value("camera_size", math::ZeroVec);
-            level_data.metadata.player_spawn_point = json_metadata.value("player_spawn_point", math::ZeroVec);
-            level_data.metadata.spawn_package = json_metadata.value("spawn_package", true);
-            level_data.metadata.use_package_spawn_position = json_metadata.value("use_custom_package_spawn_position", false);
-            level_data.metadata.package_spawn_position = json_metadata.value("package_spawn_position", math::ZeroVec);
-
-            level_data.metadata.background_size = json_metadata.value("background_size", math::ZeroVec);
-            level_data.metadata.background_color = json_metadata.value("background_color", mono::Color::BLACK);
-            level_data.metadata.ambient_shade = json_metadata.value("ambient_shade", mono::Color::WHITE);
-            level_data.metadata.background_texture = json_metadata.value("background_texture", "");
-            level_data.metadata.background_music = json_metadata.value("background_music", std::string());
-            level_data.metadata.triggers = json_metadata.value("triggers", std::vector<std::string>());
-
-            level_data.metadata.navmesh_start = json_metadata.value("navmesh_start", math::ZeroVec);
-            level_data.metadata.navmesh_end = json_metadata.value("navmesh_end", math::ZeroVec);
-            level_data.metadata.navmesh_density = json_metadata.value("navmesh_density", 1.0f);
-
-            level_data.metadata.completed_trigger = json_metadata.value("completed_trigger", "");
-            level_data.metadata.completed_alt_trigger = json_metadata.value("completed_alt_trigger", "");
-            level_data.metadata.aborted_trigger = json_metadata.value("aborted_trigger", "");
-            level_data.metadata.failed_trigger = json_metadata.value("failed_trigger", "");
+            const uint32_t begin = std::min(index * entities_per_thread, n_entities);
+            const uint32_t end = std::min(begin + entities_per_thread, n_entities);
+            workers.emplace_back(decode_entities, begin, end);
         }
 
-        const std::vector<mono::EntityData>& loaded_entity_data = json["entities"];
-        
+        decode_entities(0, std::min(entities_per_thread, n_entities));
+
+        for(std::thread& worker : workers)
+            worker.join();
+
+        out_threads = n_threads;
+        return decoded_entities;
+    }
+
+    // Creates the entities in file order, all of them before any components so components can refer to other entities.
+    void CommitEntities(
+        const std::vector<DecodedEntity>& decoded_entities,
+        mono::IEntityManager* entity_manager,
+        game::EntityCreationCallback creation_callback,
+        game::LevelData& level_data)
+    {
         std::vector<mono::Entity> loaded_entities;
-        loaded_entities.reserve(loaded_entity_data.size());
+        loaded_entities.reserve(decoded_entities.size());
 
-        for(const mono::EntityData& entity_data : loaded_entity_data)
+        for(const DecodedEntity& decoded : decoded_entities)
         {
+            const mono::EntityData& entity_data = decoded.entity_data;
             mono::Entity entity = entity_manager->CreateEntity(entity_data.entity_name.c_str(), entity_data.entity_uuid, { });
             entity_manager->SetEntityProperties(entity.id, entity_data.entity_properties);
 
             loaded_entities.push_back(entity);
         }
 
+        level_data.loaded_entities.reserve(loaded_entities.size());
+
         for(uint32_t index = 0; index < loaded_entities.size(); ++index)
         {
-            mono::Entity& entity = loaded_entities[index];
-            const mono::EntityData& entity_data = loaded_entity_data[index];
+            const mono::Entity& entity = loaded_entities[index];
+            const std::vector<Component>& components = decoded_entities[index].components;
 
-            std::vector<Component> components;
-            components.reserve(entity_data.entity_components.size());
-
-            for(const mono::ComponentData& component_data : entity_data.entity_components)
+            for(const Component& component : components)
             {
-                Component component = component::DefaultComponentFromHash(component_data.hash);
-                MergeAttributes(component.properties, component_data.properties);
-
                 const bool add_component_result = entity_manager->AddComponent(entity.id, component.hash);
                 const bool set_component_result = entity_manager->SetComponentData(entity.id, component.hash, component.properties);
                 if(!add_component_result || !set_component_result)
                 {
                     //System::Log("WorldFile|Failed to setup component with name '%s' for entity named '%s'", ComponentNameFromHash(component.hash), entity_name.c_str());
                 }
-
-                components.push_back(std::move(component));
             }
 
             level_data.loaded_entities.push_back(entity.id);
@@ -99,13 +159,113 @@ namespace
             if(creation_callback)
                 creation_callback(entity, components);
         }
+    }
+
+    game::LevelData ReadWorldComponents(
+        const char* filename,
+        mono::IEntityManager* entity_manager,
+        game::EntityCreationCallback creation_callback,
+        game::WorldLoadTimings& timings)
+    {
+        System::Log("WorldFile|Loading world '%s'.", filename);
+
+        const auto parse_start = std::chrono::steady_clock::now();
+        const std::vector<byte> file_data = file::FileReadAll(filename);
+        const nlohmann::json& json = nlohmann::json::parse(file_data);
+
+        game::LevelData level_data;
+
+        const bool has_metadata = json.contains("metadata");
+        if(has_metadata)
+            level_data.metadata = ReadMetadata(json["metadata"]);
+
+        const nlohmann::json& json_entities = json["entities"];
+        timings.parse_ms = MillisecondsSince(parse_start);
+
+        const auto read_entity = [&json_entities](uint32_t index, mono::EntityData& out_entity_data) {
+            out_entity_data = json_entities[index].get<mono::EntityData>();
+        };
+
+        const auto decode_start = std::chrono::steady_clock::now();
+        const std::vector<DecodedEntity> decoded_entities = DecodeEntities(json_entities.size(), read_entity, timings.n_threads);
+        timings.decode_ms = MillisecondsSince(decode_start);
+
+        const auto commit_start = std::chrono::steady_clock::now();
+        CommitEntities(decoded_entities, entity_manager, creation_callback, level_data);
+        timings.commit_ms = MillisecondsSince(commit_start);
+
+        timings.n_entities = decoded_entities.size();
+        return level_data;
+    }
+
+    // Same as above, but the entities are decoded straight out of the mapped binary world.
+    game::LevelData ReadWorldBinaryComponents(
+        const char* filename,
+        const game::WorldBinaryReader& reader,
+        mono::IEntityManager* entity_manager,
+        game::EntityCreationCallback creation_callback,
+        game::WorldLoadTimings& timings)
+    {
+        System::Log("WorldFile|Loading binary world '%s'.", filename);
+
+        const auto parse_start = std::chrono::steady_clock::now();
+
+        game::LevelData level_data;
+
+        const std::string metadata = reader.Metadata();
+        if(!metadata.empty())
+            level_data.metadata = ReadMetadata(nlohmann::json::parse(metadata));
+
+        timings.parse_ms += MillisecondsSince(parse_start);
 
+        const auto read_entity = [&reader](uint32_t index, mono::EntityData& out_entity_data) {
+            reader.ReadEntity(index, out_entity_data);
+            reader.ReadEntityComponents(index, out_entity_data.entity_components);
+        };
+
+        const auto decode_start = std::chrono::steady_clock::now();
+        const std::vector<DecodedEntity> decoded_entities = DecodeEntities(reader.EntityCount(), read_entity, timings.n_threads);
+        timings.decode_ms = MillisecondsSince(decode_start);
+
+        const auto commit_start = std::chrono::steady_clock::now();
+        CommitEntities(decoded_entities, entity_manager, creation_callback, level_data);
+        timings.commit_ms = MillisecondsSince(commit_start);
+
+        timings.n_entities = decoded_entities.size();
         return level_data;
     }
 }
 
 game::LevelData game::ReadWorldComponentObjects(
-        const char* filename, mono::IEntityManager* entity_manager, game::EntityCreationCallback creation_callback)
+    const char* filename,
+    mono::IEntityManager* entity_manager,
+    game::EntityCreationCallback creation_callback,
+    game::WorldLoadTimings* out_timings,
+    bool allow_binary)
 {
-    return ReadWorldComponents(filename, entity_manager, creation_callback);
+    WorldLoadTimings timings;
+
+    // Prefer the converted binary world, it is only used when made from the json world as it is now.
+    const std::string binary_filename = WorldBinaryFilename(filename);
+    if(allow_binary && file::Exists(binary_filename.c_str()))
+    {
+        const auto open_start = std::chrono::steady_clock::now();
+        game::WorldBinaryReader reader;
+        const bool opened = reader.Open(binary_filename.c_str(), filename);
+        timings.parse_ms = MillisecondsSince(open_start);
+
+        if(opened)
+        {
+            timings.binary = true;
+            game::LevelData level_data = ReadWorldBinaryComponents(filename, reader, entity_manager, creation_callback, timings);
+            if(out_timings)
+                *out_timings = timings;
+            return level_data;
+        }
+    }
+
+    game::LevelData level_data = ReadWorldComponents(filename, entity_manager, creation_callback, timings);
+    if(out_timings)
+        *out_timings = timings;
+    return level_data;
 }
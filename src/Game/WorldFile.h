@@ -55,9 +55,25 @@ namespace game
         std::vector<uint32_t> loaded_entities;
     };
 
+    // Time per stage of loading a world, in milliseconds.
+    struct WorldLoadTimings
+    {
+        bool binary = false;
+        uint32_t n_entities = 0;
+        uint32_t n_threads = 0;
+        float parse_ms = 0.0f;  // Read and parse the json, or map the binary.
+        float decode_ms = 0.0f; // Entities decoded and merged with the default components, on worker threads.
+        float commit_ms = 0.0f; // Entities and components created in the entity manager, in file order.
+    };
+
     using EntityCreationCallback = std::function<
         void (const mono::Entity& entity, const std::vector<Component>& components)>;
 
+    // Loads the binary world when there is an up to date one, unless allow_binary is false.
     LevelData ReadWorldComponentObjects(
-        const char* filename, mono::IEntityManager* entity_manager, EntityCreationCallback creation_callback);
+        const char* filename,
+        mono::IEntityManager* entity_manager,
+        EntityCreationCallback creation_callback,
+        WorldLoadTimings* out_timings = nullptr,
+        bool allow_binary = true);
 }
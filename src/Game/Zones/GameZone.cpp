@@ -33,6 +33,7 @@
 #include "Hud/Debug/PhysicsStatsElement.h"
 #include "Hud/Debug/ConsoleDrawer.h"
 #include "Hud/Debug/ParticleStatusDrawer.h"
+#include "Hud/Debug/TargetStatsDrawer.h"
 
 #include "Navigation/NavMeshVisualizer.h"
 #include "Navigation/NavigationSystem.h"
@@ -175,6 +176,7 @@ void GameZone::OnLoad(mono::ICamera* camera, mono::IRenderer* renderer)
     // Debug
     AddDrawable(new PhysicsStatsElement(physics_system), LayerId::UI);
     AddDrawable(new ParticleStatusDrawer(particle_system), LayerId::UI);
+    AddDrawable(new TargetStatsDrawer(target_system), LayerId::UI);
     AddDrawable(new NavmeshVisualizer(navigation_system, *m_event_handler), LayerId::UI);
     AddDrawable(new mono::TransformSystemDrawer(g_draw_transformsystem, transform_system), LayerId::UI);
     AddDrawable(new mono::PhysicsDebugDrawer(
@@ -200,7 +202,7 @@ void GameZone::PostLoad()
     mono::PhysicsSystem* physics_system = m_system_context->GetSystem<mono::PhysicsSystem>();
     game::NavigationSystem* navigation_system = m_system_context->GetSystem<game::NavigationSystem>();
     navigation_system->SetupNavmesh(
-        metadata.navmesh_start, metadata.navmesh_end, metadata.navmesh_density, physics_system->GetSpace());
+        metadata.navmesh_start, metadata.navmesh_end, metadata.navmesh_density, physics_system->GetSpace(), m_world_file);
 }
 
 int GameZone::OnUnload()
@@ -12,6 +12,7 @@
 #include "Network/NetworkMessage.h"
 #include "Network/ClientReplicator.h"
 #include "Network/ClientManager.h"
+#include "Network/Snapshot.h"
 
 #include "Camera/ICamera.h"
 #include "EntitySystem/IEntityManager.h"
@@ -41,8 +42,11 @@ using namespace game;
 
 RemoteZone::RemoteZone(const ZoneCreationContext& context)
     : m_system_context(context.system_context)
+    , m_num_entities(context.num_entities)
     , m_event_handler(context.event_handler)
     , m_game_config(*context.game_config)
+    , m_client_manager(nullptr)
+    , m_snapshot_receiver(std::make_unique<SnapshotReceiver>())
 {
     using namespace std::placeholders;
 
@@ -52,6 +56,7 @@ RemoteZone::RemoteZone(const ZoneCreationContext& context)
     const std::function<mono::EventResult (const SpriteMessage&)> sprite_func = std::bind(&RemoteZone::HandleSpriteMessage, this, _1);
     const std::function<mono::EventResult (const TransformMessage&)> transform_func = std::bind(&RemoteZone::HandleTransformMessage, this, _1);
     const std::function<mono::EventResult (const DamageInfoMessage&)> damage_func = std::bind(&RemoteZone::HandleDamageInfoMessage, this, _1);
+    const std::function<mono::EventResult (const SnapshotMessage&)> snapshot_func = std::bind(&RemoteZone::HandleSnapshotMessage, this, _1);
 
     m_metadata_token = m_event_handler->AddListener(metadata_func);
     m_text_token = m_event_handler->AddListener(text_func);
@@ -59,6 +64,7 @@ RemoteZone::RemoteZone(const ZoneCreationContext& context)
     m_sprite_token = m_event_handler->AddListener(sprite_func);
     m_transform_token = m_event_handler->AddListener(transform_func);
     m_damageinfo_token = m_event_handler->AddListener(damage_func);
+    m_snapshot_token = m_event_handler->AddListener(snapshot_func);
 }
 
 RemoteZone::~RemoteZone()
@@ -69,6 +75,7 @@ RemoteZone::~RemoteZone()
     m_event_handler->RemoveListener(m_sprite_token);
     m_event_handler->RemoveListener(m_transform_token);
     m_event_handler->RemoveListener(m_damageinfo_token);
+    m_event_handler->RemoveListener(m_snapshot_token);
 }
 
 void RemoteZone::OnLoad(mono::ICamera* camera, mono::IRenderer* renderer)
@@ -86,9 +93,10 @@ void RemoteZone::OnLoad(mono::ICamera* camera, mono::IRenderer* renderer)
     CameraSystem* camera_system = m_system_context->GetSystem<CameraSystem>();
     ClientManager* client_manager = m_system_context->GetSystem<ClientManager>();
     client_manager->StartClient();
+    m_client_manager = client_manager;
 
     m_position_prediction_system =
-        m_system_context->CreateSystem<PositionPredictionSystem>(500, client_manager, transform_system);
+        m_system_context->CreateSystem<PositionPredictionSystem>(m_num_entities, client_manager, transform_system);
 
     m_spawn_prediction_system = m_system_context->CreateSystem<SpawnPredictionSystem>(
         client_manager, m_sprite_system, m_damage_system, m_position_prediction_system);
@@ -174,11 +182,37 @@ mono::EventResult RemoteZone::HandleDamageInfoMessage(const DamageInfoMessage& d
     if(!is_allocated)
         m_damage_system->CreateRecord(damageinfo_message.entity_id);
 
+    m_damage_system->SetHealth(damageinfo_message.entity_id, damageinfo_message.health);
+
     DamageRecord* damage_record = m_damage_system->GetDamageRecord(damageinfo_message.entity_id);
-    damage_record->health = damageinfo_message.health;
     damage_record->full_health = damageinfo_message.full_health;
     damage_record->is_boss = damageinfo_message.is_boss;
     damage_record->last_damaged_timestamp = damageinfo_message.damage_timestamp;
 
     return mono::EventResult::HANDLED;
 }
+
+mono::EventResult RemoteZone::HandleSnapshotMessage(const SnapshotMessage& snapshot_message)
+{
+    m_snapshot_transforms.clear();
+    m_snapshot_sprites.clear();
+
+    const bool success = m_snapshot_receiver->ReadSnapshot(snapshot_message, m_snapshot_transforms, m_snapshot_sprites);
+    if(!success)
+        return mono::EventResult::HANDLED;
+
+    for(const SpriteMessage& sprite_message : m_snapshot_sprites)
+        HandleSpriteMessage(sprite_message);
+
+    for(const TransformMessage& transform_message : m_snapshot_transforms)
+        HandleTransformMessage(transform_message);
+
+    SnapshotAckMessage ack_message;
+    ack_message.snapshot_id = snapshot_message.snapshot_id;
+
+    NetworkMessage message;
+    message.payload = SerializeMessage(ack_message);
+    m_client_manager->SendMessage(message);
+
+    return mono::EventResult::HANDLED;
+}
@@ -8,6 +8,7 @@
 #include "EventHandler/EventToken.h"
 
 #include <memory>
+#include <vector>
 
 class ImGuiInputHandler;
 
@@ -24,6 +25,7 @@ namespace game
     struct SpriteMessage;
     struct TransformMessage;
     struct DamageInfoMessage;
+    struct SnapshotMessage;
 
     class DamageSystem;
 
@@ -43,10 +45,12 @@ namespace game
         mono::EventResult HandleSpriteMessage(const SpriteMessage& sprite_message);
         mono::EventResult HandleTransformMessage(const TransformMessage& transform_message);
         mono::EventResult HandleDamageInfoMessage(const DamageInfoMessage& damageinfo_message);
+        mono::EventResult HandleSnapshotMessage(const SnapshotMessage& snapshot_message);
 
     private:
 
         mono::SystemContext* m_system_context;
+        uint32_t m_num_entities;
         mono::EventHandler* m_event_handler;
         const game::Config m_game_config;
 
@@ -56,6 +60,7 @@ namespace game
         game::DamageSystem* m_damage_system;
         class PositionPredictionSystem* m_position_prediction_system;
         class SpawnPredictionSystem* m_spawn_prediction_system;
+        class ClientManager* m_client_manager;
 
         mono::EventToken<game::LevelMetadataMessage> m_metadata_token;
         mono::EventToken<game::TextMessage> m_text_token;
@@ -63,6 +68,11 @@ namespace game
         mono::EventToken<game::SpriteMessage> m_sprite_token;
         mono::EventToken<game::TransformMessage> m_transform_token;
         mono::EventToken<game::DamageInfoMessage> m_damageinfo_token;
+        mono::EventToken<game::SnapshotMessage> m_snapshot_token;
+
+        std::unique_ptr<class SnapshotReceiver> m_snapshot_receiver;
+        std::vector<TransformMessage> m_snapshot_transforms;
+        std::vector<SpriteMessage> m_snapshot_sprites;
 
         std::unique_ptr<class ConsoleDrawer> m_console_drawer;
         std::unique_ptr<class ClientPlayerDaemon> m_player_daemon;
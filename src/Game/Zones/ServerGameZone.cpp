@@ -25,6 +25,7 @@ using namespace game;
 ServerGameZone::ServerGameZone(const ZoneCreationContext& context)
     : GameZone(context)
     , m_system_context(context.system_context)
+    , m_num_entities(context.num_entities)
     , m_event_handler(context.event_handler)
     , m_game_config(*context.game_config)
 { }
@@ -47,6 +48,7 @@ void ServerGameZone::OnLoad(mono::ICamera* camera, mono::IRenderer* renderer)
     //server_manager->StartServer();
 
     ServerReplicator* server_replicator = new ServerReplicator(
+        m_num_entities,
         m_event_handler,
         entity_system,
         transform_system,
@@ -54,7 +56,8 @@ void ServerGameZone::OnLoad(mono::ICamera* camera, mono::IRenderer* renderer)
         damage_system,
         server_manager,
         m_leveldata.metadata,
-        m_game_config.server_replication_interval);
+        m_game_config.server_replication_interval,
+        m_game_config.server_snapshot_replication);
     AddUpdatable(server_replicator);
 
     // Debug
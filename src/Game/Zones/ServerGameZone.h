@@ -22,6 +22,7 @@ namespace game
     protected:
 
         mono::SystemContext* m_system_context;
+        uint32_t m_num_entities;
         mono::EventHandler* m_event_handler;
         const game::Config m_game_config;
     };
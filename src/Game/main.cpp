@@ -5,6 +5,7 @@
 
 #include "System/Audio.h"
 #include "System/System.h"
+#include "System/File.h"
 #include "System/Network.h"
 
 #include "EntitySystem/IEntityManager.h"
@@ -14,7 +15,10 @@
 #include "FontIds.h"
 #include "GameConfig.h"
 #include "GameSystems.h"
+#include "ProcessMemory.h"
 #include "Resources.h"
+#include "WorldBinary.h"
+#include "WorldFile.h"
 #include "Zones/ZoneManager.h"
 
 #include "Network/NetworkMessage.h"
@@ -22,8 +26,12 @@
 #include "Entity/ComponentFunctions.h"
 #include "Entity/GameComponentFuncs.h"
 
+#include "nlohmann/json.hpp"
+
 #include <cassert>
 #include <cstring>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -36,6 +44,8 @@ namespace
         const char* start_zone = nullptr;
         const char* game_config = "res/configs/game_config.json";
         const char* log_file = "game_log.log";
+        bool convert_worlds = false;
+        const char* benchmark_world = nullptr;
     };
 
     Options ParseCommandline(int argc, char* argv[])
@@ -67,10 +77,162 @@ namespace
             {
                 options.log_file = argv[++index];
             }
+            else if(std::strcmp(arg, "-convert-worlds") == 0)
+            {
+                options.convert_worlds = true;
+            }
+            else if(std::strcmp(arg, "-benchmark-load") == 0)
+            {
+                options.benchmark_world = argv[++index];
+            }
         }
 
         return options;
     }
+
+    // Writes the binary version of every world next to the json world, then exits.
+    int ConvertAllWorlds(const char* all_worlds_file)
+    {
+        const std::vector<byte> file_data = file::FileReadAll(all_worlds_file);
+        const nlohmann::json& json = nlohmann::json::parse(file_data);
+
+        int result = 0;
+
+        for(const std::string& world_file : json["all_worlds"])
+        {
+            const std::string binary_file = game::WorldBinaryFilename(world_file.c_str());
+            if(!game::ConvertWorldToBinary(world_file.c_str(), binary_file.c_str()))
+            {
+                System::Log("main|Failed to convert world '%s'.", world_file.c_str());
+                result = 1;
+                continue;
+            }
+
+            game::MappedFile json_world;
+            game::MappedFile binary_world;
+            json_world.Open(world_file.c_str());
+            binary_world.Open(binary_file.c_str());
+            System::Log(
+                "main|Converted '%s', %u kb json, %u kb binary.",
+                world_file.c_str(), uint32_t(json_world.Size() / 1024), uint32_t(binary_world.Size() / 1024));
+        }
+
+        return result;
+    }
+
+    struct WorldLoadResult
+    {
+        bool loaded = false;
+        game::WorldLoadTimings timings;
+        float total_ms = 0.0f;
+        size_t peak_growth_kb = 0;
+    };
+
+    // Loads the world into the entity system, logs the time per stage and how far the load raised the peak
+    // resident memory, then releases the entities again.
+    WorldLoadResult BenchmarkWorldLoad(
+        const char* world_file, bool allow_binary, mono::IEntityManager* entity_manager, mono::SystemContext& system_context)
+    {
+        WorldLoadResult result;
+
+        game::ResetPeakResidentBytes();
+        const size_t resident_before = game::ResidentBytes();
+
+        const game::LevelData level_data =
+            game::ReadWorldComponentObjects(world_file, entity_manager, nullptr, &result.timings, allow_binary);
+
+        const size_t peak_resident = game::PeakResidentBytes();
+        result.loaded = true;
+        result.total_ms = result.timings.parse_ms + result.timings.decode_ms + result.timings.commit_ms;
+        result.peak_growth_kb = (peak_resident > resident_before) ? (peak_resident - resident_before) / 1024 : 0;
+
+        System::Log(
+            "main|Loaded '%s' (%s), %u entities on %u threads. parse %.2f ms, decode %.2f ms, commit %.2f ms, total %.2f ms, peak +%u kb.",
+            world_file,
+            result.timings.binary ? "binary" : "json",
+            result.timings.n_entities,
+            result.timings.n_threads,
+            result.timings.parse_ms,
+            result.timings.decode_ms,
+            result.timings.commit_ms,
+            result.total_ms,
+            uint32_t(result.peak_growth_kb));
+
+        for(uint32_t entity_id : level_data.loaded_entities)
+            entity_manager->ReleaseEntity(entity_id);
+        system_context.SyncSystems();
+
+        return result;
+    }
+
+    // Loads each world as json and, when it has been converted, as binary. Then logs one table row per world.
+    // "all" benchmarks every world in the world list.
+    void BenchmarkWorldLoads(const char* benchmark_world, mono::IEntityManager* entity_manager, mono::SystemContext& system_context)
+    {
+        std::vector<std::string> world_files;
+        if(std::strcmp(benchmark_world, "all") == 0)
+        {
+            const std::vector<byte> file_data = file::FileReadAll("res/worlds/all_worlds.json");
+            const nlohmann::json& json = nlohmann::json::parse(file_data);
+            world_files = json["all_worlds"].get<std::vector<std::string>>();
+        }
+        else
+        {
+            world_files.push_back(benchmark_world);
+        }
+
+        if(!game::ResetPeakResidentBytes())
+            System::Log("main|Peak memory can not be reset here, each peak is the highest since the game started.");
+
+        struct WorldRow
+        {
+            std::string world_file;
+            uint32_t n_entities;
+            WorldLoadResult json;
+            WorldLoadResult binary;
+        };
+
+        std::vector<WorldRow> rows;
+
+        for(const std::string& world_file : world_files)
+        {
+            WorldRow row;
+            row.world_file = world_file;
+            row.json = BenchmarkWorldLoad(world_file.c_str(), false, entity_manager, system_context);
+            row.n_entities = row.json.timings.n_entities;
+
+            const std::string binary_file = game::WorldBinaryFilename(world_file.c_str());
+            if(file::Exists(binary_file.c_str()))
+            {
+                row.binary = BenchmarkWorldLoad(world_file.c_str(), true, entity_manager, system_context);
+                row.binary.loaded = row.binary.timings.binary;
+            }
+
+            rows.push_back(std::move(row));
+        }
+
+        System::Log("main|world | entities | json ms | binary ms | json peak kb | binary peak kb");
+        for(const WorldRow& row : rows)
+        {
+            if(row.binary.loaded)
+            {
+                System::Log(
+                    "main|%s | %u | %.2f | %.2f | %u | %u",
+                    row.world_file.c_str(),
+                    row.n_entities,
+                    row.json.total_ms,
+                    row.binary.total_ms,
+                    uint32_t(row.json.peak_growth_kb),
+                    uint32_t(row.binary.peak_growth_kb));
+            }
+            else
+            {
+                System::Log(
+                    "main|%s | %u | %.2f | - | %u | -",
+                    row.world_file.c_str(), row.n_entities, row.json.total_ms, uint32_t(row.json.peak_growth_kb));
+            }
+        }
+    }
 }
 
 int main(int argc, char* argv[])
@@ -89,6 +251,13 @@ int main(int argc, char* argv[])
 
     System::Initialize(system_init_context);
 
+    if(options.convert_worlds)
+    {
+        const int result = ConvertAllWorlds("res/worlds/all_worlds.json");
+        System::Shutdown();
+        return result;
+    }
+
     game::Config game_config;
     game::LoadConfig(options.game_config, game_config);
 
@@ -143,14 +312,21 @@ int main(int argc, char* argv[])
         game::RegisterSharedComponents(entity_manager);
         game::LoadFonts();
 
-        game::ZoneCreationContext zone_context;
-        zone_context.num_entities = max_entities;
-        zone_context.event_handler = &event_handler;
-        zone_context.game_config = &game_config;
-        zone_context.system_context = &system_context;
-        zone_context.window = window.get();
-
-        game::ZoneManager::Run(&camera, zone_context, options.start_zone);
+        if(options.benchmark_world)
+        {
+            BenchmarkWorldLoads(options.benchmark_world, entity_manager, system_context);
+        }
+        else
+        {
+            game::ZoneCreationContext zone_context;
+            zone_context.num_entities = max_entities;
+            zone_context.event_handler = &event_handler;
+            zone_context.game_config = &game_config;
+            zone_context.system_context = &system_context;
+            zone_context.window = window.get();
+
+            game::ZoneManager::Run(&camera, zone_context, options.start_zone);
+        }
 
         system_context.DestroySystems();
 
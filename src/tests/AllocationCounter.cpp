@@ -0,0 +1,36 @@
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<uint32_t> g_allocations(0);
+}
+
+// Counts every heap allocation in the test executable.
+void* operator new(std::size_t size)
+{
+    g_allocations++;
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if(!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept
+{
+    std::free(memory);
+}
+
+uint32_t tests::HeapAllocations()
+{
+    return g_allocations;
+}
@@ -0,0 +1,10 @@
+
+#pragma once
+
+#include <cstdint>
+
+namespace tests
+{
+    // Number of global operator new calls made by the test executable so far.
+    uint32_t HeapAllocations();
+}
@@ -0,0 +1,111 @@
+
+#include "gtest/gtest.h"
+
+#include "Entity/AttributeSet.h"
+#include "Entity/Component.h"
+
+#include <chrono>
+#include <cstdio>
+
+TEST(AttributeSet, FindsAttributes)
+{
+    std::vector<Attribute> attributes;
+    for(uint32_t index = 0; index < 40; ++index)
+        attributes.push_back({ index * 2654435761u, float(index) });
+
+    // Same as the linear search, the first one wins.
+    attributes.push_back({ attributes[3].id, 100.0f });
+
+    const AttributeSet attribute_set(attributes);
+
+    for(uint32_t index = 0; index < 40; ++index)
+    {
+        float value = 0.0f;
+        EXPECT_TRUE(FindAttribute(attributes[index].id, attribute_set, value, FallbackMode::REQUIRE_ATTRIBUTE));
+        EXPECT_EQ(float(index), value);
+    }
+
+    EXPECT_EQ(nullptr, attribute_set.Find(7));
+}
+
+TEST(AttributeSet, MergeKeepsOrder)
+{
+    std::vector<Attribute> result = { { 3, 1.0f }, { 1, 2.0f } };
+    const std::vector<Attribute> other = { { 1, 5.0f }, { 2, 6.0f }, { 2, 7.0f } };
+    MergeAttributes(result, other);
+
+    ASSERT_EQ(3u, result.size());
+    EXPECT_EQ(3u, result[0].id);
+    EXPECT_EQ(5.0f, std::get<float>(result[1].value));
+    EXPECT_EQ(2u, result[2].id);
+    EXPECT_EQ(7.0f, std::get<float>(result[2].value));
+}
+
+TEST(AttributeSetBenchmark, ComponentSetupThroughput)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t n_spawns = 20000;
+    const uint32_t component_hashes[] = {
+        TRANSFORM_COMPONENT, SPRITE_COMPONENT, PHYSICS_COMPONENT, CIRCLE_SHAPE_COMPONENT, AREA_EMITTER_COMPONENT
+    };
+
+    // What a spawned entity file overrides, the rest comes from the defaults.
+    std::vector<std::vector<Attribute>> overrides;
+    for(uint32_t hash : component_hashes)
+    {
+        const std::vector<Attribute>& default_properties = component::DefaultComponentFromHash(hash).properties;
+        overrides.emplace_back(default_properties.begin(), default_properties.begin() + default_properties.size() / 2);
+    }
+
+    // Merges every component with the defaults and reads all properties back, like the Update functions do.
+    const auto setup_components = [&](auto read_properties) {
+        uint32_t n_found = 0;
+        for(uint32_t spawn = 0; spawn < n_spawns; ++spawn)
+        {
+            for(uint32_t index = 0; index < std::size(component_hashes); ++index)
+            {
+                Component component = component::DefaultComponentFromHash(component_hashes[index]);
+                MergeAttributes(component.properties, overrides[index]);
+                n_found += read_properties(component);
+            }
+        }
+        return n_found;
+    };
+
+    const auto read_vector = [](const Component& component) {
+        uint32_t n_found = 0;
+        for(const Attribute& attribute : component.properties)
+        {
+            const Attribute* found = nullptr;
+            n_found += FindAttribute(attribute.id, component.properties, found);
+        }
+        return n_found;
+    };
+
+    const auto read_set = [](const Component& component) {
+        const AttributeSet attribute_set(component.properties);
+        uint32_t n_found = 0;
+        for(const Attribute& attribute : component.properties)
+        {
+            const Attribute* found = nullptr;
+            n_found += FindAttribute(attribute.id, attribute_set, found);
+        }
+        return n_found;
+    };
+
+    const auto vector_start = Clock::now();
+    const uint32_t vector_found = setup_components(read_vector);
+    const std::chrono::duration<double> vector_seconds = Clock::now() - vector_start;
+
+    const auto set_start = Clock::now();
+    const uint32_t set_found = setup_components(read_set);
+    const std::chrono::duration<double> set_seconds = Clock::now() - set_start;
+
+    EXPECT_EQ(vector_found, set_found);
+
+    const uint32_t n_components = n_spawns * std::size(component_hashes);
+    std::printf(
+        "Component setups/sec, vector lookup: %.0f, attribute set: %.0f\n",
+        n_components / vector_seconds.count(), n_components / set_seconds.count());
+}
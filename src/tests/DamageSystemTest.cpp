@@ -0,0 +1,226 @@
+
+#include "gtest/gtest.h"
+
+#include "BitSet.h"
+#include "DamageSystem/AreaEffectQueue.h"
+#include "DamageSystem/DamageSystem.h"
+#include "Entity/Component.h"
+#include "EntitySystem/EntitySystem.h"
+#include "IUpdatable.h"
+#include "Math/MathFunctions.h"
+#include "Rendering/Sprite/SpriteSystem.h"
+#include "SystemContext.h"
+#include "TransformSystem/TransformSystem.h"
+
+#include <chrono>
+#include <cstdio>
+
+TEST(BitSet, ForEachSetVisitsSetBitsInOrder)
+{
+    game::BitSet bit_set(200);
+    const std::vector<uint32_t> expected = { 0, 5, 63, 64, 130, 199 };
+    for(uint32_t index : expected)
+        bit_set.Set(index, true);
+
+    bit_set.Set(5, false);
+    bit_set.Set(5, true);
+    EXPECT_TRUE(bit_set.Test(130));
+    EXPECT_FALSE(bit_set.Test(131));
+
+    std::vector<uint32_t> visited;
+    bit_set.ForEachSet([&visited](uint32_t index) { visited.push_back(index); });
+    EXPECT_EQ(expected, visited);
+}
+
+TEST(AreaEffectQueue, BarrageIsClusteredInQueueOrder)
+{
+    game::AreaEffectQueue queue;
+
+    // A rocket barrage hitting two spots, and one explosion far away.
+    for(int index = 0; index < 20; ++index)
+    {
+        const math::Vector spot = (index % 2) == 0 ? math::Vector(0.0f, 0.0f) : math::Vector(50.0f, 0.0f);
+        const math::Vector offset(float(index % 5), float(index % 3));
+        queue.Push({ spot + offset, 3.0f, 10.0f, index, 0, 1 });
+    }
+    queue.Push({ math::Vector(-200.0f, 0.0f), 5.0f, 10.0f, 100, 0, 2 });
+
+    const std::vector<game::AreaEffectCluster>& clusters = queue.BuildClusters(15.0f);
+    const std::vector<game::AreaEffect>& effects = queue.ClusteredEffects();
+    ASSERT_EQ(3u, clusters.size());
+    ASSERT_EQ(21u, effects.size());
+
+    EXPECT_EQ(10u, clusters[0].n_effects);
+    EXPECT_EQ(10u, clusters[1].n_effects);
+    EXPECT_EQ(1u, clusters[2].n_effects);
+    EXPECT_EQ(2u, clusters[2].object_types);
+
+    for(const game::AreaEffectCluster& cluster : clusters)
+    {
+        EXPECT_LE(cluster.radius, 15.0f);
+
+        int last_damage = -1;
+        for(uint32_t index = cluster.first_effect; index < cluster.first_effect + cluster.n_effects; ++index)
+        {
+            const game::AreaEffect& effect = effects[index];
+            const float distance = math::DistanceBetween(cluster.center, effect.position);
+            EXPECT_LE(distance + effect.radius, cluster.radius + 0.001f);
+
+            // The damage is the queue index here.
+            EXPECT_GT(effect.damage, last_damage);
+            last_damage = effect.damage;
+        }
+    }
+}
+
+TEST(DamageSystem, DeadRecordsAreReleasedOnce)
+{
+    constexpr uint32_t n_entities = 10;
+
+    mono::SystemContext system_context;
+    mono::EntitySystem* entity_system = system_context.CreateSystem<mono::EntitySystem>(
+        n_entities, &system_context, component::ComponentNameFromHash, AttributeNameFromHash);
+    mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+    mono::SpriteSystem* sprite_system = system_context.CreateSystem<mono::SpriteSystem>(n_entities, transform_system);
+
+    game::DamageSystem damage_system(n_entities, transform_system, sprite_system, nullptr, entity_system, nullptr);
+
+    std::vector<uint32_t> released_count(n_entities, 0);
+    const mono::ReleaseCallback on_release = [&released_count](uint32_t entity_id, mono::ReleasePhase phase) {
+        released_count[entity_id]++;
+    };
+
+    std::vector<uint32_t> entity_ids;
+    for(uint32_t index = 0; index < 5; ++index)
+    {
+        const mono::Entity entity = entity_system->CreateEntity("damage_test", { });
+        entity_system->AddReleaseCallback(entity.id, mono::ReleasePhase::PRE_RELEASE, on_release);
+
+        game::DamageRecord* record = damage_system.CreateRecord(entity.id);
+        record->full_health = 100;
+        entity_ids.push_back(entity.id);
+    }
+
+    const uint32_t damaged_id = entity_ids[0];
+    const uint32_t drained_id = entity_ids[1];
+    const uint32_t set_id = entity_ids[2];
+    const uint32_t reactivated_id = entity_ids[3];
+    const uint32_t alive_id = entity_ids[4];
+
+    // Each way of taking a record to 0 health, the first two listed twice.
+    const game::DamageDetails lethal_damage(1000, false, true, false);
+    damage_system.ApplyDamage(damaged_id, 0, 0, lethal_damage);
+    damage_system.ApplyDamage(damaged_id, 0, 0, lethal_damage);
+    damage_system.GainHealth(drained_id, -1000);
+    damage_system.SetHealth(drained_id, 0);
+    damage_system.SetHealth(set_id, 0);
+
+    // Killed and brought back in the same frame.
+    damage_system.ApplyDamage(reactivated_id, 0, 0, lethal_damage);
+    damage_system.ReactivateDamageRecord(reactivated_id);
+
+    damage_system.ApplyDamage(alive_id, 0, 0, game::DamageDetails(10, false, true, false));
+
+    mono::UpdateContext update_context;
+    update_context.delta_s = 1.0f / 60.0f;
+    update_context.timestamp = 16;
+    update_context.paused = false;
+
+    damage_system.Update(update_context);
+    damage_system.PostUpdate();
+    entity_system->Sync();
+
+    // Nothing more to release the next frame.
+    update_context.timestamp += 16;
+    damage_system.Update(update_context);
+    damage_system.PostUpdate();
+    entity_system->Sync();
+
+    EXPECT_EQ(1u, released_count[damaged_id]);
+    EXPECT_EQ(1u, released_count[drained_id]);
+    EXPECT_EQ(1u, released_count[set_id]);
+    EXPECT_EQ(0u, released_count[reactivated_id]);
+    EXPECT_EQ(0u, released_count[alive_id]);
+
+    EXPECT_FALSE(damage_system.IsAllocated(damaged_id));
+    EXPECT_FALSE(damage_system.IsAllocated(drained_id));
+    EXPECT_FALSE(damage_system.IsAllocated(set_id));
+
+    ASSERT_TRUE(damage_system.IsAllocated(reactivated_id));
+    EXPECT_EQ(100, damage_system.GetDamageRecord(reactivated_id)->health);
+    ASSERT_TRUE(damage_system.IsAllocated(alive_id));
+    EXPECT_EQ(90, damage_system.GetDamageRecord(alive_id)->health);
+
+    system_context.DestroySystems();
+}
+
+TEST(DamageSystemBenchmark, ThousandRecordsTwoHundredHitsPerFrame)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t n_records = 1000;
+    constexpr uint32_t hits_per_frame = 200;
+    constexpr uint32_t n_frames = 500;
+
+    // No lethal damage, the death path needs the entity and sprite systems.
+    game::DamageSystem damage_system(n_records, nullptr, nullptr, nullptr, nullptr, nullptr);
+    for(uint32_t entity_id = 0; entity_id < n_records; ++entity_id)
+    {
+        game::DamageRecord* record = damage_system.CreateRecord(entity_id);
+        record->full_health = 1000000;
+        damage_system.SetHealth(entity_id, record->full_health);
+    }
+
+    uint32_t damaged_callbacks = 0;
+    uint32_t global_callbacks = 0;
+
+    for(uint32_t entity_id = 0; entity_id < n_records; entity_id += 10)
+    {
+        const auto on_damaged = [&damaged_callbacks](uint32_t, uint32_t, uint32_t, int, game::DamageType) { damaged_callbacks++; };
+        damage_system.SetDamageCallback(entity_id, game::DamageType::DAMAGED, on_damaged);
+    }
+
+    const auto on_any_damage = [&global_callbacks](uint32_t, uint32_t, uint32_t, int, game::DamageType) { global_callbacks++; };
+    damage_system.SetGlobalDamageCallback(game::DamageType::DT_ALL, on_any_damage);
+
+    mono::UpdateContext update_context;
+    update_context.delta_s = 1.0f / 60.0f;
+    update_context.timestamp = 0;
+    update_context.paused = false;
+
+    const game::DamageDetails damage_details(1, false, true, false);
+
+    std::chrono::duration<double> idle_seconds(0.0);
+    std::chrono::duration<double> damage_seconds(0.0);
+
+    for(uint32_t frame = 0; frame < n_frames; ++frame)
+    {
+        update_context.timestamp = frame * 16;
+
+        const auto idle_start = Clock::now();
+        damage_system.Update(update_context);
+        damage_system.PostUpdate();
+        idle_seconds += Clock::now() - idle_start;
+
+        const auto damage_start = Clock::now();
+        for(uint32_t hit = 0; hit < hits_per_frame; ++hit)
+        {
+            const uint32_t entity_id = (frame * hits_per_frame + hit * 7) % n_records;
+            damage_system.ApplyDamage(entity_id, 0, 0, damage_details);
+        }
+        damage_system.Update(update_context);
+        damage_system.PostUpdate();
+        damage_seconds += Clock::now() - damage_start;
+    }
+
+    EXPECT_EQ(n_frames * hits_per_frame, global_callbacks);
+    EXPECT_GT(damaged_callbacks, 0u);
+
+    uint32_t alive = 0;
+    damage_system.ForEeach([&alive](uint32_t, const game::DamageRecord&) { alive++; });
+    EXPECT_EQ(n_records, alive);
+
+    std::printf(
+        "DamageSystem %u records, us/frame without damage: %.3f, with %u hits: %.3f\n",
+        n_records, idle_seconds.count() * 1e6 / n_frames, hits_per_frame, damage_seconds.count() * 1e6 / n_frames);
+}
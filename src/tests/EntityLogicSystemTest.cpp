@@ -0,0 +1,961 @@
+
+#include "gtest/gtest.h"
+
+#include "Entity/Component.h"
+#include "Entity/ComponentFunctions.h"
+#include "Entity/EntityLogicSystem.h"
+#include "Entity/IEntityLogic.h"
+#include "Entity/ILogicPool.h"
+#include "Entity/LogicCommandBuffer.h"
+#include "Enemies/BatController.h"
+#include "Enemies/BatLogicPool.h"
+#include "Enemies/BlobController.h"
+#include "Enemies/BlobLogicPool.h"
+#include "RandomStream.h"
+#include "Weapons/BulletWeapon/BulletLogic.h"
+#include "Weapons/BulletWeapon/BulletSoundPool.h"
+#include "CollisionConfiguration.h"
+#include "DamageSystem/DamageSystem.h"
+#include "AllocationCounter.h"
+
+#include "IGameSystem.h"
+#include "SystemContext.h"
+#include "EntitySystem/EntitySystem.h"
+#include "TransformSystem/TransformSystem.h"
+#include "TriggerSystem/TriggerSystem.h"
+#include "Physics/IBody.h"
+#include "Physics/PhysicsSystem.h"
+#include "Rendering/Sprite/SpriteSystem.h"
+#include "System/Audio.h"
+#include "Math/Matrix.h"
+
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct FullAutoResult
+    {
+        uint32_t bullets_fired;
+        uint32_t bullets_expired;
+        uint32_t bullets_after_warmup;
+        uint32_t heap_allocations_after_warmup;
+        float seconds_after_warmup;
+        uint32_t slab_pages_after_warmup;
+        game::LogicAllocationStats stats;
+    };
+
+    // Holds the trigger for a number of seconds, rounds_per_second with a few projectiles each. The bullets are
+    // real BulletLogics with a body and a shape each, released when their life span runs out.
+    FullAutoResult RunFullAuto(bool use_pool)
+    {
+        constexpr uint32_t n_entities = 2000;
+        constexpr float seconds = 10.0f;
+        constexpr float delta_s = 1.0f / 60.0f;
+        constexpr float rounds_per_second = 20.0f;
+        constexpr uint32_t projectiles_per_round = 5;
+
+        mono::SystemContext system_context;
+        mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+
+        mono::PhysicsSystemInitParams physics_system_params;
+        physics_system_params.n_bodies = n_entities;
+        physics_system_params.n_circle_shapes = n_entities;
+        physics_system_params.n_segment_shapes = 0;
+        physics_system_params.n_polygon_shapes = 0;
+        mono::PhysicsSystem* physics_system = system_context.CreateSystem<mono::PhysicsSystem>(physics_system_params, transform_system);
+
+        game::BulletSoundPool sound_pool(4);
+
+        game::EntityLogicSystem logic_system(n_entities, nullptr, nullptr);
+        mono::IGameSystem& game_system = logic_system;
+
+        std::vector<uint32_t> expired_ids;
+        const game::BulletImpactCallback on_impact = [&expired_ids](
+            uint32_t bullet_entity_id, uint32_t, uint32_t, const char*, game::BulletImpactFlag, const game::DamageDetails&, const game::CollisionDetails&) {
+            expired_ids.push_back(bullet_entity_id);
+        };
+
+        game::BulletConfiguration bullet_config = { };
+        bullet_config.min_damage = 10;
+        bullet_config.max_damage = 20;
+        bullet_config.life_span = 1.5f;
+
+        game::CollisionConfiguration collision_config;
+        collision_config.collision_category = game::CollisionCategory::PLAYER_BULLET;
+        collision_config.collision_mask = 0;
+        collision_config.collision_callback = &on_impact;
+
+        mono::BodyComponent body_params;
+        body_params.mass = 1.0f;
+        body_params.inertia = 1.0f;
+        body_params.type = mono::BodyType::DYNAMIC;
+
+        mono::CircleComponent shape_params;
+        shape_params.radius = 0.1f;
+        shape_params.offset = math::ZeroVec;
+        shape_params.is_sensor = false;
+        shape_params.category = 0;
+        shape_params.mask = 0;
+
+        mono::UpdateContext update_context;
+        update_context.delta_s = delta_s;
+        update_context.timestamp = 0;
+        update_context.paused = false;
+
+        FullAutoResult result = { };
+
+        std::vector<uint32_t> free_ids;
+        for(uint32_t entity_id = n_entities; entity_id > 0; --entity_id)
+            free_ids.push_back(entity_id - 1);
+
+        std::vector<uint32_t> active_ids;
+        active_ids.reserve(n_entities);
+        expired_ids.reserve(n_entities);
+
+        float fire_counter = 0.0f;
+        const uint32_t n_frames = seconds / delta_s;
+        const uint32_t warmup_frames = 120;
+        uint32_t allocations_at_warmup = 0;
+
+        for(uint32_t frame = 0; frame < n_frames; ++frame)
+        {
+            if(frame == warmup_frames)
+            {
+                result.slab_pages_after_warmup = logic_system.GetAllocationStats().slab_pages;
+                allocations_at_warmup = tests::HeapAllocations();
+            }
+
+            fire_counter += delta_s * rounds_per_second;
+            for(; fire_counter >= 1.0f; fire_counter -= 1.0f)
+            {
+                for(uint32_t index = 0; index < projectiles_per_round; ++index)
+                {
+                    const uint32_t entity_id = free_ids.back();
+                    free_ids.pop_back();
+
+                    transform_system->SetTransform(entity_id, math::CreateMatrixWithPosition(math::ZeroVec));
+                    physics_system->AllocateBody(entity_id, body_params);
+                    physics_system->AddShape(entity_id, shape_params);
+
+                    const math::Vector velocity(10.0f, 0.0f);
+                    if(use_pool)
+                    {
+                        logic_system.AddPooledLogic<game::BulletLogic>(
+                            entity_id, entity_id, 0, 0, math::ZeroVec, velocity, 0.0f, bullet_config, collision_config,
+                            transform_system, physics_system, nullptr, &sound_pool);
+                    }
+                    else
+                    {
+                        game::BulletLogic* logic = new game::BulletLogic(
+                            entity_id, 0, 0, math::ZeroVec, velocity, 0.0f, bullet_config, collision_config,
+                            transform_system, physics_system, nullptr, &sound_pool);
+                        logic_system.AddLogic(entity_id, logic);
+                    }
+
+                    active_ids.push_back(entity_id);
+                    result.bullets_fired++;
+                    if(frame >= warmup_frames)
+                        result.bullets_after_warmup++;
+                }
+            }
+
+            update_context.timestamp += 16;
+            game_system.Update(update_context);
+
+            // What the weapon system does when the bullet runs out of time, the entity and its logic goes away.
+            for(uint32_t entity_id : expired_ids)
+            {
+                logic_system.ReleaseLogic(entity_id);
+                physics_system->ReleaseBody(entity_id);
+                free_ids.push_back(entity_id);
+                active_ids.erase(std::find(active_ids.begin(), active_ids.end(), entity_id));
+                result.bullets_expired++;
+            }
+            expired_ids.clear();
+        }
+
+        result.heap_allocations_after_warmup = tests::HeapAllocations() - allocations_at_warmup;
+        result.seconds_after_warmup = (n_frames - warmup_frames) * delta_s;
+
+        for(uint32_t entity_id : active_ids)
+        {
+            logic_system.ReleaseLogic(entity_id);
+            physics_system->ReleaseBody(entity_id);
+        }
+
+        result.stats = logic_system.GetAllocationStats();
+        system_context.DestroySystems();
+
+        return result;
+    }
+
+    constexpr uint32_t FrameEnd = uint32_t(-1);
+    constexpr uint32_t MainThreadFlag = 0x80000000u;
+
+    // Works on its own state and records a command now and then, like a bullet running out of time.
+    class TestThreadSafeLogic : public game::IEntityLogic
+    {
+    public:
+
+        TestThreadSafeLogic(uint32_t entity_id, std::vector<uint32_t>& command_log)
+            : m_entity_id(entity_id)
+            , m_command_log(command_log)
+            , m_state(entity_id * 2654435761u + 1)
+            , m_value(0.0f)
+        { }
+
+        bool IsThreadSafe() const override
+        {
+            return true;
+        }
+
+        void UpdateWithCommands(const mono::UpdateContext& update_context, game::LogicCommandBuffer& commands) override
+        {
+            for(uint32_t index = 0; index < 256; ++index)
+            {
+                m_state ^= m_state << 13;
+                m_state ^= m_state >> 17;
+                m_state ^= m_state << 5;
+                m_value += float(m_state % 1000) * update_context.delta_s;
+            }
+
+            if(m_state % 7 == 0)
+                commands.Call(&TestThreadSafeLogic::RecordCommand, &m_command_log, m_entity_id);
+        }
+
+        static void RecordCommand(void* context, uint32_t entity_id)
+        {
+            static_cast<std::vector<uint32_t>*>(context)->push_back(entity_id);
+        }
+
+        const uint32_t m_entity_id;
+        std::vector<uint32_t>& m_command_log;
+        uint32_t m_state;
+        float m_value;
+    };
+
+    class TestMainThreadLogic : public game::IEntityLogic
+    {
+    public:
+
+        TestMainThreadLogic(uint32_t entity_id, std::vector<uint32_t>& command_log)
+            : m_entity_id(entity_id)
+            , m_command_log(command_log)
+        { }
+
+        void Update(const mono::UpdateContext& update_context) override
+        {
+            m_command_log.push_back(m_entity_id | MainThreadFlag);
+        }
+
+        const uint32_t m_entity_id;
+        std::vector<uint32_t>& m_command_log;
+    };
+
+    struct LogicRunResult
+    {
+        std::vector<uint32_t> command_log;
+        std::vector<float> values;
+        double ms_per_frame;
+    };
+
+    LogicRunResult RunLogics(uint32_t n_threads)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+
+        constexpr uint32_t n_entities = 2000;
+        constexpr uint32_t n_frames = 120;
+
+        LogicRunResult result;
+
+        game::EntityLogicSystem logic_system(n_entities, nullptr, nullptr);
+        logic_system.SetUpdateThreads(n_threads);
+        mono::IGameSystem& game_system = logic_system;
+
+        std::vector<TestThreadSafeLogic*> thread_safe_logics;
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+        {
+            if(entity_id % 10 == 0)
+            {
+                logic_system.AddLogic(entity_id, new TestMainThreadLogic(entity_id, result.command_log));
+            }
+            else
+            {
+                TestThreadSafeLogic* logic = new TestThreadSafeLogic(entity_id, result.command_log);
+                logic_system.AddLogic(entity_id, logic);
+                thread_safe_logics.push_back(logic);
+            }
+        }
+
+        mono::UpdateContext update_context;
+        update_context.delta_s = 1.0f / 60.0f;
+        update_context.timestamp = 0;
+        update_context.paused = false;
+
+        const auto start = Clock::now();
+        for(uint32_t frame = 0; frame < n_frames; ++frame)
+        {
+            update_context.timestamp += 16;
+            game_system.Update(update_context);
+            result.command_log.push_back(FrameEnd);
+        }
+        const std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+        result.ms_per_frame = duration.count() / n_frames;
+
+        for(const TestThreadSafeLogic* logic : thread_safe_logics)
+            result.values.push_back(logic->m_value);
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+            logic_system.ReleaseLogic(entity_id);
+
+        return result;
+    }
+}
+
+TEST(EntityLogicSystem, FullAutoBulletLogicAllocations)
+{
+    const FullAutoResult heap_result = RunFullAuto(false);
+    const FullAutoResult pooled_result = RunFullAuto(true);
+
+    EXPECT_GT(heap_result.bullets_expired, 0u);
+    EXPECT_EQ(heap_result.bullets_fired, pooled_result.bullets_fired);
+    EXPECT_EQ(heap_result.bullets_expired, pooled_result.bullets_expired);
+    EXPECT_EQ(pooled_result.bullets_fired, pooled_result.stats.pooled_logics);
+    EXPECT_EQ(0u, pooled_result.stats.heap_logics);
+
+    // After two seconds the slab has all the blocks it needs.
+    EXPECT_GT(pooled_result.slab_pages_after_warmup, 0u);
+    EXPECT_EQ(pooled_result.slab_pages_after_warmup, pooled_result.stats.slab_pages);
+
+    // Everything else a bullet does is the same in both runs, the slab saves the logic allocation for each bullet.
+    ASSERT_GE(heap_result.heap_allocations_after_warmup, pooled_result.heap_allocations_after_warmup);
+    EXPECT_GE(heap_result.heap_allocations_after_warmup - pooled_result.heap_allocations_after_warmup, pooled_result.bullets_after_warmup);
+
+    std::printf(
+        "Full auto, %u bullets, heap allocations per second: new %.1f, slab %.1f\n",
+        pooled_result.bullets_fired,
+        heap_result.heap_allocations_after_warmup / heap_result.seconds_after_warmup,
+        pooled_result.heap_allocations_after_warmup / pooled_result.seconds_after_warmup);
+}
+
+namespace
+{
+    audio::ISoundPtr CreateTestSound(const char* sound_file)
+    {
+        return audio::CreateNullSound();
+    }
+}
+
+TEST(BulletSoundPool, VoicesAreSharedAndReleased)
+{
+    game::BulletSoundPool sound_pool(2, CreateTestSound);
+
+    EXPECT_EQ(game::BulletSoundPool::NoVoice, sound_pool.AcquireVoice(""));
+
+    // The first bullets get a voice each, then they start sharing the least used one.
+    const uint32_t first = sound_pool.AcquireVoice("res/sound/bullet.wav");
+    const uint32_t second = sound_pool.AcquireVoice("res/sound/bullet.wav");
+    const uint32_t third = sound_pool.AcquireVoice("res/sound/bullet.wav");
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(2u, sound_pool.GetStats().sounds_created);
+    EXPECT_EQ(2u, sound_pool.GetStats().voices_playing);
+
+    // Another sound file gets its own voices.
+    const uint32_t other = sound_pool.AcquireVoice("res/sound/other_bullet.wav");
+    EXPECT_NE(first, other);
+    EXPECT_NE(second, other);
+    EXPECT_EQ(4u, sound_pool.GetStats().sounds_created);
+    EXPECT_EQ(3u, sound_pool.GetStats().voices_playing);
+
+    // A voice stops with its last bullet, and is the one picked up again.
+    sound_pool.ReleaseVoice(second);
+    EXPECT_EQ(2u, sound_pool.GetStats().voices_playing);
+    sound_pool.ReleaseVoice(third);
+    EXPECT_EQ(2u, sound_pool.GetStats().voices_playing);
+    EXPECT_EQ(second, sound_pool.AcquireVoice("res/sound/bullet.wav"));
+    EXPECT_EQ(3u, sound_pool.GetStats().voices_playing);
+
+    sound_pool.ReleaseVoice(second);
+    sound_pool.ReleaseVoice(first);
+    sound_pool.ReleaseVoice(other);
+    sound_pool.ReleaseVoice(game::BulletSoundPool::NoVoice);
+    EXPECT_EQ(0u, sound_pool.GetStats().voices_playing);
+    EXPECT_EQ(4u, sound_pool.GetStats().sounds_created);
+}
+
+TEST(LogicPoolStorage, AddSwapRemoveAndReAdd)
+{
+    struct TestData
+    {
+        uint32_t value;
+    };
+
+    game::LogicPoolStorage<TestData> storage(10);
+    for(uint32_t entity_id : { 2u, 5u, 7u })
+        storage.Add(entity_id).value = entity_id * 10;
+
+    EXPECT_EQ(3u, storage.Size());
+    EXPECT_TRUE(storage.Contains(5));
+    EXPECT_FALSE(storage.Contains(3));
+
+    // Removing the first one swaps the last one into its place.
+    storage.Remove(2);
+    ASSERT_EQ(2u, storage.Size());
+    EXPECT_FALSE(storage.Contains(2));
+    EXPECT_EQ(7u, storage.EntityIds()[0]);
+    EXPECT_EQ(70u, storage.Data()[0].value);
+    EXPECT_EQ(5u, storage.EntityIds()[1]);
+    EXPECT_EQ(50u, storage.Data()[1].value);
+
+    // The swapped one is still found by its entity id.
+    storage.Remove(7);
+    ASSERT_EQ(1u, storage.Size());
+    EXPECT_FALSE(storage.Contains(7));
+    EXPECT_EQ(5u, storage.EntityIds()[0]);
+    EXPECT_EQ(50u, storage.Data()[0].value);
+
+    storage.Add(7).value = 71;
+    storage.Add(2).value = 21;
+    ASSERT_EQ(3u, storage.Size());
+    EXPECT_EQ(7u, storage.EntityIds()[1]);
+    EXPECT_EQ(71u, storage.Data()[1].value);
+    EXPECT_EQ(2u, storage.EntityIds()[2]);
+    EXPECT_EQ(21u, storage.Data()[2].value);
+
+    // Removing the last one needs no swap.
+    storage.Remove(2);
+    storage.Remove(5);
+    storage.Remove(7);
+    EXPECT_EQ(0u, storage.Size());
+    EXPECT_FALSE(storage.Contains(5));
+}
+
+namespace
+{
+    class TestLogicPool : public game::ILogicPool
+    {
+    public:
+
+        TestLogicPool()
+            : m_entities(10)
+        { }
+
+        void Add(uint32_t entity_id) override
+        {
+            m_entities.Add(entity_id);
+        }
+
+        void Remove(uint32_t entity_id) override
+        {
+            m_entities.Remove(entity_id);
+        }
+
+        uint32_t Size() const override
+        {
+            return m_entities.Size();
+        }
+
+        void Update(const mono::UpdateContext& update_context) override
+        { }
+
+        game::LogicPoolStorage<uint32_t> m_entities;
+    };
+
+    class TestReleasedLogic : public game::IEntityLogic
+    {
+    public:
+
+        TestReleasedLogic(bool& released)
+            : m_released(released)
+        { }
+
+        ~TestReleasedLogic()
+        {
+            m_released = true;
+        }
+
+        void Update(const mono::UpdateContext& update_context) override
+        { }
+
+        bool& m_released;
+    };
+}
+
+TEST(EntityLogicSystem, BatchedLogicReplacesTheOldLogic)
+{
+    game::EntityLogicSystem logic_system(10, nullptr, nullptr);
+
+    std::unique_ptr<TestLogicPool> owned_pool = std::make_unique<TestLogicPool>();
+    TestLogicPool* logic_pool = owned_pool.get();
+    logic_system.SetLogicPool(game::EntityLogicType::BAT, std::move(owned_pool));
+
+    // Updating the behaviour component adds the logic again.
+    EXPECT_TRUE(logic_system.AddBatchedLogic(game::EntityLogicType::BAT, 3));
+    EXPECT_TRUE(logic_system.AddBatchedLogic(game::EntityLogicType::BAT, 3));
+    EXPECT_EQ(1u, logic_pool->Size());
+
+    bool released = false;
+    logic_system.AddLogic(4, new TestReleasedLogic(released));
+    EXPECT_TRUE(logic_system.AddBatchedLogic(game::EntityLogicType::BAT, 4));
+    EXPECT_TRUE(released);
+    EXPECT_EQ(2u, logic_pool->Size());
+
+    // A type without a pool still releases the pooled logic, the caller makes the new one.
+    EXPECT_FALSE(logic_system.AddBatchedLogic(game::EntityLogicType::BLOB, 3));
+    EXPECT_EQ(1u, logic_pool->Size());
+    EXPECT_FALSE(logic_pool->m_entities.Contains(3));
+
+    logic_system.ReleaseLogic(4);
+    EXPECT_EQ(0u, logic_pool->Size());
+}
+
+namespace
+{
+    // The local position of each entity for each frame, the entities either with one controller each or in the
+    // logic pool of the type. Both get their random numbers from random_seed.
+    std::vector<std::vector<math::Vector>> RunMovingEnemies(
+        game::EntityLogicType type, bool batched, uint32_t n_entities, uint32_t n_frames, uint32_t random_seed)
+    {
+        mono::SystemContext system_context;
+        mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+        mono::SpriteSystem* sprite_system = system_context.CreateSystem<mono::SpriteSystem>(n_entities, transform_system);
+        mono::IGameSystem& transform_game_system = *transform_system;
+
+        mono::UpdateContext update_context;
+        update_context.delta_s = 1.0f / 60.0f;
+        update_context.timestamp = 0;
+        update_context.paused = false;
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+            transform_system->SetTransform(entity_id, math::CreateMatrixWithPosition(math::Vector(entity_id, 0.0f)));
+        transform_game_system.Update(update_context);
+
+        game::EntityLogicSystem logic_system(n_entities, &system_context, nullptr);
+        mono::IGameSystem& logic_game_system = logic_system;
+
+        if(type == game::EntityLogicType::BAT)
+            logic_system.SetLogicPool(type, std::make_unique<game::BatLogicPool>(n_entities, transform_system, sprite_system, random_seed));
+        else
+            logic_system.SetLogicPool(type, std::make_unique<game::BlobLogicPool>(n_entities, transform_system, sprite_system, random_seed));
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+        {
+            if(batched)
+                logic_system.AddBatchedLogic(type, entity_id);
+            else if(type == game::EntityLogicType::BAT)
+                logic_system.AddLogic(entity_id, new game::BatController(entity_id, &system_context, nullptr, random_seed));
+            else
+                logic_system.AddLogic(entity_id, new game::BlobController(entity_id, &system_context, nullptr, random_seed));
+        }
+
+        std::vector<std::vector<math::Vector>> positions(n_entities);
+        for(uint32_t frame = 0; frame < n_frames; ++frame)
+        {
+            update_context.timestamp += 16;
+            logic_game_system.Update(update_context);
+            transform_game_system.Update(update_context);
+
+            for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+                positions[entity_id].push_back(math::GetPosition(transform_system->GetTransform(entity_id)));
+        }
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+            logic_system.ReleaseLogic(entity_id);
+
+        system_context.DestroySystems();
+        return positions;
+    }
+
+    // Same positions in the same frames, compared exactly since both do the same float math.
+    void ExpectSamePositions(
+        const std::vector<std::vector<math::Vector>>& expected, const std::vector<std::vector<math::Vector>>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for(uint32_t entity_id = 0; entity_id < expected.size(); ++entity_id)
+        {
+            ASSERT_EQ(expected[entity_id].size(), actual[entity_id].size());
+            for(uint32_t frame = 0; frame < expected[entity_id].size(); ++frame)
+            {
+                const math::Vector& expected_position = expected[entity_id][frame];
+                const math::Vector& actual_position = actual[entity_id][frame];
+                ASSERT_TRUE(expected_position.x == actual_position.x && expected_position.y == actual_position.y)
+                    << "entity " << entity_id << ", frame " << frame;
+            }
+        }
+    }
+
+    // How far any entity got from where it started, and how many of them moved at all.
+    std::pair<float, uint32_t> MoveExtent(const std::vector<std::vector<math::Vector>>& positions)
+    {
+        float max_distance = 0.0f;
+        uint32_t n_moved = 0;
+
+        for(uint32_t entity_id = 0; entity_id < positions.size(); ++entity_id)
+        {
+            const math::Vector start_position(entity_id, 0.0f);
+
+            float entity_max_distance = 0.0f;
+            for(const math::Vector& position : positions[entity_id])
+                entity_max_distance = std::max(entity_max_distance, math::Length(position - start_position));
+
+            max_distance = std::max(max_distance, entity_max_distance);
+            if(entity_max_distance > 0.0f)
+                n_moved++;
+        }
+
+        return { max_distance, n_moved };
+    }
+}
+
+TEST(RandomStream, SameSeedAndEntitySameNumbers)
+{
+    game::RandomStream first(1234, 7);
+    game::RandomStream second(1234, 7);
+    game::RandomStream other_entity(1234, 8);
+    game::RandomStream other_seed(4321, 7);
+
+    uint32_t other_entity_differs = 0;
+    uint32_t other_seed_differs = 0;
+
+    for(int index = 0; index < 100; ++index)
+    {
+        const float value = first.Random(-1.0f, 1.0f);
+        EXPECT_EQ(value, second.Random(-1.0f, 1.0f));
+        EXPECT_GE(value, -1.0f);
+        EXPECT_LT(value, 1.0f);
+
+        if(other_entity.Random(-1.0f, 1.0f) != value)
+            other_entity_differs++;
+        if(other_seed.Random(-1.0f, 1.0f) != value)
+            other_seed_differs++;
+    }
+
+    EXPECT_GT(other_entity_differs, 90u);
+    EXPECT_GT(other_seed_differs, 90u);
+
+    uint32_t chances = 0;
+    for(int index = 0; index < 10000; ++index)
+        chances += first.Chance(25) ? 1 : 0;
+    EXPECT_NEAR(2500, chances, 250);
+}
+
+TEST(BatLogicPool, MovesLikeBatController)
+{
+    constexpr uint32_t n_bats = 50;
+    constexpr uint32_t n_frames = 600;
+    constexpr uint32_t random_seed = 1234;
+
+    const std::vector<std::vector<math::Vector>>& controller_positions =
+        RunMovingEnemies(game::EntityLogicType::BAT, false, n_bats, n_frames, random_seed);
+    const std::vector<std::vector<math::Vector>>& batched_positions =
+        RunMovingEnemies(game::EntityLogicType::BAT, true, n_bats, n_frames, random_seed);
+    ExpectSamePositions(controller_positions, batched_positions);
+
+    // A quarter unit on each axis, and the ease overshoots a bit.
+    const std::pair<float, uint32_t> extent = MoveExtent(batched_positions);
+    EXPECT_LT(extent.first, 0.5f);
+    EXPECT_EQ(n_bats, extent.second);
+
+    // Another seed takes the bats somewhere else.
+    const std::vector<std::vector<math::Vector>>& other_seed_positions =
+        RunMovingEnemies(game::EntityLogicType::BAT, true, n_bats, n_frames, random_seed + 1);
+    EXPECT_NE(batched_positions.back().back().x, other_seed_positions.back().back().x);
+}
+
+TEST(BlobLogicPool, MovesLikeBlobController)
+{
+    constexpr uint32_t n_blobs = 50;
+    constexpr uint32_t n_frames = 600;
+    constexpr uint32_t random_seed = 1234;
+
+    const std::vector<std::vector<math::Vector>>& controller_positions =
+        RunMovingEnemies(game::EntityLogicType::BLOB, false, n_blobs, n_frames, random_seed);
+    const std::vector<std::vector<math::Vector>>& batched_positions =
+        RunMovingEnemies(game::EntityLogicType::BLOB, true, n_blobs, n_frames, random_seed);
+    ExpectSamePositions(controller_positions, batched_positions);
+
+    // The blobs jump a quarter unit on each axis from where they are, so they wander off a bit over time.
+    const std::pair<float, uint32_t> extent = MoveExtent(batched_positions);
+    EXPECT_GT(extent.first, 0.0f);
+    EXPECT_EQ(n_blobs, extent.second);
+}
+
+TEST(EntityLogicSystemBenchmark, Update2000Bats)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t n_entities = 2000;
+    constexpr uint32_t n_frames = 600;
+
+    mono::SystemContext system_context;
+    mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+    system_context.CreateSystem<mono::SpriteSystem>(n_entities, transform_system);
+
+    for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+        transform_system->SetTransform(entity_id, math::CreateMatrixWithPosition(math::Vector(entity_id % 50, entity_id / 50)));
+
+    // Returns the time per frame, the bats either as one BatController each or in the bat logic pool.
+    const auto run_bats = [&](bool batched) {
+        game::EntityLogicSystem logic_system(n_entities, &system_context, nullptr);
+        mono::IGameSystem& game_system = logic_system;
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+        {
+            if(batched)
+                logic_system.AddBatchedLogic(game::EntityLogicType::BAT, entity_id);
+            else
+                logic_system.AddLogic(entity_id, new game::BatController(entity_id, &system_context, nullptr));
+        }
+
+        mono::UpdateContext update_context;
+        update_context.delta_s = 1.0f / 60.0f;
+        update_context.timestamp = 0;
+        update_context.paused = false;
+
+        const auto start = Clock::now();
+        for(uint32_t frame = 0; frame < n_frames; ++frame)
+        {
+            update_context.timestamp += 16;
+            game_system.Update(update_context);
+        }
+        const std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+
+        EXPECT_EQ(batched ? n_entities : 0u, logic_system.GetAllocationStats().batched_logics);
+
+        for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+            logic_system.ReleaseLogic(entity_id);
+
+        return duration.count() / n_frames;
+    };
+
+    const double controller_ms = run_bats(false);
+    const double batched_ms = run_bats(true);
+
+    // The bats only move around where they started.
+    for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+    {
+        const math::Vector start_position(entity_id % 50, entity_id / 50);
+        EXPECT_LT(math::Length(transform_system->GetWorldPosition(entity_id) - start_position), 1.0f);
+    }
+
+    system_context.DestroySystems();
+
+    std::printf("%u bats, ms per frame: BatController %.3f, BatLogicPool %.3f\n", n_entities, controller_ms, batched_ms);
+}
+
+namespace
+{
+    // Splits the command log at the frame ends and checks that the entity ids in each frame are in order.
+    bool IsInEntityOrder(const std::vector<uint32_t>& command_log)
+    {
+        uint32_t last_entity_id = 0;
+        for(uint32_t entry : command_log)
+        {
+            if(entry == FrameEnd)
+            {
+                last_entity_id = 0;
+                continue;
+            }
+
+            const uint32_t entity_id = entry & ~MainThreadFlag;
+            if(entity_id < last_entity_id)
+                return false;
+
+            last_entity_id = entity_id;
+        }
+
+        return true;
+    }
+}
+
+TEST(EntityLogicSystem, ParallelUpdateIsDeterministic)
+{
+    const LogicRunResult serial_result = RunLogics(1);
+    const LogicRunResult two_thread_result = RunLogics(2);
+    const LogicRunResult four_thread_result = RunLogics(4);
+
+    // The main thread logics and the commands of the thread safe logics in entity order, for any number of threads.
+    EXPECT_FALSE(serial_result.command_log.empty());
+    EXPECT_TRUE(IsInEntityOrder(serial_result.command_log));
+    EXPECT_EQ(serial_result.command_log, two_thread_result.command_log);
+    EXPECT_EQ(serial_result.command_log, four_thread_result.command_log);
+
+    EXPECT_EQ(serial_result.values, two_thread_result.values);
+    EXPECT_EQ(serial_result.values, four_thread_result.values);
+
+    std::printf(
+        "2000 logics, ms per frame: serial %.3f, 2 threads %.3f, 4 threads %.3f\n",
+        serial_result.ms_per_frame, two_thread_result.ms_per_frame, four_thread_result.ms_per_frame);
+}
+
+namespace
+{
+    constexpr const char* spawned_entity_file = "logic_command_buffer_test.entity";
+
+    void WriteTransformEntityFile()
+    {
+        nlohmann::json component_properties;
+        for(const Attribute& property : component::DefaultComponentFromHash(TRANSFORM_COMPONENT).properties)
+            component_properties.push_back(property);
+
+        nlohmann::json json_components;
+        json_components.push_back(
+            { { "hash", TRANSFORM_COMPONENT }, { "name", component::ComponentNameFromHash(TRANSFORM_COMPONENT) }, { "properties", component_properties } });
+
+        nlohmann::json json_entity;
+        json_entity["uuid_hash"] = 0;
+        json_entity["name"] = "spawned";
+        json_entity["entity_properties"] = 0;
+        json_entity["components"] = json_components;
+
+        nlohmann::json json;
+        json["entities"] = { json_entity };
+        json["metadata"] = nlohmann::json::object();
+
+        const std::string serialized = json.dump(4);
+        FILE* file = std::fopen(spawned_entity_file, "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(serialized.data(), 1, serialized.size(), file);
+        std::fclose(file);
+    }
+
+    void RecordCall(void* context, uint32_t entity_id)
+    {
+        static_cast<std::vector<uint32_t>*>(context)->push_back(entity_id);
+    }
+}
+
+TEST(LogicCommandBuffer, CommandsApplyToTheSystemsFromTheContext)
+{
+    constexpr uint32_t n_entities = 100;
+    constexpr uint32_t trigger_hash = 0x1234u;
+
+    WriteTransformEntityFile();
+
+    mono::SystemContext system_context;
+    mono::EntitySystem* entity_system = system_context.CreateSystem<mono::EntitySystem>(
+        n_entities, &system_context, component::ComponentNameFromHash, AttributeNameFromHash);
+    mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+
+    mono::PhysicsSystemInitParams physics_system_params;
+    physics_system_params.n_bodies = n_entities;
+    physics_system_params.n_circle_shapes = n_entities;
+    physics_system_params.n_segment_shapes = 0;
+    physics_system_params.n_polygon_shapes = 0;
+    mono::PhysicsSystem* physics_system = system_context.CreateSystem<mono::PhysicsSystem>(physics_system_params, transform_system);
+    mono::SpriteSystem* sprite_system = system_context.CreateSystem<mono::SpriteSystem>(n_entities, transform_system);
+    mono::TriggerSystem* trigger_system = system_context.CreateSystem<mono::TriggerSystem>(n_entities, physics_system, sprite_system);
+    game::DamageSystem* damage_system = system_context.CreateSystem<game::DamageSystem>(
+        n_entities, transform_system, sprite_system, physics_system, entity_system, trigger_system);
+    game::RegisterSharedComponents(entity_system);
+
+    const game::LogicCommandTargets targets = game::MakeLogicCommandTargets(&system_context);
+    EXPECT_EQ(entity_system, targets.entity_manager);
+    EXPECT_EQ(transform_system, targets.transform_system);
+    EXPECT_EQ(physics_system, targets.physics_system);
+    EXPECT_EQ(trigger_system, targets.trigger_system);
+    EXPECT_EQ(damage_system, targets.damage_system);
+
+    const uint32_t moved_id = entity_system->CreateEntity("moved", { }).id;
+    mono::BodyComponent body_params;
+    body_params.mass = 1.0f;
+    body_params.inertia = 1.0f;
+    body_params.type = mono::BodyType::DYNAMIC;
+    physics_system->AllocateBody(moved_id, body_params);
+
+    uint32_t releases = 0;
+    const uint32_t released_id = entity_system->CreateEntity("released", { }).id;
+    const mono::ReleaseCallback on_release = [&releases](uint32_t entity_id, mono::ReleasePhase phase) {
+        releases++;
+    };
+    entity_system->AddReleaseCallback(released_id, mono::ReleasePhase::PRE_RELEASE, on_release);
+
+    const uint32_t damaged_id = entity_system->CreateEntity("damaged", { }).id;
+    damage_system->CreateRecord(damaged_id)->full_health = 100;
+
+    uint32_t triggers = 0;
+    const mono::TriggerCallback on_trigger = [&triggers](uint32_t trigger_id) {
+        triggers++;
+    };
+    trigger_system->RegisterTriggerCallback(trigger_hash, on_trigger, mono::INVALID_ID);
+
+    std::vector<uint32_t> calls;
+
+    game::LogicCommandBuffer commands;
+    commands.SetBodyVelocity(moved_id, math::Vector(1.0f, 2.0f));
+    commands.SetBodyPosition(moved_id, math::Vector(3.0f, 4.0f));
+    commands.ReleaseEntity(released_id);
+    commands.ApplyDamage(damaged_id, 0, 0, game::DamageDetails(10, false, true, false));
+    commands.EmitTrigger(trigger_hash);
+    commands.SpawnEntity(spawned_entity_file, math::Vector(5.0f, 6.0f));
+    commands.Call(RecordCall, &calls, 7);
+    EXPECT_EQ(7u, commands.Size());
+
+    // Part of the commands first, the rest continues from there.
+    commands.ApplyUntil(targets, 2);
+    EXPECT_EQ(7u, commands.Size());
+    EXPECT_TRUE(calls.empty());
+
+    mono::IBody* moved_body = physics_system->GetBody(moved_id);
+    EXPECT_EQ(1.0f, moved_body->GetVelocity().x);
+    EXPECT_EQ(2.0f, moved_body->GetVelocity().y);
+    EXPECT_EQ(3.0f, moved_body->GetPosition().x);
+    EXPECT_EQ(4.0f, moved_body->GetPosition().y);
+
+    commands.Apply(targets);
+    EXPECT_EQ(0u, commands.Size());
+
+    mono::UpdateContext update_context;
+    update_context.delta_s = 1.0f / 60.0f;
+    update_context.timestamp = 16;
+    update_context.paused = false;
+
+    mono::IGameSystem& trigger_game_system = *trigger_system;
+    trigger_game_system.Update(update_context);
+    entity_system->Sync();
+
+    EXPECT_EQ(1u, releases);
+    EXPECT_EQ(90, damage_system->GetDamageRecord(damaged_id)->health);
+    EXPECT_EQ(1u, triggers);
+    EXPECT_EQ(std::vector<uint32_t>{ 7 }, calls);
+
+    uint32_t spawned = 0;
+    for(uint32_t entity_id = 0; entity_id < n_entities; ++entity_id)
+    {
+        const math::Vector position = math::GetPosition(transform_system->GetTransform(entity_id));
+        if(position.x == 5.0f && position.y == 6.0f)
+            spawned++;
+    }
+    EXPECT_EQ(1u, spawned);
+
+    system_context.DestroySystems();
+    std::remove(spawned_entity_file);
+}
+
+TEST(LogicCommandBuffer, CommandsWithoutTargetsAreDropped)
+{
+    std::vector<uint32_t> calls;
+
+    game::LogicCommandBuffer commands;
+    commands.SetBodyVelocity(1, math::Vector(1.0f, 2.0f));
+    commands.SetBodyPosition(1, math::Vector(3.0f, 4.0f));
+    commands.ReleaseEntity(2);
+    commands.ApplyDamage(3, 0, 0, game::DamageDetails(10, false, true, false));
+    commands.EmitTrigger(0x1234u);
+    commands.SpawnEntity(spawned_entity_file, math::Vector(5.0f, 6.0f));
+    commands.Call(RecordCall, &calls, 7);
+
+    // No systems at all, only the call has nothing to look up.
+    commands.Apply(game::MakeLogicCommandTargets(nullptr));
+    EXPECT_EQ(0u, commands.Size());
+    EXPECT_EQ(std::vector<uint32_t>{ 7 }, calls);
+}
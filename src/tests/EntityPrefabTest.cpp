@@ -0,0 +1,162 @@
+
+#include "gtest/gtest.h"
+
+#include "Entity/EntityPrefabSystem.h"
+#include "Entity/Component.h"
+#include "Entity/ComponentFunctions.h"
+#include "EntitySystem/EntitySystem.h"
+#include "EntitySystem/Serialize.h"
+#include "SystemContext.h"
+#include "TransformSystem/TransformSystem.h"
+
+#include "nlohmann/json.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    nlohmann::json MakeEntityJson(const char* name)
+    {
+        const uint32_t component_hashes[] = {
+            NAME_FOLDER_COMPONENT, TRANSFORM_COMPONENT, SPRITE_COMPONENT, PHYSICS_COMPONENT, CIRCLE_SHAPE_COMPONENT
+        };
+
+        nlohmann::json json_components;
+        for(uint32_t hash : component_hashes)
+        {
+            nlohmann::json component_properties;
+            for(const Attribute& property : component::DefaultComponentFromHash(hash).properties)
+                component_properties.push_back(property);
+
+            nlohmann::json json_component;
+            json_component["hash"] = hash;
+            json_component["name"] = component::ComponentNameFromHash(hash);
+            json_component["properties"] = component_properties;
+            json_components.push_back(json_component);
+        }
+
+        nlohmann::json json_entity;
+        json_entity["uuid_hash"] = 0;
+        json_entity["name"] = name;
+        json_entity["entity_properties"] = 0;
+        json_entity["components"] = json_components;
+        return json_entity;
+    }
+
+    std::vector<byte> MakeFileData(const std::vector<nlohmann::json>& json_entities)
+    {
+        nlohmann::json json;
+        json["entities"] = json_entities;
+        json["metadata"] = nlohmann::json::object();
+
+        const std::string serialized = json.dump(4);
+        return std::vector<byte>(serialized.begin(), serialized.end());
+    }
+}
+
+TEST(EntityPrefab, ParseResolvesComponents)
+{
+    game::EntityPrefab prefab;
+    ASSERT_TRUE(game::ParseEntityPrefab(MakeFileData({ MakeEntityJson("bullet") }), prefab));
+
+    EXPECT_EQ("bullet", prefab.name);
+    EXPECT_FALSE(prefab.is_collection);
+    ASSERT_EQ(5u, prefab.components.size());
+    EXPECT_EQ(TRANSFORM_COMPONENT, prefab.components[1].hash);
+    EXPECT_EQ(component::DefaultComponentFromHash(PHYSICS_COMPONENT).properties.size(), prefab.components[3].properties.size());
+
+    ASSERT_TRUE(game::ParseEntityPrefab(MakeFileData({ MakeEntityJson("first"), MakeEntityJson("second") }), prefab));
+    EXPECT_TRUE(prefab.is_collection);
+}
+
+TEST(EntityPrefab, ParseRejectsBrokenFile)
+{
+    const std::string truncated = "{ \"entities\": [ { \"name\": ";
+    const std::string wrong_type = "{ \"entities\": 7 }";
+
+    game::EntityPrefab prefab;
+    EXPECT_FALSE(game::ParseEntityPrefab(std::vector<byte>(truncated.begin(), truncated.end()), prefab));
+    EXPECT_FALSE(game::ParseEntityPrefab(std::vector<byte>(wrong_type.begin(), wrong_type.end()), prefab));
+    EXPECT_FALSE(game::ParseEntityPrefab(std::vector<byte>(), prefab));
+}
+
+TEST(EntityPrefabBenchmark, SpawnThroughput)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t n_entities = 500;
+    constexpr uint32_t n_rounds = 20;
+    constexpr const char* entity_file = "prefab_test.entity";
+
+    {
+        nlohmann::json json_components;
+        for(uint32_t hash : { TRANSFORM_COMPONENT, TAG_COMPONENT })
+        {
+            nlohmann::json component_properties;
+            for(const Attribute& property : component::DefaultComponentFromHash(hash).properties)
+                component_properties.push_back(property);
+
+            json_components.push_back({ { "hash", hash }, { "name", component::ComponentNameFromHash(hash) }, { "properties", component_properties } });
+        }
+
+        nlohmann::json json_entity;
+        json_entity["uuid_hash"] = 0;
+        json_entity["name"] = "bullet";
+        json_entity["entity_properties"] = 0;
+        json_entity["components"] = json_components;
+
+        const std::vector<byte> file_data = MakeFileData({ json_entity });
+        FILE* file = std::fopen(entity_file, "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(file_data.data(), 1, file_data.size(), file);
+        std::fclose(file);
+    }
+
+    mono::SystemContext system_context;
+    mono::EntitySystem* entity_system = system_context.CreateSystem<mono::EntitySystem>(
+        n_entities, &system_context, component::ComponentNameFromHash, AttributeNameFromHash);
+    system_context.CreateSystem<mono::TransformSystem>(n_entities);
+    game::RegisterSharedComponents(entity_system);
+
+    game::EntityPrefabSystem prefab_system(entity_system);
+    prefab_system.Preload(entity_file);
+
+    // Fills the entity system and releases everything, a wave of bullets or enemies at a time.
+    const auto run_spawns = [&](const auto& spawn_entity) {
+        std::vector<uint32_t> spawned_ids;
+        spawned_ids.reserve(n_entities);
+
+        const auto start = Clock::now();
+        for(uint32_t round = 0; round < n_rounds; ++round)
+        {
+            for(uint32_t index = 0; index < n_entities; ++index)
+                spawned_ids.push_back(spawn_entity().id);
+
+            for(uint32_t entity_id : spawned_ids)
+                entity_system->ReleaseEntity(entity_id);
+
+            spawned_ids.clear();
+            entity_system->Sync();
+        }
+        const std::chrono::duration<double> seconds = Clock::now() - start;
+        return (n_rounds * n_entities) / seconds.count();
+    };
+
+    const double file_spawns_per_second = run_spawns([&]() { return entity_system->SpawnEntity(entity_file); });
+    const double prefab_spawns_per_second = run_spawns([&]() { return prefab_system.SpawnEntity(entity_file); });
+
+    const game::PrefabStats& stats = prefab_system.GetStats();
+    EXPECT_EQ(1u, stats.prefabs);
+    EXPECT_EQ(1u, stats.cache_misses);
+    EXPECT_EQ(n_rounds * n_entities, stats.spawns);
+    EXPECT_GT(prefab_spawns_per_second, file_spawns_per_second);
+
+    system_context.DestroySystems();
+    std::remove(entity_file);
+
+    std::printf(
+        "Entity spawns/sec through the entity manager: %.0f, from the prefab: %.0f\n",
+        file_spawns_per_second, prefab_spawns_per_second);
+}
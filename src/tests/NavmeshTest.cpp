@@ -1,13 +1,150 @@
 
 #include "Navigation/NavMesh.h"
 #include "Navigation/NavmeshFactory.h"
+#include "Navigation/NavmeshHierarchy.h"
+#include "Navigation/NavmeshCache.h"
+#include "Navigation/FlowField.h"
+#include "Math/MathFunctions.h"
+#include "Util/Algorithm.h"
 #include "Util/Random.h"
 
 #include "gtest/gtest.h"
 
-#include <numeric>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
 
-class Navmesh : public testing::Test 
+namespace
+{
+    // The previous linear scan implementation, kept around as reference for the nodes/sec comparison.
+    game::NavigationResult ReferenceAStar(const game::NavmeshContext& context, int start_index, int end_index)
+    {
+        game::NavigationResult result;
+        result.nodes_evaluated = 0;
+        result.result = game::AStarResult::FAILED;
+
+        if(start_index == -1 || end_index == -1)
+            return result;
+
+        if(start_index == end_index)
+        {
+            result.result = game::AStarResult::SUCCESS;
+            return result;
+        }
+
+        const auto heuristics = [&context](int from, int to) {
+            return math::DistanceBetweenSquared(context.points[from], context.points[to]);
+        };
+
+        std::unordered_map<int, int> came_from;
+        std::vector<int> closed_set;
+        std::vector<int> open_set;
+
+        std::vector<float> g_score(context.nodes.size(), math::INF);
+        std::vector<float> f_score(context.nodes.size(), math::INF);
+
+        g_score[start_index] = 0;
+        f_score[start_index] = heuristics(start_index, end_index);
+
+        bool found_goal = false;
+        open_set.push_back(start_index);
+
+        while(!open_set.empty())
+        {
+            float lowest_f = math::INF;
+            int current_index = 0;
+            for(int open_node : open_set)
+            {
+                if(f_score[open_node] < lowest_f)
+                {
+                    lowest_f = f_score[open_node];
+                    current_index = open_node;
+                }
+            }
+
+            mono::remove(open_set, current_index);
+            closed_set.push_back(current_index);
+
+            if(current_index == end_index)
+            {
+                found_goal = true;
+                break;
+            }
+
+            for(int neighbour_index : context.nodes[current_index].neighbours_index)
+            {
+                if(neighbour_index == -1 || mono::contains(closed_set, neighbour_index))
+                    continue;
+
+                if(!mono::contains(open_set, neighbour_index))
+                    open_set.push_back(neighbour_index);
+
+                const float tentative_g_score = g_score[current_index] + heuristics(current_index, neighbour_index);
+                if(tentative_g_score >= g_score[neighbour_index])
+                    continue;
+
+                came_from[neighbour_index] = current_index;
+                g_score[neighbour_index] = tentative_g_score;
+                f_score[neighbour_index] = tentative_g_score + heuristics(neighbour_index, end_index);
+            }
+        }
+
+        if(found_goal)
+        {
+            result.result = game::AStarResult::SUCCESS;
+            result.nodes_evaluated = closed_set.size();
+        }
+
+        return result;
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    void BenchmarkFindClosestIndex(const char* name, const game::NavmeshContext& context, const math::Vector& min, const math::Vector& max)
+    {
+        // Same navmesh without the grid falls back to the linear scan.
+        game::NavmeshContext linear_context;
+        linear_context.points = context.points;
+
+        constexpr int n_queries = 1000;
+
+        std::vector<math::Vector> queries;
+        queries.reserve(n_queries);
+
+        // Include some points outside of the navmesh bounds as well.
+        const math::Vector margin = (max - min) * 0.1f;
+        for(int index = 0; index < n_queries; ++index)
+        {
+            queries.emplace_back(
+                mono::Random(min.x - margin.x, max.x + margin.x),
+                mono::Random(min.y - margin.y, max.y + margin.y));
+        }
+
+        std::vector<int> linear_result;
+        linear_result.reserve(n_queries);
+
+        const auto linear_start = Clock::now();
+        for(const math::Vector& query : queries)
+            linear_result.push_back(game::FindClosestIndex(linear_context, query));
+        const std::chrono::duration<double> linear_seconds = Clock::now() - linear_start;
+
+        std::vector<int> grid_result;
+        grid_result.reserve(n_queries);
+
+        const auto grid_start = Clock::now();
+        for(const math::Vector& query : queries)
+            grid_result.push_back(game::FindClosestIndex(context, query));
+        const std::chrono::duration<double> grid_seconds = Clock::now() - grid_start;
+
+        EXPECT_EQ(linear_result, grid_result);
+
+        std::printf(
+            "%s (%zu points) FindClosestIndex queries/sec linear: %.0f, grid: %.0f\n",
+            name, context.points.size(), n_queries / linear_seconds.count(), n_queries / grid_seconds.count());
+    }
+}
+
+class Navmesh : public testing::Test
 {
 protected:
     virtual void SetUp()
@@ -23,8 +160,16 @@ protected:
 
         m_context.points = game::GenerateMeshPoints(m_min_navmesh, m_max_navmesh, density);
         m_context.nodes = game::GenerateMeshNodes(m_context.points, density * 1.5f, connection_filter);
+        m_context.grid = game::GenerateMeshGrid(m_context.points, density);
     }
-    
+
+    math::Vector RandomPosition() const
+    {
+        return math::Vector(
+            mono::Random(m_min_navmesh.x, m_max_navmesh.x),
+            mono::Random(m_min_navmesh.y, m_max_navmesh.y));
+    }
+
     game::NavmeshContext m_context;
     math::Vector m_min_navmesh;
     math::Vector m_max_navmesh;
@@ -32,27 +177,332 @@ protected:
 
 TEST_F(Navmesh, AStar)
 {
-    std::vector<int> nodes_evaluated;
-    nodes_evaluated.reserve(1000);
+    constexpr int n_searches = 1000;
+
+    std::vector<std::pair<int, int>> searches;
+    searches.reserve(n_searches);
 
-    for(int index = 0; index < 1000; ++index)
+    for(int index = 0; index < n_searches; ++index)
     {
-        const math::Vector start_position = {
-            mono::Random(m_min_navmesh.x, m_max_navmesh.x),
-            mono::Random(m_min_navmesh.y, m_max_navmesh.y)
-        };
+        const int start_index = game::FindClosestIndex(m_context, RandomPosition());
+        const int end_index = game::FindClosestIndex(m_context, RandomPosition());
+        searches.emplace_back(start_index, end_index);
+    }
 
-        const math::Vector end_position = {
-            mono::Random(m_min_navmesh.x, m_max_navmesh.x),
-            mono::Random(m_min_navmesh.y, m_max_navmesh.y)
-        };
+    int reference_nodes = 0;
+    const auto reference_start = Clock::now();
 
-        const game::NavigationResult& nav_result = game::AStar(m_context, start_position, end_position);
+    for(const auto& [start_index, end_index] : searches)
+    {
+        const game::NavigationResult& nav_result = ReferenceAStar(m_context, start_index, end_index);
+        reference_nodes += nav_result.nodes_evaluated;
+    }
+
+    const std::chrono::duration<double> reference_seconds = Clock::now() - reference_start;
+
+    int total_nodes = 0;
+    const auto start = Clock::now();
+
+    for(const auto& [start_index, end_index] : searches)
+    {
+        const game::NavigationResult& nav_result = game::AStar(m_context, start_index, end_index);
         EXPECT_TRUE(nav_result.result == game::AStarResult::SUCCESS);
+        total_nodes += nav_result.nodes_evaluated;
+    }
+
+    const std::chrono::duration<double> seconds = Clock::now() - start;
+
+    std::printf("Average number of nodes evaluated: %u\n", total_nodes / n_searches);
+    std::printf("Nodes/sec before: %.0f, after: %.0f\n", reference_nodes / reference_seconds.count(), total_nodes / seconds.count());
+}
+
+TEST_F(Navmesh, AStarReusesScratchBuffers)
+{
+    for(int index = 0; index < 200; ++index)
+    {
+        const math::Vector start_position = RandomPosition();
+        const math::Vector end_position = RandomPosition();
+
+        const game::NavigationResult& nav_result = game::AStar(m_context, start_position, end_position);
+        ASSERT_TRUE(nav_result.result == game::AStarResult::SUCCESS);
+
+        const int start_index = game::FindClosestIndex(m_context, start_position);
+        const int end_index = game::FindClosestIndex(m_context, end_position);
+        if(start_index == end_index)
+            continue;
+
+        ASSERT_FALSE(nav_result.path_indices.empty());
+        EXPECT_EQ(start_index, nav_result.path_indices.front());
+        EXPECT_EQ(end_index, nav_result.path_indices.back());
+
+        // Reuse the scratch buffers with a second search in between, the result should be the same.
+        game::AStar(m_context, end_index, start_index);
+        const game::NavigationResult& repeated_result = game::AStar(m_context, start_index, end_index);
+        EXPECT_EQ(nav_result.path_indices, repeated_result.path_indices);
+    }
+}
+
+TEST_F(Navmesh, FindClosestIndexGrid)
+{
+    BenchmarkFindClosestIndex("70x50", m_context, m_min_navmesh, m_max_navmesh);
+}
+
+TEST(NavmeshBenchmark, LargeSyntheticMesh)
+{
+    const auto connection_filter = [](const math::Vector& first, const math::Vector& second) -> bool {
+        return false;
+    };
+
+    const math::Vector min_navmesh(-250.0f, -250.0f);
+    const math::Vector max_navmesh(250.0f, 250.0f);
+
+    constexpr float density = 1.0f;
+
+    game::NavmeshContext context;
+    context.points = game::GenerateMeshPoints(min_navmesh, max_navmesh, density);
+
+    const auto nodes_start = Clock::now();
+    context.nodes = game::GenerateMeshNodes(context.points, density * 1.5f, connection_filter);
+    const std::chrono::duration<double> nodes_seconds = Clock::now() - nodes_start;
+
+    const auto grid_start = Clock::now();
+    context.grid = game::GenerateMeshGrid(context.points, density);
+    const std::chrono::duration<double> grid_seconds = Clock::now() - grid_start;
+
+    ASSERT_EQ(context.points.size(), context.nodes.size());
+
+    // Interior nodes should be fully connected to the surrounding 8 points.
+    const int interior_index = game::FindClosestIndex(context, math::Vector(0.0f, 0.0f));
+    ASSERT_NE(-1, interior_index);
+    for(int neighbour_index : context.nodes[interior_index].neighbours_index)
+        EXPECT_NE(-1, neighbour_index);
+
+    std::printf("500x500 (%zu points) GenerateMeshNodes: %.1f ms, GenerateMeshGrid: %.1f ms\n",
+        context.points.size(), nodes_seconds.count() * 1000.0, grid_seconds.count() * 1000.0);
+
+    BenchmarkFindClosestIndex("500x500", context, min_navmesh, max_navmesh);
+}
+
+TEST(NavmeshHierarchy, CompareWithFlatSearch)
+{
+    const math::Vector min_navmesh(-100.0f, -100.0f);
+    const math::Vector max_navmesh(100.0f, 100.0f);
+
+    constexpr float density = 1.0f;
+
+    // Walls across the map with a single opening each, so paths across the map need to go around.
+    const auto is_wall = [](const math::Vector& point) {
+        const bool wall_1 = (point.x == -50.0f && point.y > -80.0f);
+        const bool wall_2 = (point.x == 0.0f && point.y < 80.0f);
+        const bool wall_3 = (point.x == 50.0f && point.y > -80.0f);
+        return wall_1 || wall_2 || wall_3;
+    };
+
+    const auto connection_filter = [](const math::Vector& first, const math::Vector& second) -> bool {
+        return false;
+    };
+
+    game::NavmeshContext context;
+    context.points = game::GenerateMeshPoints(min_navmesh, max_navmesh, density);
+    mono::remove_if(context.points, is_wall);
+    context.nodes = game::GenerateMeshNodes(context.points, density * 1.5f, connection_filter);
+    context.grid = game::GenerateMeshGrid(context.points, density);
+
+    const game::NavmeshHierarchy hierarchy = game::GenerateNavmeshHierarchy(context, density * 16.0f);
+    ASSERT_FALSE(hierarchy.abstract_nodes.empty());
 
-        nodes_evaluated.push_back(nav_result.nodes_evaluated);
+    const auto path_length = [&context](const std::vector<int>& path) {
+        float length = 0.0f;
+        for(size_t index = 1; index < path.size(); ++index)
+            length += math::DistanceBetween(context.points[path[index - 1]], context.points[path[index]]);
+        return length;
+    };
+
+    int flat_nodes = 0;
+    int hierarchical_nodes = 0;
+    float flat_length = 0.0f;
+    float hierarchical_length = 0.0f;
+    int n_paths = 0;
+
+    for(int index = 0; index < 100; ++index)
+    {
+        const math::Vector start_position(mono::Random(-100.0f, -60.0f), mono::Random(-100.0f, 100.0f));
+        const math::Vector end_position(mono::Random(60.0f, 100.0f), mono::Random(-100.0f, 100.0f));
+
+        const int start_index = game::FindClosestIndex(context, start_position);
+        const int end_index = game::FindClosestIndex(context, end_position);
+        ASSERT_FALSE(game::IsShortPath(hierarchy, start_index, end_index));
+
+        const game::NavigationResult& flat_result = game::AStar(context, start_index, end_index);
+        const game::NavigationResult& hierarchical_result = game::HierarchicalAStar(context, hierarchy, start_index, end_index);
+
+        ASSERT_TRUE(flat_result.result == game::AStarResult::SUCCESS);
+        ASSERT_TRUE(hierarchical_result.result == game::AStarResult::SUCCESS);
+
+        // The refined path should be connected all the way.
+        EXPECT_EQ(start_index, hierarchical_result.path_indices.front());
+        EXPECT_EQ(end_index, hierarchical_result.path_indices.back());
+
+        for(size_t path_index = 1; path_index < hierarchical_result.path_indices.size(); ++path_index)
+        {
+            const game::NavmeshNode& node = context.nodes[hierarchical_result.path_indices[path_index - 1]];
+            const int next_index = hierarchical_result.path_indices[path_index];
+            EXPECT_NE(std::end(node.neighbours_index), std::find(std::begin(node.neighbours_index), std::end(node.neighbours_index), next_index));
+        }
+
+        flat_nodes += flat_result.nodes_evaluated;
+        hierarchical_nodes += hierarchical_result.nodes_evaluated;
+        flat_length += path_length(flat_result.path_indices);
+        hierarchical_length += path_length(hierarchical_result.path_indices);
+        n_paths++;
     }
 
-    const int total_nodes = std::accumulate(nodes_evaluated.begin(), nodes_evaluated.end(), 0);
-    std::printf("Average number of nodes evaluated: %u\n", total_nodes / nodes_evaluated.size());
+    const float length_ratio = hierarchical_length / flat_length;
+    EXPECT_LT(hierarchical_nodes, flat_nodes);
+    EXPECT_LT(length_ratio, 1.1f);
+
+    std::printf(
+        "Abstract nodes: %zu, average nodes evaluated flat: %d, hierarchical: %d, path length ratio: %.3f\n",
+        hierarchy.abstract_nodes.size(), flat_nodes / n_paths, hierarchical_nodes / n_paths, length_ratio);
+}
+
+TEST_F(Navmesh, ConnectionFilterTestedOncePerPair)
+{
+    // Blocks every connection crossing x = 0.5
+    int n_filter_calls = 0;
+    const auto connection_filter = [&n_filter_calls](const math::Vector& first, const math::Vector& second) -> bool {
+        n_filter_calls++;
+        return (first.x < 0.5f) != (second.x < 0.5f);
+    };
+
+    const std::vector<game::NavmeshNode>& nodes = game::GenerateMeshNodes(m_context.points, 1.5f, connection_filter);
+    ASSERT_EQ(m_context.nodes.size(), nodes.size());
+
+    int n_connections = 0;
+    for(uint32_t index = 0; index < nodes.size(); ++index)
+    {
+        for(int neighbour_index : nodes[index].neighbours_index)
+        {
+            if(neighbour_index == -1)
+                continue;
+
+            n_connections++;
+            EXPECT_EQ(m_context.points[index].x < 0.5f, m_context.points[neighbour_index].x < 0.5f);
+        }
+    }
+
+    // Each connection is stored on both nodes but only tested once.
+    EXPECT_LT(n_filter_calls, n_connections);
+}
+
+TEST_F(Navmesh, ReadWriteCache)
+{
+    const char* cache_file = "navmesh_test_cache.navmesh";
+    constexpr uint64_t cache_key = 0xC0FFEE;
+
+    ASSERT_TRUE(game::WriteNavmeshCache(cache_file, cache_key, m_context));
+
+    game::NavmeshContext stale_context;
+    EXPECT_FALSE(game::ReadNavmeshCache(cache_file, cache_key + 1, stale_context));
+    EXPECT_TRUE(stale_context.points.empty());
+
+    game::NavmeshContext loaded_context;
+    ASSERT_TRUE(game::ReadNavmeshCache(cache_file, cache_key, loaded_context));
+    ASSERT_EQ(m_context.points.size(), loaded_context.points.size());
+    ASSERT_EQ(m_context.nodes.size(), loaded_context.nodes.size());
+
+    for(uint32_t index = 0; index < m_context.nodes.size(); ++index)
+    {
+        EXPECT_EQ(m_context.points[index], loaded_context.points[index]);
+        EXPECT_EQ(m_context.nodes[index].data_index, loaded_context.nodes[index].data_index);
+        EXPECT_TRUE(std::equal(
+            std::begin(m_context.nodes[index].neighbours_index),
+            std::end(m_context.nodes[index].neighbours_index),
+            std::begin(loaded_context.nodes[index].neighbours_index)));
+    }
+
+    std::remove(cache_file);
+}
+
+TEST_F(Navmesh, FlowFieldFollowsToTarget)
+{
+    const math::Vector target_position(20.0f, 10.0f);
+    const game::FlowField flow_field = game::CalculateFlowField(m_context, target_position);
+
+    ASSERT_EQ(m_context.nodes.size(), flow_field.distances.size());
+    ASSERT_NE(-1, flow_field.target_index);
+    EXPECT_EQ(0.0f, flow_field.distances[flow_field.target_index]);
+
+    // Following next_index from any node ends up at the target with decreasing distance.
+    for(int index = 0; index < 100; ++index)
+    {
+        int node_index = game::FindClosestIndex(m_context, RandomPosition());
+        int steps = 0;
+
+        while(flow_field.next_index[node_index] != -1)
+        {
+            const int next_index = flow_field.next_index[node_index];
+            ASSERT_LT(flow_field.distances[next_index], flow_field.distances[node_index]);
+            node_index = next_index;
+            ASSERT_LT(++steps, int(m_context.nodes.size()));
+        }
+
+        EXPECT_EQ(flow_field.target_index, node_index);
+    }
+
+    // The time sliced builder gives the same field.
+    game::FlowFieldBuilder builder;
+    game::BeginFlowField(m_context, target_position, builder);
+
+    int n_slices = 1;
+    while(!game::ContinueFlowField(m_context, builder, 100))
+        n_slices++;
+
+    EXPECT_GT(n_slices, 1);
+    EXPECT_EQ(flow_field.distances, builder.field.distances);
+
+    math::Vector direction;
+    float distance;
+    const bool sampled = game::SampleFlowField(m_context, flow_field, math::Vector(-20.0f, 10.0f), direction, distance);
+    ASSERT_TRUE(sampled);
+    EXPECT_NEAR(1.0f, direction.x, 1e-3f);
+    EXPECT_NEAR(40.0f, distance, 1e-3f);
+}
+
+TEST_F(Navmesh, FlowFieldScalingBenchmark)
+{
+    const math::Vector target_position = RandomPosition();
+
+    const auto field_start = Clock::now();
+    const game::FlowField flow_field = game::CalculateFlowField(m_context, target_position);
+    const std::chrono::duration<double, std::milli> field_ms = Clock::now() - field_start;
+
+    std::printf("FlowField (%zu nodes) calculated in %.2f ms\n", m_context.nodes.size(), field_ms.count());
+
+    for(int n_agents : { 10, 100, 1000 })
+    {
+        std::vector<math::Vector> agent_positions;
+        for(int index = 0; index < n_agents; ++index)
+            agent_positions.push_back(RandomPosition());
+
+        const auto astar_start = Clock::now();
+        for(const math::Vector& agent_position : agent_positions)
+        {
+            const game::NavigationResult& nav_result = game::AStar(m_context, agent_position, target_position);
+            EXPECT_TRUE(nav_result.result == game::AStarResult::SUCCESS);
+        }
+        const std::chrono::duration<double, std::milli> astar_ms = Clock::now() - astar_start;
+
+        const auto sample_start = Clock::now();
+        for(const math::Vector& agent_position : agent_positions)
+        {
+            math::Vector direction;
+            float distance;
+            EXPECT_TRUE(game::SampleFlowField(m_context, flow_field, agent_position, direction, distance));
+        }
+        const std::chrono::duration<double, std::milli> sample_ms = Clock::now() - sample_start;
+
+        std::printf("%4d agents, AStar all agents: %.3f ms (%.4f ms per agent), FlowField sample all agents: %.3f ms (+ %.2f ms field)\n",
+            n_agents, astar_ms.count(), astar_ms.count() / n_agents, sample_ms.count(), field_ms.count());
+    }
 }
@@ -0,0 +1,232 @@
+
+#include "gtest/gtest.h"
+
+#include "Network/NetworkMessage.h"
+#include "Network/NetworkSerialize.h"
+#include "Network/ReliableChannel.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    struct LoopbackConfig
+    {
+        float packet_loss = 0.0f;   // 0 - 1
+        uint32_t latency_ms = 0;
+        uint32_t jitter_ms = 0;     // Random extra latency, reorders packets
+    };
+
+    // Simulated one way link, packets are delivered when their time has come.
+    class LoopbackLink
+    {
+    public:
+
+        LoopbackLink(const LoopbackConfig& config, uint32_t seed)
+            : m_config(config)
+            , m_random(seed)
+        { }
+
+        void Send(const std::vector<byte>& packet, uint32_t timestamp)
+        {
+            std::uniform_real_distribution<float> loss_distribution(0.0f, 1.0f);
+            if(loss_distribution(m_random) < m_config.packet_loss)
+                return;
+
+            std::uniform_int_distribution<uint32_t> jitter_distribution(0, m_config.jitter_ms);
+            const uint32_t deliver_timestamp = timestamp + m_config.latency_ms + jitter_distribution(m_random);
+            m_in_flight.push_back({ deliver_timestamp, packet });
+        }
+
+        void Receive(uint32_t timestamp, std::vector<std::vector<byte>>& out_packets)
+        {
+            const auto sort_on_time = [](const InFlightPacket& first, const InFlightPacket& second) {
+                return first.deliver_timestamp < second.deliver_timestamp;
+            };
+            std::stable_sort(m_in_flight.begin(), m_in_flight.end(), sort_on_time);
+
+            auto it = m_in_flight.begin();
+            for(; it != m_in_flight.end() && it->deliver_timestamp <= timestamp; ++it)
+                out_packets.push_back(it->packet);
+
+            m_in_flight.erase(m_in_flight.begin(), it);
+        }
+
+    private:
+
+        struct InFlightPacket
+        {
+            uint32_t deliver_timestamp;
+            std::vector<byte> packet;
+        };
+
+        LoopbackConfig m_config;
+        std::mt19937 m_random;
+        std::vector<InFlightPacket> m_in_flight;
+    };
+
+    struct ReceivedMessages
+    {
+        std::vector<uint16_t> spawned_entities;
+        uint32_t n_transforms = 0;
+    };
+
+    void DecodeMessages(const std::vector<byte>& message_buffer, ReceivedMessages& received_messages)
+    {
+        for(const byte_view& message : game::UnpackMessageBuffer(message_buffer))
+        {
+            const uint32_t message_type = game::PeekMessageType(message);
+            if(message_type == game::SpawnMessage::message_type)
+            {
+                game::SpawnMessage spawn_message;
+                ASSERT_TRUE(game::DeserializeMessage(message, spawn_message));
+                received_messages.spawned_entities.push_back(spawn_message.entity_id);
+            }
+            else if(message_type == game::TransformMessage::message_type)
+            {
+                received_messages.n_transforms++;
+            }
+        }
+    }
+
+    // Server sends a spawn and a transform every frame, the client only acknowledges.
+    void RunLoopback(
+        const LoopbackConfig& config,
+        uint16_t n_frames,
+        game::ReliableChannel& server_channel,
+        game::ReliableChannel& client_channel,
+        ReceivedMessages& received_messages)
+    {
+        constexpr uint32_t frame_time = 16;
+        constexpr uint32_t settle_frames = 200;
+
+        LoopbackLink server_to_client(config, 1);
+        LoopbackLink client_to_server(config, 2);
+
+        std::vector<std::vector<byte>> packets;
+        std::vector<byte> message_buffer;
+
+        for(uint32_t frame = 0; frame < n_frames + settle_frames; ++frame)
+        {
+            const uint32_t timestamp = 1000 + frame * frame_time;
+
+            packets.clear();
+            if(frame < n_frames)
+            {
+                game::SpawnMessage spawn_message = { };
+                spawn_message.entity_id = frame;
+                spawn_message.spawn = true;
+
+                game::TransformMessage transform_message = { };
+                transform_message.entity_id = frame;
+
+                std::vector<byte> frame_buffer;
+                game::PrepareMessageBuffer(frame_buffer);
+                game::SerializeMessageToBuffer(spawn_message, frame_buffer);
+                game::SerializeMessageToBuffer(transform_message, frame_buffer);
+
+                server_channel.SendPacket(frame_buffer, timestamp, packets);
+            }
+            server_channel.Update(timestamp, packets);
+            for(const std::vector<byte>& packet : packets)
+                server_to_client.Send(packet, timestamp);
+
+            packets.clear();
+            server_to_client.Receive(timestamp, packets);
+            for(const std::vector<byte>& packet : packets)
+            {
+                if(client_channel.ReceivePacket(packet, message_buffer))
+                    DecodeMessages(message_buffer, received_messages);
+            }
+
+            packets.clear();
+            client_channel.Update(timestamp, packets);
+            for(const std::vector<byte>& packet : packets)
+                client_to_server.Send(packet, timestamp);
+
+            packets.clear();
+            client_to_server.Receive(timestamp, packets);
+            for(const std::vector<byte>& packet : packets)
+                server_channel.ReceivePacket(packet, message_buffer);
+        }
+    }
+
+    std::vector<uint16_t> MakeExpectedSpawns(uint16_t n_frames)
+    {
+        std::vector<uint16_t> expected_spawns(n_frames);
+        for(uint16_t index = 0; index < n_frames; ++index)
+            expected_spawns[index] = index;
+        return expected_spawns;
+    }
+}
+
+TEST(ReliableChannel, Reliability)
+{
+    EXPECT_EQ(game::MessageReliability::RELIABLE_ORDERED, game::GetMessageReliability(game::SpawnMessage::message_type));
+    EXPECT_EQ(game::MessageReliability::RELIABLE_ORDERED, game::GetMessageReliability(game::DamageInfoMessage::message_type));
+    EXPECT_EQ(game::MessageReliability::UNRELIABLE, game::GetMessageReliability(game::TransformMessage::message_type));
+    EXPECT_EQ(game::MessageReliability::UNRELIABLE, game::GetMessageReliability(game::SnapshotMessage::message_type));
+}
+
+TEST(ReliableChannel, PerfectLinkDoesNotResend)
+{
+    LoopbackConfig config;
+    config.latency_ms = 30;
+
+    game::ReliableChannel server_channel(100, 16);
+    game::ReliableChannel client_channel(100, 16);
+    ReceivedMessages received_messages;
+    RunLoopback(config, 300, server_channel, client_channel, received_messages);
+
+    EXPECT_EQ(MakeExpectedSpawns(300), received_messages.spawned_entities);
+    EXPECT_EQ(300u, received_messages.n_transforms);
+    EXPECT_EQ(0u, server_channel.GetStats().messages_resent);
+    EXPECT_EQ(0u, server_channel.UnackedMessages());
+}
+
+TEST(ReliableChannel, LossAndReorderKeepsReliableMessagesInOrder)
+{
+    LoopbackConfig config;
+    config.packet_loss = 0.3f;
+    config.latency_ms = 50;
+    config.jitter_ms = 60;
+
+    game::ReliableChannel server_channel;
+    game::ReliableChannel client_channel;
+    ReceivedMessages received_messages;
+    RunLoopback(config, 1000, server_channel, client_channel, received_messages);
+
+    // Every spawn exactly once and in order, transforms are lost with the packets.
+    EXPECT_EQ(MakeExpectedSpawns(1000), received_messages.spawned_entities);
+    EXPECT_LT(received_messages.n_transforms, 1000u);
+    EXPECT_GT(received_messages.n_transforms, 500u);
+    EXPECT_GT(server_channel.GetStats().messages_resent, 0u);
+    EXPECT_EQ(0u, server_channel.UnackedMessages());
+}
+
+TEST(ReliableChannel, DuplicatePacketsAreDropped)
+{
+    game::ReliableChannel server_channel;
+    game::ReliableChannel client_channel;
+
+    game::SpawnMessage spawn_message = { };
+    spawn_message.entity_id = 7;
+
+    std::vector<std::vector<byte>> packets;
+    server_channel.SendPacket(game::SerializeMessage(spawn_message), 0, packets);
+    ASSERT_EQ(1u, packets.size());
+
+    std::vector<byte> message_buffer;
+    ReceivedMessages received_messages;
+
+    EXPECT_TRUE(client_channel.ReceivePacket(packets.front(), message_buffer));
+    DecodeMessages(message_buffer, received_messages);
+    EXPECT_FALSE(client_channel.ReceivePacket(packets.front(), message_buffer));
+
+    // Unsequenced packets are not for the channel
+    EXPECT_FALSE(client_channel.ReceivePacket(game::SerializeMessage(spawn_message), message_buffer));
+
+    ASSERT_EQ(1u, received_messages.spawned_entities.size());
+    EXPECT_EQ(7u, received_messages.spawned_entities.front());
+    EXPECT_EQ(1u, client_channel.GetStats().packets_dropped);
+}
@@ -0,0 +1,158 @@
+
+#include "gtest/gtest.h"
+
+#include "Network/ReplicationTables.h"
+#include "Network/Snapshot.h"
+#include "Util/Random.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr uint32_t StressEntities = 5000;
+
+    game::EntitySnapshotState MakeEntityState(uint16_t entity_id, const math::Vector& position)
+    {
+        game::EntitySnapshotState state;
+        state.entity_id = entity_id;
+        state.position_x = game::QuantizePosition(position.x);
+        state.position_y = game::QuantizePosition(position.y);
+        state.filename_hash = 0xC0FFEE + entity_id;
+        state.hex_color = 0xFFFFFFFF;
+        return state;
+    }
+
+    // Sends snapshots with an immediate ack until the client has everything, returns the number of snapshots.
+    int ReplicateUntilInSync(
+        const std::vector<game::EntitySnapshotState>& current,
+        const std::vector<float>& priorities,
+        game::Snapshot& server_snapshot,
+        game::Snapshot& client_snapshot,
+        int max_snapshots)
+    {
+        game::SnapshotMessage message;
+        game::Snapshot sent_snapshot;
+        game::Snapshot read_snapshot;
+        std::vector<game::EntitySnapshotChange> changes;
+
+        for(int n_snapshots = 0; n_snapshots < max_snapshots; ++n_snapshots)
+        {
+            message.snapshot_id = server_snapshot.snapshot_id + 1;
+            game::WriteSnapshotDelta(server_snapshot, current, priorities, {}, message, sent_snapshot);
+            sent_snapshot.snapshot_id = message.snapshot_id;
+
+            if(!game::ReadSnapshotDelta(message, client_snapshot, read_snapshot, changes))
+                return -1;
+
+            std::swap(server_snapshot, sent_snapshot);
+            std::swap(client_snapshot, read_snapshot);
+
+            if(message.n_entities == 0)
+                return n_snapshots;
+        }
+
+        return max_snapshots;
+    }
+}
+
+TEST(ReplicationTables, OnlyChangedEntitiesAreMarked)
+{
+    game::TransformTable current;
+    current.Resize(StressEntities);
+
+    game::ClientReplicationState client_1;
+    game::ClientReplicationState client_2;
+    client_1.Resize(StressEntities);
+    client_2.Resize(StressEntities);
+
+    for(uint32_t entity_id = 0; entity_id < StressEntities; ++entity_id)
+    {
+        current.position_x[entity_id] = float(entity_id);
+        current.rotation[entity_id] = 0.5f;
+    }
+
+    game::MarkChangedTransforms(current, client_1.transforms, 0.001f, client_1.transform_changed);
+    for(uint32_t entity_id = 1; entity_id < StressEntities; ++entity_id)
+    {
+        ASSERT_NE(0, client_1.transform_changed[entity_id]);
+        client_1.transforms.Copy(entity_id, current);
+    }
+
+    // Client 1 is up to date except for entity 0 and the move of 4999 is within the tolerance,
+    // client 2 has not been sent anything.
+    current.position_y[4999] += 0.0001f;
+    game::MarkChangedTransforms(current, client_1.transforms, 0.001f, client_1.transform_changed);
+    game::MarkChangedTransforms(current, client_2.transforms, 0.001f, client_2.transform_changed);
+
+    uint32_t n_changed_1 = 0;
+    uint32_t n_changed_2 = 0;
+    for(uint32_t entity_id = 0; entity_id < StressEntities; ++entity_id)
+    {
+        n_changed_1 += client_1.transform_changed[entity_id];
+        n_changed_2 += client_2.transform_changed[entity_id];
+    }
+
+    EXPECT_EQ(1u, n_changed_1);
+    EXPECT_EQ(StressEntities, n_changed_2);
+
+    std::vector<int> current_health(StressEntities, 100);
+    current_health[4321] = 50;
+    game::MarkChangedValues(current_health, client_1.health, client_1.health_changed);
+    client_1.health = current_health;
+    current_health[4321] = 40;
+    game::MarkChangedValues(current_health, client_1.health, client_1.health_changed);
+
+    EXPECT_EQ(1, client_1.health_changed[4321]);
+    EXPECT_EQ(0, client_1.health_changed[4320]);
+}
+
+TEST(ReplicationStress, SnapshotReplicates5000Entities)
+{
+    std::vector<game::EntitySnapshotState> current;
+    std::vector<float> priorities;
+    for(uint32_t entity_id = 0; entity_id < StressEntities; ++entity_id)
+    {
+        const math::Vector position(mono::Random(-500.0f, 500.0f), mono::Random(-500.0f, 500.0f));
+        current.push_back(MakeEntityState(entity_id, position));
+        priorities.push_back(mono::Random(1.0f, 10.0f));
+    }
+
+    game::Snapshot server_snapshot;
+    game::Snapshot client_snapshot;
+
+    const auto start_time = std::chrono::high_resolution_clock::now();
+
+    // Everything spawns at once, the client catches up over a number of snapshots.
+    const int n_full_snapshots = ReplicateUntilInSync(current, priorities, server_snapshot, client_snapshot, 1000);
+    ASSERT_GT(n_full_snapshots, 0);
+    ASSERT_LT(n_full_snapshots, 1000);
+    ASSERT_EQ(StressEntities, client_snapshot.entities.size());
+
+    for(uint32_t index = 0; index < StressEntities; ++index)
+    {
+        ASSERT_EQ(current[index].entity_id, client_snapshot.entities[index].entity_id);
+        ASSERT_EQ(0u, game::SnapshotFieldsChanged(current[index], client_snapshot.entities[index]));
+    }
+
+    // Then everything moves a bit.
+    for(game::EntitySnapshotState& state : current)
+    {
+        state.position_x += game::QuantizePosition(mono::Random(-0.5f, 0.5f));
+        state.position_y += game::QuantizePosition(mono::Random(-0.5f, 0.5f));
+    }
+
+    const int n_delta_snapshots = ReplicateUntilInSync(current, priorities, server_snapshot, client_snapshot, 1000);
+    ASSERT_GT(n_delta_snapshots, 0);
+    ASSERT_LT(n_delta_snapshots, n_full_snapshots);
+
+    for(uint32_t index = 0; index < StressEntities; ++index)
+        ASSERT_EQ(0u, game::SnapshotFieldsChanged(current[index], client_snapshot.entities[index]));
+
+    const auto end_time = std::chrono::high_resolution_clock::now();
+    const auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    std::printf(
+        "Replicated %u entities, snapshots to sync spawned: %d, moved: %d, %lld ms\n",
+        StressEntities, n_full_snapshots, n_delta_snapshots, (long long)duration_ms);
+}
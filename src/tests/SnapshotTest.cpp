@@ -0,0 +1,371 @@
+
+#include "gtest/gtest.h"
+
+#include "Network/BitStream.h"
+#include "Network/NetworkMessage.h"
+#include "Network/NetworkSerialize.h"
+#include "Network/Snapshot.h"
+#include "Network/SpatialHash.h"
+#include "Util/Random.h"
+
+#include <cstdio>
+
+namespace
+{
+    game::EntitySnapshotState MakeEntityState(uint16_t entity_id, const math::Vector& position, float rotation)
+    {
+        game::EntitySnapshotState state;
+        state.entity_id = entity_id;
+        state.position_x = game::QuantizePosition(position.x);
+        state.position_y = game::QuantizePosition(position.y);
+        state.rotation = game::QuantizeRotation(rotation);
+        state.filename_hash = 0xC0FFEE + entity_id;
+        state.hex_color = 0xFFFFFFFF;
+        state.animation_id = 1;
+        state.shadow_size = game::QuantizeShadow(0.5f);
+        return state;
+    }
+
+    bool IsSameState(const game::EntitySnapshotState& first, const game::EntitySnapshotState& second)
+    {
+        return
+            first.entity_id == second.entity_id &&
+            game::SnapshotFieldsChanged(first, second) == 0;
+    }
+
+    bool IsSameSnapshot(const game::Snapshot& first, const game::Snapshot& second)
+    {
+        if(first.entities.size() != second.entities.size())
+            return false;
+
+        for(size_t index = 0; index < first.entities.size(); ++index)
+        {
+            if(!IsSameState(first.entities[index], second.entities[index]))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Serializes and unpacks the message the same way as it is sent over the network.
+    bool SendReceive(const game::SnapshotMessage& message, game::SnapshotMessage& out_message)
+    {
+        std::vector<byte> message_buffer;
+        game::PrepareMessageBuffer(message_buffer);
+        if(!game::SerializeMessageToBuffer(message, message_buffer))
+            return false;
+
+        const std::vector<byte_view> message_views = game::UnpackMessageBuffer(message_buffer);
+        return message_views.size() == 1 && game::DeserializeMessage(message_views.front(), out_message);
+    }
+}
+
+TEST(Snapshot, BitStreamRoundTrip)
+{
+    byte buffer[12];
+    game::BitWriter writer(buffer, sizeof(buffer));
+
+    writer.Write(5, 3);
+    writer.WriteBool(true);
+    writer.Write(0xDEADBEEF, 32);
+    writer.Write(game::ZigZagEncode(-77), 9);
+
+    // Rewound data is discarded
+    const uint32_t bit_position = writer.BitPosition();
+    writer.Write(0x7FFF, 15);
+    writer.Rewind(bit_position);
+    writer.Write(0x3, 2);
+
+    writer.Write(0xFFFFFFFF, 32);
+    writer.Write(0xFFFFFFFF, 32);
+    EXPECT_TRUE(writer.Overflow());
+
+    game::BitReader reader(buffer, writer.BytesWritten());
+    EXPECT_EQ(5u, reader.Read(3));
+    EXPECT_TRUE(reader.ReadBool());
+    EXPECT_EQ(0xDEADBEEF, reader.Read(32));
+    EXPECT_EQ(-77, game::ZigZagDecode(reader.Read(9)));
+    EXPECT_EQ(0x3u, reader.Read(2));
+    EXPECT_FALSE(reader.Overflow());
+}
+
+TEST(Snapshot, QuantizeRoundTrip)
+{
+    for(float value : { 0.0f, 1.0f, -1.0f, 123.456f, -987.654f })
+        EXPECT_NEAR(value, game::DequantizePosition(game::QuantizePosition(value)), 1.0f / 256.0f);
+
+    for(float rotation : { 0.0f, 1.0f, -1.0f, 3.1f, -3.1f })
+        EXPECT_NEAR(rotation, game::DequantizeRotation(game::QuantizeRotation(rotation)), 0.001f);
+}
+
+TEST(Snapshot, FullAndDeltaRoundTrip)
+{
+    game::Snapshot server_baseline;
+    std::vector<game::EntitySnapshotState> current;
+    for(uint16_t entity_id = 0; entity_id < 30; ++entity_id)
+        current.push_back(MakeEntityState(entity_id * 3, math::Vector(entity_id, -entity_id), entity_id * 0.1f));
+
+    // Full snapshot, no baseline
+    game::SnapshotMessage message;
+    message.timestamp = 1000;
+    message.snapshot_id = 1;
+
+    game::Snapshot sent_snapshot;
+    game::WriteSnapshotDelta(server_baseline, current, {}, {}, message, sent_snapshot);
+    sent_snapshot.snapshot_id = message.snapshot_id;
+
+    EXPECT_EQ(game::NoSnapshot, message.baseline_id);
+    EXPECT_EQ(30u, message.n_entities);
+
+    game::SnapshotMessage received_message;
+    ASSERT_TRUE(SendReceive(message, received_message));
+
+    game::Snapshot client_snapshot;
+    std::vector<game::EntitySnapshotChange> changes;
+    ASSERT_TRUE(game::ReadSnapshotDelta(received_message, game::Snapshot(), client_snapshot, changes));
+    EXPECT_TRUE(IsSameSnapshot(sent_snapshot, client_snapshot));
+    EXPECT_EQ(30u, changes.size());
+
+    const game::TransformMessage transform_message = game::MakeTransformMessage(client_snapshot.entities[10], message.timestamp);
+    EXPECT_EQ(30u, transform_message.entity_id);
+    EXPECT_NEAR(10.0f, transform_message.position.x, 0.01f);
+    EXPECT_NEAR(-10.0f, transform_message.position.y, 0.01f);
+    EXPECT_NEAR(1.0f, transform_message.rotation, 0.01f);
+
+    // Delta against the acknowledged snapshot: move two entities, remove one, add one and respawn one.
+    current[5].position_x += game::QuantizePosition(0.5f);
+    current[7].rotation = game::QuantizeRotation(2.0f);
+    current.erase(current.begin() + 20);
+    current.push_back(MakeEntityState(500, math::Vector(1.0f, 2.0f), 0.0f));
+    current[25].hex_color = 0xFF0000FF;
+
+    const std::vector<uint32_t> spawned_entities = { current[27].entity_id };
+
+    game::SnapshotMessage delta_message;
+    delta_message.timestamp = 1100;
+    delta_message.snapshot_id = 2;
+
+    game::Snapshot sent_delta_snapshot;
+    game::WriteSnapshotDelta(sent_snapshot, current, {}, spawned_entities, delta_message, sent_delta_snapshot);
+    sent_delta_snapshot.snapshot_id = delta_message.snapshot_id;
+
+    EXPECT_EQ(1u, delta_message.baseline_id);
+    EXPECT_EQ(6u, delta_message.n_entities);
+    EXPECT_LT(delta_message.data_size, message.data_size / 4);
+
+    ASSERT_TRUE(SendReceive(delta_message, received_message));
+
+    game::Snapshot client_delta_snapshot;
+    ASSERT_TRUE(game::ReadSnapshotDelta(received_message, client_snapshot, client_delta_snapshot, changes));
+    EXPECT_TRUE(IsSameSnapshot(sent_delta_snapshot, client_delta_snapshot));
+    EXPECT_EQ(current.size(), client_delta_snapshot.entities.size());
+    EXPECT_EQ(5u, changes.size());
+
+    // Wrong baseline
+    EXPECT_FALSE(game::ReadSnapshotDelta(received_message, game::Snapshot(), client_delta_snapshot, changes));
+}
+
+TEST(Snapshot, EntitiesThatDoNotFitAreSentLater)
+{
+    std::vector<game::EntitySnapshotState> current;
+    for(uint16_t entity_id = 0; entity_id < 2000; ++entity_id)
+    {
+        const math::Vector position(mono::Random(-100.0f, 100.0f), mono::Random(-100.0f, 100.0f));
+        current.push_back(MakeEntityState(entity_id, position, mono::Random(-3.0f, 3.0f)));
+    }
+
+    // Acknowledge every snapshot, the client should converge on the server state.
+    game::Snapshot client_snapshot;
+    game::Snapshot server_snapshot;
+    int n_snapshots = 0;
+
+    while(!IsSameSnapshot(client_snapshot, game::Snapshot{ 0, current }) && n_snapshots < 100)
+    {
+        n_snapshots++;
+
+        game::SnapshotMessage message;
+        message.timestamp = n_snapshots;
+        message.snapshot_id = n_snapshots;
+
+        game::Snapshot sent_snapshot;
+        game::WriteSnapshotDelta(server_snapshot, current, {}, {}, message, sent_snapshot);
+        sent_snapshot.snapshot_id = message.snapshot_id;
+        EXPECT_LE(message.data_size, game::SnapshotMessageDataSize);
+
+        game::SnapshotMessage received_message;
+        ASSERT_TRUE(SendReceive(message, received_message));
+
+        game::Snapshot read_snapshot;
+        std::vector<game::EntitySnapshotChange> changes;
+        ASSERT_TRUE(game::ReadSnapshotDelta(received_message, client_snapshot, read_snapshot, changes));
+        ASSERT_TRUE(IsSameSnapshot(sent_snapshot, read_snapshot));
+
+        server_snapshot = sent_snapshot;
+        client_snapshot = read_snapshot;
+    }
+
+    EXPECT_GT(n_snapshots, 1);
+    EXPECT_LT(n_snapshots, 100);
+}
+
+TEST(Snapshot, ReceiverSkipsOldSnapshots)
+{
+    std::vector<game::EntitySnapshotState> current = { MakeEntityState(1, math::Vector(1.0f, 1.0f), 0.0f) };
+
+    game::Snapshot snapshot_1;
+    game::SnapshotMessage message_1;
+    message_1.timestamp = 1;
+    message_1.snapshot_id = 1;
+    game::WriteSnapshotDelta(game::Snapshot(), current, {}, {}, message_1, snapshot_1);
+
+    current[0].position_x += 10;
+
+    game::Snapshot snapshot_2;
+    game::SnapshotMessage message_2;
+    message_2.timestamp = 2;
+    message_2.snapshot_id = 2;
+    game::WriteSnapshotDelta(game::Snapshot(), current, {}, {}, message_2, snapshot_2);
+
+    game::SnapshotReceiver receiver;
+    std::vector<game::TransformMessage> transforms;
+    std::vector<game::SpriteMessage> sprites;
+
+    EXPECT_TRUE(receiver.ReadSnapshot(message_2, transforms, sprites));
+    EXPECT_EQ(1u, transforms.size());
+    EXPECT_EQ(1u, sprites.size());
+
+    transforms.clear();
+    sprites.clear();
+
+    EXPECT_TRUE(receiver.ReadSnapshot(message_1, transforms, sprites));
+    EXPECT_TRUE(transforms.empty());
+    EXPECT_TRUE(sprites.empty());
+
+    EXPECT_TRUE(game::IsNewerSnapshot(1, 0xFFFF));
+    EXPECT_FALSE(game::IsNewerSnapshot(0xFFFF, 1));
+}
+
+TEST(Snapshot, HighPriorityEntitiesGoFirst)
+{
+    // More new entities than fit in one message, the ones with high priority should be in it.
+    constexpr uint16_t n_entities = 200;
+
+    std::vector<game::EntitySnapshotState> current;
+    std::vector<float> priorities;
+    for(uint16_t entity_id = 0; entity_id < n_entities; ++entity_id)
+    {
+        const math::Vector position(mono::Random(-200.0f, 200.0f), mono::Random(-200.0f, 200.0f));
+        current.push_back(MakeEntityState(entity_id, position, 0.0f));
+        priorities.push_back((entity_id % 2) ? 10.0f : 1.0f);
+    }
+
+    game::SnapshotMessage message;
+    message.snapshot_id = 1;
+    game::Snapshot sent_snapshot;
+    game::WriteSnapshotDelta(game::Snapshot(), current, priorities, {}, message, sent_snapshot);
+
+    ASSERT_GT(message.n_entities, 0u);
+    ASSERT_LT(message.n_entities, n_entities);
+
+    // All odd ids first, and the message is filled up with the even ones.
+    uint32_t n_odd = 0;
+    for(const game::EntitySnapshotState& state : sent_snapshot.entities)
+        n_odd += (state.entity_id % 2);
+
+    EXPECT_EQ(std::min<uint32_t>(message.n_entities, n_entities / 2), n_odd);
+    EXPECT_GT(message.data_size, game::SnapshotMessageDataSize - 32);
+
+    game::Snapshot client_snapshot;
+    std::vector<game::EntitySnapshotChange> changes;
+    ASSERT_TRUE(game::ReadSnapshotDelta(message, game::Snapshot(), client_snapshot, changes));
+    EXPECT_TRUE(IsSameSnapshot(sent_snapshot, client_snapshot));
+}
+
+TEST(SpatialHash, QueryMatchesBruteForce)
+{
+    std::vector<math::Quad> bounds;
+    for(int index = 0; index < 2000; ++index)
+    {
+        const math::Vector position(mono::Random(-500.0f, 500.0f), mono::Random(-500.0f, 500.0f));
+        const float size = (index % 100 == 0) ? 200.0f : mono::Random(0.1f, 4.0f);
+        bounds.push_back({ position, position + math::Vector(size, size) });
+    }
+
+    game::SpatialHash spatial_hash;
+    spatial_hash.Build(bounds, 10.0f);
+
+    std::vector<uint32_t> found_indices;
+    std::vector<uint32_t> expected_indices;
+
+    for(int query = 0; query < 50; ++query)
+    {
+        const math::Vector position(mono::Random(-550.0f, 450.0f), mono::Random(-550.0f, 450.0f));
+        const float size = (query == 0) ? 2000.0f : mono::Random(1.0f, 60.0f);
+        const math::Quad area = { position, position + math::Vector(size, size) };
+
+        expected_indices.clear();
+        for(uint32_t index = 0; index < bounds.size(); ++index)
+        {
+            const math::Quad& quad = bounds[index];
+            const bool overlaps =
+                area.bottom_left.x <= quad.top_right.x && area.top_right.x >= quad.bottom_left.x &&
+                area.bottom_left.y <= quad.top_right.y && area.top_right.y >= quad.bottom_left.y;
+            if(overlaps)
+                expected_indices.push_back(index);
+        }
+
+        found_indices.clear();
+        spatial_hash.Query(area, found_indices);
+        EXPECT_EQ(expected_indices, found_indices);
+    }
+}
+
+TEST(SnapshotBenchmark, BytesPerEntity)
+{
+    constexpr uint16_t n_entities = 1000;
+
+    std::vector<game::EntitySnapshotState> current;
+    for(uint16_t entity_id = 0; entity_id < n_entities; ++entity_id)
+    {
+        const math::Vector position(mono::Random(-200.0f, 200.0f), mono::Random(-200.0f, 200.0f));
+        current.push_back(MakeEntityState(entity_id, position, mono::Random(-3.0f, 3.0f)));
+    }
+
+    game::SnapshotMessage message;
+    message.snapshot_id = 1;
+
+    game::Snapshot sent_full_snapshot;
+    game::WriteSnapshotDelta(game::Snapshot(), current, {}, {}, message, sent_full_snapshot);
+
+    const float full_bytes_per_entity = float(message.data_size) / float(message.n_entities);
+
+    // The client has acknowledged all entities
+    const game::Snapshot baseline = { 1, current };
+
+    // Everything moves a little, like a frame of enemies chasing the player.
+    for(game::EntitySnapshotState& state : current)
+    {
+        state.position_x += game::QuantizePosition(mono::Random(-0.5f, 0.5f));
+        state.position_y += game::QuantizePosition(mono::Random(-0.5f, 0.5f));
+        state.rotation += 10;
+    }
+
+    game::Snapshot sent_snapshot;
+    game::SnapshotMessage delta_message;
+    delta_message.snapshot_id = 2;
+    game::WriteSnapshotDelta(baseline, current, {}, {}, delta_message, sent_snapshot);
+
+    const float delta_bytes_per_entity = float(delta_message.data_size) / float(delta_message.n_entities);
+
+    // The transform message as sent before, with the length and type prefix.
+    constexpr size_t message_prefix_size = sizeof(uint32_t) * 2;
+    constexpr size_t transform_bytes = message_prefix_size + sizeof(game::TransformMessage);
+    constexpr size_t transform_and_sprite_bytes = transform_bytes + message_prefix_size + sizeof(game::SpriteMessage);
+
+    std::printf("Bytes per entity, TransformMessage: %zu, TransformMessage + SpriteMessage: %zu\n", transform_bytes, transform_and_sprite_bytes);
+    std::printf("Bytes per entity, full snapshot: %.2f, delta snapshot: %.2f\n", full_bytes_per_entity, delta_bytes_per_entity);
+    std::printf("Moving entities per message, TransformMessage: %zu, delta snapshot: %u\n",
+        game::NetworkMessageBufferSize / transform_bytes, delta_message.n_entities);
+
+    EXPECT_LT(delta_bytes_per_entity * 3.0f, float(transform_bytes));
+}
@@ -0,0 +1,157 @@
+
+#include "gtest/gtest.h"
+
+#include "StateMachine.h"
+#include "AllocationCounter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    struct TestContext
+    {
+        uint32_t timestamp;
+    };
+
+    enum class States
+    {
+        IDLE,
+        TRACKING,
+        ATTACKING
+    };
+
+    // Cycles through the states like an enemy controller, a few updates in each.
+    class DynamicController
+    {
+    public:
+
+        DynamicController()
+        {
+            const MyStateMachine::StateTable state_table = {
+                MyStateMachine::MakeState(States::IDLE, &DynamicController::ToIdle, &DynamicController::Idle, this),
+                MyStateMachine::MakeState(States::TRACKING, &DynamicController::ToTracking, &DynamicController::Tracking, this),
+                MyStateMachine::MakeState(
+                    States::ATTACKING, &DynamicController::ToAttacking, &DynamicController::Attacking, &DynamicController::ExitAttacking, this),
+            };
+            m_states.SetStateTableAndState(state_table, States::IDLE);
+        }
+
+        void Update(const TestContext& context)
+        {
+            m_states.UpdateState(context);
+        }
+
+        uint32_t m_counter = 0;
+
+    private:
+
+        void ToIdle() { m_counter += 1; }
+        void Idle(const TestContext& context) { if(context.timestamp % 3 == 0) m_states.TransitionTo(States::TRACKING); }
+        void ToTracking() { m_counter += 10; }
+        void Tracking(const TestContext& context) { if(context.timestamp % 5 == 0) m_states.TransitionTo(States::ATTACKING); }
+        void ToAttacking() { m_counter += 100; }
+        void Attacking(const TestContext& context) { if(context.timestamp % 7 == 0) m_states.TransitionTo(States::IDLE); }
+        void ExitAttacking() { m_counter += 1000; }
+
+        using MyStateMachine = StateMachine<States, const TestContext&>;
+        MyStateMachine m_states;
+    };
+
+    class StaticController
+    {
+    public:
+
+        StaticController()
+        {
+            static constexpr MyStateMachine::State state_table[] = {
+                MyStateMachine::MakeState(States::IDLE, &StaticController::ToIdle, &StaticController::Idle),
+                MyStateMachine::MakeState(States::TRACKING, &StaticController::ToTracking, &StaticController::Tracking),
+                MyStateMachine::MakeState(
+                    States::ATTACKING, &StaticController::ToAttacking, &StaticController::Attacking, &StaticController::ExitAttacking),
+            };
+            static_assert(MyStateMachine::IsStateTableOrdered(state_table));
+            m_states.SetStateTableAndState(this, state_table, States::IDLE);
+        }
+
+        void Update(const TestContext& context)
+        {
+            m_states.UpdateState(context);
+        }
+
+        uint32_t m_counter = 0;
+
+    private:
+
+        void ToIdle() { m_counter += 1; }
+        void Idle(const TestContext& context) { if(context.timestamp % 3 == 0) m_states.TransitionTo(States::TRACKING); }
+        void ToTracking() { m_counter += 10; }
+        void Tracking(const TestContext& context) { if(context.timestamp % 5 == 0) m_states.TransitionTo(States::ATTACKING); }
+        void ToAttacking() { m_counter += 100; }
+        void Attacking(const TestContext& context) { if(context.timestamp % 7 == 0) m_states.TransitionTo(States::IDLE); }
+        void ExitAttacking() { m_counter += 1000; }
+
+        using MyStateMachine = StaticStateMachine<StaticController, States, const TestContext&>;
+        MyStateMachine m_states;
+    };
+
+    template <typename T>
+    double UpdateControllers(std::vector<T>& controllers, uint32_t n_frames)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+
+        const auto start = Clock::now();
+        for(uint32_t frame = 1; frame <= n_frames; ++frame)
+        {
+            const TestContext context = { frame };
+            for(T& controller : controllers)
+                controller.Update(context);
+        }
+        const std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+        return duration.count();
+    }
+}
+
+TEST(StaticStateMachine, SameTransitionsAsStateMachine)
+{
+    DynamicController dynamic_controller;
+    StaticController static_controller;
+
+    for(uint32_t frame = 1; frame < 200; ++frame)
+    {
+        const TestContext context = { frame };
+        dynamic_controller.Update(context);
+        static_controller.Update(context);
+        ASSERT_EQ(dynamic_controller.m_counter, static_controller.m_counter);
+    }
+
+    EXPECT_GT(static_controller.m_counter, 1000u);
+}
+
+TEST(StaticStateMachineBenchmark, Update1000StateMachines)
+{
+    constexpr uint32_t n_controllers = 1000;
+    constexpr uint32_t n_frames = 1000;
+
+    const uint32_t dynamic_allocations_before = tests::HeapAllocations();
+    std::vector<DynamicController> dynamic_controllers(n_controllers);
+    const uint32_t dynamic_allocations = tests::HeapAllocations() - dynamic_allocations_before;
+
+    const uint32_t static_allocations_before = tests::HeapAllocations();
+    std::vector<StaticController> static_controllers(n_controllers);
+    const uint32_t static_allocations = tests::HeapAllocations() - static_allocations_before;
+
+    const double dynamic_ms = UpdateControllers(dynamic_controllers, n_frames);
+    const double static_ms = UpdateControllers(static_controllers, n_frames);
+
+    for(uint32_t index = 0; index < n_controllers; ++index)
+        ASSERT_EQ(dynamic_controllers[index].m_counter, static_controllers[index].m_counter);
+
+    // Only the vector of controllers itself.
+    EXPECT_EQ(1u, static_allocations);
+
+    std::printf(
+        "%u state machines over %u frames: StateMachine %.1f ms %u allocations, StaticStateMachine %.1f ms %u allocations\n",
+        n_controllers, n_frames, dynamic_ms, dynamic_allocations, static_ms, static_allocations);
+}
@@ -0,0 +1,137 @@
+
+#include "gtest/gtest.h"
+
+#include "Entity/TargetGrid.h"
+#include "Math/MathFunctions.h"
+#include "Util/Random.h"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace
+{
+    // Reference for TargetGrid::FindTarget, the highest priority with anything in range and the nearest of those.
+    uint32_t BruteForceFindTarget(const std::vector<game::TargetGridPoint>& points, const math::Vector& position, float max_distance)
+    {
+        uint32_t found_entity_id = uint32_t(-1);
+        int best_priority = std::numeric_limits<int>::min();
+        float best_distance_sq = max_distance * max_distance;
+
+        for(const game::TargetGridPoint& point : points)
+        {
+            const float distance_sq = math::DistanceBetweenSquared(point.position, position);
+            if(distance_sq >= max_distance * max_distance || point.priority < best_priority)
+                continue;
+
+            if(point.priority > best_priority || distance_sq < best_distance_sq)
+            {
+                found_entity_id = point.entity_id;
+                best_priority = point.priority;
+                best_distance_sq = distance_sq;
+            }
+        }
+
+        return found_entity_id;
+    }
+
+    uint32_t GridFindTarget(const game::TargetGrid& grid, const math::Vector& position, float max_distance)
+    {
+        game::TargetGridPoint found_point;
+        return grid.FindTarget(position, max_distance, found_point) ? found_point.entity_id : uint32_t(-1);
+    }
+
+    std::vector<game::TargetGridPoint> MakePoints(uint32_t first_id, int count, int priority, float world_size)
+    {
+        std::vector<game::TargetGridPoint> points;
+        for(int index = 0; index < count; ++index)
+        {
+            const math::Vector position(mono::Random(-world_size, world_size), mono::Random(-world_size, world_size));
+            points.push_back({ first_id + index, position, priority });
+        }
+        return points;
+    }
+}
+
+TEST(TargetGrid, FindTargetMatchesBruteForce)
+{
+    std::vector<game::TargetGridPoint> points = MakePoints(0, 300, 0, 100.0f);
+    const std::vector<game::TargetGridPoint> decoys = MakePoints(1000, 5, 2, 100.0f);
+    points.insert(points.end(), decoys.begin(), decoys.end());
+
+    game::TargetGrid grid(8.0f);
+    grid.Build(points);
+
+    const float distances[] = { 1.0f, 5.0f, 20.0f, 75.0f, math::INF };
+
+    for(int index = 0; index < 500; ++index)
+    {
+        // Some queries outside of the bounds as well.
+        const math::Vector position(mono::Random(-150.0f, 150.0f), mono::Random(-150.0f, 150.0f));
+        for(float max_distance : distances)
+            EXPECT_EQ(BruteForceFindTarget(points, position, max_distance), GridFindTarget(grid, position, max_distance));
+    }
+
+    grid.Build({ });
+    EXPECT_EQ(uint32_t(-1), GridFindTarget(grid, math::ZeroVec, math::INF));
+}
+
+TEST(TargetGridBenchmark, HordeEnemiesAndHomingBullets)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr int n_frames = 100;
+    constexpr float world_size = 100.0f;
+
+    // Two players and a few high priority decoys, a horde of enemies that look for them and
+    // player homing bullets that look for enemies.
+    std::vector<game::TargetGridPoint> player_targets = MakePoints(0, 2, 0, world_size);
+    const std::vector<game::TargetGridPoint> decoys = MakePoints(10, 3, 1, world_size);
+    player_targets.insert(player_targets.end(), decoys.begin(), decoys.end());
+
+    std::vector<game::TargetGridPoint> enemy_targets = MakePoints(100, 500, 0, world_size);
+    std::vector<math::Vector> bullets;
+    for(int index = 0; index < 200; ++index)
+        bullets.emplace_back(mono::Random(-world_size, world_size), mono::Random(-world_size, world_size));
+
+    game::TargetGrid player_grid(8.0f);
+    game::TargetGrid enemy_grid(8.0f);
+
+    std::vector<uint32_t> brute_force_result;
+    std::vector<uint32_t> grid_result;
+
+    std::chrono::duration<double> brute_force_seconds(0.0);
+    std::chrono::duration<double> grid_seconds(0.0);
+
+    for(int frame = 0; frame < n_frames; ++frame)
+    {
+        for(game::TargetGridPoint& enemy : enemy_targets)
+            enemy.position += math::Vector(mono::Random(-0.2f, 0.2f), mono::Random(-0.2f, 0.2f));
+
+        brute_force_result.clear();
+        grid_result.clear();
+
+        const auto brute_force_start = Clock::now();
+        for(const game::TargetGridPoint& enemy : enemy_targets)
+            brute_force_result.push_back(BruteForceFindTarget(player_targets, enemy.position, 20.0f));
+        for(const math::Vector& bullet : bullets)
+            brute_force_result.push_back(BruteForceFindTarget(enemy_targets, bullet, 2.0f));
+        brute_force_seconds += Clock::now() - brute_force_start;
+
+        // The grids are rebuilt every frame like in TargetSystem::Update.
+        const auto grid_start = Clock::now();
+        player_grid.Build(player_targets);
+        enemy_grid.Build(enemy_targets);
+        for(const game::TargetGridPoint& enemy : enemy_targets)
+            grid_result.push_back(GridFindTarget(player_grid, enemy.position, 20.0f));
+        for(const math::Vector& bullet : bullets)
+            grid_result.push_back(GridFindTarget(enemy_grid, bullet, 2.0f));
+        grid_seconds += Clock::now() - grid_start;
+
+        EXPECT_EQ(brute_force_result, grid_result);
+    }
+
+    std::printf(
+        "500 enemies, 200 bullets, ms/frame brute force: %.4f, grid (including rebuild): %.4f\n",
+        brute_force_seconds.count() * 1000.0 / n_frames, grid_seconds.count() * 1000.0 / n_frames);
+}
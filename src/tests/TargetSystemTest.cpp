@@ -0,0 +1,216 @@
+
+#include "gtest/gtest.h"
+
+#include "Entity/TargetSystem.h"
+#include "Entity/VisibilityPairTable.h"
+#include "DamageSystem/DamageSystem.h"
+#include "Physics/PhysicsSystem.h"
+#include "TransformSystem/TransformSystem.h"
+#include "Math/Matrix.h"
+#include "IUpdatable.h"
+#include "AllocationCounter.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    constexpr uint32_t NumEntities = 1000;
+    constexpr uint32_t NumPlayers = 2;
+    constexpr uint32_t NumEnemies = 500;
+    constexpr uint32_t NumBullets = 200;
+
+    mono::PhysicsSystemInitParams MakePhysicsParams()
+    {
+        mono::PhysicsSystemInitParams physics_system_params;
+        physics_system_params.n_bodies = NumEntities;
+        physics_system_params.n_circle_shapes = NumEntities;
+        physics_system_params.n_segment_shapes = 0;
+        physics_system_params.n_polygon_shapes = 0;
+        return physics_system_params;
+    }
+
+    class TargetSystemTest : public testing::Test
+    {
+    protected:
+
+        TargetSystemTest()
+            : transform_system(NumEntities)
+            , physics_system(MakePhysicsParams(), &transform_system)
+            , damage_system(NumEntities, &transform_system, nullptr, nullptr, nullptr, nullptr)
+            , target_system(NumEntities, &transform_system, &physics_system, &damage_system)
+        { }
+
+        void SetPosition(uint32_t entity_id, const math::Vector& position)
+        {
+            transform_system.SetTransform(entity_id, math::CreateMatrixWithPosition(position));
+        }
+
+        mono::TransformSystem transform_system;
+        mono::PhysicsSystem physics_system;
+        game::DamageSystem damage_system;
+        game::TargetSystem target_system;
+    };
+}
+
+TEST_F(TargetSystemTest, TargetTurnsInvalidWhenDisabledOrReleased)
+{
+    target_system.AllocateTarget(10);
+    target_system.SetTargetData(10, game::TargetFaction::Player, 0);
+    SetPosition(10, math::Vector(1.0f, 1.0f));
+
+    game::ITargetPtr target = target_system.AquireTarget(game::TargetFaction::Player, math::ZeroVec, 5.0f);
+    ASSERT_TRUE(target->IsValid());
+    EXPECT_EQ(10u, target->TargetId());
+
+    target_system.SetTargetEnabled(10, false);
+    EXPECT_FALSE(target->IsValid());
+    EXPECT_FALSE(target_system.AquireTarget(game::TargetFaction::Player, math::ZeroVec, 5.0f)->IsValid());
+
+    target_system.SetTargetEnabled(10, true);
+    target = target_system.AquireTarget(game::TargetFaction::Player, math::ZeroVec, 5.0f);
+    ASSERT_TRUE(target->IsValid());
+
+    target_system.ReleaseTarget(10);
+    EXPECT_FALSE(target->IsValid());
+    EXPECT_EQ(mono::INVALID_ID, target->TargetId());
+
+    // Same id allocated again does not bring old targets back.
+    target_system.AllocateTarget(10);
+    target_system.SetTargetData(10, game::TargetFaction::Player, 0);
+    EXPECT_FALSE(target->IsValid());
+    EXPECT_TRUE(target_system.AquireTarget(game::TargetFaction::Player, math::ZeroVec, 5.0f)->IsValid());
+}
+
+TEST(VisibilityPairTable, InsertFindAndRemove)
+{
+    constexpr uint32_t max_pairs = 100;
+    game::VisibilityPairTable table(max_pairs);
+
+    for(uint32_t index = 0; index < max_pairs; ++index)
+    {
+        game::VisibilityPair* pair = table.Insert(index, index % 3);
+        ASSERT_NE(nullptr, pair);
+        pair->query_timestamp = index;
+    }
+    EXPECT_EQ(max_pairs, table.Size());
+    EXPECT_EQ(nullptr, table.Insert(max_pairs, 0));
+    EXPECT_EQ(nullptr, table.Find(0, 1));
+
+    // Inserting an existing pair returns it.
+    EXPECT_EQ(table.Find(10, 1), table.Insert(10, 1));
+    EXPECT_EQ(max_pairs, table.Size());
+
+    table.RemoveIf([](const game::VisibilityPair& pair) { return (pair.query_timestamp % 2) == 0; });
+    EXPECT_EQ(max_pairs / 2, table.Size());
+
+    // Churn through the removed slots, more than the table holds, to force the rehash.
+    for(uint32_t round = 0; round < 10; ++round)
+    {
+        for(uint32_t index = 0; index < max_pairs / 2; ++index)
+            ASSERT_NE(nullptr, table.Insert(1000 + round, index));
+
+        table.RemoveIf([round](const game::VisibilityPair& pair) { return pair.observer_id == 1000 + round; });
+    }
+
+    for(uint32_t index = 0; index < max_pairs; ++index)
+    {
+        const game::VisibilityPair* pair = table.Find(index, index % 3);
+        if((index % 2) == 0)
+        {
+            EXPECT_EQ(nullptr, pair);
+        }
+        else
+        {
+            ASSERT_NE(nullptr, pair);
+            EXPECT_EQ(index, pair->query_timestamp);
+        }
+    }
+    EXPECT_EQ(max_pairs / 2, table.Size());
+}
+
+TEST_F(TargetSystemTest, HordeSoakDoesNotAllocate)
+{
+    target_system.SetGlobalTargetMode(game::EnemyTargetMode::Horde);
+
+    for(uint32_t index = 0; index < NumPlayers; ++index)
+    {
+        target_system.AllocateTarget(index);
+        target_system.SetTargetData(index, game::TargetFaction::Player, 0);
+    }
+
+    const uint32_t first_enemy = NumPlayers;
+    for(uint32_t index = 0; index < NumEnemies; ++index)
+    {
+        target_system.AllocateTarget(first_enemy + index);
+        target_system.SetTargetData(first_enemy + index, game::TargetFaction::Enemies, 0);
+    }
+
+    std::vector<game::ITargetPtr> enemy_targets(NumEnemies);
+    std::vector<game::ITargetPtr> bullet_targets(NumBullets);
+
+    mono::UpdateContext update_context;
+    update_context.delta_s = 1.0f / 60.0f;
+    update_context.timestamp = 0;
+    update_context.paused = false;
+
+    const auto run_frame = [&](uint32_t frame) {
+
+        // Everything moves in circles so the grid extents stay the same.
+        for(uint32_t entity_id = 0; entity_id < first_enemy + NumEnemies; ++entity_id)
+        {
+            const float angle = frame * 0.05f + entity_id;
+            const float radius = 10.0f + (entity_id % 90);
+            SetPosition(entity_id, math::Vector(std::cos(angle) * radius, std::sin(angle) * radius));
+        }
+
+        // Some enemies die and respawn, the targets are rebuilt in between.
+        const uint32_t toggled_enemy = first_enemy + (frame % NumEnemies);
+        target_system.SetTargetEnabled(toggled_enemy, (frame % 2) == 0);
+
+        update_context.timestamp = frame * 16;
+        target_system.Update(update_context);
+
+        for(uint32_t index = 0; index < NumEnemies; ++index)
+        {
+            const math::Vector& position = transform_system.GetWorldPosition(first_enemy + index);
+            enemy_targets[index] = target_system.AquireTarget(game::TargetFaction::Player, position, 20.0f);
+
+            // Line of sight like the enemy controllers check it, some every frame and some now and then.
+            if((index % 4) == 0)
+                target_system.SeesTarget(first_enemy + index, enemy_targets[index].get());
+            else if(((frame + index) % 30) == 0)
+                target_system.QueryVisibility(first_enemy + index, enemy_targets[index].get());
+        }
+
+        for(uint32_t index = 0; index < NumBullets; ++index)
+        {
+            const float angle = frame * 0.1f + index;
+            const math::Vector position(std::cos(angle) * 50.0f, std::sin(angle) * 50.0f);
+            if(!bullet_targets[index] || !bullet_targets[index]->IsValid())
+                bullet_targets[index] = target_system.AquireTarget(game::TargetFaction::Enemies, position, 2.0f);
+        }
+    };
+
+    // Let the scratch buffers reach their working size first.
+    for(uint32_t frame = 0; frame < 10; ++frame)
+        run_frame(frame);
+
+    constexpr uint32_t n_soak_frames = 600;
+    const uint32_t allocations_before = tests::HeapAllocations();
+
+    for(uint32_t frame = 10; frame < 10 + n_soak_frames; ++frame)
+        run_frame(frame);
+
+    const uint32_t allocations = tests::HeapAllocations() - allocations_before;
+    std::printf("Horde soak, %u frames, allocations per frame: %.2f\n", n_soak_frames, float(allocations) / n_soak_frames);
+
+    EXPECT_EQ(0u, allocations);
+
+    for(const game::ITargetPtr& target : enemy_targets)
+        EXPECT_TRUE(target->IsValid());
+
+    const game::VisibilityStats& stats = target_system.GetVisibilityStats();
+    EXPECT_GT(stats.active_pairs, 0u);
+    EXPECT_GT(stats.cache_hits, 0u);
+}
@@ -0,0 +1,254 @@
+
+#include "gtest/gtest.h"
+
+#include "Weapons/EffectiveWeaponConfig.h"
+#include "Weapons/Modifiers/DamageModifier.h"
+#include "Weapons/BulletWeapon/BulletWeapon.h"
+#include "Weapons/WeaponSystem.h"
+#include "Entity/Component.h"
+#include "Entity/ComponentFunctions.h"
+#include "Entity/GameComponentFuncs.h"
+#include "Entity/EntityLogicSystem.h"
+#include "Entity/EntityPrefabSystem.h"
+#include "CollisionConfiguration.h"
+#include "AllocationCounter.h"
+
+#include "SystemContext.h"
+#include "EntitySystem/EntitySystem.h"
+#include "EntitySystem/Serialize.h"
+#include "Physics/PhysicsSystem.h"
+#include "Rendering/Sprite/SpriteSystem.h"
+#include "TransformSystem/TransformSystem.h"
+#include "System/Hash.h"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    game::WeaponConfiguration MakeWeaponConfig()
+    {
+        game::WeaponConfiguration weapon_config = { };
+        weapon_config.name = "plasma_rifle_full_auto";
+        weapon_config.magazine_size = 40;
+        weapon_config.projectiles_per_fire = 3;
+        weapon_config.rounds_per_second = 20.0f;
+        weapon_config.fire_sound = "res/sound/weapons/plasma_rifle_fire.wav";
+        weapon_config.out_of_ammo_sound = "res/sound/weapons/out_of_ammo.wav";
+        weapon_config.reload_sound = "res/sound/weapons/plasma_rifle_reload.wav";
+        weapon_config.reload_finished_sound = "res/sound/weapons/plasma_rifle_reloaded.wav";
+        return weapon_config;
+    }
+
+    game::BulletConfiguration MakeBulletConfig()
+    {
+        game::BulletConfiguration bullet_config = { };
+        bullet_config.name = "plasma_rifle_bullet";
+        bullet_config.min_damage = 10;
+        bullet_config.max_damage = 20;
+        bullet_config.entity_file = "res/entities/plasma_bullet.entity";
+        bullet_config.impact_entity_file = "res/entities/plasma_impact.entity";
+        bullet_config.sound_file = "res/sound/weapons/plasma_bullet_loop.wav";
+        return bullet_config;
+    }
+}
+
+TEST(EffectiveWeaponConfig, RebuildsWhenModifiersChange)
+{
+    game::DamageModifier damage_modifier("damage", 5);
+    game::WeaponModifierList modifiers;
+
+    game::EffectiveWeaponConfig effective_config(MakeWeaponConfig(), MakeBulletConfig());
+    EXPECT_FALSE(effective_config.IsCurrent(0));
+
+    effective_config.Rebuild(0, modifiers);
+    EXPECT_TRUE(effective_config.IsCurrent(0));
+    EXPECT_EQ(10, effective_config.Bullet().min_damage);
+
+    modifiers.push_back(&damage_modifier);
+    EXPECT_FALSE(effective_config.IsCurrent(1));
+
+    effective_config.Rebuild(1, modifiers);
+    EXPECT_EQ(15, effective_config.Bullet().min_damage);
+    EXPECT_EQ(25, effective_config.Bullet().max_damage);
+}
+
+namespace
+{
+    constexpr const char* bullet_entity_file = "weapon_config_test_bullet.entity";
+
+    void WriteBulletEntityFile()
+    {
+        nlohmann::json json_components;
+        for(uint32_t hash : { TRANSFORM_COMPONENT, PHYSICS_COMPONENT, CIRCLE_SHAPE_COMPONENT })
+        {
+            nlohmann::json component_properties;
+            for(const Attribute& property : component::DefaultComponentFromHash(hash).properties)
+                component_properties.push_back(property);
+
+            json_components.push_back({ { "hash", hash }, { "name", component::ComponentNameFromHash(hash) }, { "properties", component_properties } });
+        }
+
+        nlohmann::json json_entity;
+        json_entity["uuid_hash"] = 0;
+        json_entity["name"] = "plasma_bullet";
+        json_entity["entity_properties"] = 0;
+        json_entity["components"] = json_components;
+
+        nlohmann::json json;
+        json["entities"] = { json_entity };
+        json["metadata"] = nlohmann::json::object();
+
+        const std::string serialized = json.dump(4);
+        FILE* file = std::fopen(bullet_entity_file, "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(serialized.data(), 1, serialized.size(), file);
+        std::fclose(file);
+    }
+
+    struct FireResult
+    {
+        uint32_t fire_allocations;
+        uint32_t bullets_expired;
+    };
+
+    // Fires a BulletWeapon n_shots times, the bullets expire and are released before the next shot. With
+    // change_modifiers the modifiers change before every shot, so every Fire copies the configuration and
+    // applies the modifiers, like it did on every shot before the configuration was cached.
+    FireResult FireBulletWeapon(uint32_t n_shots, bool change_modifiers)
+    {
+        constexpr uint32_t n_entities = 200;
+        constexpr uint32_t owner_id = 1;
+
+        mono::SystemContext system_context;
+        mono::EntitySystem* entity_system = system_context.CreateSystem<mono::EntitySystem>(
+            n_entities, &system_context, component::ComponentNameFromHash, AttributeNameFromHash);
+        mono::TransformSystem* transform_system = system_context.CreateSystem<mono::TransformSystem>(n_entities);
+
+        mono::PhysicsSystemInitParams physics_system_params;
+        physics_system_params.n_bodies = n_entities;
+        physics_system_params.n_circle_shapes = n_entities;
+        physics_system_params.n_segment_shapes = 0;
+        physics_system_params.n_polygon_shapes = 0;
+        mono::PhysicsSystem* physics_system = system_context.CreateSystem<mono::PhysicsSystem>(physics_system_params, transform_system);
+        mono::SpriteSystem* sprite_system = system_context.CreateSystem<mono::SpriteSystem>(n_entities, transform_system);
+
+        game::EntityPrefabSystem* prefab_system = system_context.CreateSystem<game::EntityPrefabSystem>(entity_system);
+        game::EntityLogicSystem* logic_system = system_context.CreateSystem<game::EntityLogicSystem>(n_entities, &system_context, nullptr);
+        game::WeaponSystem* weapon_system = system_context.CreateSystem<game::WeaponSystem>(
+            transform_system, sprite_system, physics_system, entity_system, prefab_system, nullptr, nullptr, logic_system, nullptr, &system_context);
+
+        game::RegisterSharedComponents(entity_system);
+        game::RegisterGameComponents(entity_system);
+
+        std::vector<uint32_t> expired_bullets;
+        const game::BulletImpactCallback on_impact = [&expired_bullets](
+            uint32_t bullet_entity_id, uint32_t, uint32_t, const char*, game::BulletImpactFlag, const game::DamageDetails&, const game::CollisionDetails&) {
+            expired_bullets.push_back(bullet_entity_id);
+        };
+
+        game::CollisionConfiguration collision_config;
+        collision_config.collision_category = game::CollisionCategory::PLAYER_BULLET;
+        collision_config.collision_mask = game::PLAYER_BULLET_MASK;
+        collision_config.collision_callback = &on_impact;
+
+        // No sounds, there is no audio device in the tests. The bullets expire on their first update.
+        game::WeaponConfiguration weapon_config = MakeWeaponConfig();
+        weapon_config.fire_sound.clear();
+        weapon_config.out_of_ammo_sound.clear();
+        weapon_config.reload_sound.clear();
+        weapon_config.reload_finished_sound.clear();
+        weapon_config.infinite_ammo = true;
+        weapon_config.bullet_velocity = 10.0f;
+        weapon_config.fire_rate_multiplier = 1.0f;
+        weapon_config.max_fire_rate = 1.0f;
+
+        game::BulletConfiguration bullet_config = MakeBulletConfig();
+        bullet_config.entity_file = bullet_entity_file;
+        bullet_config.sound_file.clear();
+        bullet_config.life_span = 0.0f;
+
+        game::DamageModifier damage_modifier("damage", 5);
+        game::DamageModifier crit_modifier("crit_damage", 1.5f);
+        weapon_system->AddModifierForId(owner_id, &damage_modifier);
+        int crit_modifier_id = -1;
+
+        const game::WeaponSetup weapon_setup(hash::Hash("plasma_rifle"), hash::Hash(weapon_config.name.c_str()), hash::Hash(bullet_config.name.c_str()));
+        game::Weapon weapon(owner_id, weapon_setup, weapon_config, bullet_config, collision_config, entity_system, &system_context);
+        mono::IGameSystem& logic_game_system = *logic_system;
+        mono::IGameSystem& entity_game_system = *entity_system;
+
+        mono::UpdateContext update_context;
+        update_context.delta_s = 1.0f / weapon_config.rounds_per_second;
+        update_context.timestamp = 0;
+        update_context.paused = false;
+
+        FireResult result = { };
+
+        for(uint32_t shot = 0; shot < n_shots; ++shot)
+        {
+            if(change_modifiers)
+            {
+                if(crit_modifier_id == -1)
+                {
+                    crit_modifier_id = weapon_system->AddModifierForId(owner_id, &crit_modifier);
+                }
+                else
+                {
+                    weapon_system->RemoveModifierForEntity(owner_id, crit_modifier_id);
+                    crit_modifier_id = -1;
+                }
+            }
+
+            update_context.timestamp += 50;
+
+            const uint32_t allocations_before = tests::HeapAllocations();
+            const game::WeaponState state = weapon.Fire(math::ZeroVec, math::Vector(10.0f, 0.0f), update_context.timestamp);
+            result.fire_allocations += tests::HeapAllocations() - allocations_before;
+            EXPECT_EQ(game::WeaponState::FIRE, state);
+
+            logic_game_system.Update(update_context);
+
+            for(uint32_t bullet_id : expired_bullets)
+                entity_system->ReleaseEntity(bullet_id);
+
+            result.bullets_expired += expired_bullets.size();
+            expired_bullets.clear();
+            entity_game_system.Sync();
+        }
+
+        system_context.DestroySystems();
+        return result;
+    }
+}
+
+TEST(EffectiveWeaponConfig, FireAllocations)
+{
+    constexpr uint32_t n_shots = 10000;
+
+    WriteBulletEntityFile();
+
+    const FireResult cached_result = FireBulletWeapon(n_shots, false);
+    const FireResult rebuilt_result = FireBulletWeapon(n_shots, true);
+
+    std::remove(bullet_entity_file);
+
+    const uint32_t n_bullets = n_shots * MakeWeaponConfig().projectiles_per_fire;
+    EXPECT_EQ(n_bullets, cached_result.bullets_expired);
+    EXPECT_EQ(n_bullets, rebuilt_result.bullets_expired);
+
+    // Spawning the bullets allocates the same in both runs, the configuration copies come on top of that.
+    ASSERT_GE(rebuilt_result.fire_allocations, cached_result.fire_allocations);
+    EXPECT_GE(rebuilt_result.fire_allocations - cached_result.fire_allocations, n_shots);
+
+    std::printf(
+        "Weapon::Fire heap allocations over %u shots: configuration copied per shot %u (%.2f per shot), cached %u (%.2f per shot)\n",
+        n_shots,
+        rebuilt_result.fire_allocations,
+        double(rebuilt_result.fire_allocations) / n_shots,
+        cached_result.fire_allocations,
+        double(cached_result.fire_allocations) / n_shots);
+}
@@ -0,0 +1,182 @@
+
+#include "gtest/gtest.h"
+
+#include "WorldBinary.h"
+#include "EntitySystem/Serialize.h"
+#include "System/File.h"
+
+#include "nlohmann/json.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace
+{
+    constexpr const char* test_world_file = "world_binary_test.components";
+
+    std::vector<mono::EntityData> MakeEntities(uint32_t n_entities)
+    {
+        std::vector<mono::EntityData> entities;
+
+        for(uint32_t index = 0; index < n_entities; ++index)
+        {
+            mono::ComponentData transform;
+            transform.hash = 100;
+            transform.properties = {
+                { 1, math::Vector(index, index * 2.0f) },
+                { 2, float(index) * 0.5f },
+            };
+
+            mono::ComponentData sprite;
+            sprite.hash = 200;
+            sprite.properties = {
+                { 3, std::string("res/sprites/tree.sprite") },
+                { 4, int(index % 7) },
+                { 5, index % 2 == 0 },
+            };
+
+            mono::ComponentData shape;
+            shape.hash = 300;
+            shape.properties = {
+                { 6, std::vector<math::Vector>{ math::Vector(0, 0), math::Vector(1, 0), math::Vector(1, float(index)) } },
+            };
+
+            mono::EntityData entity;
+            entity.entity_name = "tree_" + std::to_string(index % 10);
+            entity.entity_uuid = index + 1;
+            entity.entity_properties = index;
+            entity.entity_components = { transform, sprite, shape };
+            entities.push_back(entity);
+        }
+
+        return entities;
+    }
+
+    void WriteWorld(const std::vector<mono::EntityData>& entities)
+    {
+        nlohmann::json json;
+        json["entities"] = entities;
+        json["metadata"] = { { "level_name", "Binary test" }, { "navmesh_density", 2.0f } };
+
+        const std::string serialized = json.dump(4);
+        FILE* file = std::fopen(test_world_file, "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(serialized.data(), 1, serialized.size(), file);
+        std::fclose(file);
+    }
+}
+
+TEST(WorldBinary, RoundTrip)
+{
+    const std::vector<mono::EntityData> entities = MakeEntities(50);
+    WriteWorld(entities);
+
+    const std::string binary_file = game::WorldBinaryFilename(test_world_file);
+    ASSERT_TRUE(game::ConvertWorldToBinary(test_world_file, binary_file.c_str()));
+
+    game::WorldBinaryReader reader;
+    ASSERT_TRUE(reader.Open(binary_file.c_str(), test_world_file));
+    ASSERT_EQ(entities.size(), reader.EntityCount());
+    EXPECT_EQ("Binary test", nlohmann::json::parse(reader.Metadata())["level_name"]);
+
+    std::vector<mono::EntityData> read_entities(reader.EntityCount());
+    for(uint32_t index = 0; index < reader.EntityCount(); ++index)
+    {
+        reader.ReadEntity(index, read_entities[index]);
+        reader.ReadEntityComponents(index, read_entities[index].entity_components);
+    }
+
+    EXPECT_EQ(nlohmann::json(entities), nlohmann::json(read_entities));
+
+    // The binary is not used once the json world has been changed.
+    WriteWorld(MakeEntities(51));
+    game::WorldBinaryReader stale_reader;
+    EXPECT_FALSE(stale_reader.Open(binary_file.c_str(), test_world_file));
+
+    std::remove(binary_file.c_str());
+    std::remove(test_world_file);
+}
+
+TEST(WorldBinary, RejectsBrokenTables)
+{
+    WriteWorld(MakeEntities(10));
+
+    const std::string binary_file = game::WorldBinaryFilename(test_world_file);
+    ASSERT_TRUE(game::ConvertWorldToBinary(test_world_file, binary_file.c_str()));
+    const std::vector<byte> binary_data = file::FileReadAll(binary_file.c_str());
+
+    uint32_t n_strings = 0;
+    std::memcpy(&n_strings, binary_data.data() + 16, sizeof(n_strings));
+
+    // Header, then the string table, then the entities, components and attributes.
+    constexpr size_t header_size = 48;
+    constexpr size_t string_size = 8;
+    const size_t first_entity = header_size + n_strings * string_size;
+
+    // Byte offset into the binary and a value that points outside of a table.
+    const std::pair<size_t, uint32_t> corruptions[] = {
+        { header_size + 4, 0x00FFFFFF },        // Length of the first string.
+        { first_entity, n_strings },            // Name of the first entity.
+        { first_entity + 12, 1000 },            // First component of the first entity.
+    };
+
+    for(const auto& [byte_offset, value] : corruptions)
+    {
+        std::vector<byte> broken_data = binary_data;
+        std::memcpy(broken_data.data() + byte_offset, &value, sizeof(value));
+
+        FILE* file = std::fopen(binary_file.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(broken_data.data(), 1, broken_data.size(), file);
+        std::fclose(file);
+
+        game::WorldBinaryReader reader;
+        EXPECT_FALSE(reader.Open(binary_file.c_str(), test_world_file));
+    }
+
+    std::remove(binary_file.c_str());
+    std::remove(test_world_file);
+}
+
+TEST(WorldBinaryBenchmark, LoadTime)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    WriteWorld(MakeEntities(5000));
+
+    const std::string binary_file = game::WorldBinaryFilename(test_world_file);
+    ASSERT_TRUE(game::ConvertWorldToBinary(test_world_file, binary_file.c_str()));
+
+    const auto json_start = Clock::now();
+    const std::vector<byte> file_data = file::FileReadAll(test_world_file);
+    const nlohmann::json json = nlohmann::json::parse(file_data);
+    const std::vector<mono::EntityData> json_entities = json["entities"];
+    const std::chrono::duration<double, std::milli> json_ms = Clock::now() - json_start;
+
+    const auto binary_start = Clock::now();
+    game::WorldBinaryReader reader;
+    ASSERT_TRUE(reader.Open(binary_file.c_str(), test_world_file));
+
+    mono::EntityData entity_data;
+    size_t n_components = 0;
+    for(uint32_t index = 0; index < reader.EntityCount(); ++index)
+    {
+        reader.ReadEntity(index, entity_data);
+        reader.ReadEntityComponents(index, entity_data.entity_components);
+        n_components += entity_data.entity_components.size();
+    }
+    const std::chrono::duration<double, std::milli> binary_ms = Clock::now() - binary_start;
+
+    EXPECT_EQ(json_entities.size() * 3, n_components);
+    EXPECT_LT(reader.MappedSize(), file_data.size());
+
+    std::printf(
+        "World load, %zu entities: json %.1f ms %zu kb, binary %.1f ms %zu kb\n",
+        json_entities.size(), json_ms.count(), file_data.size() / 1024, binary_ms.count(), reader.MappedSize() / 1024);
+
+    std::remove(binary_file.c_str());
+    std::remove(test_world_file);
+}